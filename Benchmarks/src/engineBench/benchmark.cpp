@@ -0,0 +1,442 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+namespace EngineBench {
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		double elapsedMs(const BenchmarkRunner::Function& run, const size_t iterations)
+		{
+			const Clock::time_point begin = Clock::now();
+			run(iterations);
+			return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+		}
+
+		void writeEscaped(std::FILE* file, const std::string& text)
+		{
+			for (const char c : text) {
+				if (c == '"' || c == '\\') {
+					std::fputc('\\', file);
+				}
+				std::fputc(c, file);
+			}
+		}
+
+		// Reads the "benchmarks" array of a results file. Any JSON is accepted, values other than
+		// the fields of a benchmark entry are skipped.
+		class ResultsParser {
+		public:
+			explicit ResultsParser(const std::string& text) : m_text(text) {}
+
+			bool parse(std::vector<BenchmarkResult>& results)
+			{
+				bool hasBenchmarks = false;
+				if (!consume('{')) {
+					return fail("expected an object");
+				}
+				if (!consume('}')) {
+					do {
+						std::string key;
+						if (!parseString(key) || !consume(':')) {
+							return fail("expected a key");
+						}
+						if (key == "benchmarks") {
+							if (!parseBenchmarks(results)) {
+								return false;
+							}
+							hasBenchmarks = true;
+						}
+						else if (!skipValue(0)) {
+							return false;
+						}
+					} while (consume(','));
+					if (!consume('}')) {
+						return fail("expected '}'");
+					}
+				}
+				skipSpaces();
+				if (m_position != m_text.size()) {
+					return fail("unexpected trailing characters");
+				}
+				return hasBenchmarks || fail("no benchmarks array");
+			}
+
+			inline const std::string& getError() const { return m_error; }
+		private:
+			static constexpr int MaxDepth = 64;
+
+			bool parseBenchmarks(std::vector<BenchmarkResult>& results)
+			{
+				results.clear();
+				if (!consume('[')) {
+					return fail("benchmarks is not an array");
+				}
+				if (consume(']')) {
+					return true;
+				}
+				do {
+					BenchmarkResult result;
+					if (!parseEntry(result)) {
+						return false;
+					}
+					results.push_back(std::move(result));
+				} while (consume(','));
+				return consume(']') || fail("expected ']'");
+			}
+
+			// Statistics missing from an entry fall back to its median
+			bool parseEntry(BenchmarkResult& result)
+			{
+				if (!consume('{')) {
+					return fail("benchmark entry is not an object");
+				}
+				bool hasName = false;
+				bool hasMean = false;
+				bool hasMin = false;
+				bool hasMax = false;
+				if (!consume('}')) {
+					do {
+						std::string key;
+						if (!parseString(key) || !consume(':')) {
+							return fail("expected a key");
+						}
+						if (key == "name") {
+							if (!parseString(result.name)) {
+								return fail("benchmark name is not a string");
+							}
+							hasName = true;
+							continue;
+						}
+
+						double* field = nullptr;
+						double iterations = 0;
+						double repetitions = 0;
+						if (key == "iterations") {
+							field = &iterations;
+						}
+						else if (key == "repetitions") {
+							field = &repetitions;
+						}
+						else if (key == "median") {
+							field = &result.median;
+						}
+						else if (key == "mean") {
+							field = &result.mean;
+							hasMean = true;
+						}
+						else if (key == "stddev") {
+							field = &result.stddev;
+						}
+						else if (key == "min") {
+							field = &result.min;
+							hasMin = true;
+						}
+						else if (key == "max") {
+							field = &result.max;
+							hasMax = true;
+						}
+
+						if (!field) {
+							if (!skipValue(0)) {
+								return false;
+							}
+						}
+						else if (!parseNumber(*field)) {
+							return fail("expected a number for " + key);
+						}
+						if (field == &iterations) {
+							result.iterations = static_cast<size_t>(iterations);
+						}
+						else if (field == &repetitions) {
+							result.repetitions = static_cast<size_t>(repetitions);
+						}
+					} while (consume(','));
+					if (!consume('}')) {
+						return fail("expected '}'");
+					}
+				}
+				if (!hasName) {
+					return fail("a benchmark has no name");
+				}
+				result.mean = hasMean ? result.mean : result.median;
+				result.min = hasMin ? result.min : result.median;
+				result.max = hasMax ? result.max : result.median;
+				return true;
+			}
+
+			bool skipValue(const int depth)
+			{
+				if (depth > MaxDepth) {
+					return fail("nested too deep");
+				}
+				skipSpaces();
+				if (m_position >= m_text.size()) {
+					return fail("unexpected end");
+				}
+				const char c = m_text[m_position];
+				if (c == '"') {
+					std::string text;
+					return parseString(text) || fail("invalid string");
+				}
+				if (c == '{' || c == '[') {
+					const char close = c == '{' ? '}' : ']';
+					++m_position;
+					if (consume(close)) {
+						return true;
+					}
+					do {
+						if (c == '{') {
+							std::string key;
+							if (!parseString(key) || !consume(':')) {
+								return fail("expected a key");
+							}
+						}
+						if (!skipValue(depth + 1)) {
+							return false;
+						}
+					} while (consume(','));
+					return consume(close) || fail(std::string("expected '") + close + "'");
+				}
+				for (const char* literal : { "true", "false", "null" }) {
+					if (m_text.compare(m_position, std::char_traits<char>::length(literal), literal) == 0) {
+						m_position += std::char_traits<char>::length(literal);
+						return true;
+					}
+				}
+				double number;
+				return parseNumber(number) || fail("unexpected character");
+			}
+
+			// Escapes other than \" and \\ are kept verbatim, the writer produces no others
+			bool parseString(std::string& text)
+			{
+				if (!consume('"')) {
+					return false;
+				}
+				text.clear();
+				while (m_position < m_text.size() && m_text[m_position] != '"') {
+					if (m_text[m_position] == '\\' && m_position + 1 < m_text.size()) {
+						const char escaped = m_text[m_position + 1];
+						if (escaped != '"' && escaped != '\\') {
+							text += '\\';
+						}
+						text += escaped;
+						m_position += 2;
+						continue;
+					}
+					text += m_text[m_position++];
+				}
+				if (m_position >= m_text.size()) {
+					return false;
+				}
+				++m_position;
+				return true;
+			}
+
+			bool parseNumber(double& number)
+			{
+				skipSpaces();
+				const char* begin = m_text.c_str() + m_position;
+				char* end = nullptr;
+				number = std::strtod(begin, &end);
+				if (end == begin) {
+					return false;
+				}
+				m_position += static_cast<size_t>(end - begin);
+				return true;
+			}
+
+			bool consume(const char c)
+			{
+				skipSpaces();
+				if (m_position < m_text.size() && m_text[m_position] == c) {
+					++m_position;
+					return true;
+				}
+				return false;
+			}
+
+			void skipSpaces()
+			{
+				while (m_position < m_text.size() && (m_text[m_position] == ' ' || m_text[m_position] == '\n'
+					|| m_text[m_position] == '\r' || m_text[m_position] == '\t')) {
+					++m_position;
+				}
+			}
+
+			bool fail(const std::string& error)
+			{
+				if (m_error.empty()) {
+					m_error = error + " at offset " + std::to_string(m_position);
+				}
+				return false;
+			}
+
+			const std::string& m_text;
+			size_t m_position = 0;
+			std::string m_error;
+		};
+
+		const BenchmarkResult* findResult(const std::vector<BenchmarkResult>& results, const std::string& name)
+		{
+			for (const BenchmarkResult& result : results) {
+				if (result.name == name) {
+					return &result;
+				}
+			}
+			return nullptr;
+		}
+	}
+
+	void BenchmarkRunner::add(std::string name, Function run, const size_t itemsPerIteration)
+	{
+		m_names.push_back(std::move(name));
+		m_functions.push_back(std::move(run));
+		m_itemsPerIteration.push_back(std::max<size_t>(1, itemsPerIteration));
+	}
+
+	std::vector<BenchmarkResult> BenchmarkRunner::run()
+	{
+		std::vector<BenchmarkResult> results;
+		std::printf("%-40s %12s %12s %12s %12s %8s\n", "benchmark", "median ns", "mean ns", "min ns", "max ns", "cv %");
+		for (size_t i = 0; i < m_names.size(); ++i) {
+			if (!m_options.filter.empty() && m_names[i].find(m_options.filter) == std::string::npos) {
+				continue;
+			}
+			const BenchmarkResult result = measure(m_names[i], m_functions[i], m_itemsPerIteration[i]);
+			std::printf("%-40s %12.3f %12.3f %12.3f %12.3f %8.2f\n", result.name.c_str(), result.median, result.mean,
+				result.min, result.max, result.mean > 0 ? 100.0 * result.stddev / result.mean : 0.0);
+			std::fflush(stdout);
+			results.push_back(result);
+		}
+		return results;
+	}
+
+	BenchmarkResult BenchmarkRunner::measure(const std::string& name, const Function& run, const size_t itemsPerIteration) const
+	{
+		// Warm-up doubles as calibration: caches, branch predictors and the frequency governor settle
+		// while the iteration count grows to fill a repetition
+		size_t iterations = 1;
+		double warmupMs = 0;
+		while (true) {
+			const double ms = elapsedMs(run, iterations);
+			warmupMs += ms;
+			if (ms >= m_options.minRepetitionMs && warmupMs >= m_options.warmupMs) {
+				break;
+			}
+			if (ms < m_options.minRepetitionMs) {
+				iterations *= 2;
+			}
+		}
+
+		std::vector<double> samples(std::max<size_t>(1, m_options.repetitions));
+		for (double& sample : samples) {
+			sample = elapsedMs(run, iterations) * 1e6 / static_cast<double>(iterations * itemsPerIteration);
+		}
+		std::sort(samples.begin(), samples.end());
+
+		BenchmarkResult result;
+		result.name = name;
+		result.iterations = iterations;
+		result.repetitions = samples.size();
+		result.min = samples.front();
+		result.max = samples.back();
+		const size_t middle = samples.size() / 2;
+		result.median = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+		for (const double sample : samples) {
+			result.mean += sample;
+		}
+		result.mean /= static_cast<double>(samples.size());
+		for (const double sample : samples) {
+			result.stddev += (sample - result.mean) * (sample - result.mean);
+		}
+		result.stddev = samples.size() > 1 ? std::sqrt(result.stddev / static_cast<double>(samples.size() - 1)) : 0.0;
+		return result;
+	}
+
+	bool writeResults(const char* path, const std::vector<BenchmarkResult>& results)
+	{
+		std::FILE* file = std::fopen(path, "w");
+		if (!file) {
+			std::fprintf(stderr, "Can't create %s\n", path);
+			return false;
+		}
+
+#ifndef NDEBUG
+		const char* build = "debug";
+#else
+		const char* build = "release";
+#endif
+		std::fprintf(file, "{\n\"unit\": \"ns\",\n\"build\": \"%s\",\n\"benchmarks\": [\n", build);
+		for (size_t i = 0; i < results.size(); ++i) {
+			const BenchmarkResult& result = results[i];
+			std::fputs("{\"name\": \"", file);
+			writeEscaped(file, result.name);
+			std::fprintf(file, "\", \"iterations\": %zu, \"repetitions\": %zu, \"median\": %.4f, \"mean\": %.4f, \"stddev\": %.4f, \"min\": %.4f, \"max\": %.4f}%s\n",
+				result.iterations, result.repetitions, result.median, result.mean, result.stddev, result.min, result.max,
+				i + 1 < results.size() ? "," : "");
+		}
+		std::fputs("]\n}\n", file);
+		const bool isWritten = std::ferror(file) == 0;
+		std::fclose(file);
+		if (!isWritten) {
+			std::fprintf(stderr, "Failed writing %s\n", path);
+		}
+		return isWritten;
+	}
+
+	bool readResults(const char* path, std::vector<BenchmarkResult>& results)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			std::fprintf(stderr, "Can't open %s\n", path);
+			return false;
+		}
+		const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		ResultsParser parser(text);
+		if (!parser.parse(results)) {
+			std::fprintf(stderr, "Can't read results from %s: %s\n", path, parser.getError().c_str());
+			return false;
+		}
+		return true;
+	}
+
+	size_t compareResults(const std::vector<BenchmarkResult>& baseline, const std::vector<BenchmarkResult>& current, const double thresholdPercent)
+	{
+		size_t regressions = 0;
+		std::printf("%-40s %12s %12s %10s\n", "benchmark", "baseline ns", "current ns", "change");
+		for (const BenchmarkResult& result : current) {
+			const BenchmarkResult* previous = findResult(baseline, result.name);
+			if (!previous) {
+				std::printf("%-40s %12s %12.3f %10s  new\n", result.name.c_str(), "-", result.median, "-");
+				continue;
+			}
+
+			const double change = previous->median > 0 ? 100.0 * (result.median - previous->median) / previous->median : 0.0;
+			const char* verdict = "";
+			if (change > thresholdPercent) {
+				verdict = "  REGRESSION";
+				++regressions;
+			}
+			else if (change < -thresholdPercent) {
+				verdict = "  improved";
+			}
+			std::printf("%-40s %12.3f %12.3f %+9.1f%%%s\n", result.name.c_str(), previous->median, result.median, change, verdict);
+		}
+		for (const BenchmarkResult& result : baseline) {
+			if (!findResult(current, result.name)) {
+				std::printf("%-40s %12.3f %12s %10s  missing\n", result.name.c_str(), result.median, "-", "-");
+			}
+		}
+		std::printf("%zu regression(s) beyond %.1f%%\n", regressions, thresholdPercent);
+		return regressions;
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace EngineBench {
+	// Keeps the optimizer from dropping a result the benchmark doesn't otherwise use
+	template<typename T>
+	inline void keep(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "g"(&value) : "memory");
+#else
+		static const void* volatile s_sink;
+		s_sink = &value;
+#endif
+	}
+
+	// Nanoseconds per item over the repetitions of one benchmark
+	struct BenchmarkResult {
+		std::string name;
+		size_t iterations = 0; // per repetition
+		size_t repetitions = 0;
+		double min = 0;
+		double median = 0;
+		double mean = 0;
+		double stddev = 0;
+		double max = 0;
+	};
+
+	struct BenchmarkOptions {
+		double warmupMs = 100;
+		// The iteration count is doubled until a repetition takes at least this long
+		double minRepetitionMs = 10;
+		size_t repetitions = 15;
+		// Only benchmarks whose name contains it run
+		std::string filter;
+	};
+
+	class BenchmarkRunner {
+	public:
+		// run(iterations) performs the measured operation that many times, itemsPerIteration turns the
+		// time into a cost per item when one iteration processes many (entities, events...)
+		using Function = std::function<void(size_t iterations)>;
+
+		explicit BenchmarkRunner(const BenchmarkOptions& options) : m_options(options) {}
+
+		void add(std::string name, Function run, const size_t itemsPerIteration = 1);
+		inline const std::vector<std::string>& getNames() const { return m_names; }
+
+		// Runs the benchmarks in registration order and prints a line per benchmark as it finishes
+		std::vector<BenchmarkResult> run();
+	private:
+		BenchmarkResult measure(const std::string& name, const Function& run, const size_t itemsPerIteration) const;
+
+		BenchmarkOptions m_options;
+		std::vector<std::string> m_names;
+		std::vector<Function> m_functions;
+		std::vector<size_t> m_itemsPerIteration;
+	};
+
+	bool writeResults(const char* path, const std::vector<BenchmarkResult>& results);
+	bool readResults(const char* path, std::vector<BenchmarkResult>& results);
+
+	// Prints how every benchmark's median moved between two result files, returns the number of
+	// benchmarks slower than the baseline by more than thresholdPercent
+	size_t compareResults(const std::vector<BenchmarkResult>& baseline, const std::vector<BenchmarkResult>& current, const double thresholdPercent);
+}
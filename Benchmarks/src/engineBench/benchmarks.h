@@ -0,0 +1,17 @@
+#pragma once
+
+#include "benchmark.h"
+
+namespace EngineBench {
+	// One function per engine area. Benchmarks with a large fixture build it the first time they run,
+	// so the ones left out by --filter cost nothing.
+
+	// Camera, buffer layouts, events and input
+	void registerCoreBenchmarks(BenchmarkRunner& runner);
+	// Allocators, the job system and logging
+	void registerSystemBenchmarks(BenchmarkRunner& runner);
+	// Registry, transform hierarchy, culling, level of detail selection and scene files
+	void registerSceneBenchmarks(BenchmarkRunner& runner);
+	// Drawing through OpenGL into a hidden window, one iteration is one frame finished by the GPU
+	void registerGpuBenchmarks(BenchmarkRunner& runner);
+}
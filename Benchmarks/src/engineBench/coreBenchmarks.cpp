@@ -0,0 +1,244 @@
+#include "benchmarks.h"
+
+#include "camera.h"
+#include "events.h"
+#include "eventQueue.h"
+#include "input.h"
+#include "rendering/OpenGL/vertexBuffer.h"
+
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <functional>
+#include <string>
+
+namespace EngineBench {
+	namespace {
+		using namespace GameEngine;
+
+		// The camera as it was: three Euler matrices and lookAt on every change, projection rebuilt every frame
+		class LegacyCamera {
+		public:
+			void moveAndRotate(const glm::vec3& move_delta, const glm::vec3& rotate_delta) {
+				m_position += m_direction * move_delta.x;
+				m_position += m_right * move_delta.y;
+				m_position += m_up * move_delta.z;
+				m_rotation += rotate_delta;
+				m_updateViewMatrix = true;
+			}
+			void setPerspective() {
+				m_projectionMatrix = glm::perspective(glm::radians(45.0f), 1.f, 0.1f, 100.0f);
+			}
+			glm::mat4 getViewProjectionMatrix() {
+				if (m_updateViewMatrix) {
+					updateViewMatrix();
+				}
+				return m_projectionMatrix * m_viewMatrix;
+			}
+		private:
+			void updateViewMatrix() {
+				const glm::mat3 rotationMatrix_x = {
+					1, 0, 0,
+					0, std::cos(m_rotation.x), -std::sin(m_rotation.x),
+					0, std::sin(m_rotation.x), std::cos(m_rotation.x),
+				};
+				const glm::mat3 rotationMatrix_y = {
+					std::cos(m_rotation.y), 0, -std::sin(m_rotation.y),
+					0, 1, 0,
+					std::sin(m_rotation.y), 0, std::cos(m_rotation.y),
+				};
+				const glm::mat3 rotationMatrix_z = {
+					std::cos(m_rotation.z), -std::sin(m_rotation.z), 0,
+					std::sin(m_rotation.z), std::cos(m_rotation.z), 0,
+					0, 0, 1,
+				};
+				const glm::mat3 euler_rotateMatrix = rotationMatrix_z * rotationMatrix_y * rotationMatrix_x;
+				m_direction = glm::normalize(euler_rotateMatrix * glm::vec3(1.f, 0.f, 0.f));
+				m_right = glm::normalize(euler_rotateMatrix * glm::vec3(0.f, -1.f, 0.f));
+				m_up = glm::cross(m_right, m_direction);
+				m_viewMatrix = glm::lookAt(m_position, m_position + m_direction, m_up);
+				m_updateViewMatrix = false;
+			}
+
+			glm::vec3 m_position = { 0.f, 0.f, 2.f };
+			glm::vec3 m_rotation = { 0.f, 0.f, 0.f };
+			glm::vec3 m_direction = { 1.f, 0.f, 0.f };
+			glm::vec3 m_right = { 0.f, -1.f, 0.f };
+			glm::vec3 m_up = { 0.f, 0.f, 1.f };
+			glm::mat4 m_viewMatrix = glm::mat4(1.f);
+			glm::mat4 m_projectionMatrix = glm::mat4(1.f);
+			bool m_updateViewMatrix = true;
+		};
+
+		// Mouse look turns the camera on most frames, a walking camera only moves, an idle one does neither
+		enum class Motion { Look, Walk, Idle };
+
+		glm::vec3 moveDelta(const Motion motion, const size_t i) {
+			return motion == Motion::Idle ? glm::vec3(0.f) : glm::vec3(0.01f, (i & 1) ? 0.005f : -0.005f, 0.f);
+		}
+		glm::vec3 rotateDelta(const Motion motion, const size_t i) {
+			return motion == Motion::Look ? glm::vec3(0.f, 0.0007f * ((i & 2) ? 1.f : -1.f), 0.001f) : glm::vec3(0.f);
+		}
+
+		// The dispatcher as it was before the queue: window callback -> std::function -> std::function
+		class LegacyDispatcher {
+		public:
+			template<typename Type>
+			void addEventListener(std::function<void(Type&)> callback) {
+				m_eventCallbacks[static_cast<size_t>(Type::getTypeStatic())] = [func = std::move(callback)](BaseEvent& e) {
+					func(static_cast<Type&>(e));
+				};
+			}
+			void dispacth(BaseEvent& event) {
+				auto& callback = m_eventCallbacks[static_cast<size_t>(event.getType())];
+				if (callback) {
+					callback(event);
+				}
+			}
+		private:
+			std::function<void(BaseEvent&)> m_eventCallbacks[static_cast<size_t>(EventType::EventsCount)];
+		};
+
+		// Stands in for the camera code, cheap enough that the dispatch cost stays visible
+		struct CameraState {
+			double lastX = 0, lastY = 0;
+			double yaw = 0, pitch = 0;
+
+			void onMouseMoved(const double x, const double y) {
+				yaw += (x - lastX) * 0.1;
+				pitch += (y - lastY) * 0.1;
+				lastX = x;
+				lastY = y;
+			}
+		};
+	}
+
+	void registerCoreBenchmarks(BenchmarkRunner& runner)
+	{
+		// Camera: the main loop moves it and reads the view-projection matrix every frame
+		static Camera s_camera({ 0.f, 0.f, 2.f }, { 0.f, 0.f, 0.f }, Camera::ProjectionMode::Perspective);
+		runner.add("camera/move_rotate_view_projection", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				s_camera.moveAndRotate({ 0.01f, 0.f, 0.f }, { 0.f, 0.001f, 0.002f });
+				keep(s_camera.getViewProjectionMatrix());
+			}
+		});
+		runner.add("camera/view_projection_cached", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				keep(s_camera.getViewProjectionMatrix());
+			}
+		});
+		runner.add("camera/frustum", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				keep(s_camera.getFrustum());
+			}
+		});
+
+		// The previous Euler camera against the quaternion one, the projection is set every frame like the old main loop did
+		const struct { Motion motion; const char* name; } motions[] = {
+			{ Motion::Look, "look" }, { Motion::Walk, "walk" }, { Motion::Idle, "idle" }
+		};
+		for (const auto& [motion, name] : motions) {
+			runner.add(std::string("camera/") + name + "_euler_legacy", [motion = motion](const size_t iterations) {
+				LegacyCamera camera;
+				for (size_t i = 0; i < iterations; ++i) {
+					camera.moveAndRotate(moveDelta(motion, i), rotateDelta(motion, i));
+					camera.setPerspective();
+					keep(camera.getViewProjectionMatrix());
+				}
+			});
+			runner.add(std::string("camera/") + name + "_quaternion", [motion = motion](const size_t iterations) {
+				Camera camera({ 0.f, 0.f, 2.f }, { 0.f, 0.f, 0.f }, Camera::ProjectionMode::Perspective);
+				for (size_t i = 0; i < iterations; ++i) {
+					camera.moveAndRotate(moveDelta(motion, i), rotateDelta(motion, i));
+					camera.setProjectionMode(Camera::ProjectionMode::Perspective);
+					keep(camera.getViewProjectionMatrix());
+				}
+			});
+		}
+
+		runner.add("buffer_layout/build_4_elements", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				const BufferLayout layout = {
+					BufferElement(ShaderDataType::Float3),
+					BufferElement(ShaderDataType::Float3),
+					BufferElement(ShaderDataType::Float2),
+					BufferElement(ShaderDataType::Mat4, 1)
+				};
+				keep(layout);
+			}
+		});
+		static const BufferLayout s_layoutA = { ShaderDataType::Float3, ShaderDataType::Float3, ShaderDataType::Float2 };
+		static const BufferLayout s_layoutB = { ShaderDataType::Float3, ShaderDataType::Float3, ShaderDataType::Float2 };
+		runner.add("buffer_layout/compare", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				const bool isEqual = s_layoutA == s_layoutB;
+				keep(isEqual);
+			}
+		});
+
+		// Events: one listener, the way the camera controller subscribes
+		static EventDispathcer s_dispatcher;
+		static double s_yaw = 0;
+		s_dispatcher.addEventListener<MouseMovedEvent>([](MouseMovedEvent& event) {
+			s_yaw += event.getX() * 0.1;
+		});
+		runner.add("events/dispatch_mouse_moved", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				MouseMovedEvent event(static_cast<double>(i & 1023), 1.0);
+				s_dispatcher.dispacth(event);
+			}
+			keep(s_yaw);
+		});
+		static CameraState s_legacyCamera;
+		static LegacyDispatcher s_legacyDispatcher;
+		s_legacyDispatcher.addEventListener<MouseMovedEvent>([](MouseMovedEvent& event) {
+			s_legacyCamera.onMouseMoved(event.getX(), event.getY());
+		});
+		static std::function<void(BaseEvent&)> s_windowCallback = [](BaseEvent& event) { s_legacyDispatcher.dispacth(event); };
+		runner.add("events/dispatch_std_function_legacy", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				MouseMovedEvent event(static_cast<double>(i & 1023), 1.0);
+				s_windowCallback(event);
+			}
+			keep(s_legacyCamera.yaw);
+		});
+		constexpr size_t EventsPerFrame = 64;
+		static EventQueue s_eventQueue;
+		runner.add("events/queue_push_dispatch", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				for (size_t j = 0; j < EventsPerFrame; ++j) {
+					s_eventQueue.push(KeyPressedEvent(static_cast<KeyCode>(j % 26 + 65), false));
+				}
+				s_eventQueue.dispatch(s_dispatcher);
+			}
+		}, EventsPerFrame);
+		// A fast mouse between two frames, the queue keeps only the last move of a run
+		constexpr size_t MovesPerFrame = 500;
+		runner.add("events/queue_mouse_moves_coalesced", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				for (size_t j = 0; j < MovesPerFrame; ++j) {
+					s_eventQueue.push(MouseMovedEvent(static_cast<double>(i * 7 + j), static_cast<double>(i * 3 + j * 2)));
+				}
+				s_eventQueue.dispatch(s_dispatcher);
+			}
+			keep(s_yaw);
+		}, MovesPerFrame);
+
+		// Input: a tick of key changes followed by the queries gameplay code makes
+		runner.add("input/tick_and_queries", [](const size_t iterations) {
+			size_t pressed = 0;
+			for (size_t i = 0; i < iterations; ++i) {
+				const KeyCode key = static_cast<KeyCode>(i % 26 + 65);
+				Input::pressKey(key);
+				Input::moveCursor({ static_cast<float>(i & 1023), 0.f });
+				Input::captureTick();
+				pressed += Input::isKeyJustPressed(key) + Input::isKeyPressed(KeyCode::KEY_W);
+				Input::releaseKey(key);
+				keep(Input::getCursorDelta());
+			}
+			keep(pressed);
+		});
+	}
+}
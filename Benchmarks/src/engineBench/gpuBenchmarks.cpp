@@ -0,0 +1,686 @@
+#include "benchmarks.h"
+
+#include "window.h"
+
+#include "rendering/culling.h"
+#include "rendering/OpenGL/shader.h"
+#include "rendering/OpenGL/vertexBuffer.h"
+#include "rendering/OpenGL/vertexArray.h"
+#include "rendering/OpenGL/indexBuffer.h"
+#include "rendering/OpenGL/openGL_Renderer.h"
+#include "rendering/OpenGL/indirectRenderer.h"
+#include "rendering/OpenGL/glState.h"
+#include "rendering/OpenGL/textureManager.h"
+#include "resources/meshFile.h"
+#include "resources/textureFile.h"
+
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace EngineBench {
+	namespace {
+		using namespace GameEngine;
+
+		float cubePoints[] = {
+			-0.5,  0.5,  0.5,      1, 1, 1,
+			-0.5,  0.5, -0.5,      1, 1, 1,
+			-0.5, -0.5,  0.5,      1, 1, 1,
+			-0.5, -0.5, -0.5,      1, 1, 1,
+
+			0.5,  0.5,  0.5,      1, 0, 0,
+			0.5,  0.5, -0.5,      0, 1, 0,
+			0.5, -0.5,  0.5,      0, 0, 1,
+			0.5, -0.5, -0.5,      0, 1, 1
+		};
+		GLuint cubeIndices[] = {
+			0, 1, 2, 1, 2, 3,
+			4, 5, 6, 5, 6, 7,
+			0, 1, 4, 1, 4, 5,
+			2, 3, 6, 3, 6, 7,
+			0, 2, 4, 2, 4, 6,
+			1, 3, 5, 3, 5, 7,
+		};
+		// Bounding sphere of the unit cube
+		const float cubeRadius = std::sqrt(0.75f);
+
+		const char* uniformVertexShader = R"(
+			#version 460
+
+			layout (location = 0) in vec3 pos;
+			layout (location = 1) in vec3 color;
+
+			out vec4 vertexColor;
+
+			uniform mat4 model_matrix;
+			uniform mat4 view_projection_matrix;
+
+			void main(){
+				gl_Position = view_projection_matrix * model_matrix * vec4(pos, 1);
+				vertexColor = vec4(color, 1);
+			}
+		)";
+		const char* instancedVertexShader = R"(
+			#version 460
+
+			layout (location = 0) in vec3 pos;
+			layout (location = 1) in vec3 color;
+			layout (location = 2) in mat4 instance_model_matrix;
+
+			out vec4 vertexColor;
+
+			uniform mat4 view_projection_matrix;
+
+			void main(){
+				gl_Position = view_projection_matrix * instance_model_matrix * vec4(pos, 1);
+				vertexColor = vec4(color, 1);
+			}
+		)";
+		const char* indirectVertexShader = R"(
+			#version 460
+
+			layout (location = 0) in vec3 pos;
+			layout (location = 1) in vec3 color;
+
+			out vec4 vertexColor;
+
+			struct ObjectData {
+				mat4 model;
+				uint meshId;
+				uint padding[3];
+			};
+			layout (std430, binding = 0) readonly buffer Objects {
+				ObjectData objects[];
+			};
+
+			uniform mat4 view_projection_matrix;
+
+			void main(){
+				gl_Position = view_projection_matrix * objects[gl_DrawID].model * vec4(pos, 1);
+				vertexColor = vec4(color, 1);
+			}
+		)";
+		const char* colorFragmentShader = R"(
+			#version 460
+
+			in vec4 vertexColor;
+			out vec4 fragmentColor;
+
+			void main(){
+				fragmentColor = vertexColor;
+			}
+		)";
+
+		void checkCompiled(const std::initializer_list<bool> compiled)
+		{
+			for (const bool isCompiled : compiled) {
+				if (!isCompiled) {
+					std::fprintf(stderr, "Shader compilation failed\n");
+					std::exit(1);
+				}
+			}
+		}
+
+		// Never shown, without a display it renders through OSMesa. Frames are finished with glFinish
+		// instead of being presented, so the swap interval doesn't matter.
+		Window& getWindow()
+		{
+			static Window s_window(1280, 720, "engine_bench", true);
+			return s_window;
+		}
+
+		// Cubes on a grid, side * side * side of them
+		std::vector<glm::mat4> makeCubeGrid(const size_t cubesCount, float& extent)
+		{
+			const size_t side = static_cast<size_t>(std::ceil(std::cbrt(static_cast<double>(cubesCount))));
+			std::vector<glm::mat4> modelMatrices;
+			modelMatrices.reserve(cubesCount);
+			for (size_t i = 0; i < cubesCount; ++i) {
+				const glm::vec3 position = {
+					static_cast<float>(i % side) * 2.f,
+					static_cast<float>((i / side) % side) * 2.f,
+					static_cast<float>(i / (side * side)) * 2.f
+				};
+				modelMatrices.push_back(glm::scale(glm::translate(glm::mat4(1.f), position), glm::vec3(0.5f)));
+			}
+			extent = static_cast<float>(side) * 2.f;
+			return modelMatrices;
+		}
+
+		// A model_matrix uniform per cube against a single instanced call
+		struct InstancingFixture {
+			static constexpr size_t CubesCount = 10000;
+
+			InstancingFixture() :
+				window(getWindow()),
+				meshLayout{ ShaderDataType::Float3, ShaderDataType::Float3 },
+				instanceLayout{ { ShaderDataType::Mat4, 1 } },
+				modelMatrices(makeCubeGrid(CubesCount, extent)),
+				meshBuffer(cubePoints, sizeof(cubePoints), meshLayout),
+				indexBuffer(cubeIndices, sizeof(cubeIndices) / sizeof(GLuint)),
+				instanceBuffer(modelMatrices.data(), modelMatrices.size() * sizeof(glm::mat4), instanceLayout),
+				uniformShader(uniformVertexShader, colorFragmentShader),
+				instancedShader(instancedVertexShader, colorFragmentShader)
+			{
+				checkCompiled({ uniformShader.isCompiled(), instancedShader.isCompiled() });
+				uniformVertexArray.addVertexBuffer(meshBuffer);
+				uniformVertexArray.setIndexBuffer(indexBuffer);
+				instancedVertexArray.addVertexBuffer(meshBuffer);
+				instancedVertexArray.addVertexBuffer(instanceBuffer);
+				instancedVertexArray.setIndexBuffer(indexBuffer);
+
+				modelMatrixLocation = uniformShader.getUniformLocation("model_matrix");
+				uniformViewProjectionLocation = uniformShader.getUniformLocation("view_projection_matrix");
+				instancedViewProjectionLocation = instancedShader.getUniformLocation("view_projection_matrix");
+				viewProjection = glm::perspective(glm::radians(60.f), window.getAspect(), 0.1f, extent * 4.f) *
+					glm::lookAt(glm::vec3(-extent, extent * 0.75f, -extent), glm::vec3(extent * 0.5f), glm::vec3(0, 1, 0));
+			}
+
+			Window& window;
+			float extent = 0.f;
+			BufferLayout meshLayout;
+			BufferLayout instanceLayout;
+			std::vector<glm::mat4> modelMatrices;
+			VertexBuffer meshBuffer;
+			IndexBuffer indexBuffer;
+			VertexBuffer instanceBuffer;
+			VertexArray uniformVertexArray;
+			VertexArray instancedVertexArray;
+			Shader uniformShader;
+			Shader instancedShader;
+			int modelMatrixLocation = -1;
+			int uniformViewProjectionLocation = -1;
+			int instancedViewProjectionLocation = -1;
+			glm::mat4 viewProjection = glm::mat4(1.f);
+		};
+
+		InstancingFixture& getInstancing()
+		{
+			static InstancingFixture s_fixture;
+			return s_fixture;
+		}
+
+		// About half of the cubes outside the frustum: CPU culling and a draw call per visible cube
+		// against the compute shader culling and a single multi-draw indirect call
+		struct IndirectFixture {
+			static constexpr size_t CubesCount = 100000;
+
+			IndirectFixture() :
+				window(getWindow()),
+				meshLayout{ ShaderDataType::Float3, ShaderDataType::Float3 },
+				modelMatrices(makeCubeGrid(CubesCount, extent)),
+				meshBuffer(cubePoints, sizeof(cubePoints), meshLayout),
+				indexBuffer(cubeIndices, sizeof(cubeIndices) / sizeof(GLuint)),
+				indirectRenderer(meshLayout),
+				uniformShader(uniformVertexShader, colorFragmentShader),
+				indirectShader(indirectVertexShader, colorFragmentShader),
+				visibleIndices(CubesCount)
+			{
+				vertexArray.addVertexBuffer(meshBuffer);
+				vertexArray.setIndexBuffer(indexBuffer);
+				cubeMeshId = indirectRenderer.addMesh(
+					cubePoints, sizeof(cubePoints) / meshLayout.getStride(), cubeIndices, sizeof(cubeIndices) / sizeof(GLuint), glm::vec3(0.f), cubeRadius
+				);
+				checkCompiled({ uniformShader.isCompiled(), indirectShader.isCompiled(), indirectRenderer.isCompiled() });
+
+				modelMatrixLocation = uniformShader.getUniformLocation("model_matrix");
+				uniformViewProjectionLocation = uniformShader.getUniformLocation("view_projection_matrix");
+				indirectViewProjectionLocation = indirectShader.getUniformLocation("view_projection_matrix");
+				// Looking at the middle of the grid from inside it, the cubes behind the camera get culled
+				viewProjection = glm::perspective(glm::radians(60.f), window.getAspect(), 0.1f, extent * 2.f) *
+					glm::lookAt(glm::vec3(extent * 0.5f), glm::vec3(extent, extent * 0.5f, extent * 0.5f), glm::vec3(0, 1, 0));
+				frustum = Frustum::fromMatrix(viewProjection);
+				spheres.reserve(CubesCount);
+			}
+
+			Window& window;
+			float extent = 0.f;
+			BufferLayout meshLayout;
+			std::vector<glm::mat4> modelMatrices;
+			VertexBuffer meshBuffer;
+			IndexBuffer indexBuffer;
+			VertexArray vertexArray;
+			IndirectRenderer indirectRenderer;
+			uint32_t cubeMeshId = 0;
+			Shader uniformShader;
+			Shader indirectShader;
+			int modelMatrixLocation = -1;
+			int uniformViewProjectionLocation = -1;
+			int indirectViewProjectionLocation = -1;
+			glm::mat4 viewProjection = glm::mat4(1.f);
+			Frustum frustum;
+			BoundingSpheres spheres;
+			std::vector<uint32_t> visibleIndices;
+		};
+
+		IndirectFixture& getIndirect()
+		{
+			static IndirectFixture s_fixture;
+			return s_fixture;
+		}
+
+		constexpr uint32_t TextureSize = 64;
+
+		float quadPoints[] = {
+			0.f, 0.f,     0.f, 0.f,
+			1.f, 0.f,     1.f, 0.f,
+			1.f, 1.f,     1.f, 1.f,
+			0.f, 1.f,     0.f, 1.f,
+		};
+		GLuint quadIndices[] = {
+			0, 1, 2, 2, 3, 0,
+		};
+
+		struct InstanceData {
+			float offset[2];
+			int32_t layer;
+			int32_t residentMip;
+		};
+
+		const char* separateVertexShader = R"(
+			#version 460
+
+			layout (location = 0) in vec2 pos;
+			layout (location = 1) in vec2 uv;
+
+			out vec2 vertexUv;
+
+			// Offset in xy, size in zw, both in clip space
+			uniform vec4 placement[1];
+
+			void main(){
+				gl_Position = vec4(placement[0].xy + pos * placement[0].zw, 0, 1);
+				vertexUv = uv;
+			}
+		)";
+		const char* separateFragmentShader = R"(
+			#version 460
+
+			in vec2 vertexUv;
+			out vec4 fragmentColor;
+
+			uniform sampler2D image;
+
+			void main(){
+				fragmentColor = texture(image, vertexUv);
+			}
+		)";
+		const char* pooledVertexShader = R"(
+			#version 460
+
+			layout (location = 0) in vec2 pos;
+			layout (location = 1) in vec2 uv;
+			layout (location = 2) in vec2 offset;
+			layout (location = 3) in ivec2 textureSlot;
+
+			out vec2 vertexUv;
+			flat out int layer;
+			flat out float residentMip;
+
+			uniform vec4 placement[1];
+
+			void main(){
+				gl_Position = vec4(offset + pos * placement[0].zw, 0, 1);
+				vertexUv = uv;
+				layer = textureSlot.x;
+				residentMip = float(textureSlot.y);
+			}
+		)";
+		const char* pooledFragmentShader = R"(
+			#version 460
+
+			in vec2 vertexUv;
+			flat in int layer;
+			flat in float residentMip;
+			out vec4 fragmentColor;
+
+			uniform sampler2DArray pool;
+
+			void main(){
+				float lod = max(textureQueryLod(pool, vertexUv).y, residentMip);
+				fragmentColor = textureLod(pool, vec3(vertexUv, layer), lod);
+			}
+		)";
+
+		// A checkerboard with a per-texture pair of colors and cell size, so no two textures are alike
+		void generatePixels(const uint32_t index, std::vector<uint8_t>& pixels)
+		{
+			uint32_t hash = index * 2654435761u + 0x9E3779B9u;
+			hash ^= hash >> 15;
+			const uint8_t colors[2][3] = {
+				{ static_cast<uint8_t>(hash), static_cast<uint8_t>(hash >> 8), static_cast<uint8_t>(hash >> 16) },
+				{ static_cast<uint8_t>(~hash), static_cast<uint8_t>(index), static_cast<uint8_t>(hash >> 24) },
+			};
+			const uint32_t cellShift = 1 + index % 4;
+			pixels.resize(TextureSize * TextureSize * 4);
+			for (uint32_t y = 0; y < TextureSize; ++y) {
+				for (uint32_t x = 0; x < TextureSize; ++x) {
+					const uint8_t* color = colors[((x >> cellShift) ^ (y >> cellShift)) & 1];
+					uint8_t* texel = &pixels[(y * TextureSize + x) * 4];
+					texel[0] = color[0];
+					texel[1] = color[1];
+					texel[2] = color[2];
+					texel[3] = 255;
+				}
+			}
+		}
+
+		// Distinct 64x64 textures cooked into a temporary directory, loaded through the texture manager and
+		// streamed in full. One textured quad per texture, drawn with a GL_TEXTURE_2D per object bound before
+		// each draw, or with the pooled array texture in a single instanced draw picking the layer per instance.
+		struct TextureFixture {
+			static constexpr size_t TexturesCount = 1000;
+			// Bytes uploaded per update(), what a frame of the engine spends on streaming
+			static constexpr size_t UploadBudget = 256 * 1024;
+
+			TextureFixture() :
+				window(getWindow()),
+				directory(std::filesystem::temp_directory_path() / "engine_bench_textures"),
+				quadLayout{ ShaderDataType::Float2, ShaderDataType::Float2 },
+				instanceLayout{ { ShaderDataType::Float2, 1 }, { ShaderDataType::Int2, 1 } },
+				quadBuffer(quadPoints, sizeof(quadPoints), quadLayout),
+				indexBuffer(quadIndices, sizeof(quadIndices) / sizeof(GLuint)),
+				separateShader(separateVertexShader, separateFragmentShader),
+				pooledShader(pooledVertexShader, pooledFragmentShader)
+			{
+				checkCompiled({ separateShader.isCompiled(), pooledShader.isCompiled() });
+
+				std::filesystem::create_directories(directory);
+				std::vector<uint8_t> pixels;
+				for (size_t i = 0; i < TexturesCount; ++i) {
+					paths.push_back((directory / ("texture" + std::to_string(i) + ".getx")).string());
+					generatePixels(static_cast<uint32_t>(i), pixels);
+					if (!TextureFile::write(paths.back(), TextureSize, TextureSize, pixels.data())) {
+						std::exit(1);
+					}
+				}
+				for (const std::string& path : paths) {
+					ids.push_back(textureManager.load(path));
+					if (ids.back() == InvalidTextureId) {
+						std::exit(1);
+					}
+				}
+				while (textureManager.getStreamingCount() != 0) {
+					textureManager.update(UploadBudget);
+				}
+
+				// The same textures as separate objects, mips copied from the cooked files
+				separateTextures.resize(TexturesCount);
+				glGenTextures(static_cast<GLsizei>(TexturesCount), separateTextures.data());
+				for (size_t i = 0; i < TexturesCount; ++i) {
+					TextureFile file;
+					if (!file.open(paths[i])) {
+						std::exit(1);
+					}
+					GLState::bindTexture(0, GL_TEXTURE_2D, separateTextures[i]);
+					glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(file.getMipsCount()), GL_RGBA8, TextureSize, TextureSize);
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+					for (uint32_t mip = 0; mip < file.getMipsCount(); ++mip) {
+						glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(mip), 0, 0,
+							static_cast<GLsizei>(file.getMip(mip).width), static_cast<GLsizei>(file.getMip(mip).height),
+							GL_RGBA, GL_UNSIGNED_BYTE, file.getMipData(mip));
+					}
+				}
+
+				// A grid filling the window, one quad per texture
+				const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(TexturesCount) * window.getAspect())));
+				const size_t rows = (TexturesCount + columns - 1) / columns;
+				cellSize = { 0.f, 0.f, 2.f / static_cast<float>(columns), 2.f / static_cast<float>(rows) };
+				std::vector<InstanceData> instances(TexturesCount);
+				placements.resize(TexturesCount);
+				for (size_t i = 0; i < TexturesCount; ++i) {
+					const float x = -1.f + static_cast<float>(i % columns) * cellSize.z;
+					const float y = -1.f + static_cast<float>(i / columns) * cellSize.w;
+					instances[i] = { { x, y }, static_cast<int32_t>(textureManager.getLayer(ids[i])), static_cast<int32_t>(textureManager.getResidentMip(ids[i])) };
+					placements[i] = { x, y, cellSize.z, cellSize.w };
+				}
+				instanceBuffer = std::make_unique<VertexBuffer>(instances.data(), instances.size() * sizeof(InstanceData), instanceLayout);
+
+				separateVertexArray.addVertexBuffer(quadBuffer);
+				separateVertexArray.setIndexBuffer(indexBuffer);
+				pooledVertexArray.addVertexBuffer(quadBuffer);
+				pooledVertexArray.addVertexBuffer(*instanceBuffer);
+				pooledVertexArray.setIndexBuffer(indexBuffer);
+				separatePlacementLocation = separateShader.getUniformLocation("placement");
+				pooledPlacementLocation = pooledShader.getUniformLocation("placement");
+			}
+
+			~TextureFixture()
+			{
+				for (const GLuint texture : separateTextures) {
+					GLState::deleteTexture(texture);
+				}
+				std::error_code error;
+				std::filesystem::remove_all(directory, error);
+			}
+
+			Window& window;
+			std::filesystem::path directory;
+			std::vector<std::string> paths;
+			BufferLayout quadLayout;
+			BufferLayout instanceLayout;
+			VertexBuffer quadBuffer;
+			IndexBuffer indexBuffer;
+			std::unique_ptr<VertexBuffer> instanceBuffer;
+			VertexArray separateVertexArray;
+			VertexArray pooledVertexArray;
+			Shader separateShader;
+			Shader pooledShader;
+			TextureManager textureManager;
+			std::vector<TextureId> ids;
+			std::vector<GLuint> separateTextures;
+			std::vector<glm::vec4> placements;
+			glm::vec4 cellSize = glm::vec4(0.f);
+			int separatePlacementLocation = -1;
+			int pooledPlacementLocation = -1;
+		};
+
+		TextureFixture& getTextures()
+		{
+			static TextureFixture s_fixture;
+			return s_fixture;
+		}
+
+		// A flat grid of a million triangles with positions and normals, cooked into a temporary file
+		struct MeshFileFixture {
+			static constexpr uint32_t Columns = 1000;
+			static constexpr uint32_t Rows = 500;
+			static constexpr size_t TrianglesCount = static_cast<size_t>(Columns) * Rows * 2;
+
+			MeshFileFixture() : window(getWindow()), path((std::filesystem::temp_directory_path() / "engine_bench_mesh.gem").string())
+			{
+				std::vector<float> vertices;
+				vertices.reserve(static_cast<size_t>(Columns + 1) * (Rows + 1) * 6);
+				for (uint32_t y = 0; y <= Rows; ++y) {
+					for (uint32_t x = 0; x <= Columns; ++x) {
+						vertices.insert(vertices.end(), { static_cast<float>(x), static_cast<float>(y), 0.f, 0.f, 0.f, 1.f });
+					}
+				}
+				std::vector<uint32_t> indices;
+				indices.reserve(TrianglesCount * 3);
+				for (uint32_t y = 0; y < Rows; ++y) {
+					for (uint32_t x = 0; x < Columns; ++x) {
+						const uint32_t a = y * (Columns + 1) + x;
+						const uint32_t b = a + 1;
+						const uint32_t c = a + Columns + 1;
+						const uint32_t d = c + 1;
+						indices.insert(indices.end(), { a, b, c, b, d, c });
+					}
+				}
+				const BufferLayout layout{ ShaderDataType::Float3, ShaderDataType::Float3 };
+				if (!MeshFile::write(path, layout, vertices.data(), vertices.size() / 6, indices.data(), indices.size())) {
+					std::exit(1);
+				}
+			}
+
+			~MeshFileFixture()
+			{
+				std::error_code error;
+				std::filesystem::remove(path, error);
+			}
+
+			Window& window;
+			std::string path;
+		};
+
+		MeshFileFixture& getMeshFile()
+		{
+			static MeshFileFixture s_fixture;
+			return s_fixture;
+		}
+	}
+
+	void registerGpuBenchmarks(BenchmarkRunner& runner)
+	{
+		runner.add("gpu/instancing_uniform_per_draw_10k", [](const size_t iterations) {
+			InstancingFixture& scene = getInstancing();
+			OpenGL_Renderer::setDepthTest(true);
+			for (size_t i = 0; i < iterations; ++i) {
+				OpenGL_Renderer::clear();
+				scene.uniformShader.bind();
+				scene.uniformShader.setMat4(scene.uniformViewProjectionLocation, scene.viewProjection);
+				scene.uniformVertexArray.bind();
+				for (const glm::mat4& modelMatrix : scene.modelMatrices) {
+					scene.uniformShader.setMat4(scene.modelMatrixLocation, modelMatrix);
+					OpenGL_Renderer::draw(scene.uniformVertexArray);
+				}
+			}
+			glFinish();
+		}, InstancingFixture::CubesCount);
+		// Naive submission that rebinds per draw, the state cache drops the redundant binds
+		runner.add("gpu/instancing_rebind_per_draw_10k", [](const size_t iterations) {
+			InstancingFixture& scene = getInstancing();
+			OpenGL_Renderer::setDepthTest(true);
+			for (size_t i = 0; i < iterations; ++i) {
+				OpenGL_Renderer::clear();
+				for (const glm::mat4& modelMatrix : scene.modelMatrices) {
+					scene.uniformShader.bind();
+					scene.uniformShader.setMat4(scene.uniformViewProjectionLocation, scene.viewProjection);
+					scene.uniformShader.setMat4(scene.modelMatrixLocation, modelMatrix);
+					scene.uniformVertexArray.bind();
+					OpenGL_Renderer::draw(scene.uniformVertexArray);
+				}
+			}
+			glFinish();
+		}, InstancingFixture::CubesCount);
+		runner.add("gpu/instancing_instanced_10k", [](const size_t iterations) {
+			InstancingFixture& scene = getInstancing();
+			OpenGL_Renderer::setDepthTest(true);
+			for (size_t i = 0; i < iterations; ++i) {
+				OpenGL_Renderer::clear();
+				scene.instancedShader.bind();
+				scene.instancedShader.setMat4(scene.instancedViewProjectionLocation, scene.viewProjection);
+				scene.instancedVertexArray.bind();
+				OpenGL_Renderer::drawInstanced(scene.instancedVertexArray, scene.modelMatrices.size());
+			}
+			glFinish();
+		}, InstancingFixture::CubesCount);
+
+		// The CPU path pays for the bounds too, the GPU one transforms them in the culling shader
+		runner.add("gpu/indirect_cpu_culling_draws_100k", [](const size_t iterations) {
+			IndirectFixture& scene = getIndirect();
+			OpenGL_Renderer::setDepthTest(true);
+			for (size_t i = 0; i < iterations; ++i) {
+				OpenGL_Renderer::clear();
+				scene.spheres.clear();
+				for (const glm::mat4& modelMatrix : scene.modelMatrices) {
+					scene.spheres.push(glm::vec3(modelMatrix[3]), cubeRadius * 0.5f);
+				}
+				const size_t visibleCount = Culling::cullSpheres(scene.frustum, scene.spheres, 0, scene.spheres.size(), scene.visibleIndices.data());
+
+				scene.uniformShader.bind();
+				scene.uniformShader.setMat4(scene.uniformViewProjectionLocation, scene.viewProjection);
+				scene.vertexArray.bind();
+				for (size_t j = 0; j < visibleCount; ++j) {
+					scene.uniformShader.setMat4(scene.modelMatrixLocation, scene.modelMatrices[scene.visibleIndices[j]]);
+					OpenGL_Renderer::draw(scene.vertexArray);
+				}
+			}
+			glFinish();
+		}, IndirectFixture::CubesCount);
+		runner.add("gpu/indirect_gpu_culling_mdi_100k", [](const size_t iterations) {
+			IndirectFixture& scene = getIndirect();
+			OpenGL_Renderer::setDepthTest(true);
+			for (size_t i = 0; i < iterations; ++i) {
+				OpenGL_Renderer::clear();
+				scene.indirectRenderer.begin();
+				for (const glm::mat4& modelMatrix : scene.modelMatrices) {
+					scene.indirectRenderer.submit(scene.cubeMeshId, modelMatrix);
+				}
+				scene.indirectShader.bind();
+				scene.indirectShader.setMat4(scene.indirectViewProjectionLocation, scene.viewProjection);
+				scene.indirectRenderer.flush(scene.indirectShader, scene.frustum);
+			}
+			glFinish();
+		}, IndirectFixture::CubesCount);
+
+		// Loading the cooked files into a new manager, then streaming every level in frames of the upload budget
+		runner.add("gpu/texture_load_stream_1k", [](const size_t iterations) {
+			const TextureFixture& scene = getTextures();
+			for (size_t i = 0; i < iterations; ++i) {
+				TextureManager textureManager;
+				for (const std::string& path : scene.paths) {
+					keep(textureManager.load(path));
+				}
+				while (textureManager.getStreamingCount() != 0) {
+					textureManager.update(TextureFixture::UploadBudget);
+				}
+				glFinish();
+			}
+		}, TextureFixture::TexturesCount);
+		// Samplers keep their default unit 0
+		runner.add("gpu/texture_bind_per_object_1k", [](const size_t iterations) {
+			TextureFixture& scene = getTextures();
+			OpenGL_Renderer::setDepthTest(false);
+			for (size_t i = 0; i < iterations; ++i) {
+				OpenGL_Renderer::clear();
+				scene.separateShader.bind();
+				scene.separateVertexArray.bind();
+				for (size_t j = 0; j < TextureFixture::TexturesCount; ++j) {
+					GLState::bindTexture(0, GL_TEXTURE_2D, scene.separateTextures[j]);
+					scene.separateShader.setVec4Array(scene.separatePlacementLocation, &scene.placements[j], 1);
+					OpenGL_Renderer::draw(scene.separateVertexArray);
+				}
+			}
+			glFinish();
+		}, TextureFixture::TexturesCount);
+		runner.add("gpu/texture_array_instanced_1k", [](const size_t iterations) {
+			TextureFixture& scene = getTextures();
+			OpenGL_Renderer::setDepthTest(false);
+			for (size_t i = 0; i < iterations; ++i) {
+				OpenGL_Renderer::clear();
+				scene.pooledShader.bind();
+				scene.pooledShader.setVec4Array(scene.pooledPlacementLocation, &scene.cellSize, 1);
+				scene.textureManager.getPool(scene.textureManager.getPoolIndex(scene.ids[0])).bind(0);
+				OpenGL_Renderer::drawInstanced(scene.pooledVertexArray, TextureFixture::TexturesCount);
+			}
+			glFinish();
+		}, TextureFixture::TexturesCount);
+
+		// The path of Application::loadMesh: mapping the cooked file and creating the buffers straight from it
+		runner.add("gpu/mesh_load_1M_triangles", [](const size_t iterations) {
+			const MeshFileFixture& mesh = getMeshFile();
+			for (size_t i = 0; i < iterations; ++i) {
+				MeshFile file;
+				if (!file.open(mesh.path)) {
+					std::exit(1);
+				}
+				VertexBuffer vertexBuffer(file.getVertices(), file.getVerticesCount() * file.getLayout().getStride(), file.getLayout());
+				IndexBuffer indexBuffer(file.getIndices(), file.getIndicesCount());
+				glFinish();
+			}
+		}, MeshFileFixture::TrianglesCount);
+	}
+}
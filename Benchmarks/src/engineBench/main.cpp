@@ -0,0 +1,112 @@
+#include "benchmarks.h"
+
+#include "jobSystem.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// The engine's benchmark suite. Every benchmark is warmed up, then repeated and reported as the
+// median/mean/min/max cost of one item in nanoseconds. GPU benchmarks draw into a hidden window and
+// only run with --gpu, everything else needs no window.
+// Usage:
+//   engine_bench [--filter text] [--repetitions 15] [--min-time ms = 10] [--warmup ms = 100] [--json path] [--list]
+//                [--workers count = hardware threads] [--gpu]
+//   engine_bench --compare baseline.json current.json [--threshold percent = 5]
+// Compare mode exits with 1 when a benchmark's median got slower than the baseline by more than the threshold.
+
+namespace {
+	const char* optionValue(const int argc, char** argv, int& i)
+	{
+		if (i + 1 >= argc) {
+			std::fprintf(stderr, "Option %s needs a value\n", argv[i]);
+			std::exit(2);
+		}
+		return argv[++i];
+	}
+}
+
+int main(int argc, char** argv)
+{
+	EngineBench::BenchmarkOptions options;
+	const char* jsonPath = nullptr;
+	const char* comparePaths[2] = { nullptr, nullptr };
+	double threshold = 5.0;
+	bool isListing = false;
+	bool hasGpu = false;
+	uint32_t workersCount = 0;
+
+	for (int i = 1; i < argc; ++i) {
+		const char* option = argv[i];
+		if (std::strcmp(option, "--filter") == 0) {
+			options.filter = optionValue(argc, argv, i);
+		}
+		else if (std::strcmp(option, "--repetitions") == 0) {
+			options.repetitions = std::strtoul(optionValue(argc, argv, i), nullptr, 10);
+		}
+		else if (std::strcmp(option, "--min-time") == 0) {
+			options.minRepetitionMs = std::strtod(optionValue(argc, argv, i), nullptr);
+		}
+		else if (std::strcmp(option, "--warmup") == 0) {
+			options.warmupMs = std::strtod(optionValue(argc, argv, i), nullptr);
+		}
+		else if (std::strcmp(option, "--json") == 0) {
+			jsonPath = optionValue(argc, argv, i);
+		}
+		else if (std::strcmp(option, "--list") == 0) {
+			isListing = true;
+		}
+		else if (std::strcmp(option, "--workers") == 0) {
+			workersCount = static_cast<uint32_t>(std::strtoul(optionValue(argc, argv, i), nullptr, 10));
+		}
+		else if (std::strcmp(option, "--gpu") == 0) {
+			hasGpu = true;
+		}
+		else if (std::strcmp(option, "--compare") == 0) {
+			comparePaths[0] = optionValue(argc, argv, i);
+			comparePaths[1] = optionValue(argc, argv, i);
+		}
+		else if (std::strcmp(option, "--threshold") == 0) {
+			threshold = std::strtod(optionValue(argc, argv, i), nullptr);
+		}
+		else {
+			std::fprintf(stderr, "Unknown option %s\n", option);
+			return 2;
+		}
+	}
+
+	if (comparePaths[0]) {
+		std::vector<EngineBench::BenchmarkResult> baseline;
+		std::vector<EngineBench::BenchmarkResult> current;
+		if (!EngineBench::readResults(comparePaths[0], baseline) || !EngineBench::readResults(comparePaths[1], current)) {
+			return 2;
+		}
+		return EngineBench::compareResults(baseline, current, threshold) > 0 ? 1 : 0;
+	}
+
+	EngineBench::BenchmarkRunner runner(options);
+	EngineBench::registerCoreBenchmarks(runner);
+	EngineBench::registerSystemBenchmarks(runner);
+	EngineBench::registerSceneBenchmarks(runner);
+	if (hasGpu) {
+		EngineBench::registerGpuBenchmarks(runner);
+	}
+	if (isListing) {
+		for (const std::string& name : runner.getNames()) {
+			std::printf("%s\n", name.c_str());
+		}
+		return 0;
+	}
+
+	// Parallel paths (culling, the transform hierarchy, parallel_for) split their work over these workers
+	GameEngine::JobSystem::init(workersCount);
+	std::printf("Workers: %u\n", GameEngine::JobSystem::getWorkersCount());
+	const std::vector<EngineBench::BenchmarkResult> results = runner.run();
+	GameEngine::JobSystem::shutdown();
+	if (jsonPath && !EngineBench::writeResults(jsonPath, results)) {
+		return 2;
+	}
+	return 0;
+}
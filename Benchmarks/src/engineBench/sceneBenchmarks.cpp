@@ -0,0 +1,518 @@
+#include "benchmarks.h"
+
+#include "camera.h"
+#include "components.h"
+#include "transformHierarchy.h"
+#include "ecs/registry.h"
+#include "rendering/culling.h"
+#include "rendering/lodSelector.h"
+#include "resources/meshSimplifier.h"
+#include "resources/sceneFile.h"
+#include "resources/sceneLoader.h"
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace EngineBench {
+	namespace {
+		using namespace GameEngine;
+
+		struct Velocity {
+			glm::vec3 value;
+		};
+		struct Tag {
+			uint32_t value;
+		};
+
+		// A million entities moving, the same data in plain arrays next to them
+		struct EcsFixture {
+			static constexpr size_t EntitiesCount = 1000000;
+
+			EcsFixture() : plainTransforms(EntitiesCount), plainVelocities(EntitiesCount, Velocity{ { 1.f, 1.f, 0.f } })
+			{
+				entities.reserve(EntitiesCount);
+				for (size_t i = 0; i < EntitiesCount; ++i) {
+					entities.push_back(registry.create(Transform{}, Velocity{ { static_cast<float>(i % 7), 1.f, 0.f } }));
+				}
+			}
+
+			Registry registry;
+			std::vector<Entity> entities;
+			std::vector<Transform> plainTransforms;
+			std::vector<Velocity> plainVelocities;
+		};
+
+		EcsFixture& getEcs()
+		{
+			static EcsFixture s_fixture;
+			return s_fixture;
+		}
+
+		// Three levels: roots with 10 children with 99 children each, parents first
+		struct HierarchyNode {
+			uint32_t parent;
+			glm::vec3 position;
+			glm::vec3 scale;
+		};
+
+		constexpr size_t ChildrenPerRoot = 10;
+		constexpr size_t ChildrenPerChild = 99;
+		constexpr size_t NodesPerRoot = 1 + ChildrenPerRoot + ChildrenPerRoot * ChildrenPerChild;
+		constexpr size_t RotationsCount = 64;
+
+		struct HierarchyFixture {
+			static constexpr size_t RootsCount = 100;
+
+			HierarchyFixture()
+			{
+				for (size_t root = 0; root < RootsCount; ++root) {
+					const uint32_t rootIndex = static_cast<uint32_t>(nodes.size());
+					nodes.push_back({ UINT32_MAX, { static_cast<float>(root) * 10.f, 0.f, 0.f }, glm::vec3(1.f) });
+					for (size_t child = 0; child < ChildrenPerRoot; ++child) {
+						const uint32_t childIndex = static_cast<uint32_t>(nodes.size());
+						nodes.push_back({ rootIndex, { 0.f, static_cast<float>(child), 0.f }, glm::vec3(0.5f) });
+						for (size_t leaf = 0; leaf < ChildrenPerChild; ++leaf) {
+							nodes.push_back({ childIndex, { 0.f, 0.f, static_cast<float>(leaf) * 0.1f }, glm::vec3(0.9f) });
+						}
+					}
+				}
+				for (size_t i = 0; i < RotationsCount; ++i) {
+					rotations[i] = glm::angleAxis(static_cast<float>(i) * 0.1f, glm::normalize(glm::vec3(1.f, 2.f, 3.f)));
+				}
+				worldMatrices.resize(nodes.size());
+				for (const HierarchyNode& node : nodes) {
+					ids.push_back(hierarchy.create(
+						node.parent == UINT32_MAX ? InvalidTransformId : ids[node.parent], node.position, glm::quat(1.f, 0.f, 0.f, 0.f), node.scale
+					));
+				}
+				hierarchy.update();
+			}
+
+			inline const glm::quat& getRotation(const size_t node, const size_t frame) const { return rotations[(node + frame) % RotationsCount]; }
+
+			std::vector<HierarchyNode> nodes;
+			glm::quat rotations[RotationsCount];
+			std::vector<glm::mat4> worldMatrices;
+			TransformHierarchy hierarchy;
+			std::vector<TransformId> ids;
+			size_t frame = 0;
+		};
+
+		HierarchyFixture& getHierarchy()
+		{
+			static HierarchyFixture s_fixture;
+			return s_fixture;
+		}
+
+		// Ten roots and ten children per node over five levels, every node rotated every frame
+		struct UpdateAllFixture {
+			static constexpr size_t NodesCount = 100000;
+
+			UpdateAllFixture()
+			{
+				nodes.reserve(NodesCount);
+				for (size_t i = 0; i < NodesCount; ++i) {
+					const TransformId parent = i < 10 ? InvalidTransformId : nodes[i / 10];
+					nodes.push_back(hierarchy.create(parent, { 1.f, 0.f, 0.f }));
+				}
+			}
+
+			TransformHierarchy hierarchy;
+			std::vector<TransformId> nodes;
+		};
+
+		UpdateAllFixture& getUpdateAll()
+		{
+			static UpdateAllFixture s_fixture;
+			return s_fixture;
+		}
+
+		// Objects scattered around a camera at the origin looking down -z
+		struct CullingFixture {
+			explicit CullingFixture(const size_t count) : visible(count)
+			{
+				std::mt19937 random(42);
+				std::uniform_real_distribution<float> position(-500.f, 500.f);
+				std::uniform_real_distribution<float> size(0.5f, 5.f);
+				spheres.reserve(count);
+				boxes.reserve(count);
+				for (size_t i = 0; i < count; ++i) {
+					const glm::vec3 center = { position(random), position(random), position(random) };
+					spheres.push(center, size(random));
+					boxes.push(center, { size(random), size(random), size(random) });
+				}
+				const glm::mat4 projection = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 500.f);
+				const glm::mat4 view = glm::lookAt(glm::vec3(0.f), glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f, 1.f, 0.f));
+				frustum = Frustum::fromMatrix(projection * view);
+			}
+
+			BoundingSpheres spheres;
+			BoundingBoxes boxes;
+			std::vector<uint32_t> visible;
+			Frustum frustum;
+		};
+
+		template<size_t Count>
+		CullingFixture& getCulling()
+		{
+			static CullingFixture s_fixture(Count);
+			return s_fixture;
+		}
+
+		// The vectorized, scalar and job system paths over the same objects
+		template<size_t Count>
+		void registerCulling(BenchmarkRunner& runner, const std::string& suffix)
+		{
+			runner.add("culling/spheres_" + suffix, [](const size_t iterations) {
+				CullingFixture& culling = getCulling<Count>();
+				for (size_t i = 0; i < iterations; ++i) {
+					keep(Culling::cullSpheres(culling.frustum, culling.spheres, 0, Count, culling.visible.data()));
+				}
+			}, Count);
+			runner.add("culling/boxes_" + suffix, [](const size_t iterations) {
+				CullingFixture& culling = getCulling<Count>();
+				for (size_t i = 0; i < iterations; ++i) {
+					keep(Culling::cullBoxes(culling.frustum, culling.boxes, 0, Count, culling.visible.data()));
+				}
+			}, Count);
+			runner.add("culling/spheres_scalar_" + suffix, [](const size_t iterations) {
+				CullingFixture& culling = getCulling<Count>();
+				for (size_t i = 0; i < iterations; ++i) {
+					keep(Culling::cullSpheresScalar(culling.frustum, culling.spheres, 0, Count, culling.visible.data()));
+				}
+			}, Count);
+			runner.add("culling/boxes_scalar_" + suffix, [](const size_t iterations) {
+				CullingFixture& culling = getCulling<Count>();
+				for (size_t i = 0; i < iterations; ++i) {
+					keep(Culling::cullBoxesScalar(culling.frustum, culling.boxes, 0, Count, culling.visible.data()));
+				}
+			}, Count);
+			runner.add("culling/spheres_parallel_" + suffix, [](const size_t iterations) {
+				CullingFixture& culling = getCulling<Count>();
+				for (size_t i = 0; i < iterations; ++i) {
+					keep(Culling::cullSpheresParallel(culling.frustum, culling.spheres, culling.visible.data()));
+				}
+			}, Count);
+			runner.add("culling/boxes_parallel_" + suffix, [](const size_t iterations) {
+				CullingFixture& culling = getCulling<Count>();
+				for (size_t i = 0; i < iterations; ++i) {
+					keep(Culling::cullBoxesParallel(culling.frustum, culling.boxes, culling.visible.data()));
+				}
+			}, Count);
+		}
+
+		// A dense sphere simplified into a level of detail chain and a grid of its copies on the ground,
+		// a swaying camera flies over the grid's diagonal. Culling is left out, every object counts every frame.
+		struct LodFixture {
+			static constexpr int SphereRings = 128;
+			static constexpr int SphereSegments = 256;
+			static constexpr size_t ObjectsCount = 10000;
+			static constexpr size_t FramesCount = 600;
+			static constexpr float ViewportHeight = 1080.f;
+			static constexpr float MaxPixelError = 1.f;
+			static constexpr float Spacing = 4.f;
+
+			LodFixture() : layout{ ShaderDataType::Float3, ShaderDataType::Float3 },
+				camera({ 0.f, 0.f, 3.f }, { 0.f, 0.f, 0.f }, Camera::ProjectionMode::Perspective)
+			{
+				// Position and normal, the seam column is duplicated like an exporter would for the uvs
+				const float pi = 3.14159265358979f;
+				for (int ring = 0; ring <= SphereRings; ++ring) {
+					for (int segment = 0; segment <= SphereSegments; ++segment) {
+						const float theta = pi * static_cast<float>(ring) / SphereRings;
+						const float phi = 2.f * pi * static_cast<float>(segment) / SphereSegments;
+						const float position[3] = { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+						vertices.insert(vertices.end(), position, position + 3);
+						vertices.insert(vertices.end(), position, position + 3);
+					}
+				}
+				for (int ring = 0; ring < SphereRings; ++ring) {
+					for (int segment = 0; segment < SphereSegments; ++segment) {
+						const uint32_t a = static_cast<uint32_t>(ring * (SphereSegments + 1) + segment);
+						const uint32_t b = a + 1;
+						const uint32_t c = a + SphereSegments + 1;
+						const uint32_t d = c + 1;
+						if (ring != 0) {
+							indices.insert(indices.end(), { a, b, c });
+						}
+						if (ring != SphereRings - 1) {
+							indices.insert(indices.end(), { b, d, c });
+						}
+					}
+				}
+
+				const MeshLodChain chain = MeshSimplifier::buildLods(layout, vertices.data(), vertices.size() / 6, indices.data(), indices.size());
+				for (const auto& lod : chain.lods) {
+					levels.push_back({ lod.firstIndex, lod.indicesCount, lod.error });
+				}
+
+				const size_t side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(ObjectsCount))));
+				for (size_t i = 0; i < ObjectsCount; ++i) {
+					positions.push_back({ static_cast<float>(i % side) * Spacing, static_cast<float>(i / side) * Spacing, 0.f });
+				}
+				extent = static_cast<float>(side) * Spacing;
+				camera.setAspect(16.f / 9.f);
+				currentLods.assign(ObjectsCount, 0);
+			}
+
+			// Slow flight plus a sway fast enough to turn back, the back and forth motion is what makes levels pop
+			size_t selectFrame(const float hysteresis)
+			{
+				const float t = static_cast<float>(frame % FramesCount) / static_cast<float>(FramesCount);
+				const float sway = std::sin(static_cast<float>(frame) * 0.1f) * 10.f;
+				camera.setPosition({ extent * t + sway, extent * t + sway, 3.f });
+				++frame;
+
+				const glm::vec3 cameraPosition = camera.getPosition();
+				size_t triangles = 0;
+				for (size_t i = 0; i < ObjectsCount; ++i) {
+					const float distance = glm::length(positions[i] - cameraPosition);
+					currentLods[i] = LodSelector::select(
+						levels.data(), levels.size(), currentLods[i], camera.getPixelsPerUnit(distance, ViewportHeight), MaxPixelError, hysteresis
+					);
+					triangles += levels[currentLods[i]].indicesCount / 3;
+				}
+				return triangles;
+			}
+
+			BufferLayout layout;
+			std::vector<float> vertices;
+			std::vector<uint32_t> indices;
+			std::vector<LodLevel> levels;
+			std::vector<glm::vec3> positions;
+			std::vector<uint32_t> currentLods;
+			Camera camera;
+			float extent = 0.f;
+			size_t frame = 0;
+		};
+
+		LodFixture& getLod()
+		{
+			static LodFixture s_fixture;
+			return s_fixture;
+		}
+
+		// A snapshot with one node per entity in a wide hierarchy, every tenth entity keeps a plain matrix
+		// instead. The file lives in the temp directory while the benchmarks run.
+		struct SceneFileFixture {
+			static constexpr size_t EntitiesCount = 500000;
+			static constexpr size_t MovedPerSave = 1000;
+
+			SceneFileFixture() : path((std::filesystem::temp_directory_path() / "engine_bench_scene.gesc").string())
+			{
+				std::mt19937 random(42);
+				std::uniform_real_distribution<float> position(-500.f, 500.f);
+				snapshot.meshPaths = { "", "assets/meshes/rock.gem", "assets/meshes/tree.gem", "assets/meshes/house.gem" };
+				for (size_t i = 0; i < EntitiesCount; ++i) {
+					const uint32_t mesh = static_cast<uint32_t>(i % snapshot.meshPaths.size());
+					if (i % 10 == 9) {
+						SceneMatrix matrix = {};
+						matrix.values[0] = matrix.values[5] = matrix.values[10] = matrix.values[15] = 1.f;
+						matrix.values[12] = position(random);
+						matrix.values[13] = position(random);
+						matrix.values[14] = position(random);
+						snapshot.entities.push_back({ SceneFileHeader::InvalidIndex, mesh, static_cast<uint32_t>(snapshot.matrices.size()), SceneFileHeader::InvalidIndex });
+						snapshot.matrices.push_back(matrix);
+						continue;
+					}
+					const uint32_t node = static_cast<uint32_t>(snapshot.nodes.size());
+					const uint32_t parent = node < 1000 ? SceneFileHeader::InvalidIndex : node / 10;
+					snapshot.nodes.push_back({ parent, { position(random), position(random), position(random) }, { 0.f, 0.f, 0.f, 1.f }, { 1.f, 1.f, 1.f }, 0 });
+					snapshot.entities.push_back({ node, mesh, SceneFileHeader::InvalidIndex, SceneFileHeader::InvalidIndex });
+				}
+				meshIds = { 0, 1, 2, 3 };
+				save();
+			}
+			~SceneFileFixture()
+			{
+				std::error_code error;
+				std::filesystem::remove(path, error);
+			}
+
+			void save()
+			{
+				if (!SceneFile::write(path, snapshot, &stats)) {
+					std::fprintf(stderr, "Can't write the scene snapshot %s\n", path.c_str());
+					std::exit(1);
+				}
+			}
+
+			std::string path;
+			SceneSnapshot snapshot;
+			SceneSaveStats stats;
+			std::vector<uint32_t> meshIds;
+			Registry scene;
+			TransformHierarchy transforms;
+			std::mt19937 random{ 7 };
+		};
+
+		SceneFileFixture& getSceneFile()
+		{
+			static SceneFileFixture s_fixture;
+			return s_fixture;
+		}
+	}
+
+	void registerSceneBenchmarks(BenchmarkRunner& runner)
+	{
+		// ECS: per entity cost of iterating a view, against the same data in plain arrays
+		runner.add("ecs/view_each_1M", [](const size_t iterations) {
+			Registry& registry = getEcs().registry;
+			for (size_t i = 0; i < iterations; ++i) {
+				registry.view<Transform, const Velocity>().each([](Entity, Transform& transform, const Velocity& velocity) {
+					transform.model_matrix[3] += glm::vec4(velocity.value * 0.016f, 0.f);
+				});
+			}
+		}, EcsFixture::EntitiesCount);
+		runner.add("ecs/view_each_chunk_1M", [](const size_t iterations) {
+			Registry& registry = getEcs().registry;
+			for (size_t i = 0; i < iterations; ++i) {
+				registry.view<Transform, const Velocity>().eachChunk([](const size_t count, const Entity*, Transform* transforms, const Velocity* velocities) {
+					for (size_t j = 0; j < count; ++j) {
+						transforms[j].model_matrix[3] += glm::vec4(velocities[j].value * 0.016f, 0.f);
+					}
+				});
+			}
+		}, EcsFixture::EntitiesCount);
+		runner.add("ecs/plain_arrays_1M", [](const size_t iterations) {
+			EcsFixture& ecs = getEcs();
+			for (size_t i = 0; i < iterations; ++i) {
+				for (size_t j = 0; j < EcsFixture::EntitiesCount; ++j) {
+					ecs.plainTransforms[j].model_matrix[3] += glm::vec4(ecs.plainVelocities[j].value * 0.016f, 0.f);
+				}
+			}
+			keep(ecs.plainTransforms.back());
+		}, EcsFixture::EntitiesCount);
+		// Moves an entity to another archetype and back
+		runner.add("ecs/add_remove_component", [](const size_t iterations) {
+			EcsFixture& ecs = getEcs();
+			for (size_t i = 0; i < iterations; ++i) {
+				const Entity entity = ecs.entities[(i * 10) % EcsFixture::EntitiesCount];
+				ecs.registry.add<Tag>(entity, Tag{ static_cast<uint32_t>(i) });
+				ecs.registry.remove<Tag>(entity);
+			}
+		});
+		constexpr size_t CreatedPerIteration = 1024;
+		runner.add("ecs/create_destroy", [](const size_t iterations) {
+			static Registry s_churnRegistry;
+			static std::vector<Entity> s_created(CreatedPerIteration);
+			for (size_t i = 0; i < iterations; ++i) {
+				for (Entity& entity : s_created) {
+					entity = s_churnRegistry.create(Transform{}, Velocity{ { 1.f, 0.f, 0.f } });
+				}
+				for (const Entity entity : s_created) {
+					s_churnRegistry.destroy(entity);
+				}
+			}
+		}, CreatedPerIteration);
+
+		// Transforms: every node of a 5-level hierarchy rotated and updated
+		runner.add("transforms/update_all_100k", [](const size_t iterations) {
+			UpdateAllFixture& fixture = getUpdateAll();
+			for (size_t i = 0; i < iterations; ++i) {
+				const glm::quat rotation = glm::angleAxis(static_cast<float>(i & 255) * 0.01f, glm::vec3(0.f, 1.f, 0.f));
+				for (const TransformId id : fixture.nodes) {
+					fixture.hierarchy.setRotation(id, rotation);
+				}
+				fixture.hierarchy.update();
+			}
+		}, UpdateAllFixture::NodesCount);
+		// A three level scene: every local matrix rebuilt with the glm helpers and multiplied with the
+		// parent's, against the hierarchy with every node and with 1% of them animated
+		constexpr size_t HierarchyNodesCount = HierarchyFixture::RootsCount * NodesPerRoot;
+		runner.add("transforms/naive_recompute_100k", [](const size_t iterations) {
+			HierarchyFixture& scene = getHierarchy();
+			for (size_t i = 0; i < iterations; ++i) {
+				for (size_t j = 0; j < scene.nodes.size(); ++j) {
+					const HierarchyNode& node = scene.nodes[j];
+					const glm::mat4 local = glm::translate(glm::mat4(1.f), node.position)
+						* glm::mat4_cast(scene.getRotation(j, scene.frame)) * glm::scale(glm::mat4(1.f), node.scale);
+					scene.worldMatrices[j] = node.parent == UINT32_MAX ? local : scene.worldMatrices[node.parent] * local;
+				}
+				++scene.frame;
+			}
+			keep(scene.worldMatrices.back());
+		}, HierarchyNodesCount);
+		for (const size_t animatedStride : { size_t(1), size_t(100) }) {
+			runner.add(animatedStride == 1 ? "transforms/hierarchy_all_animated_100k" : "transforms/hierarchy_1pct_animated_100k",
+				[animatedStride](const size_t iterations) {
+				HierarchyFixture& scene = getHierarchy();
+				for (size_t i = 0; i < iterations; ++i) {
+					for (size_t j = 0; j < scene.ids.size(); j += animatedStride) {
+						scene.hierarchy.setRotation(scene.ids[j], scene.getRotation(j, scene.frame));
+					}
+					scene.hierarchy.update();
+					++scene.frame;
+				}
+			}, HierarchyNodesCount);
+		}
+
+		// Culling: per object cost of the scalar, vectorized and job system paths
+		registerCulling<10000>(runner, "10k");
+		registerCulling<100000>(runner, "100k");
+		registerCulling<1000000>(runner, "1M");
+
+		// Scene files: a save into a new file, a save that rewrites only the chunks of scattered moves and
+		// the load path of Application::loadScene without the mesh uploads, mapping plus instantiation
+		runner.add("scene/full_save_500k", [](const size_t iterations) {
+			SceneFileFixture& fixture = getSceneFile();
+			for (size_t i = 0; i < iterations; ++i) {
+				std::error_code error;
+				std::filesystem::remove(fixture.path, error);
+				fixture.save();
+			}
+			keep(fixture.stats.bytesWritten);
+		}, SceneFileFixture::EntitiesCount);
+		runner.add("scene/incremental_save_500k", [](const size_t iterations) {
+			SceneFileFixture& fixture = getSceneFile();
+			std::uniform_int_distribution<size_t> node(0, fixture.snapshot.nodes.size() - 1);
+			for (size_t i = 0; i < iterations; ++i) {
+				for (size_t j = 0; j < SceneFileFixture::MovedPerSave; ++j) {
+					fixture.snapshot.nodes[node(fixture.random)].position[0] += 1.f;
+				}
+				fixture.save();
+			}
+			keep(fixture.stats.chunksWritten);
+		}, SceneFileFixture::EntitiesCount);
+		runner.add("scene/load_500k", [](const size_t iterations) {
+			SceneFileFixture& fixture = getSceneFile();
+			for (size_t i = 0; i < iterations; ++i) {
+				SceneFile file;
+				if (!file.open(fixture.path) || !SceneLoader::instantiate(file, fixture.meshIds, fixture.scene, fixture.transforms)) {
+					std::fprintf(stderr, "Can't load the scene snapshot %s\n", fixture.path.c_str());
+					std::exit(1);
+				}
+			}
+			keep(fixture.scene.size());
+		}, SceneFileFixture::EntitiesCount);
+
+		// Level of detail: simplifying the sphere once, then picking a level per object and frame
+		runner.add("lod/build_chain_sphere", [](const size_t iterations) {
+			const LodFixture& lod = getLod();
+			for (size_t i = 0; i < iterations; ++i) {
+				keep(MeshSimplifier::buildLods(lod.layout, lod.vertices.data(), lod.vertices.size() / 6, lod.indices.data(), lod.indices.size()));
+			}
+		});
+		runner.add("lod/select_10k", [](const size_t iterations) {
+			LodFixture& lod = getLod();
+			for (size_t i = 0; i < iterations; ++i) {
+				keep(lod.selectFrame(LodSelector::DefaultHysteresis));
+			}
+		}, LodFixture::ObjectsCount);
+		runner.add("lod/select_10k_no_hysteresis", [](const size_t iterations) {
+			LodFixture& lod = getLod();
+			for (size_t i = 0; i < iterations; ++i) {
+				keep(lod.selectFrame(0.f));
+			}
+		}, LodFixture::ObjectsCount);
+	}
+}
@@ -0,0 +1,336 @@
+#include "benchmarks.h"
+
+#include "jobSystem.h"
+#include "log.h"
+#include "memory/frameMemory.h"
+#include "memory/linearArena.h"
+#include "memory/poolAllocator.h"
+#include "memory/stlAllocators.h"
+
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/null_sink.h>
+
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace EngineBench {
+	namespace {
+		using namespace GameEngine;
+
+		struct Particle {
+			float position[3];
+			float velocity[3];
+			float color[4];
+			float age;
+			float lifetime;
+			uint32_t flags;
+			uint32_t padding[3];
+		};
+		static_assert(sizeof(Particle) == 64, "The small object should fill a cache line");
+
+		struct TransformInput {
+			glm::vec3 position;
+			glm::vec3 axis;
+			float angle;
+			glm::vec3 scale;
+		};
+
+		struct TransformsFixture {
+			static constexpr size_t Count = 1000000;
+
+			TransformsFixture() : inputs(Count), outputs(Count)
+			{
+				for (size_t i = 0; i < Count; ++i) {
+					const float value = static_cast<float>(i);
+					inputs[i] = { { value, value * 0.5f, -value }, glm::normalize(glm::vec3(1.f, value, 2.f)), value * 0.01f, { 1.f, 2.f, 1.f } };
+				}
+			}
+
+			void compute(const size_t begin, const size_t end)
+			{
+				for (size_t i = begin; i < end; ++i) {
+					const TransformInput& input = inputs[i];
+					glm::mat4 model = glm::translate(glm::mat4(1.f), input.position);
+					model = glm::rotate(model, input.angle, input.axis);
+					outputs[i] = glm::scale(model, input.scale);
+				}
+			}
+
+			std::vector<TransformInput> inputs;
+			std::vector<glm::mat4> outputs;
+		};
+
+		TransformsFixture& getTransforms()
+		{
+			static TransformsFixture s_fixture;
+			return s_fixture;
+		}
+
+		// Messages go to a sink that drops them, only the calls and the logging thread are measured.
+		// Anything the engine logs outside of these benchmarks still reaches the console.
+		template<typename Fn>
+		void withNullSink(Fn&& fn)
+		{
+			static const std::shared_ptr<spdlog::logger> s_nullLogger =
+				std::make_shared<spdlog::logger>("bench", std::make_shared<spdlog::sinks::null_sink_mt>());
+			Log::flush();
+			const std::shared_ptr<spdlog::logger> previous = spdlog::default_logger();
+			spdlog::set_default_logger(s_nullLogger);
+			fn();
+			Log::flush();
+			spdlog::set_default_logger(previous);
+		}
+
+		// Runs fn on threadsCount threads released together and returns once all of them are done
+		template<typename Fn>
+		void onThreads(const size_t threadsCount, const Fn& fn)
+		{
+			std::atomic<bool> go = false;
+			std::vector<std::thread> threads;
+			for (size_t i = 0; i < threadsCount; ++i) {
+				threads.emplace_back([&go, &fn]() {
+					while (!go.load(std::memory_order_acquire)) {
+						std::this_thread::yield();
+					}
+					fn();
+				});
+			}
+			go.store(true, std::memory_order_release);
+			for (std::thread& thread : threads) {
+				thread.join();
+			}
+		}
+
+		// Restarts the job system with the given workers for fn and with the previous count after it.
+		// The restart is inside the timed call, the iteration count grows until it is noise next to the work.
+		template<typename Fn>
+		void withWorkers(const uint32_t workers, Fn&& fn)
+		{
+			const uint32_t previous = JobSystem::getWorkersCount();
+			// The job system logs every start, keeps them out of the results table
+			withNullSink([workers]() {
+				JobSystem::shutdown();
+				JobSystem::init(workers);
+			});
+			fn();
+			withNullSink([previous]() {
+				JobSystem::shutdown();
+				JobSystem::init(previous);
+			});
+		}
+	}
+
+	void registerSystemBenchmarks(BenchmarkRunner& runner)
+	{
+		// Memory: frame arena allocations and pooled object churn
+		constexpr size_t AllocationsPerFrame = 10000;
+		static LinearArena s_arena;
+		runner.add("memory/arena_allocate_64", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				for (size_t j = 0; j < AllocationsPerFrame; ++j) {
+					keep(s_arena.allocate(64, 16));
+				}
+				s_arena.reset();
+			}
+		}, AllocationsPerFrame);
+		// A window of live objects, the oldest one is destroyed for every new one
+		constexpr size_t LiveObjects = 1024;
+		static ObjectPool<Particle> s_particles;
+		static std::vector<Particle*> s_live(LiveObjects, nullptr);
+		runner.add("memory/object_pool_churn", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				Particle*& slot = s_live[i % LiveObjects];
+				if (slot) {
+					s_particles.destroy(slot);
+				}
+				slot = s_particles.create();
+				keep(slot);
+			}
+		});
+		// The same window of live objects through the heap
+		static std::vector<std::unique_ptr<Particle>> s_heapLive(LiveObjects);
+		runner.add("memory/heap_object_churn", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				std::unique_ptr<Particle>& slot = s_heapLive[i % LiveObjects];
+				slot = std::make_unique<Particle>();
+				keep(slot.get());
+			}
+		});
+
+		// Short-lived arrays built and dropped many times a frame
+		constexpr uint32_t VectorSize = 64;
+		runner.add("memory/heap_vector_64", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				std::vector<uint32_t> values;
+				values.reserve(VectorSize);
+				for (uint32_t j = 0; j < VectorSize; ++j) {
+					values.push_back(j);
+				}
+				keep(values[i % VectorSize]);
+			}
+		});
+		runner.add("memory/scratch_vector_64", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				ScratchScope scratch;
+				ArenaVector<uint32_t> values{ ArenaAllocator<uint32_t>(scratch.getArena()) };
+				values.reserve(VectorSize);
+				for (uint32_t j = 0; j < VectorSize; ++j) {
+					values.push_back(j);
+				}
+				keep(values[i % VectorSize]);
+			}
+		});
+		runner.add("memory/frame_array_64", [](const size_t iterations) {
+			for (size_t i = 0; i < iterations; ++i) {
+				LinearArena& arena = FrameMemory::getFrameArena();
+				for (size_t j = 0; j < AllocationsPerFrame; ++j) {
+					uint32_t* values = arena.allocateArray<uint32_t>(VectorSize);
+					for (uint32_t k = 0; k < VectorSize; ++k) {
+						values[k] = k;
+					}
+					keep(values[j % VectorSize]);
+				}
+				FrameMemory::endFrame();
+			}
+		}, AllocationsPerFrame);
+
+		// std::map insert and erase, one item is a node allocated and freed
+		constexpr uint32_t MapSize = 10000;
+		runner.add("memory/map_nodes_heap", [](const size_t iterations) {
+			static std::map<uint32_t, uint32_t> s_map;
+			for (size_t i = 0; i < iterations; ++i) {
+				for (uint32_t j = 0; j < MapSize; ++j) {
+					s_map[j] = j;
+				}
+				for (uint32_t j = 0; j < MapSize; ++j) {
+					s_map.erase(j);
+				}
+			}
+		}, MapSize);
+		runner.add("memory/map_nodes_pool", [](const size_t iterations) {
+			using PooledMap = std::map<uint32_t, uint32_t, std::less<uint32_t>, PoolAllocator<std::pair<const uint32_t, uint32_t>>>;
+			static SmallObjectAllocator s_smallObjects;
+			static PooledMap s_map{ PoolAllocator<std::pair<const uint32_t, uint32_t>>(s_smallObjects) };
+			for (size_t i = 0; i < iterations; ++i) {
+				for (uint32_t j = 0; j < MapSize; ++j) {
+					s_map[j] = j;
+				}
+				for (uint32_t j = 0; j < MapSize; ++j) {
+					s_map.erase(j);
+				}
+			}
+		}, MapSize);
+
+		// Jobs: model matrices from position/rotation/scale, on the calling thread and split over the workers
+		runner.add("jobs/model_matrices_serial_1M", [](const size_t iterations) {
+			TransformsFixture& transforms = getTransforms();
+			for (size_t i = 0; i < iterations; ++i) {
+				transforms.compute(0, TransformsFixture::Count);
+			}
+			keep(transforms.outputs.back());
+		}, TransformsFixture::Count);
+		runner.add("jobs/model_matrices_parallel_for_1M", [](const size_t iterations) {
+			TransformsFixture& transforms = getTransforms();
+			for (size_t i = 0; i < iterations; ++i) {
+				JobSystem::parallel_for(0, TransformsFixture::Count, 4096, [&transforms](const size_t begin, const size_t end) {
+					transforms.compute(begin, end);
+				});
+			}
+			keep(transforms.outputs.back());
+		}, TransformsFixture::Count);
+		// The same split over 1, 2, 4... workers up to the hardware threads, whatever --workers says
+		const uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+		std::vector<uint32_t> workerCounts;
+		for (uint32_t workers = 1; workers < hardwareThreads; workers *= 2) {
+			workerCounts.push_back(workers);
+		}
+		workerCounts.push_back(hardwareThreads);
+		for (const uint32_t workers : workerCounts) {
+			runner.add("jobs/parallel_for_w" + std::to_string(workers), [workers](const size_t iterations) {
+				TransformsFixture& transforms = getTransforms();
+				withWorkers(workers, [&transforms, iterations]() {
+					for (size_t i = 0; i < iterations; ++i) {
+						JobSystem::parallel_for(0, TransformsFixture::Count, 4096, [&transforms](const size_t begin, const size_t end) {
+							transforms.compute(begin, end);
+						});
+					}
+				});
+				keep(transforms.outputs.back());
+			}, TransformsFixture::Count);
+		}
+
+		// Logging from one thread: spdlog formatting on the calling thread, the old LOG_WARN, against the
+		// queue. A burst is what a frame logs, the flush after it counts since the queue has to drain
+		// before the next one. A flood never pauses and is bound by the logging thread.
+		constexpr size_t BurstSize = 256;
+		static const std::string s_path = "assets/meshes/sponza.gem";
+		runner.add("log/spdlog_sync_warn", [](const size_t iterations) {
+			withNullSink([iterations]() {
+				for (size_t i = 0; i < iterations; ++i) {
+					spdlog::warn("Frame {0} took {1:.2f} ms loading {2}", i, static_cast<double>(i) * 0.25, s_path);
+				}
+			});
+		});
+		runner.add("log/async_warn_burst_256", [](const size_t iterations) {
+			withNullSink([iterations]() {
+				for (size_t i = 0; i < iterations; ++i) {
+					for (size_t j = 0; j < BurstSize; ++j) {
+						LOG_WARN("Frame {0} took {1:.2f} ms loading {2}", j, static_cast<double>(j) * 0.25, s_path);
+					}
+					Log::flush();
+				}
+			});
+		}, BurstSize);
+		runner.add("log/async_err_flood", [](const size_t iterations) {
+			withNullSink([iterations]() {
+				for (size_t i = 0; i < iterations; ++i) {
+					LOG_ERR("Frame {0} took {1:.2f} ms loading {2}", i, static_cast<double>(i) * 0.25, s_path);
+				}
+			});
+		});
+		// The same from 2, 4... threads at once, every thread making the iterations' calls, so the time per item
+		// is the time a call takes each thread while the others contend for the queue's slots. The thread counts
+		// stop where the threads' bursts together no longer fit the queue.
+		for (size_t threads = 2; threads <= hardwareThreads && threads * BurstSize <= Log::QueueCapacity; threads *= 2) {
+			const std::string suffix = "_t" + std::to_string(threads);
+			runner.add("log/spdlog_sync_warn" + suffix, [threads](const size_t iterations) {
+				withNullSink([threads, iterations]() {
+					onThreads(threads, [iterations]() {
+						for (size_t i = 0; i < iterations; ++i) {
+							spdlog::warn("Frame {0} took {1:.2f} ms loading {2}", i, static_cast<double>(i) * 0.25, s_path);
+						}
+					});
+				});
+			});
+			runner.add("log/async_warn_burst_256" + suffix, [threads](const size_t iterations) {
+				withNullSink([threads, iterations]() {
+					onThreads(threads, [iterations]() {
+						for (size_t i = 0; i < iterations; ++i) {
+							for (size_t j = 0; j < BurstSize; ++j) {
+								LOG_WARN("Frame {0} took {1:.2f} ms loading {2}", j, static_cast<double>(j) * 0.25, s_path);
+							}
+							Log::flush();
+						}
+					});
+				});
+			}, BurstSize);
+			runner.add("log/async_err_flood" + suffix, [threads](const size_t iterations) {
+				withNullSink([threads, iterations]() {
+					onThreads(threads, [iterations]() {
+						for (size_t i = 0; i < iterations; ++i) {
+							LOG_ERR("Frame {0} took {1:.2f} ms loading {2}", i, static_cast<double>(i) * 0.25, s_path);
+						}
+					});
+				});
+			});
+		}
+	}
+}
@@ -3,12 +3,46 @@
 #include "window.h"
 
 #include "camera.h"
+#include "inputRecorder.h"
+#include "renderStats.h"
+#include "transformHierarchy.h"
+#include "ecs/registry.h"
 
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace GameEngine {
+	struct ApplicationOptions {
+		enum class FrameOutput {
+			None,
+			// One "frame hash" line per frame in outputPath
+			Hash,
+			// outputPath/frame_NNNNNN.ppm per frame
+			Images
+		};
+
+		// Hidden window rendering into an offscreen framebuffer without UI. Every frame advances
+		// the simulation by exactly fixedTimeStep, so the same run produces the same images.
+		bool headless = false;
+		// Frames rendered before start() returns, 0 - until the window is closed
+		uint64_t framesCount = 0;
+		// Needs headless, frames are read back from the offscreen framebuffer
+		FrameOutput frameOutput = FrameOutput::None;
+		std::string outputPath;
+		// Directory for program binaries reused by the next start, empty - always compile
+		std::string shaderCachePath = "shader_cache";
+		// Scene snapshot loaded instead of the demo scene, empty - demo scene
+		std::string scenePath;
+	};
+
 	class Application {
 	public:
+		static constexpr uint32_t CubeMeshId = 0;
+		static constexpr uint32_t InvalidMeshId = UINT32_MAX;
+		static constexpr uint32_t InvalidTextureId = UINT32_MAX;
+
 		Application();
 		virtual ~Application();
 
@@ -17,9 +51,25 @@ namespace GameEngine {
 		Application& operator=(const Application&) = delete;
 		Application& operator=(Application&&) = delete;
 
-		virtual int start(uint width, uint height, const char* title);
-		virtual void onUpdate() {}
+		virtual int start(uint width, uint height, const char* title, const ApplicationOptions& options = {});
+		// Maps a cooked mesh file and uploads it to the GPU, returns the id for MeshRef or InvalidMeshId.
+		// Needs the context, so it can only be called once start() is running.
+		uint32_t loadMesh(const std::string& path);
+		// Adds a cooked texture to the pool of its size, only the coarsest mip is uploaded here and
+		// the finer ones stream in over the next frames. Returns InvalidTextureId on failure.
+		uint32_t loadTexture(const std::string& path);
+		// Writes every entity with a Transform, its node and mesh to a snapshot, only the chunks that
+		// changed since the last save of the same file are rewritten when the tables still fit
+		bool saveScene(const std::string& path);
+		// Replaces the scene and the transform hierarchy with a snapshot, loading the meshes it refers to
+		bool loadScene(const std::string& path);
+		// Called once per rendered frame with the real time elapsed since the previous frame
+		virtual void onUpdate(const double deltaTime) {}
+		// Called zero or more times per frame, always with fixedTimeStep
+		virtual void onFixedUpdate(const double fixedDeltaTime) {}
 		virtual void on_UI_draw() {}
+		// Called once the replayed input runs out, with the duration of every frame of the replay in seconds
+		virtual void onInputReplayFinished(const std::vector<double>& frameTimes) {}
 
 		virtual void onKeyPressed(const KeyCode key) {}
 		virtual void onMouseButtonPressed(const MouseButton mouseButton) {}
@@ -30,16 +80,55 @@ namespace GameEngine {
 		inline const bool isCursorEnabled() const { return m_isCursorEnabled; }
 		inline void enableCursor() { m_isCursorEnabled = true; m_window->enableCursor(); }
 		inline void disableCursor() { m_isCursorEnabled = false; m_window->disableCursor(); }
+		// Writes the input of every fixed tick to path until the application exits
+		bool recordInput(const std::string& path);
+		// Uses the ticks recorded in path instead of the live input, fixedTimeStep is taken from the recording
+		bool replayInput(const std::string& path);
+		inline bool isReplayingInput() const { return m_inputReplayer.isOpen() && !m_inputReplayer.isFinished(); }
+		inline void close() { m_isWindowClosed = true; }
+		inline const RenderStats& getRenderStats() const { return m_renderStats; }
+		// Memory of every texture pool and the streaming progress
+		TextureStats getTextureStats() const;
+		// Listeners added here run once per frame, after the window events are polled
+		inline EventDispathcer& getEventDispatcher() { return m_dispatcher; }
+		inline double getFrameDeltaTime() const { return m_frameDeltaTime; }
+		// Fraction of a fixed step accumulated since the last onFixedUpdate, used to blend simulation states
+		inline double getInterpolationAlpha() const { return m_interpolationAlpha; }
 		
 		bool isPerspectiveMode = true;
-		float camera_speed = 0.05;
+		// Reverse-Z infinite projection, keeps depth precision for far away geometry
+		bool isReverseZ = false;
+		// Meshes with the default layout are culled by a compute shader and drawn with one multi-draw
+		bool isGpuDriven = false;
+		// Distant meshes are drawn with simplified levels of detail whose error stays under lodPixelError
+		bool isLodEnabled = true;
+		float lodPixelError = 1.f;
+		// Texel bytes the streaming uploads per frame
+		size_t textureUploadBudget = 4 * 1024 * 1024;
+		float camera_speed = 3;
 		float sensivity = 1;
+
+		// Job system workers including the main thread, 0 - one per hardware thread
+		uint jobWorkersCount = 0;
+
+		double fixedTimeStep = 1.0 / 60.0;
+		// Simulation steps allowed per frame, the rest of the backlog is dropped after a stall
+		uint maxFixedStepsPerFrame = 5;
 		Camera camera;
+		Registry scene;
+		// Updated once per frame before culling, entities with a TransformNode get their Transform from it
+		TransformHierarchy transforms;
 
 		glm::vec2 lastCursorPos;
 	private:
 		std::unique_ptr<Window> m_window;
 		EventDispathcer m_dispatcher;
+		RenderStats m_renderStats;
+		double m_frameDeltaTime = 0;
+		double m_interpolationAlpha = 0;
+		InputRecorder m_inputRecorder;
+		InputReplayer m_inputReplayer;
+		std::vector<double> m_replayFrameTimes;
 
 		bool m_isWindowClosed = false;
 		bool m_isCursorEnabled = true;
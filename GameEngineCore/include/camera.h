@@ -1,10 +1,26 @@
 #pragma once
 
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 #include <glm/ext/matrix_float4x4.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 namespace GameEngine {
+	// Planes point inwards: a point p is inside when dot(plane.xyz, p) + plane.w >= 0 for all of them
+	struct Frustum {
+		enum Plane { Left = 0, Right, Bottom, Top, Near, Far, PlanesCount };
+
+		glm::vec4 planes[PlanesCount];
+
+		// Gribb/Hartmann extraction from a clip-space transform, the planes come out normalized.
+		// Assumes a [-1, 1] depth range, reverse-Z projections only get looser near and far planes
+		static Frustum fromMatrix(const glm::mat4& viewProjection);
+	};
+
+	// View, projection and their product are cached and rebuilt on first use after a change.
+	// The orientation is kept as a quaternion built from the Euler angles only when they change,
+	// moving the camera rebuilds the view matrix without any trigonometry.
 	class Camera {
 	public:
 		enum class ProjectionMode : uint8_t {
@@ -22,6 +38,15 @@ namespace GameEngine {
 		void setRotation(const glm::vec3& rotation);
 		void setPositionRotation(const glm::vec3& position, const glm::vec3& rotation);
 		void setProjectionMode(const ProjectionMode projectionMode);
+		// Width over height of the viewport, ignored while it's not positive (minimized window)
+		void setAspect(const float aspect);
+		// Vertical field of view of the perspective projection
+		void setFieldOfView(const float degrees);
+		// Far is unused by the reverse-Z perspective projection, which has no far plane
+		void setClipPlanes(const float nearPlane, const float farPlane);
+		// Maps near to depth 1 and far (infinity in perspective) to 0. The renderer has to use a [0, 1]
+		// clip space depth range, clear depth to 0 and pass fragments with GL_GREATER
+		void setReverseZ(const bool reverseZ);
 
 		void moveForward(const float delta);
 		void moveRight(const float delta);
@@ -31,8 +56,18 @@ namespace GameEngine {
 		void rotate(const glm::vec3& rotate_delta);
 
 		const glm::mat4& getViewMatrix();
-		const glm::mat4& getProjectionMatrix() const;
+		const glm::mat4& getProjectionMatrix();
+		const glm::mat4& getViewProjectionMatrix();
+		inline const glm::vec3& getPosition() const { return m_position; }
+		inline ProjectionMode getProjectionMode() const { return m_projectionMode; }
+		inline float getAspect() const { return m_aspect; }
+		inline bool isReverseZ() const { return m_isReverseZ; }
+		Frustum getFrustum();
+		// Screen pixels spanned by one world unit at distance from the camera, for a viewport viewportHeight
+		// pixels tall. Orthographic projections don't depend on the distance.
+		float getPixelsPerUnit(const float distance, const float viewportHeight) const;
 	private:
+		void updateOrientation();
 		void updateViewMatrix();
 		void updateProjectionMatrix();
 
@@ -40,18 +75,27 @@ namespace GameEngine {
 
 		glm::vec3 m_position;
 		glm::vec3 m_rotation; // X - Roll, Y - Pitch, Z - Yaw
+		glm::quat m_orientation;
 
 		glm::vec3 m_direction;
 		glm::vec3 m_right;
 		glm::vec3 m_up;
 
-		static constexpr glm::vec3 s_world_forward = { 1.f, 0.f, 0.f };
-		static constexpr glm::vec3 s_world_right = { 0.f, -1.f, 0.f };
-		static constexpr glm::vec3 s_world_up = { 1.f, 0.f, 0.f };
+		float m_aspect = 1.f;
+		float m_fieldOfView = 45.f;
+		float m_near = 0.1f;
+		float m_far = 100.f;
+		// Half of the orthographic view height in world units
+		float m_orthographicSize = 2.f;
+		bool m_isReverseZ = false;
 
 		glm::mat4 m_viewMatrix;
 		glm::mat4 m_projectionMatrix;
+		glm::mat4 m_viewProjectionMatrix;
 
-		bool m_updateViewMatrix = false;
+		bool m_isOrientationDirty = true;
+		bool m_isViewDirty = true;
+		bool m_isProjectionDirty = true;
+		bool m_isViewProjectionDirty = true;
 	};
 }
\ No newline at end of file
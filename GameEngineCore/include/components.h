@@ -0,0 +1,32 @@
+#pragma once
+
+#include "transformHierarchy.h"
+
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+
+namespace GameEngine {
+	struct Transform {
+		glm::mat4 model_matrix = glm::mat4(1.f);
+	};
+
+	// Links the entity to a node of the application's transform hierarchy, the world matrix of the node
+	// is copied into the entity's Transform whenever it changes
+	struct TransformNode {
+		TransformId id = InvalidTransformId;
+	};
+
+	struct MeshRef {
+		uint32_t meshId = 0;
+		// Level of detail drawn last frame, the selection keeps it unless the next one is clearly better
+		uint32_t lod = 0;
+	};
+
+	// Spins the entity around Z, the previous angle is kept for interpolation between fixed steps
+	struct Spin {
+		float angle = 0;
+		float previousAngle = 0;
+		float speed = 0.6f;
+	};
+}
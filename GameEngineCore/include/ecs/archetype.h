@@ -0,0 +1,83 @@
+#pragma once
+
+#include "entity.h"
+#include "component.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace GameEngine {
+	// Storage of every entity that has exactly the components of mask.
+	// Rows live in fixed-size chunks, each chunk holds an array of entities followed by one
+	// tightly packed array per component, so a query walks contiguous memory.
+	class Archetype {
+	public:
+		static constexpr size_t ChunkSize = 16 * 1024;
+		static constexpr size_t ChunkAlignment = 64;
+
+		explicit Archetype(const ComponentMask mask);
+		~Archetype();
+
+		Archetype(const Archetype&) = delete;
+		Archetype(Archetype&&) = delete;
+		Archetype& operator=(const Archetype&) = delete;
+		Archetype& operator=(Archetype&&) = delete;
+
+		inline ComponentMask getMask() const { return m_mask; }
+		inline const std::vector<ComponentId>& getComponents() const { return m_components; }
+		inline size_t getCount() const { return m_count; }
+		inline size_t getChunkCapacity() const { return m_chunkCapacity; }
+		inline size_t getChunksCount() const { return m_chunks.size(); }
+		inline size_t getChunkCount(const size_t chunk) const
+		{
+			const size_t first = chunk * m_chunkCapacity;
+			return m_count <= first ? 0 : (m_count - first < m_chunkCapacity ? m_count - first : m_chunkCapacity);
+		}
+
+		// Column of a component inside this archetype or -1
+		inline int getColumn(const ComponentId id) const { return m_columnByComponent[id]; }
+
+		inline Entity* getEntities(const size_t chunk) { return reinterpret_cast<Entity*>(m_chunks[chunk].get()); }
+		inline void* getColumnData(const size_t chunk, const int column) { return m_chunks[chunk].get() + m_columnOffsets[column]; }
+		inline void* getComponent(const size_t row, const int column)
+		{
+			return static_cast<uint8_t*>(getColumnData(row / m_chunkCapacity, column)) + (row % m_chunkCapacity) * m_columnInfos[column]->size;
+		}
+		inline Entity getEntity(const size_t row) { return getEntities(row / m_chunkCapacity)[row % m_chunkCapacity]; }
+
+		// Appends a row for entity, its components are left unconstructed for the caller
+		size_t allocateRow(const Entity entity);
+		// Appends count rows at once and returns the first, their entities and components are left for the caller
+		size_t allocateRows(const size_t count);
+		// Swap-and-pop: the last row is relocated into row. Returns the entity that now occupies row,
+		// or an invalid entity if row was the last one
+		Entity removeRow(const size_t row, const bool destroyComponents);
+
+		inline Archetype* getAddEdge(const ComponentId id) const { return m_addEdges[id]; }
+		inline Archetype* getRemoveEdge(const ComponentId id) const { return m_removeEdges[id]; }
+		inline void setAddEdge(const ComponentId id, Archetype* archetype) { m_addEdges[id] = archetype; }
+		inline void setRemoveEdge(const ComponentId id, Archetype* archetype) { m_removeEdges[id] = archetype; }
+	private:
+		struct ChunkDeleter {
+			void operator()(uint8_t* chunk) const;
+		};
+		using Chunk = std::unique_ptr<uint8_t[], ChunkDeleter>;
+
+		void destroyRow(const size_t row);
+
+		ComponentMask m_mask;
+		std::vector<ComponentId> m_components;
+		std::vector<const ComponentInfo*> m_columnInfos;
+		std::vector<size_t> m_columnOffsets;
+		std::array<int8_t, MaxComponentTypes> m_columnByComponent;
+
+		size_t m_chunkCapacity = 0;
+		size_t m_chunkBytes = 0;
+		std::vector<Chunk> m_chunks;
+		size_t m_count = 0;
+
+		std::array<Archetype*, MaxComponentTypes> m_addEdges = {};
+		std::array<Archetype*, MaxComponentTypes> m_removeEdges = {};
+	};
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace GameEngine {
+	using ComponentId = uint32_t;
+	using ComponentMask = uint64_t;
+
+	constexpr ComponentId MaxComponentTypes = 64;
+
+	struct ComponentInfo {
+		size_t size;
+		size_t alignment;
+		bool isTriviallyRelocatable;
+		// Move-constructs into destination and destroys source
+		void (*relocate)(void* destination, void* source);
+		void (*destroy)(void* component);
+	};
+
+	class ComponentRegistry {
+	public:
+		static ComponentId registerComponent(const ComponentInfo& info);
+		static const ComponentInfo& getInfo(const ComponentId id);
+		static size_t getCount();
+	};
+
+	template<typename T>
+	ComponentInfo makeComponentInfo()
+	{
+		static_assert(alignof(T) <= 64, "Components are stored in 64 byte aligned chunks");
+		return {
+			sizeof(T),
+			alignof(T),
+			std::is_trivially_copyable_v<T>,
+			[](void* destination, void* source) {
+				new (destination) T(std::move(*static_cast<T*>(source)));
+				static_cast<T*>(source)->~T();
+			},
+			[](void* component) {
+				static_cast<T*>(component)->~T();
+			}
+		};
+	}
+
+	template<typename T>
+	struct ComponentType {
+		static ComponentId getId()
+		{
+			static const ComponentId s_id = ComponentRegistry::registerComponent(makeComponentInfo<T>());
+			return s_id;
+		}
+	};
+
+	template<typename T>
+	inline ComponentId getComponentId()
+	{
+		return ComponentType<std::remove_cv_t<std::remove_reference_t<T>>>::getId();
+	}
+
+	template<typename T>
+	inline ComponentMask getComponentMask()
+	{
+		return ComponentMask(1) << getComponentId<T>();
+	}
+
+	inline void relocateComponent(const ComponentInfo& info, void* destination, void* source)
+	{
+		if (info.isTriviallyRelocatable) {
+			std::memcpy(destination, source, info.size);
+		}
+		else {
+			info.relocate(destination, source);
+		}
+	}
+}
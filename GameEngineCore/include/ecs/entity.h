@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+namespace GameEngine {
+	// Index into the registry's entity table plus a generation that is bumped when the index is recycled,
+	// so handles to destroyed entities can be detected
+	struct Entity {
+		static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+		uint32_t index = InvalidIndex;
+		uint32_t generation = 0;
+
+		inline bool isValid() const { return index != InvalidIndex; }
+		inline bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+		inline bool operator!=(const Entity& other) const { return !(*this == other); }
+	};
+}
@@ -0,0 +1,264 @@
+#pragma once
+
+#include "archetype.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace GameEngine {
+	class Registry;
+
+	// Iterates every archetype that contains all of Ts. Adding or removing components
+	// and creating or destroying entities while iterating is not allowed.
+	template<typename... Ts>
+	class View {
+		static_assert(sizeof...(Ts) > 0, "A view needs at least one component type");
+	public:
+		explicit View(Registry& registry)
+			: m_registry(registry), m_mask((getComponentMask<Ts>() | ...))
+		{}
+
+		// fn(Entity, Ts&...) for every matching entity
+		template<typename Fn>
+		void each(Fn&& fn);
+
+		// fn(size_t count, const Entity* entities, Ts*... components) once per non-empty chunk
+		template<typename Fn>
+		void eachChunk(Fn&& fn);
+
+		size_t count() const;
+	private:
+		template<typename Fn, size_t... I>
+		static void invokeChunk(Fn& fn, Archetype& archetype, const size_t chunk, const size_t count, const int* columns, std::index_sequence<I...>)
+		{
+			fn(count, archetype.getEntities(chunk), static_cast<Ts*>(archetype.getColumnData(chunk, columns[I]))...);
+		}
+
+		Registry& m_registry;
+		ComponentMask m_mask;
+	};
+
+	class Registry {
+	public:
+		Registry();
+		~Registry();
+
+		Registry(const Registry&) = delete;
+		Registry(Registry&&) = delete;
+		Registry& operator=(const Registry&) = delete;
+		Registry& operator=(Registry&&) = delete;
+
+		Entity create();
+		// Places the entity straight into the archetype of Ts, without intermediate moves
+		template<typename... Ts>
+		Entity create(Ts&&... components);
+		// Appends count entities to the archetype of Ts in one go. The components are left unconstructed,
+		// fn(size_t first, size_t count, const Entity* entities, Ts*... components) must write every one of
+		// them, once per chunk; first is the position of the chunk's first entity among the created ones.
+		template<typename... Ts, typename Fn>
+		void createMany(const size_t count, Fn&& fn);
+		void destroy(const Entity entity);
+		void clear();
+
+		bool isAlive(const Entity entity) const;
+		inline size_t size() const { return m_aliveCount; }
+
+		template<typename T, typename... Args>
+		T& add(const Entity entity, Args&&... args);
+		template<typename T>
+		void remove(const Entity entity);
+		template<typename T>
+		bool has(const Entity entity) const;
+		template<typename T>
+		T* tryGet(const Entity entity);
+		template<typename T>
+		T& get(const Entity entity);
+
+		template<typename... Ts>
+		inline View<Ts...> view() { return View<Ts...>(*this); }
+
+		inline const std::vector<std::unique_ptr<Archetype>>& getArchetypes() const { return m_archetypes; }
+	private:
+		struct EntityRecord {
+			Archetype* archetype = nullptr;
+			size_t row = 0;
+			uint32_t generation = 0;
+		};
+
+		Entity allocateEntity();
+		template<typename... Ts, typename Fn, size_t... I>
+		static void invokeRows(Fn& fn, Archetype& archetype, const size_t chunk, const size_t row, const size_t first, const size_t count,
+			const int* columns, std::index_sequence<I...>)
+		{
+			fn(first, count, archetype.getEntities(chunk) + row, static_cast<Ts*>(archetype.getColumnData(chunk, columns[I])) + row...);
+		}
+		Archetype* getArchetype(const ComponentMask mask);
+		Archetype* getArchetypeWith(Archetype* source, const ComponentId id);
+		Archetype* getArchetypeWithout(Archetype* source, const ComponentId id);
+		// Relocates the shared components into target, components missing in target are destroyed
+		void moveEntity(const Entity entity, Archetype* target);
+
+		std::vector<EntityRecord> m_records;
+		std::vector<uint32_t> m_freeIndices;
+		size_t m_aliveCount = 0;
+
+		std::vector<std::unique_ptr<Archetype>> m_archetypes;
+		std::unordered_map<ComponentMask, Archetype*> m_archetypeByMask;
+	};
+
+	template<typename... Ts>
+	Entity Registry::create(Ts&&... components)
+	{
+		if constexpr (sizeof...(Ts) == 0) {
+			return create();
+		}
+		else {
+			Archetype* archetype = getArchetype((getComponentMask<Ts>() | ...));
+			const Entity entity = allocateEntity();
+			const size_t row = archetype->allocateRow(entity);
+			(new (archetype->getComponent(row, archetype->getColumn(getComponentId<Ts>()))) std::decay_t<Ts>(std::forward<Ts>(components)), ...);
+
+			m_records[entity.index].archetype = archetype;
+			m_records[entity.index].row = row;
+			return entity;
+		}
+	}
+
+	template<typename... Ts, typename Fn>
+	void Registry::createMany(const size_t count, Fn&& fn)
+	{
+		static_assert(sizeof...(Ts) > 0, "Entities without components are created one by one");
+		static_assert((std::is_trivially_copyable_v<Ts> && ...), "Components created in bulk are written as plain memory");
+		if (count == 0) {
+			return;
+		}
+		Archetype* archetype = getArchetype((getComponentMask<Ts>() | ...));
+		const int columns[] = { archetype->getColumn(getComponentId<Ts>())... };
+		if (count > m_freeIndices.size()) {
+			m_records.reserve(m_records.size() + count - m_freeIndices.size());
+		}
+
+		const size_t capacity = archetype->getChunkCapacity();
+		size_t row = archetype->allocateRows(count);
+		for (size_t first = 0; first < count;) {
+			const size_t chunk = row / capacity;
+			const size_t chunkRow = row % capacity;
+			const size_t chunkCount = std::min(capacity - chunkRow, count - first);
+			Entity* entities = archetype->getEntities(chunk) + chunkRow;
+			for (size_t i = 0; i < chunkCount; ++i) {
+				entities[i] = allocateEntity();
+				m_records[entities[i].index].archetype = archetype;
+				m_records[entities[i].index].row = row + i;
+			}
+			invokeRows<Ts...>(fn, *archetype, chunk, chunkRow, first, chunkCount, columns, std::index_sequence_for<Ts...>{});
+			first += chunkCount;
+			row += chunkCount;
+		}
+	}
+
+	template<typename T, typename... Args>
+	T& Registry::add(const Entity entity, Args&&... args)
+	{
+		assert(isAlive(entity));
+		if (T* component = tryGet<T>(entity)) {
+			*component = T(std::forward<Args>(args)...);
+			return *component;
+		}
+
+		const ComponentId id = getComponentId<T>();
+		EntityRecord& record = m_records[entity.index];
+		moveEntity(entity, getArchetypeWith(record.archetype, id));
+
+		return *new (record.archetype->getComponent(record.row, record.archetype->getColumn(id))) T(std::forward<Args>(args)...);
+	}
+
+	template<typename T>
+	void Registry::remove(const Entity entity)
+	{
+		if (!has<T>(entity)) {
+			return;
+		}
+		EntityRecord& record = m_records[entity.index];
+		moveEntity(entity, getArchetypeWithout(record.archetype, getComponentId<T>()));
+	}
+
+	template<typename T>
+	bool Registry::has(const Entity entity) const
+	{
+		return isAlive(entity) && (m_records[entity.index].archetype->getMask() & getComponentMask<T>()) != 0;
+	}
+
+	template<typename T>
+	T* Registry::tryGet(const Entity entity)
+	{
+		if (!isAlive(entity)) {
+			return nullptr;
+		}
+		const EntityRecord& record = m_records[entity.index];
+		const int column = record.archetype->getColumn(getComponentId<T>());
+		if (column < 0) {
+			return nullptr;
+		}
+		return static_cast<T*>(record.archetype->getComponent(record.row, column));
+	}
+
+	template<typename T>
+	T& Registry::get(const Entity entity)
+	{
+		T* component = tryGet<T>(entity);
+		assert(component);
+		return *component;
+	}
+
+	template<typename... Ts>
+	template<typename Fn>
+	void View<Ts...>::eachChunk(Fn&& fn)
+	{
+		const ComponentId ids[] = { getComponentId<Ts>()... };
+		int columns[sizeof...(Ts)];
+
+		for (const auto& archetype : m_registry.getArchetypes()) {
+			if ((archetype->getMask() & m_mask) != m_mask || archetype->getCount() == 0) {
+				continue;
+			}
+			for (size_t i = 0; i < sizeof...(Ts); ++i) {
+				columns[i] = archetype->getColumn(ids[i]);
+			}
+			for (size_t chunk = 0; chunk < archetype->getChunksCount(); ++chunk) {
+				const size_t count = archetype->getChunkCount(chunk);
+				if (count == 0) {
+					break;
+				}
+				invokeChunk(fn, *archetype, chunk, count, columns, std::index_sequence_for<Ts...>{});
+			}
+		}
+	}
+
+	template<typename... Ts>
+	template<typename Fn>
+	void View<Ts...>::each(Fn&& fn)
+	{
+		eachChunk([&fn](const size_t count, const Entity* entities, Ts*... components) {
+			for (size_t i = 0; i < count; ++i) {
+				fn(entities[i], components[i]...);
+			}
+		});
+	}
+
+	template<typename... Ts>
+	size_t View<Ts...>::count() const
+	{
+		size_t result = 0;
+		for (const auto& archetype : m_registry.getArchetypes()) {
+			if ((archetype->getMask() & m_mask) == m_mask) {
+				result += archetype->getCount();
+			}
+		}
+		return result;
+	}
+}
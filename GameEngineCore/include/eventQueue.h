@@ -0,0 +1,43 @@
+#pragma once
+
+#include "events.h"
+
+#include <cstddef>
+#include <variant>
+#include <vector>
+
+namespace GameEngine {
+	using Event = std::variant<
+		WindowCloseEvent,
+		WindowResizeEvent,
+		KeyPressedEvent,
+		KeyReleasedEvent,
+		MouseMovedEvent,
+		MouseScrolledEvent,
+		MouseButtonPressedEvent,
+		MouseButtonReleasedEvent
+	>;
+
+	// Events collected between two drains, stored by value in preallocated memory.
+	// A move, scroll or resize right after one of the same type is merged into it, so a fast mouse
+	// costs one MouseMovedEvent per frame instead of one per OS report.
+	class EventQueue {
+	public:
+		static constexpr size_t DefaultCapacity = 256;
+
+		EventQueue() : EventQueue(DefaultCapacity) {}
+		explicit EventQueue(const size_t capacity);
+
+		void push(const Event& event);
+		// Dispatches everything in arrival order and empties the queue
+		void dispatch(EventDispathcer& dispatcher);
+
+		inline size_t size() const { return m_events.size(); }
+		inline size_t getCoalescedCount() const { return m_coalescedCount; }
+	private:
+		std::vector<Event> m_events;
+		std::vector<Event> m_dispatching;
+		size_t m_capacity;
+		size_t m_coalescedCount = 0;
+	};
+}
@@ -2,8 +2,13 @@
 
 #include "keys.h"
 
-#include <functional>
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #define EVENT_CLASS_TYPE(x) virtual EventType getType() const override { return EventType::x; }\
 							static EventType getTypeStatic() { return EventType::x; }
@@ -30,27 +35,69 @@ namespace GameEngine {
 		virtual EventType getType() const = 0;
 	};
 
-	class EventDispathcer {
+	using ListenerId = uint32_t;
+
+	// Callable stored inline next to its invoker: registering doesn't allocate and dispatch
+	// is a single indirect call. Fits lambdas capturing a few pointers or references.
+	class EventListener {
 	public:
-		template<typename Type>
-		void addEventListener(std::function<void(Type&)> callback) {
-			auto baseCallback = [func = std::move(callback)](BaseEvent& e) {
-				if (e.getType() == Type::getTypeStatic()) {
-					func(static_cast<Type&>(e));	
-				}
+		static constexpr size_t StorageSize = 4 * sizeof(void*);
+
+		template<typename Type, typename Fn>
+		static EventListener create(const ListenerId id, Fn&& callback)
+		{
+			using Function = std::decay_t<Fn>;
+			static_assert(sizeof(Function) <= StorageSize, "Listener captures too much, capture a pointer instead");
+			static_assert(alignof(Function) <= alignof(std::max_align_t), "Listener is over-aligned");
+			static_assert(std::is_trivially_copyable_v<Function>, "Listener must be trivially copyable");
+
+			EventListener listener;
+			listener.m_id = id;
+			new (listener.m_storage) Function(std::forward<Fn>(callback));
+			listener.m_invoke = [](void* storage, BaseEvent& e) {
+				(*std::launder(reinterpret_cast<Function*>(storage)))(static_cast<Type&>(e));
 			};
+			return listener;
+		}
+
+		inline void operator()(BaseEvent& e) { m_invoke(m_storage, e); }
+		inline ListenerId getId() const { return m_id; }
+	private:
+		alignas(std::max_align_t) unsigned char m_storage[StorageSize];
+		void (*m_invoke)(void* storage, BaseEvent& e) = nullptr;
+		ListenerId m_id = 0;
+	};
 
-			m_eventCallbacks[static_cast<size_t>(Type::getTypeStatic())] = std::move(baseCallback);
+	class EventDispathcer {
+	public:
+		// Any number of listeners per event type, called in registration order
+		template<typename Type, typename Fn>
+		ListenerId addEventListener(Fn&& callback) {
+			const ListenerId id = m_nextListenerId++;
+			m_eventListeners[static_cast<size_t>(Type::getTypeStatic())].push_back(
+				EventListener::create<Type>(id, std::forward<Fn>(callback))
+			);
+			return id;
+		}
+		// Must not be called from inside a listener
+		void removeEventListener(const ListenerId id) {
+			for (auto& listeners : m_eventListeners) {
+				for (auto it = listeners.begin(); it != listeners.end(); ++it) {
+					if (it->getId() == id) {
+						listeners.erase(it);
+						return;
+					}
+				}
+			}
 		}
 		void dispacth(BaseEvent& event) {
-			auto& callback = m_eventCallbacks[static_cast<size_t>(event.getType())];
-
-			if (callback) {
-				callback(event);
+			for (EventListener& listener : m_eventListeners[static_cast<size_t>(event.getType())]) {
+				listener(event);
 			}
 		}
 	private:
-		std::array<std::function<void(BaseEvent&)>, static_cast<size_t>(EventType::EventsCount)> m_eventCallbacks;
+		std::array<std::vector<EventListener>, static_cast<size_t>(EventType::EventsCount)> m_eventListeners;
+		ListenerId m_nextListenerId = 0;
 	};
 
 	class WindowCloseEvent : public BaseEvent {
@@ -2,20 +2,91 @@
 
 #include "keys.h"
 
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/vec2.hpp>
+
 namespace GameEngine {
+	// Input state of one fixed tick. Plain bytes with no pointers, so recordings are written as is.
+	struct InputFrame {
+		static constexpr size_t KeysCount = static_cast<size_t>(KeyCode::KEY_LAST) + 1;
+		static constexpr size_t KeyWordsCount = (KeysCount + 63) / 64;
+		static constexpr size_t MouseButtonsCount = static_cast<size_t>(MouseButton::MOUSE_BUTTON_LAST) + 1;
+
+		uint64_t keys[KeyWordsCount] = {};
+		glm::vec2 cursorPos = glm::vec2(0.f);
+		float scrollOffset = 0;
+		uint8_t mouseButtons = 0;
+		uint8_t reserved[3] = {};
+
+		inline bool isKeyDown(const KeyCode keyCode) const {
+			const size_t key = static_cast<size_t>(keyCode);
+			return key < KeysCount && (keys[key / 64] >> (key % 64)) & 1;
+		}
+		inline void setKey(const KeyCode keyCode, const bool down) {
+			const size_t key = static_cast<size_t>(keyCode);
+			if (key >= KeysCount) {
+				return;
+			}
+			const uint64_t mask = uint64_t(1) << (key % 64);
+			keys[key / 64] = down ? keys[key / 64] | mask : keys[key / 64] & ~mask;
+		}
+		inline bool isMouseButtonDown(const MouseButton button) const {
+			const size_t index = static_cast<size_t>(button);
+			return index < MouseButtonsCount && (mouseButtons >> index) & 1;
+		}
+		inline void setMouseButton(const MouseButton button, const bool down) {
+			const size_t index = static_cast<size_t>(button);
+			if (index >= MouseButtonsCount) {
+				return;
+			}
+			const uint8_t mask = static_cast<uint8_t>(1u << index);
+			mouseButtons = down ? mouseButtons | mask : mouseButtons & ~mask;
+		}
+	};
+	static_assert(sizeof(InputFrame) == 64, "InputFrame is part of the recording format");
+
+	// Events only change the pending state. The application calls captureTick() before every
+	// fixed update, so the state is stable for the whole tick and can tell presses apart from holds.
 	class Input {
 	public:
 		static bool isKeyPressed(const KeyCode keyCode);
-
-		static void pressKey(const KeyCode keyCode);
-		static void releaseKey(const KeyCode keyCode);
+		// Down this tick and up the previous one
+		static bool isKeyJustPressed(const KeyCode keyCode);
+		static bool isKeyJustReleased(const KeyCode keyCode);
 
 		static bool isMouseButtonPressed(const MouseButton mouseButtonCode);
+		static bool isMouseButtonJustPressed(const MouseButton mouseButtonCode);
+		static bool isMouseButtonJustReleased(const MouseButton mouseButtonCode);
 
+		static glm::vec2 getCursorPos();
+		// Cursor movement since the previous tick
+		static glm::vec2 getCursorDelta();
+		// Scroll accumulated since the previous tick
+		static float getScrollOffset();
+
+		static void pressKey(const KeyCode keyCode);
+		static void releaseKey(const KeyCode keyCode);
 		static void pressMouseButton(const MouseButton mouseButtonCode);
 		static void releaseMouseButton(const MouseButton mouseButtonCode);
+		static void moveCursor(const glm::vec2& pos);
+		static void scroll(const float offset);
+
+		// Resets all states, the cursor starts at pos so the first delta is zero
+		static void reset(const glm::vec2& cursorPos);
+		// Makes the pending state current
+		static void captureTick();
+		// Makes a recorded frame current instead, the live pending state is kept for later
+		static void captureTick(const InputFrame& frame);
+		inline static const InputFrame& getCurrentFrame() { return s_current; }
 	private:
-		static bool s_keysPressed[];
-		static bool s_mouseButtonsPressed[];
+		static void advance(const InputFrame& frame);
+
+		static InputFrame s_current;
+		static InputFrame s_previous;
+		static InputFrame s_pending;
+		// Keys pressed and released between two ticks, released only after one tick saw them down
+		static InputFrame s_deferredReleases;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "input.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace GameEngine {
+	// Recorded input, little endian:
+	//   InputRecordingHeader
+	//   framesCount InputFrame, one per fixed tick
+	struct InputRecordingHeader {
+		static constexpr uint32_t Magic = 0x4E494547; // "GEIN"
+		static constexpr uint32_t Version = 1;
+
+		uint32_t magic;
+		uint32_t version;
+		uint32_t frameSize;
+		uint32_t reserved;
+		// Replaying with another step would move the simulation differently for the same input
+		double fixedTimeStep;
+		uint64_t framesCount;
+	};
+
+	class InputRecorder {
+	public:
+		InputRecorder() = default;
+		~InputRecorder();
+
+		InputRecorder(const InputRecorder&) = delete;
+		InputRecorder(InputRecorder&&) = delete;
+		InputRecorder& operator=(const InputRecorder&) = delete;
+		InputRecorder& operator=(InputRecorder&&) = delete;
+
+		bool open(const std::string& path, const double fixedTimeStep);
+		// Writes the frames count into the header, also done by the destructor
+		void close();
+		void write(const InputFrame& frame);
+
+		inline bool isOpen() const { return m_file.is_open(); }
+		inline uint64_t getFramesCount() const { return m_header.framesCount; }
+	private:
+		std::ofstream m_file;
+		InputRecordingHeader m_header{};
+	};
+
+	class InputReplayer {
+	public:
+		InputReplayer() = default;
+		~InputReplayer() = default;
+
+		InputReplayer(const InputReplayer&) = delete;
+		InputReplayer(InputReplayer&&) = delete;
+		InputReplayer& operator=(const InputReplayer&) = delete;
+		InputReplayer& operator=(InputReplayer&&) = delete;
+
+		bool open(const std::string& path);
+		void close();
+		// Returns nullptr once every frame was played
+		const InputFrame* next();
+
+		inline bool isOpen() const { return !m_frames.empty(); }
+		inline bool isFinished() const { return m_tick >= m_frames.size(); }
+		inline size_t getTick() const { return m_tick; }
+		inline size_t getFramesCount() const { return m_frames.size(); }
+		inline double getFixedTimeStep() const { return m_fixedTimeStep; }
+	private:
+		std::vector<InputFrame> m_frames;
+		size_t m_tick = 0;
+		double m_fixedTimeStep = 0;
+	};
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace GameEngine {
+	struct JobCounter {
+		std::atomic<uint32_t> value = 0;
+
+		inline bool isDone() const { return value.load(std::memory_order_acquire) == 0; }
+	};
+
+	struct Job {
+		void (*function)(const Job& job) = nullptr;
+		void* data = nullptr;
+		size_t begin = 0;
+		size_t end = 0;
+		// Decremented once the job has finished
+		JobCounter* counter = nullptr;
+		// The job is not started before this counter reaches zero
+		const JobCounter* dependency = nullptr;
+	};
+
+	// Work-stealing scheduler: every worker owns a deque, pushes and pops its own work at the bottom
+	// and steals from the top of the others when it runs dry. The thread calling init() is worker 0
+	// and executes jobs while it waits on a counter.
+	class JobSystem {
+	public:
+		// workersCount includes the calling thread, 0 picks the hardware concurrency
+		static void init(uint32_t workersCount = 0);
+		static void shutdown();
+
+		static uint32_t getWorkersCount();
+		// Index of the calling worker or -1 for threads the job system doesn't own
+		static int getWorkerIndex();
+
+		// The counter of a job must be incremented by the caller before running it
+		static void run(const Job& job);
+		static void wait(const JobCounter& counter);
+
+		// Splits [begin, end) into ranges of grain elements and calls fn(rangeBegin, rangeEnd) on the workers,
+		// returns once every range is done. grain == 0 picks a few ranges per worker.
+		template<typename Fn>
+		static void parallel_for(const size_t begin, const size_t end, size_t grain, Fn&& fn);
+	};
+
+	template<typename Fn>
+	void JobSystem::parallel_for(const size_t begin, const size_t end, size_t grain, Fn&& fn)
+	{
+		if (begin >= end) {
+			return;
+		}
+		if (grain == 0) {
+			const size_t ranges = static_cast<size_t>(getWorkersCount()) * 4;
+			grain = (end - begin + ranges - 1) / ranges;
+		}
+
+		using Function = std::remove_reference_t<Fn>;
+		JobCounter counter;
+		counter.value.store(static_cast<uint32_t>((end - begin + grain - 1) / grain), std::memory_order_relaxed);
+
+		Job job;
+		job.function = [](const Job& job) {
+			(*static_cast<Function*>(job.data))(job.begin, job.end);
+		};
+		job.data = const_cast<void*>(static_cast<const void*>(&fn));
+		job.counter = &counter;
+
+		for (size_t rangeBegin = begin; rangeBegin < end; rangeBegin += grain) {
+			job.begin = rangeBegin;
+			job.end = rangeBegin + grain < end ? rangeBegin + grain : end;
+			run(job);
+		}
+		wait(counter);
+	}
+}
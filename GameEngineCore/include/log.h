@@ -1,19 +1,245 @@
 #pragma once
 
-#include <spdlog/spdlog.h>
+#include <spdlog/fmt/fmt.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+// Log calls copy their arguments into a lock-free queue and return, a background thread formats
+// them and hands them to the spdlog sinks. Formats must outlive the program, the macros only
+// accept string literals. Critical messages wait until they're written.
+//
+// Lowest level compiled in: 0 info, 1 warnings, 2 errors, 3 critical, 4 nothing. Debug builds keep
+// everything and release builds warnings and above, CMake option ENGINE_LOG_LEVEL overrides both.
+// A module can be set apart with GAMEENGINE_LOG_LEVEL_<MODULE>, e.g. GAMEENGINE_LOG_LEVEL_RENDERER=0.
+// A source file picks its module by defining LOG_MODULE before its first include:
+//   #define LOG_MODULE Renderer
+#ifndef GAMEENGINE_LOG_LEVEL
 #ifndef NDEBUG
+#define GAMEENGINE_LOG_LEVEL 0
+#else
+#define GAMEENGINE_LOG_LEVEL 1
+#endif
+#endif
 
-#define LOG_INFO(...) spdlog::info(__VA_ARGS__)
-#define LOG_WARN(...) spdlog::warn(__VA_ARGS__)
-#define LOG_CRIT(...) spdlog::critical(__VA_ARGS__)
-#define LOG_ERR(...) spdlog::error(__VA_ARGS__)
+#ifndef GAMEENGINE_LOG_LEVEL_CORE
+#define GAMEENGINE_LOG_LEVEL_CORE GAMEENGINE_LOG_LEVEL
+#endif
+#ifndef GAMEENGINE_LOG_LEVEL_RENDERER
+#define GAMEENGINE_LOG_LEVEL_RENDERER GAMEENGINE_LOG_LEVEL
+#endif
+#ifndef GAMEENGINE_LOG_LEVEL_RESOURCES
+#define GAMEENGINE_LOG_LEVEL_RESOURCES GAMEENGINE_LOG_LEVEL
+#endif
+#ifndef GAMEENGINE_LOG_LEVEL_ECS
+#define GAMEENGINE_LOG_LEVEL_ECS GAMEENGINE_LOG_LEVEL
+#endif
+#ifndef GAMEENGINE_LOG_LEVEL_JOBS
+#define GAMEENGINE_LOG_LEVEL_JOBS GAMEENGINE_LOG_LEVEL
+#endif
+#ifndef GAMEENGINE_LOG_LEVEL_PROFILER
+#define GAMEENGINE_LOG_LEVEL_PROFILER GAMEENGINE_LOG_LEVEL
+#endif
 
-#else
+#ifndef LOG_MODULE
+#define LOG_MODULE Core
+#endif
+
+#define LOG_AT(level, ...) \
+	do { \
+		if constexpr (::GameEngine::Log::isCompiledIn(::GameEngine::LogModule::LOG_MODULE, level)) { \
+			::GameEngine::Log::write(::GameEngine::LogModule::LOG_MODULE, level, __VA_ARGS__); \
+		} \
+	} while (false)
+
+#define LOG_INFO(...) LOG_AT(::GameEngine::LogLevel::Info, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(::GameEngine::LogLevel::Warn, __VA_ARGS__)
+#define LOG_CRIT(...) LOG_AT(::GameEngine::LogLevel::Crit, __VA_ARGS__)
+#define LOG_ERR(...) LOG_AT(::GameEngine::LogLevel::Err, __VA_ARGS__)
+
+namespace GameEngine {
+	enum class LogLevel : uint8_t {
+		Info,
+		Warn,
+		Err,
+		Crit,
+		Off
+	};
+
+	enum class LogModule : uint8_t {
+		Core,
+		Renderer,
+		Resources,
+		Ecs,
+		Jobs,
+		Profiler,
+		Count
+	};
+
+	constexpr LogLevel CompiledLogLevels[] = {
+		static_cast<LogLevel>(GAMEENGINE_LOG_LEVEL_CORE),
+		static_cast<LogLevel>(GAMEENGINE_LOG_LEVEL_RENDERER),
+		static_cast<LogLevel>(GAMEENGINE_LOG_LEVEL_RESOURCES),
+		static_cast<LogLevel>(GAMEENGINE_LOG_LEVEL_ECS),
+		static_cast<LogLevel>(GAMEENGINE_LOG_LEVEL_JOBS),
+		static_cast<LogLevel>(GAMEENGINE_LOG_LEVEL_PROFILER)
+	};
+	static_assert(std::size(CompiledLogLevels) == static_cast<size_t>(LogModule::Count), "Every module needs a compiled level");
+
+	// A message waiting in the queue: its arguments are stored as raw bytes, strings as a length
+	// followed by their characters, and decoded by the function instantiated for their types.
+	struct LogRecord {
+		static constexpr size_t PayloadCapacity = 206;
+		using FormatFunction = void (*)(const LogRecord& record, fmt::memory_buffer& out);
+
+		FormatFunction format;
+		const char* formatString;
+		std::chrono::system_clock::time_point time;
+		size_t threadId;
+		size_t position; // place in the queue, set by Log::beginRecord
+		LogLevel level;
+		LogModule module;
+		uint8_t payload[PayloadCapacity];
+	};
+
+	struct LogStats {
+		size_t written = 0;
+		// Info and warnings are dropped while the queue is full, errors wait for room
+		size_t dropped = 0;
+		// Most records ever waiting in the queue
+		size_t highWaterMark = 0;
+	};
+
+	class Log {
+	public:
+		// Records the queue holds before info and warnings are dropped
+		static constexpr size_t QueueCapacity = 4096;
+
+		static constexpr bool isCompiledIn(const LogModule module, const LogLevel level)
+		{
+			return level != LogLevel::Off && level >= CompiledLogLevels[static_cast<size_t>(module)];
+		}
+
+		template<size_t N, typename... Args>
+		static void write(const LogModule module, const LogLevel level, const char (&format)[N], const Args&... args)
+		{
+			static_assert((fixedSize<Stored<Args>>() + ... + 0) <= LogRecord::PayloadCapacity, "Too many arguments for one log record");
+
+			LogRecord* record = beginRecord(level);
+			if (record == nullptr) {
+				return;
+			}
+			record->format = &formatRecord<Stored<Args>...>;
+			record->formatString = format;
+			record->level = level;
+			record->module = module;
+			[[maybe_unused]] size_t offset = 0;
+			[[maybe_unused]] size_t reserved = (fixedSize<Stored<Args>>() + ... + 0);
+			(encode<Stored<Args>>(*record, offset, reserved, args), ...);
+			commitRecord(record);
+		}
+
+		// Blocks until everything logged so far reached the sinks
+		static void flush();
+		static LogStats getStats();
+	private:
+		// Returns nullptr when the record is dropped
+		static LogRecord* beginRecord(const LogLevel level);
+		static void commitRecord(LogRecord* record);
+
+		// Arrays decay to pointers, all character pointers become const char*
+		template<typename T>
+		using Stored = std::conditional_t<std::is_same_v<std::decay_t<T>, char*>, const char*, std::decay_t<T>>;
+
+		template<typename T>
+		static constexpr bool isString()
+		{
+			return std::is_same_v<T, const char*> || std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+		}
+		// Copied bytewise, anything else is formatted into a string on the calling thread
+		template<typename T>
+		static constexpr bool isTrivial()
+		{
+			return !isString<T>() && std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>;
+		}
+
+		template<typename T>
+		static constexpr size_t fixedSize()
+		{
+			if constexpr (isTrivial<T>()) {
+				return sizeof(T);
+			}
+			else {
+				return sizeof(uint16_t);
+			}
+		}
+
+		// Strings get whatever room the arguments after them leave and are cut to fit
+		static void encodeString(LogRecord& record, size_t& offset, size_t& reserved, const std::string_view value)
+		{
+			reserved -= sizeof(uint16_t);
+			const size_t room = LogRecord::PayloadCapacity - offset - reserved - sizeof(uint16_t);
+			const uint16_t size = static_cast<uint16_t>(std::min(value.size(), room));
+			std::memcpy(record.payload + offset, &size, sizeof(size));
+			std::memcpy(record.payload + offset + sizeof(size), value.data(), size);
+			offset += sizeof(size) + size;
+		}
+
+		template<typename T>
+		static void encode(LogRecord& record, size_t& offset, size_t& reserved, const T& value)
+		{
+			if constexpr (isTrivial<T>()) {
+				reserved -= sizeof(T);
+				std::memcpy(record.payload + offset, &value, sizeof(T));
+				offset += sizeof(T);
+			}
+			else if constexpr (std::is_pointer_v<T>) {
+				encodeString(record, offset, reserved, value != nullptr ? std::string_view(value) : std::string_view("(null)"));
+			}
+			else if constexpr (isString<T>()) {
+				encodeString(record, offset, reserved, value);
+			}
+			else {
+				encodeString(record, offset, reserved, fmt::format("{}", value));
+			}
+		}
 
-#define LOG_INFO(...) 
-#define LOG_WARN(...) 
-#define LOG_CRIT(...) 
-#define LOG_ERR(...) 
+		template<typename T>
+		static auto decode(const LogRecord& record, size_t& offset)
+		{
+			if constexpr (isTrivial<T>()) {
+				T value;
+				std::memcpy(&value, record.payload + offset, sizeof(T));
+				offset += sizeof(T);
+				return value;
+			}
+			else {
+				uint16_t size;
+				std::memcpy(&size, record.payload + offset, sizeof(size));
+				const std::string_view value(reinterpret_cast<const char*>(record.payload + offset + sizeof(size)), size);
+				offset += sizeof(size) + size;
+				return value;
+			}
+		}
 
-#endif
\ No newline at end of file
+		// Runs on the logging thread
+		template<typename... Args>
+		static void formatRecord(const LogRecord& record, fmt::memory_buffer& out)
+		{
+			size_t offset = 0;
+			// Braced initialization decodes the arguments in order
+			const std::tuple<decltype(decode<Args>(record, offset))...> values{ decode<Args>(record, offset)... };
+			std::apply([&](const auto&... arguments) {
+				fmt::vformat_to(std::back_inserter(out), std::string_view(record.formatString), fmt::make_format_args(arguments...));
+			}, values);
+		}
+	};
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "linearArena.h"
+
+#include <cstddef>
+
+namespace GameEngine {
+	struct FrameMemoryStats {
+		// Allocations and bytes taken from the frame arena during the last finished frame
+		size_t frameAllocations = 0;
+		size_t frameBytes = 0;
+		// Most bytes the frame arena and the main thread's scratch arena ever held
+		size_t frameHighWaterMark = 0;
+		size_t scratchHighWaterMark = 0;
+		// Size of the frame arena after the last reset, it grows to fit the busiest frame
+		size_t frameCapacity = 0;
+	};
+
+	// Per-frame memory: the frame arena belongs to the main thread and is reset by Application::start
+	// at the end of every loop iteration, anything allocated there is gone by the next frame.
+	// Every thread, job system workers included, also has a scratch arena for temporaries of a single
+	// function, taken and given back with ScratchScope.
+	class FrameMemory {
+	public:
+		static constexpr size_t FrameArenaBlockSize = 1024 * 1024;
+		static constexpr size_t ScratchArenaBlockSize = 256 * 1024;
+
+		// Main thread only
+		static LinearArena& getFrameArena();
+		static LinearArena& getScratchArena();
+
+		// Resets the frame arena, the statistics are only collected in debug builds
+		static void endFrame();
+		static const FrameMemoryStats& getStats();
+	};
+
+	// Everything allocated from the calling thread's scratch arena while the scope is alive is freed
+	// when it ends. Scopes nest, an inner scope must end first.
+	//
+	//   ScratchScope scratch;
+	//   ArenaVector<uint32_t> indices(ArenaAllocator<uint32_t>(scratch.getArena()));
+	class ScratchScope {
+	public:
+		ScratchScope()
+			: m_arena(FrameMemory::getScratchArena()), m_marker(m_arena.getMarker())
+		{}
+		~ScratchScope() { m_arena.rewind(m_marker); }
+
+		ScratchScope(const ScratchScope&) = delete;
+		ScratchScope(ScratchScope&&) = delete;
+		ScratchScope& operator=(const ScratchScope&) = delete;
+		ScratchScope& operator=(ScratchScope&&) = delete;
+
+		inline LinearArena& getArena() { return m_arena; }
+	private:
+		LinearArena& m_arena;
+		LinearArena::Marker m_marker;
+	};
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace GameEngine {
+	// Vector with its elements stored inside the object, it never allocates and holds at most Capacity
+	// elements. Meant for small trivially copyable records that are built once and copied around.
+	// Adding to a full vector asserts in debug builds and is refused in release ones.
+	template<typename T, size_t Capacity>
+	class InlineVector {
+		static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+			"InlineVector copies its storage as bytes and never runs destructors");
+	public:
+		InlineVector() = default;
+		InlineVector(std::initializer_list<T> values)
+		{
+			for (const T& value : values) {
+				push_back(value);
+			}
+		}
+
+		// False when full, nothing is written then
+		inline bool push_back(const T& value)
+		{
+			if (m_size == Capacity) {
+				assert(false && "InlineVector is full");
+				return false;
+			}
+			new (&m_storage[m_size * sizeof(T)]) T(value);
+			++m_size;
+			return true;
+		}
+		// nullptr when full
+		template<typename... Args>
+		inline T* emplace_back(Args&&... args)
+		{
+			if (m_size == Capacity) {
+				assert(false && "InlineVector is full");
+				return nullptr;
+			}
+			T* value = new (&m_storage[m_size * sizeof(T)]) T(std::forward<Args>(args)...);
+			++m_size;
+			return value;
+		}
+		inline void pop_back() { --m_size; }
+		inline void clear() { m_size = 0; }
+
+		inline T* data() { return std::launder(reinterpret_cast<T*>(m_storage)); }
+		inline const T* data() const { return std::launder(reinterpret_cast<const T*>(m_storage)); }
+		inline size_t size() const { return m_size; }
+		inline bool empty() const { return m_size == 0; }
+		inline bool full() const { return m_size == Capacity; }
+		static constexpr size_t capacity() { return Capacity; }
+
+		inline T& operator[](const size_t index) { return data()[index]; }
+		inline const T& operator[](const size_t index) const { return data()[index]; }
+		inline T& front() { return data()[0]; }
+		inline const T& front() const { return data()[0]; }
+		inline T& back() { return data()[m_size - 1]; }
+		inline const T& back() const { return data()[m_size - 1]; }
+
+		inline T* begin() { return data(); }
+		inline T* end() { return data() + m_size; }
+		inline const T* begin() const { return data(); }
+		inline const T* end() const { return data() + m_size; }
+	private:
+		alignas(T) unsigned char m_storage[sizeof(T) * Capacity];
+		size_t m_size = 0;
+	};
+}
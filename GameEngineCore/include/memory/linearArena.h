@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Allocation statistics are gathered in debug builds only. The counters are part of the classes
+// either way, so code built with and without NDEBUG can be linked together.
+#ifndef NDEBUG
+#define GAMEENGINE_MEMORY_STATS
+#endif
+
+namespace GameEngine {
+	struct ArenaStats {
+		// Allocations since the last reset()
+		size_t allocations = 0;
+		// Most bytes ever in use between two resets
+		size_t highWaterMark = 0;
+		// Blocks requested from the system over the arena's lifetime
+		size_t blocksAllocated = 0;
+	};
+
+	// Bump allocator: allocation moves a pointer forward, nothing is freed individually and no
+	// destructors run. reset() releases everything at once, rewind() everything allocated after a marker.
+	// Memory comes in blocks chained as needed, reset() merges them into one block of their total size
+	// so an arena used the same way every frame settles on a single block. Not thread safe.
+	class LinearArena {
+	public:
+		static constexpr size_t DefaultBlockSize = 64 * 1024;
+
+		struct Marker {
+			size_t block;
+			size_t offset;
+		};
+
+		explicit LinearArena(const size_t blockSize = DefaultBlockSize);
+		~LinearArena();
+
+		LinearArena(const LinearArena&) = delete;
+		LinearArena(LinearArena&&) = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+		LinearArena& operator=(LinearArena&&) = delete;
+
+		// alignment must be a power of two. Never returns nullptr, zero bytes get a valid address too.
+		inline void* allocate(const size_t size, const size_t alignment = alignof(std::max_align_t))
+		{
+			const uintptr_t address = (m_current + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+			// A fresh arena has no block yet, its zero range would fit an empty allocation at address 0
+			if (address + size > m_end || address == 0) {
+				return allocateSlow(size, alignment);
+			}
+			m_current = address + size;
+#ifdef GAMEENGINE_MEMORY_STATS
+			++m_stats.allocations;
+			if (getUsed() > m_stats.highWaterMark) {
+				m_stats.highWaterMark = getUsed();
+			}
+#endif
+			return reinterpret_cast<void*>(address);
+		}
+		// Uninitialized room for count objects of T
+		template<typename T>
+		inline T* allocateArray(const size_t count) { return static_cast<T*>(allocate(sizeof(T) * count, alignof(T))); }
+
+		void reset();
+		inline Marker getMarker() const { return { m_blockIndex, static_cast<size_t>(m_current - m_begin) }; }
+		// Frees everything allocated after marker was taken, the blocks are kept for reuse
+		void rewind(const Marker& marker);
+
+		// Whole blocks before the current one plus the used part of the current block
+		inline size_t getUsed() const { return m_previousBlocksBytes + static_cast<size_t>(m_current - m_begin); }
+		size_t getCapacity() const;
+		inline const ArenaStats& getStats() const { return m_stats; }
+	private:
+		struct Block {
+			uint8_t* data;
+			size_t size;
+		};
+
+		void* allocateSlow(const size_t size, const size_t alignment);
+		void setCurrentBlock(const size_t index, const size_t offset);
+
+		size_t m_blockSize;
+		std::vector<Block> m_blocks;
+		size_t m_blockIndex = 0;
+		size_t m_previousBlocksBytes = 0;
+		uintptr_t m_begin = 0;
+		uintptr_t m_current = 0;
+		uintptr_t m_end = 0;
+		ArenaStats m_stats;
+	};
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "linearArena.h"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace GameEngine {
+	struct PoolStats {
+		size_t liveCount = 0;
+		// Most elements alive at once
+		size_t highWaterMark = 0;
+		// Allocations over the pool's lifetime
+		size_t allocations = 0;
+	};
+
+	// Fixed-size elements carved out of chunks, freed elements go to an intrusive free list and are
+	// handed out again before a new chunk is taken. Chunks are only returned to the system by the
+	// destructor. Not thread safe.
+	class FixedPool {
+	public:
+		static constexpr size_t DefaultElementsPerChunk = 256;
+
+		// elementSize is rounded up to alignment, a power of two
+		FixedPool(const size_t elementSize, const size_t elementsPerChunk = DefaultElementsPerChunk, const size_t alignment = alignof(std::max_align_t));
+		FixedPool() = delete;
+		~FixedPool();
+
+		FixedPool(const FixedPool&) = delete;
+		FixedPool(FixedPool&&) = delete;
+		FixedPool& operator=(const FixedPool&) = delete;
+		FixedPool& operator=(FixedPool&&) = delete;
+
+		inline void* allocate()
+		{
+			if (!m_freeList) {
+				addChunk();
+			}
+			FreeNode* node = m_freeList;
+			m_freeList = node->next;
+#ifdef GAMEENGINE_MEMORY_STATS
+			++m_stats.allocations;
+			if (++m_stats.liveCount > m_stats.highWaterMark) {
+				m_stats.highWaterMark = m_stats.liveCount;
+			}
+#endif
+			return node;
+		}
+		// element must come from this pool
+		inline void deallocate(void* element)
+		{
+			FreeNode* node = static_cast<FreeNode*>(element);
+			node->next = m_freeList;
+			m_freeList = node;
+#ifdef GAMEENGINE_MEMORY_STATS
+			--m_stats.liveCount;
+#endif
+		}
+
+		inline size_t getElementSize() const { return m_elementSize; }
+		inline size_t getChunksCount() const { return m_chunks.size(); }
+		inline const PoolStats& getStats() const { return m_stats; }
+	private:
+		struct FreeNode {
+			FreeNode* next;
+		};
+
+		void addChunk();
+
+		size_t m_elementSize;
+		size_t m_elementsPerChunk;
+		size_t m_alignment;
+		FreeNode* m_freeList = nullptr;
+		std::vector<void*> m_chunks;
+		PoolStats m_stats;
+	};
+
+	// Typed front of a FixedPool that constructs and destroys the objects
+	template<typename T>
+	class ObjectPool {
+	public:
+		explicit ObjectPool(const size_t elementsPerChunk = FixedPool::DefaultElementsPerChunk)
+			: m_pool(sizeof(T), elementsPerChunk, alignof(T))
+		{}
+
+		template<typename... Args>
+		inline T* create(Args&&... args)
+		{
+			void* element = m_pool.allocate();
+			return new (element) T(std::forward<Args>(args)...);
+		}
+		inline void destroy(T* object)
+		{
+			if (object) {
+				object->~T();
+				m_pool.deallocate(object);
+			}
+		}
+
+		inline const PoolStats& getStats() const { return m_pool.getStats(); }
+	private:
+		FixedPool m_pool;
+	};
+
+	// One FixedPool per size class of SizeClassStep bytes up to MaxSize, larger requests go to operator new.
+	// The caller passes the size back on deallocate(), like sized delete, so no header is stored.
+	class SmallObjectAllocator {
+	public:
+		static constexpr size_t SizeClassStep = 16;
+		static constexpr size_t MaxSize = 256;
+
+		SmallObjectAllocator() = default;
+		~SmallObjectAllocator() = default;
+
+		SmallObjectAllocator(const SmallObjectAllocator&) = delete;
+		SmallObjectAllocator(SmallObjectAllocator&&) = delete;
+		SmallObjectAllocator& operator=(const SmallObjectAllocator&) = delete;
+		SmallObjectAllocator& operator=(SmallObjectAllocator&&) = delete;
+
+		// Aligned to SizeClassStep, which covers alignof(std::max_align_t) on the supported targets
+		void* allocate(const size_t size);
+		void deallocate(void* pointer, const size_t size);
+
+		// Pools that served at least one allocation, null for the others
+		inline const FixedPool* getPool(const size_t sizeClass) const { return m_pools[sizeClass].get(); }
+		static constexpr size_t SizeClassesCount = MaxSize / SizeClassStep;
+	private:
+		std::array<std::unique_ptr<FixedPool>, SizeClassesCount> m_pools;
+	};
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "linearArena.h"
+#include "poolAllocator.h"
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace GameEngine {
+	// Standard allocator drawing from a LinearArena. deallocate() does nothing, a growing container
+	// leaves its old buffers in the arena until it's reset, so reserve() up front where possible.
+	template<typename T>
+	class ArenaAllocator {
+	public:
+		using value_type = T;
+
+		explicit ArenaAllocator(LinearArena& arena) : m_arena(&arena) {}
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.getArena()) {}
+
+		inline T* allocate(const size_t count) { return m_arena->allocateArray<T>(count); }
+		inline void deallocate(T*, const size_t) {}
+
+		inline LinearArena* getArena() const { return m_arena; }
+
+		template<typename U>
+		inline bool operator==(const ArenaAllocator<U>& other) const { return m_arena == other.getArena(); }
+		template<typename U>
+		inline bool operator!=(const ArenaAllocator<U>& other) const { return m_arena != other.getArena(); }
+	private:
+		LinearArena* m_arena;
+	};
+
+	// Standard allocator for node based containers (list, map, unordered_map...): every node comes
+	// from the pool of its size class. Arrays larger than SmallObjectAllocator::MaxSize go to operator new.
+	template<typename T>
+	class PoolAllocator {
+		static_assert(alignof(T) <= SmallObjectAllocator::SizeClassStep, "Over-aligned types need their own FixedPool");
+	public:
+		using value_type = T;
+
+		explicit PoolAllocator(SmallObjectAllocator& allocator) : m_allocator(&allocator) {}
+		template<typename U>
+		PoolAllocator(const PoolAllocator<U>& other) : m_allocator(other.getAllocator()) {}
+
+		inline T* allocate(const size_t count) { return static_cast<T*>(m_allocator->allocate(sizeof(T) * count)); }
+		inline void deallocate(T* pointer, const size_t count) { m_allocator->deallocate(pointer, sizeof(T) * count); }
+
+		inline SmallObjectAllocator* getAllocator() const { return m_allocator; }
+
+		template<typename U>
+		inline bool operator==(const PoolAllocator<U>& other) const { return m_allocator == other.getAllocator(); }
+		template<typename U>
+		inline bool operator!=(const PoolAllocator<U>& other) const { return m_allocator != other.getAllocator(); }
+	private:
+		SmallObjectAllocator* m_allocator;
+	};
+
+	// Vector living in an arena, for temporaries that don't outlive the arena's next reset or rewind
+	template<typename T>
+	using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+}
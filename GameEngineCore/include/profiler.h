@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Scoped markers are compiled in when GAMEENGINE_PROFILER_ENABLED is defined (CMake option
+// ENGINE_PROFILER) and cost a single branch at runtime while Profiler::setEnabled(false).
+// Names must outlive the profiler, string literals are expected.
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef GAMEENGINE_PROFILER_ENABLED
+
+#define PROFILE_SCOPE(name) ::GameEngine::ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+
+#endif
+
+namespace GameEngine {
+	struct ProfileEvent {
+		const char* name;
+		uint64_t start; // nanoseconds since profiler start
+		uint64_t end;
+		uint32_t threadId;
+		uint16_t depth;
+		bool isGpu;
+	};
+
+	struct ProfileFrame {
+		uint64_t start = 0;
+		uint64_t end = 0;
+		std::vector<ProfileEvent> events;
+	};
+
+	class Profiler {
+	public:
+		static constexpr uint32_t GpuThreadId = 0xFFFFFFFF;
+
+		static void setEnabled(const bool enabled);
+		// Read by every scope on every thread, set from the UI
+		static inline bool isEnabled() { return s_isEnabled.load(std::memory_order_relaxed); }
+
+		static uint64_t now();
+
+		// Called by Application around every frame, collects the events of all threads
+		static void beginFrame();
+		static void endFrame();
+
+		static void record(const char* name, const uint64_t start, const uint64_t end, const uint16_t depth);
+		// GPU timings arrive a few frames late, they are attached to the frame being collected
+		static void recordGpu(const char* name, const uint64_t start, const uint64_t duration);
+
+		// Completed frames, index 0 is the oldest. Frames are read in place, they stay valid until
+		// endFrame() recycles them once the history is full.
+		static size_t getHistorySize();
+		static const ProfileFrame& getHistoryFrame(const size_t index);
+		// nullptr until a frame is completed
+		static const ProfileFrame* getLatestFrame();
+		static size_t getDroppedEventsCount();
+
+		static bool exportChromeTrace(const char* path);
+
+		static uint16_t pushDepth();
+		static void popDepth();
+	private:
+		static std::atomic<bool> s_isEnabled;
+	};
+
+	class ProfileScope {
+	public:
+		explicit ProfileScope(const char* name)
+		{
+			if (Profiler::isEnabled()) {
+				m_name = name;
+				m_depth = Profiler::pushDepth();
+				m_start = Profiler::now();
+			}
+		}
+		~ProfileScope()
+		{
+			if (m_name) {
+				Profiler::record(m_name, m_start, Profiler::now(), m_depth);
+				Profiler::popDepth();
+			}
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope(ProfileScope&&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+		ProfileScope& operator=(ProfileScope&&) = delete;
+	private:
+		const char* m_name = nullptr;
+		uint64_t m_start = 0;
+		uint16_t m_depth = 0;
+	};
+}
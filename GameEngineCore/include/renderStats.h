@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GameEngine {
+	struct RenderStats {
+		size_t drawCalls = 0;
+		size_t vertices = 0;
+		size_t indices = 0;
+		// Indices the same objects would have taken at full detail, indices is what the levels of detail left
+		size_t fullDetailIndices = 0;
+		size_t submissions = 0;
+		// Objects rejected by frustum culling before submission
+		size_t culledObjects = 0;
+		// Times the CPU blocked on the GPU before it could reuse a streaming buffer region
+		size_t fenceWaits = 0;
+		// Program and vertex array switches of the render queue in recording and in sorted order
+		size_t stateChangesUnsorted = 0;
+		size_t stateChangesSorted = 0;
+		// Binding and fixed-function state calls that reached the driver or were filtered by the state cache
+		size_t glCallsIssued = 0;
+		size_t glCallsSkipped = 0;
+	};
+
+	struct TexturePoolStats {
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t mipsCount = 0;
+		uint32_t layersCount = 0;
+		uint32_t capacity = 0;
+		// Video memory of the whole array, unused layers included
+		size_t memoryBytes = 0;
+	};
+
+	struct TextureStats {
+		std::vector<TexturePoolStats> pools;
+		// Textures with mip levels still waiting for upload
+		size_t streamingTextures = 0;
+		// Texel bytes uploaded by the last streaming update
+		size_t uploadedBytes = 0;
+	};
+}
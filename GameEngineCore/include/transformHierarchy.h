@@ -0,0 +1,128 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GameEngine {
+	using TransformId = uint32_t;
+	constexpr TransformId InvalidTransformId = UINT32_MAX;
+
+	// Parent/child transforms with local translation, rotation and scale. Nodes live in flat arrays in
+	// breadth-first order: every level of the tree is a contiguous range, parents precede their children
+	// and siblings are adjacent. update() walks the levels top-down, a level is split across the job
+	// system workers since its nodes only depend on the level above. A world matrix is recomputed only
+	// when its local transform or one of its ancestors changed.
+	//
+	// Ids stay valid until the node is destroyed, the position of a node in the arrays does not.
+	// Setters of different nodes may run concurrently, structural changes and update() may not.
+	class TransformHierarchy {
+	public:
+		TransformHierarchy() = default;
+
+		TransformHierarchy(const TransformHierarchy&) = delete;
+		TransformHierarchy(TransformHierarchy&&) = delete;
+		TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+		TransformHierarchy& operator=(TransformHierarchy&&) = delete;
+
+		TransformId create(
+			const TransformId parent = InvalidTransformId,
+			const glm::vec3& position = glm::vec3(0.f),
+			const glm::quat& rotation = glm::quat(1.f, 0.f, 0.f, 0.f),
+			const glm::vec3& scale = glm::vec3(1.f)
+		);
+		// Destroys the node together with its whole subtree
+		void destroy(const TransformId id);
+		// Keeps the local transform, the world matrix follows the new parent. Fails on a cycle.
+		bool setParent(const TransformId id, const TransformId parent);
+		void clear();
+		// Replaces every node with count new ones in a single pass, node i gets id i.
+		// fn(size_t i, TransformId& parent, glm::vec3& position, glm::quat& rotation, glm::vec3& scale) fills
+		// node i, parent defaults to none and must be less than i. Fails and leaves the hierarchy empty otherwise.
+		template<typename Fn>
+		bool assign(const size_t count, Fn&& fn);
+
+		void setPosition(const TransformId id, const glm::vec3& position);
+		void setRotation(const TransformId id, const glm::quat& rotation);
+		void setScale(const TransformId id, const glm::vec3& scale);
+		void setLocal(const TransformId id, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+
+		inline const glm::vec3& getPosition(const TransformId id) const { return m_positions[m_indices[id]]; }
+		inline const glm::quat& getRotation(const TransformId id) const { return m_rotations[m_indices[id]]; }
+		inline const glm::vec3& getScale(const TransformId id) const { return m_scales[m_indices[id]]; }
+		TransformId getParent(const TransformId id) const;
+		bool isAlive(const TransformId id) const;
+
+		// Brings every world matrix up to date, small levels stay on the calling thread
+		void update();
+
+		// Valid after update()
+		inline const glm::mat4& getWorldMatrix(const TransformId id) const { return m_worldMatrices[m_indices[id]]; }
+		// True when the world matrix changed in the last update()
+		inline bool isWorldChanged(const TransformId id) const { return m_worldVersions[m_indices[id]] == m_version; }
+
+		// Descendants of a node destroyed since the last update() are still counted
+		inline size_t size() const { return m_parents.size() - m_removedCount; }
+		inline size_t getLevelsCount() const { return m_levels.empty() ? 0 : m_levels.size() - 1; }
+		// World matrices recomputed by the last update()
+		inline size_t getUpdatedCount() const { return m_updatedCount; }
+
+		// Levels narrower than this are not worth waking up the workers
+		static constexpr size_t ParallelLevelSize = 4096;
+		static constexpr size_t ParallelGrain = 2048;
+	private:
+		static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+		// Sizes the arrays for count nodes with ids in order, every node dirty
+		void resetNodes(const size_t count);
+		void markDirty(const uint32_t index);
+		// Restores the breadth-first order after creations, reparenting and destruction
+		void rebuildOrder();
+		size_t updateRange(const size_t begin, const size_t end);
+
+		// Indexed by position in the breadth-first order
+		std::vector<uint32_t> m_parents;
+		std::vector<glm::vec3> m_positions;
+		std::vector<glm::quat> m_rotations;
+		std::vector<glm::vec3> m_scales;
+		std::vector<glm::mat4> m_worldMatrices;
+		std::vector<uint8_t> m_localDirty;
+		// update() number that last changed the world matrix, children compare it with m_version
+		std::vector<uint32_t> m_worldVersions;
+		std::vector<uint8_t> m_removed;
+		std::vector<TransformId> m_ids;
+		// First node of every level, the last entry is the nodes count
+		std::vector<uint32_t> m_levels;
+
+		// Indexed by id
+		std::vector<uint32_t> m_indices;
+		std::vector<TransformId> m_freeIds;
+
+		uint32_t m_version = 0;
+		size_t m_removedCount = 0;
+		size_t m_updatedCount = 0;
+		bool m_isOrderDirty = false;
+		std::atomic<bool> m_isAnyDirty = false;
+	};
+
+	template<typename Fn>
+	bool TransformHierarchy::assign(const size_t count, Fn&& fn)
+	{
+		resetNodes(count);
+		for (size_t i = 0; i < count; ++i) {
+			TransformId parent = InvalidTransformId;
+			fn(i, parent, m_positions[i], m_rotations[i], m_scales[i]);
+			if (parent != InvalidTransformId && parent >= i) {
+				clear();
+				return false;
+			}
+			m_parents[i] = parent == InvalidTransformId ? InvalidIndex : parent;
+		}
+		return true;
+	}
+}
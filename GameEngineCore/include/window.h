@@ -1,9 +1,9 @@
 #pragma once
 
 #include "events.h"
+#include "eventQueue.h"
 
 #include <string>
-#include <functional>
 
 #include <glm/vec2.hpp>
 
@@ -12,10 +12,10 @@ typedef unsigned int uint;
 struct GLFWwindow;
 
 namespace GameEngine {
-	using EventCallbackFn = std::function<void(BaseEvent&)>;
 	class Window {
 	public:
-		Window(uint width, uint height, std::string title);
+		// A headless window is never shown and, without a display, gets a Mesa OSMesa context
+		Window(uint width, uint height, std::string title, const bool headless = false);
 		~Window();
 
 		Window(const Window&) = delete;
@@ -27,7 +27,9 @@ namespace GameEngine {
 		inline uint getWidth() const { return winProps.width; }
 		inline uint getHeight() const { return winProps.height; }
 		inline float getAspect() const { return winProps.aspect_ratio; }
-		inline void setEventCallback(const EventCallbackFn& fn) { winProps.eventCallback = fn; }
+		inline bool isHeadless() const { return m_isHeadless; }
+		// GLFW callbacks only record events here, the application drains the queue once per frame
+		inline EventQueue& getEventQueue() { return winProps.eventQueue; }
 		glm::vec2 getCursorPos() const;
 		void enableCursor();
 		void disableCursor();
@@ -41,8 +43,9 @@ namespace GameEngine {
 			uint width, height;
 			float aspect_ratio;
 			std::string title;
-			EventCallbackFn eventCallback;
+			EventQueue eventQueue;
 		} winProps;
 		GLFWwindow* m_window;
+		bool m_isHeadless;
 	};
 }
\ No newline at end of file
@@ -1,13 +1,32 @@
 #include "application.h"
 
 #include "rendering/OpenGL/shader.h"
+#include "rendering/OpenGL/shaderCache.h"
 #include "rendering/OpenGL/vertexBuffer.h"
 #include "rendering/OpenGL/vertexArray.h"
 #include "rendering/OpenGL/indexBuffer.h"
 #include "camera.h"
 #include "rendering/OpenGL/openGL_Renderer.h"
+#include "rendering/OpenGL/batchRenderer.h"
+#include "rendering/OpenGL/uniformBuffer.h"
+#include "rendering/OpenGL/gpuTimer.h"
+#include "rendering/OpenGL/framebuffer.h"
+#include "rendering/OpenGL/frameCapture.h"
+#include "rendering/OpenGL/glState.h"
+#include "rendering/OpenGL/indirectRenderer.h"
+#include "rendering/OpenGL/textureManager.h"
+#include "rendering/culling.h"
+#include "rendering/lodSelector.h"
+#include "rendering/renderQueue.h"
+#include "resources/meshFile.h"
+#include "resources/sceneFile.h"
+#include "resources/sceneLoader.h"
 #include "modules/moduleUI.h"
 #include "input.h"
+#include "profiler.h"
+#include "components.h"
+#include "jobSystem.h"
+#include "memory/frameMemory.h"
 
 #include <imgui/imgui.h>
 
@@ -15,19 +34,94 @@
 
 #include <GLFW/glfw3.h>
 #include <log.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <memory>
+#include <vector>
 
 namespace GameEngine {
     std::unique_ptr<Shader> shader;
-    std::unique_ptr<VertexArray> vertexArray;
-    std::unique_ptr<VertexBuffer> vertexBuffer;
-    std::unique_ptr<IndexBuffer> indexBuffer;
+    std::unique_ptr<BatchRenderer> batchRenderer;
+    std::unique_ptr<IndirectRenderer> indirectRenderer;
+    std::unique_ptr<Shader> indirectShader;
+    std::unique_ptr<TextureManager> textureManager;
+    std::unique_ptr<UniformBuffer> cameraUniformBuffer;
+
+    namespace {
+        struct CameraData {
+            glm::mat4 view_matrix;
+            glm::mat4 projection_matrix;
+        };
 
-    glm::mat4 scale_matrix;
-    glm::mat4 rotate_matrix;
-    glm::mat4 model_matrix;
+        // Meshes in client memory go through the batch renderer, loaded ones stay resident on the GPU
+        // in their own vertex array and are drawn one call each
+        struct Mesh {
+            const void* vertices = nullptr;
+            size_t verticesCount = 0;
+            const uint32_t* indices = nullptr;
+            size_t indicesCount = 0;
+            BufferLayout layout;
+            Shader* shader = nullptr;
+            glm::vec3 boundsCenter = glm::vec3(0.f);
+            float boundsRadius = 0;
+
+            std::unique_ptr<VertexBuffer> vertexBuffer;
+            std::unique_ptr<IndexBuffer> indexBuffer;
+            std::unique_ptr<VertexArray> vertexArray;
+            int modelMatrixLocation = Shader::InvalidLocation;
+            // Finest first, client-memory meshes only have the full detail one
+            std::vector<LodLevel> lods;
+            // Copy in the indirect renderer's shared buffers, only meshes with its layout get one
+            uint32_t indirectMeshId = IndirectRenderer::InvalidMeshId;
+            // Cooked file the mesh was loaded from, empty for the built-in cube
+            std::string path;
+        };
+        std::vector<Mesh> meshes;
 
-    float rotate;
+        struct Renderable {
+            const Transform* transform;
+            MeshRef* meshRef;
+        };
+        // Rebuilt every frame from the scene, the visible indices in the frame arena point into both
+        std::vector<Renderable> renderables;
+        BoundingSpheres renderableBounds;
+        RenderQueue renderQueue;
+
+        // Sphere around the center of the positions' box, positions are expected in the first Float3 element
+        void computeBounds(Mesh& mesh)
+        {
+            if (mesh.verticesCount == 0 || mesh.layout.getElements().empty()
+                || mesh.layout.getElements().front().type != ShaderDataType::Float3) {
+                return;
+            }
+            const size_t stride = mesh.layout.getStride();
+            const size_t offset = mesh.layout.getElements().front().offset;
+            const auto position = [&](const size_t index) {
+                glm::vec3 value;
+                std::memcpy(&value, static_cast<const char*>(mesh.vertices) + index * stride + offset, sizeof(value));
+                return value;
+            };
+
+            glm::vec3 min = position(0);
+            glm::vec3 max = min;
+            for (size_t i = 1; i < mesh.verticesCount; ++i) {
+                min = glm::min(min, position(i));
+                max = glm::max(max, position(i));
+            }
+            mesh.boundsCenter = (min + max) * 0.5f;
+
+            float radius = 0;
+            for (size_t i = 0; i < mesh.verticesCount; ++i) {
+                radius = std::max(radius, glm::length(position(i) - mesh.boundsCenter));
+            }
+            mesh.boundsRadius = radius;
+        }
+    }
 
     float points[] = {
         -0.5,  0.5,  0.5,      1, 1, 1, // 0
@@ -53,14 +147,43 @@ namespace GameEngine {
 
         out vec4 vertexColor;
 
-		uniform float aspect_ratio;
 		uniform mat4 model_matrix;
-		uniform mat4 view_matrix;
-		uniform mat4 projection_matrix;
+
+		layout (std140, binding = 0) uniform CameraData {
+			mat4 view_matrix;
+			mat4 projection_matrix;
+		};
 
         void main(){
 			gl_Position = projection_matrix * view_matrix * model_matrix * vec4(pos, 1);
-			gl_Position.y *= aspect_ratio; 
+            vertexColor = vec4(color, 1);
+        }
+    )";
+    // Same as vertexShader, with the model matrix of the object fetched by the index of its indirect command
+    const char* indirectVertexShader = R"(
+        #version 460
+
+        layout (location = 0) in vec3 pos;
+        layout (location = 1) in vec3 color;
+
+        out vec4 vertexColor;
+
+		struct ObjectData {
+			mat4 model;
+			uint meshId;
+			uint padding[3];
+		};
+		layout (std430, binding = 0) readonly buffer Objects {
+			ObjectData objects[];
+		};
+
+		layout (std140, binding = 0) uniform CameraData {
+			mat4 view_matrix;
+			mat4 projection_matrix;
+		};
+
+        void main(){
+			gl_Position = projection_matrix * view_matrix * objects[gl_DrawID].model * vec4(pos, 1);
             vertexColor = vec4(color, 1);
         }
     )";
@@ -85,22 +208,28 @@ namespace GameEngine {
 
     }
 
-    int Application::start(uint width, uint height, const char* title)
+    int Application::start(uint width, uint height, const char* title, const ApplicationOptions& options)
     {
         LOG_INFO("Application started");
+        const auto startupBegin = std::chrono::steady_clock::now();
 
-        m_window = std::make_unique<Window>(width, height, title);
+        m_window = std::make_unique<Window>(width, height, title, options.headless);
+        JobSystem::init(jobWorkersCount);
         lastCursorPos = getCursorPos();
-
-        m_window->setEventCallback([&](BaseEvent& e) {
-            m_dispatcher.dispacth(e);
-        });
+        Input::reset(lastCursorPos);
+        camera.setAspect(m_window->getAspect());
+        OpenGL_Renderer::setDepthTest(true);
 
         m_dispatcher.addEventListener<WindowCloseEvent>([&](WindowCloseEvent& e) {
             //LOG_INFO("Window close event");
             m_isWindowClosed = true;
 
         });
+        m_dispatcher.addEventListener<WindowResizeEvent>([&](WindowResizeEvent& e) {
+            if (e.getHeight() > 0) {
+                camera.setAspect(static_cast<float>(e.getWidth()) / static_cast<float>(e.getHeight()));
+            }
+        });
         m_dispatcher.addEventListener<KeyPressedEvent>([&](KeyPressedEvent& e) {
             Input::pressKey(e.getKeyCode());
             onKeyPressed(e.getKeyCode());
@@ -117,66 +246,572 @@ namespace GameEngine {
         });
         m_dispatcher.addEventListener<MouseMovedEvent>([&](MouseMovedEvent& e) {
             //LOG_INFO("Mouse moved on {0}x{1}", e.getX(), e.getY());
+            Input::moveCursor({ static_cast<float>(e.getX()), static_cast<float>(e.getY()) });
             onMouseMoved(e.getX(), e.getY());
         });
+        m_dispatcher.addEventListener<MouseScrolledEvent>([&](MouseScrolledEvent& e) {
+            Input::scroll(static_cast<float>(e.getOffset()));
+        });
 
         // ==========================================================================================
         BufferLayout bufferLayout {
             ShaderDataType::Float3,
             ShaderDataType::Float3
         };
-        vertexArray = std::make_unique<VertexArray>();
-        vertexBuffer = std::make_unique<VertexBuffer>(points, sizeof(points), bufferLayout);
+        batchRenderer = std::make_unique<BatchRenderer>();
+        indirectRenderer = std::make_unique<IndirectRenderer>(bufferLayout);
+        textureManager = std::make_unique<TextureManager>();
+
+        cameraUniformBuffer = std::make_unique<UniformBuffer>(
+            sizeof(CameraData), static_cast<unsigned int>(UniformBlockBinding::Camera)
+        );
+
+        ShaderCache shaderCache(options.shaderCachePath);
+        shader = shaderCache.load(vertexShader, fragmentShader);
+        indirectShader = shaderCache.load(indirectVertexShader, fragmentShader);
+        shaderCache.finish();
+        LOG_INFO("Shaders ready in {0:.2f} ms, {1} from the cache, {2} compiled",
+            shaderCache.getLoadMs(), shaderCache.getHitsCount(), shaderCache.getMissesCount());
+
+        meshes.clear();
+        Mesh cube;
+        cube.vertices = points;
+        cube.verticesCount = sizeof(points) / bufferLayout.getStride();
+        cube.indices = indices;
+        cube.indicesCount = sizeof(indices) / sizeof(GLuint);
+        cube.layout = bufferLayout;
+        cube.shader = shader.get();
+        meshes.push_back(std::move(cube));
+        for (Mesh& mesh : meshes) {
+            computeBounds(mesh);
+            mesh.lods = { { 0, static_cast<uint32_t>(mesh.indicesCount), 0.f } };
+            if (mesh.layout == indirectRenderer->getLayout()) {
+                mesh.indirectMeshId = indirectRenderer->addMesh(
+                    mesh.vertices, mesh.verticesCount, mesh.indices, mesh.indicesCount, mesh.boundsCenter, mesh.boundsRadius
+                );
+            }
+        }
+        if (options.scenePath.empty() || !loadScene(options.scenePath)) {
+            // The small cube is a child of the spinning one and follows its rotation
+            const TransformId cubeNode = transforms.create();
+            scene.create(Transform{}, MeshRef{ CubeMeshId }, Spin{}, TransformNode{ cubeNode });
+            const TransformId moonNode = transforms.create(cubeNode, { 0.f, 1.2f, 0.f }, glm::quat(1.f, 0.f, 0.f, 0.f), glm::vec3(0.3f));
+            scene.create(Transform{}, MeshRef{ CubeMeshId }, TransformNode{ moonNode });
+        }
+        // =========================================================================================
 
-        indexBuffer = std::make_unique<IndexBuffer>(indices, sizeof(indices) / sizeof(GLuint));
+        GpuTimer::init();
 
-        vertexArray->addVertexBuffer(*vertexBuffer);
-        vertexArray->setIndexBuffer(*indexBuffer);
+        std::unique_ptr<Framebuffer> framebuffer;
+        std::unique_ptr<FrameCapture> frameCapture;
+        std::ofstream hashFile;
+        uint64_t combinedHash = 0;
+        if (options.headless) {
+            framebuffer = std::make_unique<Framebuffer>(width, height);
+        }
+        if (options.frameOutput != ApplicationOptions::FrameOutput::None) {
+            if (!framebuffer) {
+                LOG_ERR("Frame output needs the headless mode, frames won't be captured");
+            }
+            else if (options.frameOutput == ApplicationOptions::FrameOutput::Hash) {
+                hashFile.open(options.outputPath, std::ios::trunc);
+                if (!hashFile) {
+                    LOG_ERR("Can't create frame hash file {0}", options.outputPath);
+                }
+                frameCapture = std::make_unique<FrameCapture>(width, height, [&](const CapturedFrame& frame) {
+                    const uint64_t hash = FrameCapture::hash(frame);
+                    combinedHash = combinedHash * 31 + hash;
+                    hashFile << frame.index << ' ' << std::hex << hash << std::dec << '\n';
+                });
+            }
+            else {
+                std::error_code error;
+                std::filesystem::create_directories(options.outputPath, error);
+                frameCapture = std::make_unique<FrameCapture>(width, height, [&](const CapturedFrame& frame) {
+                    char name[32];
+                    std::snprintf(name, sizeof(name), "frame_%06llu.ppm", static_cast<unsigned long long>(frame.index));
+                    FrameCapture::writePpm((std::filesystem::path(options.outputPath) / name).string(), frame);
+                });
+            }
+        }
 
-        shader = std::make_unique<Shader>(vertexShader, fragmentShader);
-        // =========================================================================================
+        using Clock = std::chrono::steady_clock;
+        LOG_INFO("Startup took {0:.2f} ms with a {1} shader cache",
+            std::chrono::duration<double, std::milli>(Clock::now() - startupBegin).count(),
+            shaderCache.getMissesCount() == 0 ? "warm" : "cold");
+        Clock::time_point previousFrameTime = Clock::now();
+        double accumulator = 0;
+        uint64_t framesRendered = 0;
 
         while (!m_isWindowClosed) {
-            shader->bind();
-            indexBuffer->bind();
-            shader->setFloat("aspect_ratio", m_window->getAspect());
-            shader->setMat4("model_matrix", model_matrix);
-
+            Profiler::beginFrame();
+            GpuTimer::beginFrame();
+            GLState::resetStats();
+            if (framebuffer) {
+                framebuffer->bind();
+            }
+
+            const Clock::time_point frameTime = Clock::now();
+            m_frameDeltaTime = std::chrono::duration<double>(frameTime - previousFrameTime).count();
+            previousFrameTime = frameTime;
+            accumulator += options.headless ? fixedTimeStep : m_frameDeltaTime;
+            if (isReplayingInput()) {
+                m_replayFrameTimes.push_back(m_frameDeltaTime);
+            }
+
+            uint fixedSteps = 0;
+            while (accumulator >= fixedTimeStep && fixedSteps < maxFixedStepsPerFrame) {
+                PROFILE_SCOPE("Fixed update");
+                if (isReplayingInput()) {
+                    Input::captureTick(*m_inputReplayer.next());
+                }
+                else {
+                    Input::captureTick();
+                }
+                if (m_inputRecorder.isOpen()) {
+                    m_inputRecorder.write(Input::getCurrentFrame());
+                }
+                scene.view<Spin>().each([this](Entity, Spin& spin) {
+                    spin.previousAngle = spin.angle;
+                    spin.angle += spin.speed * static_cast<float>(fixedTimeStep);
+                });
+                onFixedUpdate(fixedTimeStep);
+
+                accumulator -= fixedTimeStep;
+                ++fixedSteps;
+            }
+            if (accumulator >= fixedTimeStep) {
+                accumulator = std::fmod(accumulator, fixedTimeStep);
+            }
+            m_interpolationAlpha = accumulator / fixedTimeStep;
+            if (m_inputReplayer.isOpen() && m_inputReplayer.isFinished()) {
+                LOG_INFO("Input replay finished, {0} ticks in {1} frames", m_inputReplayer.getFramesCount(), m_replayFrameTimes.size());
+                m_inputReplayer.close();
+                onInputReplayFinished(m_replayFrameTimes);
+                m_replayFrameTimes.clear();
+            }
+
+            // Before the clear, the depth clear value flips with the convention
+            OpenGL_Renderer::setReverseZ(isReverseZ);
             OpenGL_Renderer::clear();
 
-            scale_matrix = {
-                1, 0, 0, 0,
-                0, 1, 0, 0,
-                0, 0, 1, 0,
-                0, 0, 0, 1
-            };
-            
-            rotate += 0.01;
-            rotate_matrix = {
-                cos(rotate), -sin(rotate), 0, 0,
-                sin(rotate), cos(rotate), 0, 0,
-                0, 0, 1, 0,
-                0, 0, 0, 1
-            };
-            model_matrix = rotate_matrix * scale_matrix;
-
+            const float alpha = static_cast<float>(m_interpolationAlpha);
+            scene.view<const Spin, const TransformNode>().each([this, alpha](Entity, const Spin& spin, const TransformNode& node) {
+                const float angle = spin.previousAngle + (spin.angle - spin.previousAngle) * alpha;
+                transforms.setRotation(node.id, glm::angleAxis(-angle, glm::vec3(0.f, 0.f, 1.f)));
+            });
+            {
+                PROFILE_SCOPE("Transforms");
+                transforms.update();
+                scene.view<const TransformNode, Transform>().each([this](Entity, const TransformNode& node, Transform& transform) {
+                    if (transforms.isWorldChanged(node.id)) {
+                        transform.model_matrix = transforms.getWorldMatrix(node.id);
+                    }
+                });
+            }
+
+            // Cheap when nothing changed, the camera only marks its projection dirty on a new value
             camera.setProjectionMode(
                 isPerspectiveMode ? Camera::ProjectionMode::Perspective : Camera::ProjectionMode::Orthographic
             );
-            shader->setMat4("view_matrix", camera.getViewMatrix());
-            shader->setMat4("projection_matrix", camera.getProjectionMatrix());
+            camera.setReverseZ(isReverseZ);
+            const CameraData cameraData = { camera.getViewMatrix(), camera.getProjectionMatrix() };
+            cameraUniformBuffer->setData(&cameraData, sizeof(cameraData));
 
             // =========================================================================================
-            OpenGL_Renderer::draw(*vertexArray);
-            ModuleUI::updateBegin();
-            on_UI_draw();
-            ModuleUI::updateDraw();
+            uint32_t* visibleIndices = nullptr;
+            size_t visibleCount = 0;
+            {
+                PROFILE_SCOPE("Culling");
+                renderables.clear();
+                renderableBounds.clear();
+                // Objects the indirect renderer can draw skip the CPU culling, the GPU culls them on flush
+                const bool isGpuDrivenFrame = isGpuDriven && indirectRenderer->isCompiled();
+                indirectRenderer->begin();
+                scene.view<const Transform, MeshRef>().each([isGpuDrivenFrame](Entity, const Transform& transform, MeshRef& meshRef) {
+                    const Mesh& mesh = meshes[meshRef.meshId];
+                    if (isGpuDrivenFrame && mesh.indirectMeshId != IndirectRenderer::InvalidMeshId) {
+                        indirectRenderer->submit(mesh.indirectMeshId, transform.model_matrix);
+                        return;
+                    }
+                    const glm::mat4& model = transform.model_matrix;
+                    const float scale = std::max({
+                        glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))
+                    });
+                    renderableBounds.push(glm::vec3(model * glm::vec4(mesh.boundsCenter, 1.f)), mesh.boundsRadius * scale);
+                    renderables.push_back({ &transform, &meshRef });
+                });
+
+                visibleIndices = FrameMemory::getFrameArena().allocateArray<uint32_t>(renderables.size());
+                visibleCount = Culling::cullSpheresParallel(camera.getFrustum(), renderableBounds, visibleIndices);
+            }
+            {
+                PROFILE_SCOPE("Texture streaming");
+                textureManager->update(textureUploadBudget);
+            }
+            {
+                PROFILE_SCOPE("Render scene");
+                PROFILE_GPU_SCOPE("Scene");
+                // Resident meshes are recorded on the workers and sorted by state, client-memory meshes
+                // keep going through the batch renderer which groups them on its own
+                renderQueue.begin(visibleCount);
+                const glm::vec3 cameraPosition = camera.getPosition();
+                const float viewportHeight = static_cast<float>(m_window->getHeight());
+                JobSystem::parallel_for(0, visibleCount, 4096, [&](const size_t begin, const size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        const uint32_t index = visibleIndices[i];
+                        const Renderable& renderable = renderables[index];
+                        const Mesh& mesh = meshes[renderable.meshRef->meshId];
+                        if (!mesh.vertexArray) {
+                            continue;
+                        }
+                        const glm::vec3 center(
+                            renderableBounds.centerX[index], renderableBounds.centerY[index], renderableBounds.centerZ[index]
+                        );
+                        // Maps [0, inf) onto [0, 1) keeping the order, no far plane needed
+                        const float distance = glm::length(center - cameraPosition);
+
+                        uint32_t lod = 0;
+                        if (isLodEnabled && mesh.lods.size() > 1 && mesh.boundsRadius > 0) {
+                            const float scale = renderableBounds.radius[index] / mesh.boundsRadius;
+                            lod = LodSelector::select(
+                                mesh.lods.data(), mesh.lods.size(), renderable.meshRef->lod,
+                                camera.getPixelsPerUnit(distance, viewportHeight) * scale, lodPixelError
+                            );
+                        }
+                        renderable.meshRef->lod = lod;
+                        const LodLevel& level = mesh.lods[lod];
+
+                        renderQueue.push({
+                            DrawKey::make(0, mesh.shader->getSortId(), 0, mesh.vertexArray->getSortId(), distance / (distance + 1.f)),
+                            mesh.shader, mesh.vertexArray.get(), &renderable.transform->model_matrix,
+                            mesh.modelMatrixLocation, level.indicesCount, level.firstIndex
+                        });
+                    }
+                });
+                renderQueue.sort();
+                OpenGL_Renderer::execute(renderQueue.getSortedCommands(), renderQueue.size());
+
+                batchRenderer->begin();
+                RenderStats residentStats;
+                for (size_t i = 0; i < visibleCount; ++i) {
+                    const Renderable& renderable = renderables[visibleIndices[i]];
+                    const Mesh& mesh = meshes[renderable.meshRef->meshId];
+                    if (mesh.vertexArray) {
+                        ++residentStats.drawCalls;
+                        ++residentStats.submissions;
+                        residentStats.vertices += mesh.verticesCount;
+                        residentStats.indices += mesh.lods[renderable.meshRef->lod].indicesCount;
+                        residentStats.fullDetailIndices += mesh.lods[0].indicesCount;
+                        continue;
+                    }
+                    batchRenderer->submit(
+                        *mesh.shader, mesh.layout,
+                        mesh.vertices, mesh.verticesCount,
+                        mesh.indices, mesh.indicesCount,
+                        renderable.transform->model_matrix
+                    );
+                }
+                batchRenderer->flush();
+                indirectRenderer->flush(*indirectShader, camera.getFrustum());
+                m_renderStats = batchRenderer->getStats();
+                m_renderStats.drawCalls += indirectRenderer->getStats().drawCalls;
+                m_renderStats.submissions += indirectRenderer->getStats().submissions;
+                m_renderStats.indices += indirectRenderer->getStats().indices;
+                m_renderStats.fenceWaits += indirectRenderer->getStats().fenceWaits;
+                m_renderStats.drawCalls += residentStats.drawCalls;
+                m_renderStats.submissions += residentStats.submissions;
+                m_renderStats.vertices += residentStats.vertices;
+                m_renderStats.indices += residentStats.indices;
+                // Only resident meshes have levels of detail, everything else is drawn at full detail
+                m_renderStats.fullDetailIndices = m_renderStats.indices - residentStats.indices + residentStats.fullDetailIndices;
+                m_renderStats.culledObjects = renderables.size() - visibleCount;
+                m_renderStats.stateChangesUnsorted = renderQueue.getStateChangesUnsorted();
+                m_renderStats.stateChangesSorted = renderQueue.getStateChangesSorted();
+                // Counted from the frame start, the UI pass below lands in the next frame's reset
+                m_renderStats.glCallsIssued = GLState::getStats().issuedCalls;
+                m_renderStats.glCallsSkipped = GLState::getStats().skippedCalls;
+            }
+
+            if (!options.headless) {
+                PROFILE_SCOPE("UI");
+                PROFILE_GPU_SCOPE("UI");
+                ModuleUI::updateBegin();
+                on_UI_draw();
+                ModuleUI::updateDraw();
+            }
+            if (frameCapture) {
+                frameCapture->capture(*framebuffer);
+            }
             // =========================================================================================
 
             m_window->onUpdate();
-            onUpdate();
+            {
+                PROFILE_SCOPE("Dispatch events");
+                m_window->getEventQueue().dispatch(m_dispatcher);
+            }
+            {
+                PROFILE_SCOPE("onUpdate");
+                onUpdate(m_frameDeltaTime);
+            }
+
+            Profiler::endFrame();
+            FrameMemory::endFrame();
+
+            ++framesRendered;
+            if (options.framesCount != 0 && framesRendered >= options.framesCount) {
+                m_isWindowClosed = true;
+            }
         }
 
+        if (frameCapture) {
+            frameCapture->flush();
+            LOG_INFO("Captured {0} frames, {1} readback stalls", frameCapture->getDeliveredCount(), frameCapture->getStallsCount());
+            if (options.frameOutput == ApplicationOptions::FrameOutput::Hash) {
+                LOG_INFO("Frames hash {0:016x}", combinedHash);
+            }
+            frameCapture.reset();
+        }
+        framebuffer.reset();
+        GpuTimer::shutdown();
+        JobSystem::shutdown();
+        m_inputRecorder.close();
+        meshes.clear();
+        indirectRenderer.reset();
+        indirectShader.reset();
+        textureManager.reset();
+
         return 0;
     }
+
+    bool Application::recordInput(const std::string& path)
+    {
+        if (!m_inputRecorder.open(path, fixedTimeStep)) {
+            return false;
+        }
+        LOG_INFO("Recording input to {0}", path);
+        return true;
+    }
+
+    bool Application::replayInput(const std::string& path)
+    {
+        if (!m_inputReplayer.open(path)) {
+            return false;
+        }
+        fixedTimeStep = m_inputReplayer.getFixedTimeStep();
+        m_replayFrameTimes.clear();
+        m_replayFrameTimes.reserve(m_inputReplayer.getFramesCount());
+        LOG_INFO("Replaying {0} ticks of input from {1}", m_inputReplayer.getFramesCount(), path);
+        return true;
+    }
+
+    uint32_t Application::loadMesh(const std::string& path)
+    {
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point begin = Clock::now();
+
+        MeshFile file;
+        if (!file.open(path)) {
+            return InvalidMeshId;
+        }
+        const Clock::time_point mapped = Clock::now();
+
+        Mesh mesh;
+        mesh.verticesCount = file.getVerticesCount();
+        mesh.indicesCount = file.getIndicesCount();
+        mesh.layout = file.getLayout();
+        mesh.shader = shader.get();
+        mesh.path = path;
+        // The blobs already match the layout, they go from the mapping to the driver without a copy on our side
+        mesh.vertexBuffer = std::make_unique<VertexBuffer>(
+            file.getVertices(), file.getVerticesCount() * file.getLayout().getStride(), file.getLayout()
+        );
+        // Every level of detail is a range of the same index buffer
+        mesh.indexBuffer = std::make_unique<IndexBuffer>(file.getIndices(), file.getIndicesCount());
+        mesh.vertexArray = std::make_unique<VertexArray>();
+        mesh.vertexArray->addVertexBuffer(*mesh.vertexBuffer);
+        mesh.vertexArray->setIndexBuffer(*mesh.indexBuffer);
+        mesh.modelMatrixLocation = mesh.shader->getUniformLocation("model_matrix");
+        for (size_t i = 0; i < file.getLodsCount(); ++i) {
+            const MeshFileLod& lod = file.getLod(i);
+            mesh.lods.push_back({ lod.firstIndex, lod.indicesCount, lod.error });
+        }
+        mesh.indicesCount = mesh.lods[0].indicesCount;
+
+        const MeshFileHeader& header = *file.getHeader();
+        const glm::vec3 boundsMin = { header.boundsMin[0], header.boundsMin[1], header.boundsMin[2] };
+        const glm::vec3 boundsMax = { header.boundsMax[0], header.boundsMax[1], header.boundsMax[2] };
+        mesh.boundsCenter = (boundsMin + boundsMax) * 0.5f;
+        mesh.boundsRadius = glm::length(boundsMax - boundsMin) * 0.5f;
+        if (mesh.layout == indirectRenderer->getLayout()) {
+            // The GPU-driven path draws the full detail level only
+            mesh.indirectMeshId = indirectRenderer->addMesh(
+                file.getVertices(), file.getVerticesCount(), file.getIndices() + mesh.lods[0].firstIndex, mesh.lods[0].indicesCount,
+                mesh.boundsCenter, mesh.boundsRadius
+            );
+        }
+
+        const auto toMs = [](const Clock::duration duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        };
+        const Clock::time_point uploaded = Clock::now();
+        LOG_INFO("Mesh {0} loaded: {1} vertices, {2} indices, {3} levels of detail in {4:.2f} ms (map {5:.2f} ms, upload {6:.2f} ms)",
+            path, mesh.verticesCount, mesh.indicesCount, mesh.lods.size(),
+            toMs(uploaded - begin), toMs(mapped - begin), toMs(uploaded - mapped));
+
+        meshes.push_back(std::move(mesh));
+        return static_cast<uint32_t>(meshes.size() - 1);
+    }
+
+    uint32_t Application::loadTexture(const std::string& path)
+    {
+        const uint32_t id = textureManager->load(path);
+        if (id != InvalidTextureId) {
+            LOG_INFO("Texture {0} loaded into layer {1} of pool {2}, {3} mips left to stream",
+                path, textureManager->getLayer(id), textureManager->getPoolIndex(id), textureManager->getResidentMip(id));
+        }
+        return id;
+    }
+
+    bool Application::saveScene(const std::string& path)
+    {
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point begin = Clock::now();
+
+        SceneSnapshot snapshot;
+        // File indices of the nodes and meshes already stored, indexed by TransformId and mesh id
+        std::vector<uint32_t> nodeIndices;
+        std::vector<uint32_t> meshIndices(meshes.size(), SceneFileHeader::InvalidIndex);
+        std::vector<TransformId> ancestors;
+        // Stores the node after its unstored ancestors, so that parents precede their children
+        const auto storeNode = [&](const TransformId id) {
+            for (TransformId node = id; node != InvalidTransformId; node = transforms.getParent(node)) {
+                if (node < nodeIndices.size() && nodeIndices[node] != SceneFileHeader::InvalidIndex) {
+                    break;
+                }
+                ancestors.push_back(node);
+            }
+            for (auto it = ancestors.rbegin(); it != ancestors.rend(); ++it) {
+                const TransformId parent = transforms.getParent(*it);
+                const glm::vec3& position = transforms.getPosition(*it);
+                const glm::quat& rotation = transforms.getRotation(*it);
+                const glm::vec3& scale = transforms.getScale(*it);
+                snapshot.nodes.push_back({
+                    parent == InvalidTransformId ? SceneFileHeader::InvalidIndex : nodeIndices[parent],
+                    { position.x, position.y, position.z },
+                    { rotation.x, rotation.y, rotation.z, rotation.w },
+                    { scale.x, scale.y, scale.z },
+                    0
+                });
+                if (*it >= nodeIndices.size()) {
+                    nodeIndices.resize(*it + 1, SceneFileHeader::InvalidIndex);
+                }
+                nodeIndices[*it] = static_cast<uint32_t>(snapshot.nodes.size() - 1);
+            }
+            ancestors.clear();
+            return nodeIndices[id];
+        };
+
+        // Components a scene file has a table for, anything else is dropped with a warning
+        const ComponentMask storedMask = getComponentMask<Transform>() | getComponentMask<TransformNode>()
+            | getComponentMask<MeshRef>() | getComponentMask<Spin>();
+        size_t droppedCount = 0;
+        for (const auto& archetype : scene.getArchetypes()) {
+            if ((archetype->getMask() & ~storedMask) != 0 || (archetype->getMask() & getComponentMask<Transform>()) == 0) {
+                droppedCount += archetype->getCount();
+            }
+        }
+        if (droppedCount > 0) {
+            LOG_WARN("Scene {0}: {1} entities have no Transform or components a scene file can't store, they are saved without them",
+                path, droppedCount);
+        }
+
+        snapshot.entities.reserve(scene.size());
+        scene.view<Transform>().each([&](const Entity entity, const Transform& transform) {
+            SceneEntity stored = { SceneFileHeader::InvalidIndex, SceneFileHeader::InvalidIndex, SceneFileHeader::InvalidIndex, SceneFileHeader::InvalidIndex };
+            const TransformNode* node = scene.tryGet<TransformNode>(entity);
+            if (node && transforms.isAlive(node->id)) {
+                stored.node = storeNode(node->id);
+            }
+            else {
+                stored.matrix = static_cast<uint32_t>(snapshot.matrices.size());
+                SceneMatrix& matrix = snapshot.matrices.emplace_back();
+                std::memcpy(matrix.values, &transform.model_matrix, sizeof(matrix.values));
+            }
+            const MeshRef* meshRef = scene.tryGet<MeshRef>(entity);
+            if (meshRef && meshRef->meshId < meshes.size()) {
+                uint32_t& mesh = meshIndices[meshRef->meshId];
+                if (mesh == SceneFileHeader::InvalidIndex) {
+                    mesh = static_cast<uint32_t>(snapshot.meshPaths.size());
+                    snapshot.meshPaths.push_back(meshes[meshRef->meshId].path);
+                }
+                stored.mesh = mesh;
+            }
+            if (const Spin* spin = scene.tryGet<Spin>(entity)) {
+                stored.spin = static_cast<uint32_t>(snapshot.spins.size());
+                snapshot.spins.push_back({ spin->angle, spin->speed });
+            }
+            snapshot.entities.push_back(stored);
+        });
+        const Clock::time_point captured = Clock::now();
+
+        SceneSaveStats stats;
+        if (!SceneFile::write(path, snapshot, &stats)) {
+            return false;
+        }
+
+        const auto toMs = [](const Clock::duration duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        };
+        LOG_INFO("Scene {0} saved: {1} entities, {2} nodes, {3}/{4} chunks written ({5}) in {6:.2f} ms (capture {7:.2f} ms)",
+            path, snapshot.entities.size(), snapshot.nodes.size(), stats.chunksWritten, stats.chunksCount,
+            stats.isIncremental ? "incremental" : "full", toMs(Clock::now() - begin), toMs(captured - begin));
+        return true;
+    }
+
+    bool Application::loadScene(const std::string& path)
+    {
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point begin = Clock::now();
+
+        SceneFile file;
+        if (!file.open(path)) {
+            return false;
+        }
+        const Clock::time_point mapped = Clock::now();
+
+        std::vector<uint32_t> meshIds(file.getMeshesCount());
+        for (size_t i = 0; i < meshIds.size(); ++i) {
+            const std::string meshPath(file.getMeshPath(i));
+            if (meshPath.empty()) {
+                meshIds[i] = CubeMeshId;
+                continue;
+            }
+            const auto loaded = std::find_if(meshes.begin(), meshes.end(), [&](const Mesh& mesh) { return mesh.path == meshPath; });
+            meshIds[i] = loaded != meshes.end() ? static_cast<uint32_t>(loaded - meshes.begin()) : loadMesh(meshPath);
+            if (meshIds[i] == InvalidMeshId) {
+                LOG_ERR("Scene {0} needs mesh {1}", path, meshPath);
+                return false;
+            }
+        }
+        const Clock::time_point meshesLoaded = Clock::now();
+
+        if (!SceneLoader::instantiate(file, meshIds, scene, transforms)) {
+            LOG_ERR("Scene file {0} is corrupted", path);
+            return false;
+        }
+
+        const auto toMs = [](const Clock::duration duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        };
+        LOG_INFO("Scene {0} loaded: {1} entities, {2} nodes, {3} meshes in {4:.2f} ms (map {5:.2f} ms, meshes {6:.2f} ms, instantiate {7:.2f} ms)",
+            path, file.getEntitiesCount(), file.getNodesCount(), meshIds.size(), toMs(Clock::now() - begin), toMs(mapped - begin),
+            toMs(meshesLoaded - mapped), toMs(Clock::now() - meshesLoaded));
+        return true;
+    }
+
+    TextureStats Application::getTextureStats() const
+    {
+        return textureManager ? textureManager->getStats() : TextureStats();
+    }
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "ecs/archetype.h"
+
+namespace GameEngine {
+	namespace {
+		inline size_t alignUp(const size_t value, const size_t alignment)
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+	}
+
+	void Archetype::ChunkDeleter::operator()(uint8_t* chunk) const
+	{
+		::operator delete[](chunk, std::align_val_t(ChunkAlignment));
+	}
+
+	Archetype::Archetype(const ComponentMask mask)
+		: m_mask(mask)
+	{
+		m_columnByComponent.fill(-1);
+		for (ComponentId id = 0; id < MaxComponentTypes; ++id) {
+			if (mask & (ComponentMask(1) << id)) {
+				m_columnByComponent[id] = static_cast<int8_t>(m_components.size());
+				m_components.push_back(id);
+				m_columnInfos.push_back(&ComponentRegistry::getInfo(id));
+			}
+		}
+		m_columnOffsets.resize(m_components.size());
+
+		size_t rowSize = sizeof(Entity);
+		for (const ComponentInfo* info : m_columnInfos) {
+			rowSize += info->size;
+		}
+
+		// Fit as many rows as possible into ChunkSize once per-column alignment padding is accounted for
+		auto layoutSize = [this](const size_t capacity) {
+			size_t offset = sizeof(Entity) * capacity;
+			for (size_t column = 0; column < m_columnInfos.size(); ++column) {
+				offset = alignUp(offset, m_columnInfos[column]->alignment);
+				m_columnOffsets[column] = offset;
+				offset += m_columnInfos[column]->size * capacity;
+			}
+			return offset;
+		};
+		m_chunkCapacity = rowSize < ChunkSize ? ChunkSize / rowSize : 1;
+		while (m_chunkCapacity > 1 && layoutSize(m_chunkCapacity) > ChunkSize) {
+			--m_chunkCapacity;
+		}
+		m_chunkBytes = alignUp(layoutSize(m_chunkCapacity), ChunkAlignment);
+	}
+
+	Archetype::~Archetype()
+	{
+		for (size_t row = 0; row < m_count; ++row) {
+			destroyRow(row);
+		}
+	}
+
+	size_t Archetype::allocateRow(const Entity entity)
+	{
+		if (m_count == m_chunks.size() * m_chunkCapacity) {
+			m_chunks.emplace_back(new (std::align_val_t(ChunkAlignment)) uint8_t[m_chunkBytes]);
+		}
+		const size_t row = m_count++;
+		getEntities(row / m_chunkCapacity)[row % m_chunkCapacity] = entity;
+		return row;
+	}
+
+	size_t Archetype::allocateRows(const size_t count)
+	{
+		const size_t first = m_count;
+		m_count += count;
+		const size_t chunksCount = (m_count + m_chunkCapacity - 1) / m_chunkCapacity;
+		m_chunks.reserve(chunksCount);
+		while (m_chunks.size() < chunksCount) {
+			m_chunks.emplace_back(new (std::align_val_t(ChunkAlignment)) uint8_t[m_chunkBytes]);
+		}
+		return first;
+	}
+
+	Entity Archetype::removeRow(const size_t row, const bool destroyComponents)
+	{
+		if (destroyComponents) {
+			destroyRow(row);
+		}
+
+		const size_t last = m_count - 1;
+		Entity moved;
+		if (row != last) {
+			for (size_t column = 0; column < m_columnInfos.size(); ++column) {
+				relocateComponent(*m_columnInfos[column], getComponent(row, static_cast<int>(column)), getComponent(last, static_cast<int>(column)));
+			}
+			moved = getEntity(last);
+			getEntities(row / m_chunkCapacity)[row % m_chunkCapacity] = moved;
+		}
+		--m_count;
+
+		// Keep one spare chunk around so an entity bouncing between two archetypes doesn't reallocate
+		if (m_chunks.size() > 1 && (m_chunks.size() - 2) * m_chunkCapacity >= m_count) {
+			m_chunks.pop_back();
+		}
+		return moved;
+	}
+
+	void Archetype::destroyRow(const size_t row)
+	{
+		for (size_t column = 0; column < m_columnInfos.size(); ++column) {
+			if (!m_columnInfos[column]->isTriviallyRelocatable) {
+				m_columnInfos[column]->destroy(getComponent(row, static_cast<int>(column)));
+			}
+		}
+	}
+}
@@ -0,0 +1,41 @@
+#define LOG_MODULE Ecs
+
+#include "ecs/component.h"
+
+#include <log.h>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+
+namespace GameEngine {
+	namespace {
+		std::array<ComponentInfo, MaxComponentTypes> s_infos;
+		std::atomic<ComponentId> s_count = 0;
+		std::mutex s_registerMutex;
+	}
+
+	ComponentId ComponentRegistry::registerComponent(const ComponentInfo& info)
+	{
+		std::lock_guard<std::mutex> lock(s_registerMutex);
+		const ComponentId id = s_count.load(std::memory_order_relaxed);
+		if (id == MaxComponentTypes) {
+			LOG_CRIT("Too many component types, the limit is {}", MaxComponentTypes);
+			std::abort();
+		}
+		s_infos[id] = info;
+		s_count.store(id + 1, std::memory_order_release);
+		return id;
+	}
+
+	const ComponentInfo& ComponentRegistry::getInfo(const ComponentId id)
+	{
+		return s_infos[id];
+	}
+
+	size_t ComponentRegistry::getCount()
+	{
+		return s_count.load(std::memory_order_acquire);
+	}
+}
@@ -0,0 +1,139 @@
+#include "ecs/registry.h"
+
+namespace GameEngine {
+	Registry::Registry()
+	{
+		getArchetype(0);
+	}
+
+	Registry::~Registry() = default;
+
+	Entity Registry::allocateEntity()
+	{
+		Entity entity;
+		if (!m_freeIndices.empty()) {
+			entity.index = m_freeIndices.back();
+			m_freeIndices.pop_back();
+		}
+		else {
+			entity.index = static_cast<uint32_t>(m_records.size());
+			m_records.emplace_back();
+		}
+		entity.generation = m_records[entity.index].generation;
+		++m_aliveCount;
+		return entity;
+	}
+
+	Entity Registry::create()
+	{
+		Archetype* archetype = getArchetype(0);
+		const Entity entity = allocateEntity();
+		m_records[entity.index].archetype = archetype;
+		m_records[entity.index].row = archetype->allocateRow(entity);
+		return entity;
+	}
+
+	void Registry::destroy(const Entity entity)
+	{
+		if (!isAlive(entity)) {
+			return;
+		}
+		EntityRecord& record = m_records[entity.index];
+		const Entity moved = record.archetype->removeRow(record.row, true);
+		if (moved.isValid()) {
+			m_records[moved.index].row = record.row;
+		}
+
+		record.archetype = nullptr;
+		++record.generation;
+		m_freeIndices.push_back(entity.index);
+		--m_aliveCount;
+	}
+
+	void Registry::clear()
+	{
+		m_archetypeByMask.clear();
+		m_archetypes.clear();
+		m_freeIndices.clear();
+		for (uint32_t index = static_cast<uint32_t>(m_records.size()); index > 0; --index) {
+			EntityRecord& record = m_records[index - 1];
+			if (record.archetype) {
+				record.archetype = nullptr;
+				++record.generation;
+			}
+			m_freeIndices.push_back(index - 1);
+		}
+		m_aliveCount = 0;
+		getArchetype(0);
+	}
+
+	bool Registry::isAlive(const Entity entity) const
+	{
+		return entity.index < m_records.size()
+			&& m_records[entity.index].generation == entity.generation
+			&& m_records[entity.index].archetype != nullptr;
+	}
+
+	Archetype* Registry::getArchetype(const ComponentMask mask)
+	{
+		const auto it = m_archetypeByMask.find(mask);
+		if (it != m_archetypeByMask.end()) {
+			return it->second;
+		}
+		m_archetypes.push_back(std::make_unique<Archetype>(mask));
+		Archetype* archetype = m_archetypes.back().get();
+		m_archetypeByMask.emplace(mask, archetype);
+		return archetype;
+	}
+
+	Archetype* Registry::getArchetypeWith(Archetype* source, const ComponentId id)
+	{
+		Archetype* target = source->getAddEdge(id);
+		if (!target) {
+			target = getArchetype(source->getMask() | (ComponentMask(1) << id));
+			source->setAddEdge(id, target);
+			target->setRemoveEdge(id, source);
+		}
+		return target;
+	}
+
+	Archetype* Registry::getArchetypeWithout(Archetype* source, const ComponentId id)
+	{
+		Archetype* target = source->getRemoveEdge(id);
+		if (!target) {
+			target = getArchetype(source->getMask() & ~(ComponentMask(1) << id));
+			source->setRemoveEdge(id, target);
+			target->setAddEdge(id, source);
+		}
+		return target;
+	}
+
+	void Registry::moveEntity(const Entity entity, Archetype* target)
+	{
+		EntityRecord& record = m_records[entity.index];
+		Archetype* source = record.archetype;
+		const size_t sourceRow = record.row;
+		const size_t targetRow = target->allocateRow(entity);
+
+		const std::vector<ComponentId>& components = source->getComponents();
+		for (size_t column = 0; column < components.size(); ++column) {
+			const ComponentInfo& info = ComponentRegistry::getInfo(components[column]);
+			void* sourceComponent = source->getComponent(sourceRow, static_cast<int>(column));
+
+			const int targetColumn = target->getColumn(components[column]);
+			if (targetColumn >= 0) {
+				relocateComponent(info, target->getComponent(targetRow, targetColumn), sourceComponent);
+			}
+			else if (!info.isTriviallyRelocatable) {
+				info.destroy(sourceComponent);
+			}
+		}
+
+		const Entity moved = source->removeRow(sourceRow, false);
+		if (moved.isValid()) {
+			m_records[moved.index].row = sourceRow;
+		}
+		record.archetype = target;
+		record.row = targetRow;
+	}
+}
@@ -0,0 +1,49 @@
+#include "eventQueue.h"
+
+#include <log.h>
+#include <profiler.h>
+
+namespace GameEngine {
+	EventQueue::EventQueue(const size_t capacity)
+		: m_capacity(capacity)
+	{
+		m_events.reserve(capacity);
+		m_dispatching.reserve(capacity);
+	}
+
+	void EventQueue::push(const Event& event)
+	{
+		if (!m_events.empty() && m_events.back().index() == event.index()) {
+			Event& last = m_events.back();
+			if (const auto* scroll = std::get_if<MouseScrolledEvent>(&event)) {
+				last = MouseScrolledEvent(std::get<MouseScrolledEvent>(last).getOffset() + scroll->getOffset());
+				++m_coalescedCount;
+				return;
+			}
+			if (std::holds_alternative<MouseMovedEvent>(event) || std::holds_alternative<WindowResizeEvent>(event)) {
+				last = event;
+				++m_coalescedCount;
+				return;
+			}
+		}
+
+		if (m_events.size() == m_capacity) {
+			m_capacity *= 2;
+			LOG_WARN("Event queue is full, growing to {0} events", m_capacity);
+			m_events.reserve(m_capacity);
+			m_dispatching.reserve(m_capacity);
+		}
+		m_events.push_back(event);
+	}
+
+	void EventQueue::dispatch(EventDispathcer& dispatcher)
+	{
+		PROFILE_FUNCTION();
+		// Listeners may push new events, those wait for the next drain
+		m_dispatching.swap(m_events);
+		for (Event& event : m_dispatching) {
+			std::visit([&dispatcher](auto& e) { dispatcher.dispacth(e); }, event);
+		}
+		m_dispatching.clear();
+	}
+}
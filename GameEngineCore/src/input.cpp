@@ -1,35 +1,125 @@
 #include "keys.h"
 #include "input.h"
 
-bool GameEngine::Input::s_keysPressed[static_cast<size_t>(KeyCode::KEY_LAST)] = {};
-bool GameEngine::Input::s_mouseButtonsPressed[static_cast<size_t>(MouseButton::KEY_LAST) + 1] = {};
+GameEngine::InputFrame GameEngine::Input::s_current;
+GameEngine::InputFrame GameEngine::Input::s_previous;
+GameEngine::InputFrame GameEngine::Input::s_pending;
+GameEngine::InputFrame GameEngine::Input::s_deferredReleases;
 
 bool GameEngine::Input::isKeyPressed(const KeyCode keyCode)
 {
-	return s_keysPressed[static_cast<size_t>(keyCode)];
+	return s_current.isKeyDown(keyCode);
 }
 
-void GameEngine::Input::pressKey(const KeyCode keyCode)
+bool GameEngine::Input::isKeyJustPressed(const KeyCode keyCode)
 {
-	s_keysPressed[static_cast<size_t>(keyCode)] = true;
+	return s_current.isKeyDown(keyCode) && !s_previous.isKeyDown(keyCode);
 }
 
-void GameEngine::Input::releaseKey(const KeyCode keyCode)
+bool GameEngine::Input::isKeyJustReleased(const KeyCode keyCode)
 {
-	s_keysPressed[static_cast<size_t>(keyCode)] = false;
+	return !s_current.isKeyDown(keyCode) && s_previous.isKeyDown(keyCode);
 }
 
 bool GameEngine::Input::isMouseButtonPressed(const MouseButton mouseButtonCode)
 {
-	return s_mouseButtonsPressed[static_cast<size_t>(mouseButtonCode)];
+	return s_current.isMouseButtonDown(mouseButtonCode);
+}
+
+bool GameEngine::Input::isMouseButtonJustPressed(const MouseButton mouseButtonCode)
+{
+	return s_current.isMouseButtonDown(mouseButtonCode) && !s_previous.isMouseButtonDown(mouseButtonCode);
+}
+
+bool GameEngine::Input::isMouseButtonJustReleased(const MouseButton mouseButtonCode)
+{
+	return !s_current.isMouseButtonDown(mouseButtonCode) && s_previous.isMouseButtonDown(mouseButtonCode);
+}
+
+glm::vec2 GameEngine::Input::getCursorPos()
+{
+	return s_current.cursorPos;
+}
+
+glm::vec2 GameEngine::Input::getCursorDelta()
+{
+	return s_current.cursorPos - s_previous.cursorPos;
+}
+
+float GameEngine::Input::getScrollOffset()
+{
+	return s_current.scrollOffset;
+}
+
+void GameEngine::Input::pressKey(const KeyCode keyCode)
+{
+	s_pending.setKey(keyCode, true);
+	s_deferredReleases.setKey(keyCode, false);
+}
+
+void GameEngine::Input::releaseKey(const KeyCode keyCode)
+{
+	if (s_pending.isKeyDown(keyCode) && !s_current.isKeyDown(keyCode)) {
+		s_deferredReleases.setKey(keyCode, true);
+		return;
+	}
+	s_pending.setKey(keyCode, false);
 }
 
 void GameEngine::Input::pressMouseButton(const MouseButton mouseButtonCode)
 {
-	s_mouseButtonsPressed[static_cast<size_t>(mouseButtonCode)] = true;
+	s_pending.setMouseButton(mouseButtonCode, true);
+	s_deferredReleases.setMouseButton(mouseButtonCode, false);
 }
 
 void GameEngine::Input::releaseMouseButton(const MouseButton mouseButtonCode)
 {
-	s_mouseButtonsPressed[static_cast<size_t>(mouseButtonCode)] = false;
+	if (s_pending.isMouseButtonDown(mouseButtonCode) && !s_current.isMouseButtonDown(mouseButtonCode)) {
+		s_deferredReleases.setMouseButton(mouseButtonCode, true);
+		return;
+	}
+	s_pending.setMouseButton(mouseButtonCode, false);
+}
+
+void GameEngine::Input::moveCursor(const glm::vec2& pos)
+{
+	s_pending.cursorPos = pos;
+}
+
+void GameEngine::Input::scroll(const float offset)
+{
+	s_pending.scrollOffset += offset;
+}
+
+void GameEngine::Input::reset(const glm::vec2& cursorPos)
+{
+	s_pending = InputFrame();
+	s_pending.cursorPos = cursorPos;
+	s_deferredReleases = InputFrame();
+	s_current = s_pending;
+	s_previous = s_pending;
+}
+
+void GameEngine::Input::captureTick()
+{
+	advance(s_pending);
+
+	s_pending.scrollOffset = 0;
+	for (size_t word = 0; word < InputFrame::KeyWordsCount; ++word) {
+		s_pending.keys[word] &= ~s_deferredReleases.keys[word];
+		s_deferredReleases.keys[word] = 0;
+	}
+	s_pending.mouseButtons &= ~s_deferredReleases.mouseButtons;
+	s_deferredReleases.mouseButtons = 0;
+}
+
+void GameEngine::Input::captureTick(const InputFrame& frame)
+{
+	advance(frame);
+}
+
+void GameEngine::Input::advance(const InputFrame& frame)
+{
+	s_previous = s_current;
+	s_current = frame;
 }
@@ -0,0 +1,95 @@
+#include "inputRecorder.h"
+
+#include <log.h>
+
+namespace GameEngine {
+	InputRecorder::~InputRecorder()
+	{
+		close();
+	}
+
+	bool InputRecorder::open(const std::string& path, const double fixedTimeStep)
+	{
+		close();
+
+		m_file.open(path, std::ios::binary | std::ios::trunc);
+		if (!m_file) {
+			LOG_ERR("Can't create input recording {0}", path);
+			return false;
+		}
+
+		m_header = {};
+		m_header.magic = InputRecordingHeader::Magic;
+		m_header.version = InputRecordingHeader::Version;
+		m_header.frameSize = sizeof(InputFrame);
+		m_header.fixedTimeStep = fixedTimeStep;
+		m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+		return true;
+	}
+
+	void InputRecorder::close()
+	{
+		if (!m_file.is_open()) {
+			return;
+		}
+
+		m_file.seekp(0);
+		m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+		if (!m_file) {
+			LOG_ERR("Failed writing input recording");
+		}
+		m_file.close();
+		LOG_INFO("Input recording closed, {0} ticks", m_header.framesCount);
+	}
+
+	void InputRecorder::write(const InputFrame& frame)
+	{
+		m_file.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+		++m_header.framesCount;
+	}
+
+	bool InputReplayer::open(const std::string& path)
+	{
+		close();
+
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			LOG_ERR("Can't open input recording {0}", path);
+			return false;
+		}
+
+		InputRecordingHeader header;
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+			|| header.magic != InputRecordingHeader::Magic
+			|| header.version != InputRecordingHeader::Version
+			|| header.frameSize != sizeof(InputFrame)) {
+			LOG_ERR("{0} is not an input recording of version {1}", path, InputRecordingHeader::Version);
+			return false;
+		}
+
+		if (header.framesCount == 0) {
+			LOG_ERR("Input recording {0} is empty", path);
+			return false;
+		}
+		m_frames.resize(header.framesCount);
+		if (!file.read(reinterpret_cast<char*>(m_frames.data()), static_cast<std::streamsize>(m_frames.size() * sizeof(InputFrame)))) {
+			LOG_ERR("Input recording {0} is truncated", path);
+			m_frames.clear();
+			return false;
+		}
+		m_fixedTimeStep = header.fixedTimeStep;
+		return true;
+	}
+
+	void InputReplayer::close()
+	{
+		m_frames.clear();
+		m_tick = 0;
+		m_fixedTimeStep = 0;
+	}
+
+	const InputFrame* InputReplayer::next()
+	{
+		return isFinished() ? nullptr : &m_frames[m_tick++];
+	}
+}
@@ -0,0 +1,253 @@
+#define LOG_MODULE Jobs
+
+#include "jobSystem.h"
+
+#include <log.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GameEngine {
+	namespace {
+		// Chase-Lev deque with a fixed ring: the owner pushes and pops at the bottom, thieves take from the top
+		class WorkStealingDeque {
+		public:
+			static constexpr int64_t Capacity = 4096;
+
+			bool push(const Job& job)
+			{
+				const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+				const int64_t top = m_top.load(std::memory_order_acquire);
+				if (bottom - top >= Capacity) {
+					return false;
+				}
+				m_jobs[bottom & (Capacity - 1)] = job;
+				std::atomic_thread_fence(std::memory_order_release);
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return true;
+			}
+
+			bool pop(Job& job)
+			{
+				const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+				m_bottom.store(bottom, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				int64_t top = m_top.load(std::memory_order_relaxed);
+
+				if (top > bottom) {
+					m_bottom.store(bottom + 1, std::memory_order_relaxed);
+					return false;
+				}
+				job = m_jobs[bottom & (Capacity - 1)];
+				if (top == bottom) {
+					// Last job, race the thieves for it
+					const bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+					m_bottom.store(bottom + 1, std::memory_order_relaxed);
+					return won;
+				}
+				return true;
+			}
+
+			bool steal(Job& job)
+			{
+				int64_t top = m_top.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+				if (top >= bottom) {
+					return false;
+				}
+				job = m_jobs[top & (Capacity - 1)];
+				return m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			}
+		private:
+			alignas(64) std::atomic<int64_t> m_top = 0;
+			alignas(64) std::atomic<int64_t> m_bottom = 0;
+			Job m_jobs[Capacity];
+		};
+
+		struct JobSystemState {
+			std::vector<std::unique_ptr<WorkStealingDeque>> deques;
+			std::vector<std::thread> threads;
+
+			// Jobs submitted from threads the job system doesn't own
+			std::mutex injectedMutex;
+			std::deque<Job> injectedJobs;
+
+			std::mutex sleepMutex;
+			std::condition_variable wakeUp;
+			std::atomic<int32_t> pendingJobs = 0;
+			std::atomic<uint32_t> sleepingWorkers = 0;
+			std::atomic<bool> isRunning = false;
+		};
+
+		JobSystemState s_state;
+		thread_local int tl_workerIndex = -1;
+		thread_local uint32_t tl_random = 0x9E3779B9u;
+
+		inline uint32_t nextRandom()
+		{
+			tl_random ^= tl_random << 13;
+			tl_random ^= tl_random >> 17;
+			tl_random ^= tl_random << 5;
+			return tl_random;
+		}
+
+		void execute(const Job& job)
+		{
+			job.function(job);
+			if (job.counter) {
+				job.counter->value.fetch_sub(1, std::memory_order_acq_rel);
+			}
+		}
+
+		void enqueue(const Job& job)
+		{
+			if (tl_workerIndex < 0 || !s_state.deques[tl_workerIndex]->push(job)) {
+				std::lock_guard<std::mutex> lock(s_state.injectedMutex);
+				s_state.injectedJobs.push_back(job);
+			}
+			// Pairs with the sleeping check in workerLoop: either the worker sees the job or we see the sleeper
+			s_state.pendingJobs.fetch_add(1, std::memory_order_seq_cst);
+			if (s_state.sleepingWorkers.load(std::memory_order_seq_cst) > 0) {
+				std::lock_guard<std::mutex> lock(s_state.sleepMutex);
+				s_state.wakeUp.notify_one();
+			}
+		}
+
+		bool findJob(Job& job)
+		{
+			const size_t workersCount = s_state.deques.size();
+			if (tl_workerIndex >= 0 && s_state.deques[tl_workerIndex]->pop(job)) {
+				return true;
+			}
+			{
+				std::lock_guard<std::mutex> lock(s_state.injectedMutex);
+				if (!s_state.injectedJobs.empty()) {
+					job = s_state.injectedJobs.front();
+					s_state.injectedJobs.pop_front();
+					return true;
+				}
+			}
+			const size_t first = nextRandom() % workersCount;
+			for (size_t i = 0; i < workersCount; ++i) {
+				const size_t victim = (first + i) % workersCount;
+				if (static_cast<int>(victim) != tl_workerIndex && s_state.deques[victim]->steal(job)) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool executeOne()
+		{
+			Job job;
+			if (!findJob(job)) {
+				return false;
+			}
+			s_state.pendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+
+			if (job.dependency && !job.dependency->isDone()) {
+				enqueue(job);
+				return false;
+			}
+			execute(job);
+			return true;
+		}
+
+		void workerLoop(const int workerIndex)
+		{
+			tl_workerIndex = workerIndex;
+			tl_random ^= static_cast<uint32_t>(workerIndex + 1) * 0x85EBCA6Bu;
+
+			while (s_state.isRunning.load(std::memory_order_acquire)) {
+				if (executeOne()) {
+					continue;
+				}
+				std::unique_lock<std::mutex> lock(s_state.sleepMutex);
+				s_state.sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+				s_state.wakeUp.wait(lock, []() {
+					return s_state.pendingJobs.load(std::memory_order_seq_cst) > 0 || !s_state.isRunning.load(std::memory_order_acquire);
+				});
+				s_state.sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void JobSystem::init(uint32_t workersCount)
+	{
+		if (s_state.isRunning) {
+			LOG_WARN("Job system is already running");
+			return;
+		}
+		if (workersCount == 0) {
+			workersCount = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+		}
+
+		for (uint32_t i = 0; i < workersCount; ++i) {
+			s_state.deques.push_back(std::make_unique<WorkStealingDeque>());
+		}
+		s_state.isRunning = true;
+		tl_workerIndex = 0;
+		for (uint32_t i = 1; i < workersCount; ++i) {
+			s_state.threads.emplace_back(workerLoop, static_cast<int>(i));
+		}
+		LOG_INFO("Job system started with {} workers", workersCount);
+	}
+
+	void JobSystem::shutdown()
+	{
+		if (!s_state.isRunning) {
+			return;
+		}
+		// Let the queued work finish so no counter is left hanging
+		while (s_state.pendingJobs.load(std::memory_order_acquire) > 0) {
+			if (!executeOne()) {
+				std::this_thread::yield();
+			}
+		}
+		{
+			std::lock_guard<std::mutex> lock(s_state.sleepMutex);
+			s_state.isRunning = false;
+		}
+		s_state.wakeUp.notify_all();
+		for (std::thread& thread : s_state.threads) {
+			thread.join();
+		}
+		s_state.threads.clear();
+		s_state.deques.clear();
+		tl_workerIndex = -1;
+	}
+
+	uint32_t JobSystem::getWorkersCount()
+	{
+		return s_state.deques.empty() ? 1 : static_cast<uint32_t>(s_state.deques.size());
+	}
+
+	int JobSystem::getWorkerIndex()
+	{
+		return tl_workerIndex;
+	}
+
+	void JobSystem::run(const Job& job)
+	{
+		if (!s_state.isRunning) {
+			// Without workers everything runs inline, dependencies are expected to be complete
+			execute(job);
+			return;
+		}
+		enqueue(job);
+	}
+
+	void JobSystem::wait(const JobCounter& counter)
+	{
+		while (!counter.isDone()) {
+			if (!s_state.isRunning || !executeOne()) {
+				std::this_thread::yield();
+			}
+		}
+	}
+}
@@ -0,0 +1,308 @@
+#include <log.h>
+
+#include <spdlog/spdlog.h>
+#include <spdlog/details/os.h>
+#include <spdlog/sinks/sink.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace GameEngine {
+	namespace {
+		constexpr size_t QueueCapacity = Log::QueueCapacity;
+		static_assert((QueueCapacity & (QueueCapacity - 1)) == 0, "The queue capacity must be a power of two");
+		// Producers only wake the logging thread once this many records are waiting,
+		// below that it picks them up when its idle wait runs out
+		constexpr size_t WakeBacklog = QueueCapacity / 4;
+		constexpr auto IdleWait = std::chrono::milliseconds(2);
+		// Records that bypass the queue
+		constexpr size_t DirectPosition = SIZE_MAX;
+
+		constexpr const char* s_moduleNames[] = { "core", "renderer", "resources", "ecs", "jobs", "profiler" };
+		static_assert(std::size(s_moduleNames) == static_cast<size_t>(LogModule::Count), "Every module needs a name");
+
+		struct alignas(64) Slot {
+			std::atomic<size_t> sequence;
+			LogRecord record;
+		};
+		static_assert(sizeof(Slot) == 256, "A queue slot should span four cache lines");
+
+		spdlog::level::level_enum toSpdlogLevel(const LogLevel level)
+		{
+			switch (level) {
+			case LogLevel::Info: return spdlog::level::info;
+			case LogLevel::Warn: return spdlog::level::warn;
+			case LogLevel::Err: return spdlog::level::err;
+			case LogLevel::Crit: return spdlog::level::critical;
+			default: return spdlog::level::off;
+			}
+		}
+
+		void formatText(const LogRecord& record, fmt::memory_buffer& buffer)
+		{
+			buffer.clear();
+			try {
+				record.format(record, buffer);
+			}
+			catch (const std::exception&) {
+				// A format not matching its arguments, the raw format is better than nothing
+				buffer.clear();
+				buffer.append(std::string_view(record.formatString));
+			}
+		}
+
+		// Formats the record on the calling thread and writes it to the sinks of the default logger
+		void emit(const LogRecord& record, fmt::memory_buffer& buffer)
+		{
+			spdlog::logger* logger = spdlog::default_logger_raw();
+			const spdlog::level::level_enum level = toSpdlogLevel(record.level);
+			if (!logger->should_log(level)) {
+				return;
+			}
+
+			formatText(record, buffer);
+
+			spdlog::details::log_msg message(record.time, spdlog::source_loc{}, s_moduleNames[static_cast<size_t>(record.module)],
+				level, spdlog::string_view_t(buffer.data(), buffer.size()));
+			message.thread_id = record.threadId;
+			for (const spdlog::sink_ptr& sink : logger->sinks()) {
+				if (sink->should_log(level)) {
+					sink->log(message);
+				}
+			}
+		}
+
+		// Bounded multi-producer queue (D. Vyukov): every slot carries a sequence number telling whose
+		// turn it is, producers claim positions with a CAS and a single consumer, the logging thread,
+		// reads them in order.
+		class LogQueue {
+		public:
+			LogQueue()
+				: m_slots(std::make_unique<Slot[]>(QueueCapacity))
+			{
+				for (size_t i = 0; i < QueueCapacity; ++i) {
+					m_slots[i].sequence.store(i, std::memory_order_relaxed);
+				}
+				// The registry is created first so it's destroyed after the queue has drained into it
+				spdlog::default_logger_raw();
+				m_thread = std::thread(&LogQueue::run, this);
+			}
+			~LogQueue()
+			{
+				s_isStopped.store(true, std::memory_order_release);
+				m_isStopping.store(true, std::memory_order_release);
+				wake();
+				m_thread.join();
+			}
+
+			LogQueue(const LogQueue&) = delete;
+			LogQueue(LogQueue&&) = delete;
+			LogQueue& operator=(const LogQueue&) = delete;
+			LogQueue& operator=(LogQueue&&) = delete;
+
+			LogRecord* claim(const LogLevel level)
+			{
+				size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+				while (true) {
+					Slot& slot = m_slots[position & (QueueCapacity - 1)];
+					const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+					const ptrdiff_t difference = static_cast<ptrdiff_t>(sequence - position);
+					if (difference == 0) {
+						if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+							slot.record.position = position;
+							return &slot.record;
+						}
+					}
+					else if (difference < 0) {
+						if (level < LogLevel::Err) {
+							m_dropped.fetch_add(1, std::memory_order_relaxed);
+							return nullptr;
+						}
+						wake();
+						std::this_thread::yield();
+						position = m_enqueuePosition.load(std::memory_order_relaxed);
+					}
+					else {
+						position = m_enqueuePosition.load(std::memory_order_relaxed);
+					}
+				}
+			}
+
+			void publish(const LogRecord& record)
+			{
+				// The record belongs to the logging thread once published, it can't be read past the store
+				const size_t position = record.position;
+				m_slots[position & (QueueCapacity - 1)].sequence.store(position + 1, std::memory_order_release);
+				if (m_isSleeping.load(std::memory_order_relaxed)
+					&& position - m_dequeuePosition.load(std::memory_order_relaxed) >= WakeBacklog) {
+					wake();
+				}
+			}
+
+			void flush()
+			{
+				const size_t target = m_enqueuePosition.load(std::memory_order_acquire);
+				wake();
+				while (m_dequeuePosition.load(std::memory_order_acquire) < target) {
+					std::this_thread::yield();
+				}
+				spdlog::default_logger_raw()->flush();
+			}
+
+			LogStats getStats() const
+			{
+				LogStats stats;
+				stats.written = m_written.load(std::memory_order_relaxed);
+				stats.dropped = m_dropped.load(std::memory_order_relaxed);
+				stats.highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+				return stats;
+			}
+
+			// Set once the queue is destroyed at exit, later records are written by their own thread
+			static inline std::atomic<bool> s_isStopped = false;
+		private:
+			void wake()
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_wake.notify_one();
+			}
+
+			void run()
+			{
+				fmt::memory_buffer buffer;
+				bool hasUnflushed = false;
+				while (true) {
+					if (drain(buffer) > 0) {
+						hasUnflushed = true;
+						continue;
+					}
+					if (hasUnflushed) {
+						spdlog::default_logger_raw()->flush();
+						hasUnflushed = false;
+					}
+					if (m_isStopping.load(std::memory_order_acquire)) {
+						if (drain(buffer) == 0) {
+							break;
+						}
+						continue;
+					}
+
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_isSleeping.store(true, std::memory_order_relaxed);
+					m_wake.wait_for(lock, IdleWait);
+					m_isSleeping.store(false, std::memory_order_relaxed);
+				}
+				spdlog::default_logger_raw()->flush();
+			}
+
+			size_t drain(fmt::memory_buffer& buffer)
+			{
+				size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+				const size_t backlog = m_enqueuePosition.load(std::memory_order_relaxed) - position;
+				if (backlog > m_highWaterMark.load(std::memory_order_relaxed)) {
+					m_highWaterMark.store(backlog, std::memory_order_relaxed);
+				}
+
+				size_t count = 0;
+				while (true) {
+					Slot& slot = m_slots[position & (QueueCapacity - 1)];
+					if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+						break;
+					}
+					emit(slot.record, buffer);
+					slot.sequence.store(position + QueueCapacity, std::memory_order_release);
+					++position;
+					++count;
+					m_dequeuePosition.store(position, std::memory_order_release);
+				}
+				m_written.fetch_add(count, std::memory_order_relaxed);
+
+				const size_t dropped = m_dropped.load(std::memory_order_relaxed);
+				if (dropped != m_reportedDropped) {
+					const std::string text = fmt::format("{} log records dropped, the queue was full", dropped - m_reportedDropped);
+					spdlog::default_logger_raw()->log(spdlog::level::warn, text);
+					m_reportedDropped = dropped;
+				}
+				return count;
+			}
+
+			std::unique_ptr<Slot[]> m_slots;
+			alignas(64) std::atomic<size_t> m_enqueuePosition = 0;
+			// Written by the logging thread only
+			alignas(64) std::atomic<size_t> m_dequeuePosition = 0;
+			std::atomic<size_t> m_written = 0;
+			std::atomic<size_t> m_highWaterMark = 0;
+			size_t m_reportedDropped = 0;
+			alignas(64) std::atomic<size_t> m_dropped = 0;
+			std::atomic<bool> m_isSleeping = false;
+			std::atomic<bool> m_isStopping = false;
+
+			std::mutex m_mutex;
+			std::condition_variable m_wake;
+			std::thread m_thread;
+		};
+
+		LogQueue& queue()
+		{
+			static LogQueue s_queue;
+			return s_queue;
+		}
+
+		thread_local LogRecord t_directRecord;
+	}
+
+	LogRecord* Log::beginRecord(const LogLevel level)
+	{
+		LogRecord* record;
+		if (LogQueue::s_isStopped.load(std::memory_order_acquire)) {
+			record = &t_directRecord;
+			record->position = DirectPosition;
+		}
+		else {
+			record = queue().claim(level);
+			if (record == nullptr) {
+				return nullptr;
+			}
+		}
+		record->time = std::chrono::system_clock::now();
+		record->threadId = spdlog::details::os::thread_id();
+		return record;
+	}
+
+	void Log::commitRecord(LogRecord* record)
+	{
+		// spdlog may already be gone as well, the record goes straight to stderr
+		if (record->position == DirectPosition) {
+			fmt::memory_buffer buffer;
+			formatText(*record, buffer);
+			std::fprintf(stderr, "[%s] [%s] %.*s\n", s_moduleNames[static_cast<size_t>(record->module)],
+				spdlog::level::to_string_view(toSpdlogLevel(record->level)).data(), static_cast<int>(buffer.size()), buffer.data());
+			return;
+		}
+
+		const bool isCritical = record->level == LogLevel::Crit;
+		queue().publish(*record);
+		// The program may be about to go down, critical messages must reach the sinks first
+		if (isCritical) {
+			queue().flush();
+		}
+	}
+
+	void Log::flush()
+	{
+		if (!LogQueue::s_isStopped.load(std::memory_order_acquire)) {
+			queue().flush();
+		}
+	}
+
+	LogStats Log::getStats()
+	{
+		return queue().getStats();
+	}
+}
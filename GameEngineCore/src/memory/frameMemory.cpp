@@ -0,0 +1,42 @@
+#include "memory/frameMemory.h"
+
+namespace GameEngine {
+	namespace {
+		FrameMemoryStats s_stats;
+
+		LinearArena& frameArena()
+		{
+			static LinearArena arena(FrameMemory::FrameArenaBlockSize);
+			return arena;
+		}
+	}
+
+	LinearArena& FrameMemory::getFrameArena()
+	{
+		return frameArena();
+	}
+
+	LinearArena& FrameMemory::getScratchArena()
+	{
+		thread_local LinearArena arena(ScratchArenaBlockSize);
+		return arena;
+	}
+
+	void FrameMemory::endFrame()
+	{
+		LinearArena& arena = frameArena();
+#ifdef GAMEENGINE_MEMORY_STATS
+		s_stats.frameAllocations = arena.getStats().allocations;
+		s_stats.frameBytes = arena.getUsed();
+		s_stats.frameHighWaterMark = arena.getStats().highWaterMark;
+		s_stats.scratchHighWaterMark = getScratchArena().getStats().highWaterMark;
+#endif
+		arena.reset();
+		s_stats.frameCapacity = arena.getCapacity();
+	}
+
+	const FrameMemoryStats& FrameMemory::getStats()
+	{
+		return s_stats;
+	}
+}
@@ -0,0 +1,98 @@
+#include "memory/linearArena.h"
+
+#include <algorithm>
+#include <new>
+
+namespace GameEngine {
+	namespace {
+		uint8_t* allocateBlock(const size_t size)
+		{
+			return static_cast<uint8_t*>(::operator new(size, std::align_val_t(alignof(std::max_align_t))));
+		}
+
+		void freeBlock(uint8_t* data)
+		{
+			::operator delete(data, std::align_val_t(alignof(std::max_align_t)));
+		}
+	}
+
+	LinearArena::LinearArena(const size_t blockSize)
+		: m_blockSize(std::max<size_t>(blockSize, 1))
+	{}
+
+	LinearArena::~LinearArena()
+	{
+		for (const Block& block : m_blocks) {
+			freeBlock(block.data);
+		}
+	}
+
+	void LinearArena::reset()
+	{
+		if (m_blocks.size() > 1) {
+			const size_t totalSize = getCapacity();
+			for (const Block& block : m_blocks) {
+				freeBlock(block.data);
+			}
+			m_blocks.clear();
+			m_blocks.push_back({ allocateBlock(totalSize), totalSize });
+#ifdef GAMEENGINE_MEMORY_STATS
+			++m_stats.blocksAllocated;
+#endif
+		}
+		if (!m_blocks.empty()) {
+			setCurrentBlock(0, 0);
+		}
+#ifdef GAMEENGINE_MEMORY_STATS
+		m_stats.allocations = 0;
+#endif
+	}
+
+	void LinearArena::rewind(const Marker& marker)
+	{
+		if (!m_blocks.empty()) {
+			setCurrentBlock(marker.block, marker.offset);
+		}
+	}
+
+	size_t LinearArena::getCapacity() const
+	{
+		size_t capacity = 0;
+		for (const Block& block : m_blocks) {
+			capacity += block.size;
+		}
+		return capacity;
+	}
+
+	void* LinearArena::allocateSlow(const size_t size, const size_t alignment)
+	{
+		// Spare blocks left behind by a rewind come first, a new block goes right after the current one
+		const size_t worstCase = size + alignment - 1;
+		size_t index = m_blocks.empty() ? 0 : m_blockIndex + 1;
+		while (index < m_blocks.size() && m_blocks[index].size < worstCase) {
+			++index;
+		}
+		if (index == m_blocks.size()) {
+			index = m_blocks.empty() ? 0 : m_blockIndex + 1;
+			const size_t blockSize = std::max(m_blockSize, worstCase);
+			m_blocks.insert(m_blocks.begin() + static_cast<std::ptrdiff_t>(index), { allocateBlock(blockSize), blockSize });
+#ifdef GAMEENGINE_MEMORY_STATS
+			++m_stats.blocksAllocated;
+#endif
+		}
+		setCurrentBlock(index, 0);
+		return allocate(size, alignment);
+	}
+
+	void LinearArena::setCurrentBlock(const size_t index, const size_t offset)
+	{
+		m_previousBlocksBytes = 0;
+		for (size_t i = 0; i < index; ++i) {
+			m_previousBlocksBytes += m_blocks[i].size;
+		}
+		m_blockIndex = index;
+		m_begin = reinterpret_cast<uintptr_t>(m_blocks[index].data);
+		m_current = m_begin + offset;
+		m_end = m_begin + m_blocks[index].size;
+	}
+}
@@ -0,0 +1,56 @@
+#include "memory/poolAllocator.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace GameEngine {
+	static_assert(SmallObjectAllocator::SizeClassStep >= alignof(std::max_align_t), "Size classes must keep the default alignment");
+
+	FixedPool::FixedPool(const size_t elementSize, const size_t elementsPerChunk, const size_t alignment)
+		: m_elementsPerChunk(std::max<size_t>(elementsPerChunk, 1)), m_alignment(std::max(alignment, alignof(FreeNode)))
+	{
+		// Every element has to hold a free list link and keep the next one aligned
+		const size_t size = std::max(elementSize, sizeof(FreeNode));
+		m_elementSize = (size + m_alignment - 1) & ~(m_alignment - 1);
+	}
+
+	FixedPool::~FixedPool()
+	{
+		for (void* chunk : m_chunks) {
+			::operator delete(chunk, std::align_val_t(m_alignment));
+		}
+	}
+
+	void FixedPool::addChunk()
+	{
+		uint8_t* chunk = static_cast<uint8_t*>(::operator new(m_elementSize * m_elementsPerChunk, std::align_val_t(m_alignment)));
+		m_chunks.push_back(chunk);
+		// Linked back to front so the chunk is handed out in address order
+		for (size_t i = m_elementsPerChunk; i-- > 0;) {
+			FreeNode* node = reinterpret_cast<FreeNode*>(chunk + i * m_elementSize);
+			node->next = m_freeList;
+			m_freeList = node;
+		}
+	}
+
+	void* SmallObjectAllocator::allocate(const size_t size)
+	{
+		if (size == 0 || size > MaxSize) {
+			return ::operator new(size);
+		}
+		std::unique_ptr<FixedPool>& pool = m_pools[(size - 1) / SizeClassStep];
+		if (!pool) {
+			pool = std::make_unique<FixedPool>(((size - 1) / SizeClassStep + 1) * SizeClassStep, FixedPool::DefaultElementsPerChunk, SizeClassStep);
+		}
+		return pool->allocate();
+	}
+
+	void SmallObjectAllocator::deallocate(void* pointer, const size_t size)
+	{
+		if (size == 0 || size > MaxSize) {
+			::operator delete(pointer);
+			return;
+		}
+		m_pools[(size - 1) / SizeClassStep]->deallocate(pointer);
+	}
+}
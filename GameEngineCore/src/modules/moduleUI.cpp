@@ -1,9 +1,12 @@
 #include "moduleUI.h"
 
+#include "rendering/OpenGL/glState.h"
+
 #include <imgui/imgui.h>
 #include <imgui/backends/imgui_impl_opengl3.h>
 #include <imgui/backends/imgui_impl_glfw.h>
 #include <GLFW/glfw3.h>
+#include <profiler.h>
 
 void GameEngine::ModuleUI::init(GLFWwindow* pWindow)
 {
@@ -34,6 +37,7 @@ void GameEngine::ModuleUI::updateBegin()
 
 void GameEngine::ModuleUI::updateDraw()
 {
+	PROFILE_FUNCTION();
 	ImGui::Render();
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 	if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
@@ -43,4 +47,6 @@ void GameEngine::ModuleUI::updateDraw()
 		ImGui::RenderPlatformWindowsDefault();
 		glfwMakeContextCurrent(currentContextBackup);
 	}
+	// The ImGui backend binds its own program, buffers and blend state without going through the cache
+	GLState::invalidate();
 }
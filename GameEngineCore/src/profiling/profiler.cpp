@@ -0,0 +1,214 @@
+#define LOG_MODULE Profiler
+
+#include "profiler.h"
+
+#include <log.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+namespace GameEngine {
+	namespace {
+		constexpr size_t s_historySize = 240;
+
+		// Single producer (the owning thread) / single consumer (Profiler::endFrame) ring
+		struct ThreadEventBuffer {
+			static constexpr size_t Capacity = 1 << 14;
+
+			std::array<ProfileEvent, Capacity> events;
+			std::atomic<size_t> head = 0;
+			std::atomic<size_t> tail = 0;
+			uint32_t threadId = 0;
+			uint16_t depth = 0;
+		};
+
+		struct ProfilerState {
+			const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+			std::mutex buffersMutex;
+			std::vector<std::unique_ptr<ThreadEventBuffer>> buffers;
+
+			std::vector<ProfileEvent> gpuEvents;
+			std::vector<ProfileFrame> history;
+			size_t historyBegin = 0;
+			ProfileFrame currentFrame;
+
+			std::atomic<size_t> droppedEvents = 0;
+		};
+
+		ProfilerState& state()
+		{
+			static ProfilerState s_state;
+			return s_state;
+		}
+
+		ThreadEventBuffer& threadBuffer()
+		{
+			thread_local ThreadEventBuffer* tl_buffer = nullptr;
+			if (!tl_buffer) {
+				ProfilerState& profiler = state();
+				std::lock_guard<std::mutex> lock(profiler.buffersMutex);
+				profiler.buffers.push_back(std::make_unique<ThreadEventBuffer>());
+				tl_buffer = profiler.buffers.back().get();
+				tl_buffer->threadId = static_cast<uint32_t>(profiler.buffers.size() - 1);
+			}
+			return *tl_buffer;
+		}
+
+		void writeEscaped(std::FILE* file, const char* string)
+		{
+			for (; *string; ++string) {
+				if (*string == '"' || *string == '\\') {
+					std::fputc('\\', file);
+				}
+				std::fputc(*string, file);
+			}
+		}
+	}
+
+	std::atomic<bool> Profiler::s_isEnabled = false;
+
+	void Profiler::setEnabled(const bool enabled)
+	{
+		s_isEnabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	uint64_t Profiler::now()
+	{
+		return static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - state().epoch).count()
+		);
+	}
+
+	uint16_t Profiler::pushDepth()
+	{
+		return threadBuffer().depth++;
+	}
+
+	void Profiler::popDepth()
+	{
+		--threadBuffer().depth;
+	}
+
+	void Profiler::record(const char* name, const uint64_t start, const uint64_t end, const uint16_t depth)
+	{
+		ThreadEventBuffer& buffer = threadBuffer();
+
+		const size_t head = buffer.head.load(std::memory_order_relaxed);
+		if (head - buffer.tail.load(std::memory_order_acquire) >= ThreadEventBuffer::Capacity) {
+			state().droppedEvents.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		buffer.events[head & (ThreadEventBuffer::Capacity - 1)] = { name, start, end, buffer.threadId, depth, false };
+		buffer.head.store(head + 1, std::memory_order_release);
+	}
+
+	void Profiler::recordGpu(const char* name, const uint64_t start, const uint64_t duration)
+	{
+		state().gpuEvents.push_back({ name, start, start + duration, GpuThreadId, 0, true });
+	}
+
+	void Profiler::beginFrame()
+	{
+		if (!isEnabled()) {
+			return;
+		}
+		ProfilerState& profiler = state();
+		profiler.currentFrame.events.clear();
+		profiler.currentFrame.start = now();
+	}
+
+	void Profiler::endFrame()
+	{
+		if (!isEnabled()) {
+			return;
+		}
+		ProfilerState& profiler = state();
+		ProfileFrame& frame = profiler.currentFrame;
+		frame.end = now();
+
+		{
+			std::lock_guard<std::mutex> lock(profiler.buffersMutex);
+			for (auto& buffer : profiler.buffers) {
+				const size_t tail = buffer->tail.load(std::memory_order_relaxed);
+				const size_t head = buffer->head.load(std::memory_order_acquire);
+				for (size_t i = tail; i < head; ++i) {
+					frame.events.push_back(buffer->events[i & (ThreadEventBuffer::Capacity - 1)]);
+				}
+				buffer->tail.store(head, std::memory_order_release);
+			}
+		}
+		frame.events.insert(frame.events.end(), profiler.gpuEvents.begin(), profiler.gpuEvents.end());
+		profiler.gpuEvents.clear();
+
+		if (profiler.history.size() < s_historySize) {
+			profiler.history.push_back(frame);
+		}
+		else {
+			std::swap(profiler.history[profiler.historyBegin], frame);
+			profiler.historyBegin = (profiler.historyBegin + 1) % s_historySize;
+		}
+	}
+
+	size_t Profiler::getHistorySize()
+	{
+		return state().history.size();
+	}
+
+	const ProfileFrame& Profiler::getHistoryFrame(const size_t index)
+	{
+		const ProfilerState& profiler = state();
+		return profiler.history[(profiler.historyBegin + index) % profiler.history.size()];
+	}
+
+	const ProfileFrame* Profiler::getLatestFrame()
+	{
+		const size_t size = getHistorySize();
+		return size > 0 ? &getHistoryFrame(size - 1) : nullptr;
+	}
+
+	size_t Profiler::getDroppedEventsCount()
+	{
+		return state().droppedEvents.load(std::memory_order_relaxed);
+	}
+
+	bool Profiler::exportChromeTrace(const char* path)
+	{
+		std::FILE* file = std::fopen(path, "w");
+		if (!file) {
+			LOG_ERR("Can't open {} for the trace export", path);
+			return false;
+		}
+
+		std::fputs("{\"traceEvents\":[\n", file);
+		bool first = true;
+		for (size_t i = 0; i < getHistorySize(); ++i) {
+			const ProfileFrame& frame = getHistoryFrame(i);
+			std::fprintf(file, "%s{\"name\":\"Frame\",\"ph\":\"X\",\"pid\":0,\"tid\":\"Frames\",\"ts\":%.3f,\"dur\":%.3f}",
+				first ? "" : ",\n", frame.start / 1000.0, (frame.end - frame.start) / 1000.0);
+			first = false;
+
+			for (const ProfileEvent& event : frame.events) {
+				std::fputs(",\n{\"name\":\"", file);
+				writeEscaped(file, event.name);
+				if (event.isGpu) {
+					std::fprintf(file, "\",\"ph\":\"X\",\"pid\":0,\"tid\":\"GPU\",\"ts\":%.3f,\"dur\":%.3f}",
+						event.start / 1000.0, (event.end - event.start) / 1000.0);
+				}
+				else {
+					std::fprintf(file, "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+						event.threadId, event.start / 1000.0, (event.end - event.start) / 1000.0);
+				}
+			}
+		}
+		std::fputs("\n]}\n", file);
+		std::fclose(file);
+
+		LOG_INFO("Profiler trace exported to {}", path);
+		return true;
+	}
+}
@@ -0,0 +1,166 @@
+#define LOG_MODULE Renderer
+
+#include "batchRenderer.h"
+
+#include "shader.h"
+#include "vertexArray.h"
+#include "streamBuffer.h"
+#include "openGL_Renderer.h"
+
+#include <glm/vec4.hpp>
+
+#include <cstring>
+#include <log.h>
+#include <profiler.h>
+
+namespace GameEngine {
+	static constexpr size_t s_minVerticesBufferSize = 64 * 1024;
+	static constexpr size_t s_minIndicesCount = 16 * 1024;
+
+	static size_t growCapacity(size_t capacity, const size_t required)
+	{
+		while (capacity < required) {
+			capacity *= 2;
+		}
+		return capacity;
+	}
+
+	BatchRenderer::Batch::Batch(Shader* shader, const BufferLayout& layout)
+		: shader(shader), modelMatrixLocation(shader->getUniformLocation("model_matrix")), layout(layout)
+	{}
+	BatchRenderer::Batch::~Batch() = default;
+
+	BatchRenderer::BatchRenderer() = default;
+	BatchRenderer::~BatchRenderer() = default;
+
+	void BatchRenderer::begin()
+	{
+		for (auto& batch : m_batches) {
+			batch->vertices.clear();
+			batch->indices.clear();
+			batch->verticesCount = 0;
+		}
+		m_stats = {};
+	}
+
+	void BatchRenderer::submit(
+		Shader& shader,
+		const BufferLayout& layout,
+		const void* vertices,
+		const size_t verticesCount,
+		const uint32_t* indices,
+		const size_t indicesCount,
+		const glm::mat4& transform
+	)
+	{
+		Batch& batch = getBatch(shader, layout);
+
+		const size_t stride = layout.getStride();
+		const size_t firstByte = batch.vertices.size();
+		batch.vertices.resize(firstByte + verticesCount * stride);
+		std::memcpy(batch.vertices.data() + firstByte, vertices, verticesCount * stride);
+
+		const auto& elements = layout.getElements();
+		if (!elements.empty() && elements[0].type == ShaderDataType::Float3) {
+			uint8_t* vertex = batch.vertices.data() + firstByte + elements[0].offset;
+			for (size_t i = 0; i < verticesCount; ++i, vertex += stride) {
+				float position[3];
+				std::memcpy(position, vertex, sizeof(position));
+				const glm::vec4 world = transform * glm::vec4(position[0], position[1], position[2], 1.f);
+				position[0] = world.x;
+				position[1] = world.y;
+				position[2] = world.z;
+				std::memcpy(vertex, position, sizeof(position));
+			}
+		}
+
+		const uint32_t baseVertex = static_cast<uint32_t>(batch.verticesCount);
+		const size_t firstIndex = batch.indices.size();
+		batch.indices.resize(firstIndex + indicesCount);
+		for (size_t i = 0; i < indicesCount; ++i) {
+			batch.indices[firstIndex + i] = indices[i] + baseVertex;
+		}
+		batch.verticesCount += verticesCount;
+
+		++m_stats.submissions;
+	}
+
+	void BatchRenderer::flush()
+	{
+		PROFILE_FUNCTION();
+		for (auto& batchPtr : m_batches) {
+			Batch& batch = *batchPtr;
+			if (batch.indices.empty()) {
+				continue;
+			}
+
+			reserveGPUBuffers(batch);
+			// The failed mapping was logged when the buffer was created
+			if (!batch.vertexStream->isValid() || !batch.indexStream->isValid()) {
+				continue;
+			}
+			const uint64_t fenceWaits = batch.vertexStream->getFenceWaitsCount() + batch.indexStream->getFenceWaitsCount();
+			batch.vertexStream->beginRegion();
+			batch.indexStream->beginRegion();
+			m_stats.fenceWaits += batch.vertexStream->getFenceWaitsCount() + batch.indexStream->getFenceWaitsCount() - fenceWaits;
+
+			std::memcpy(batch.vertexStream->getRegionData(), batch.vertices.data(), batch.vertices.size());
+			std::memcpy(batch.indexStream->getRegionData(), batch.indices.data(), batch.indices.size() * sizeof(uint32_t));
+
+			batch.shader->bind();
+			batch.shader->setMat4(batch.modelMatrixLocation, glm::mat4(1.f));
+			batch.vertexArray->setVertexBufferOffset(batch.vertexBinding, *batch.vertexStream, batch.vertexStream->getRegionOffset());
+			// setVertexBufferOffset left the batch's vertex array bound
+			OpenGL_Renderer::draw(batch.indices.size(), batch.indexStream->getRegionOffset() / sizeof(uint32_t));
+
+			batch.vertexStream->endRegion();
+			batch.indexStream->endRegion();
+
+			++m_stats.drawCalls;
+			m_stats.vertices += batch.verticesCount;
+			m_stats.indices += batch.indices.size();
+		}
+	}
+
+	BatchRenderer::Batch& BatchRenderer::getBatch(Shader& shader, const BufferLayout& layout)
+	{
+		for (auto& batch : m_batches) {
+			if (batch->shader == &shader && batch->layout == layout) {
+				return *batch;
+			}
+		}
+		m_batches.push_back(std::make_unique<Batch>(&shader, layout));
+		return *m_batches.back();
+	}
+
+	void BatchRenderer::reserveGPUBuffers(Batch& batch)
+	{
+		const size_t indicesSize = batch.indices.size() * sizeof(uint32_t);
+		const bool fitsVertices = batch.vertexStream && batch.vertexStream->getRegionSize() >= batch.vertices.size();
+		const bool fitsIndices = batch.indexStream && batch.indexStream->getRegionSize() >= indicesSize;
+		if (fitsVertices && fitsIndices) {
+			return;
+		}
+
+		// Regions are fixed at creation, growing means a new buffer; the old one is released by the driver
+		// once the draws still reading it are done
+		if (!fitsVertices) {
+			const size_t size = growCapacity(
+				batch.vertexStream ? batch.vertexStream->getRegionSize() : s_minVerticesBufferSize, batch.vertices.size()
+			);
+			batch.vertexStream = std::make_unique<StreamBuffer>(size);
+		}
+		if (!fitsIndices) {
+			const size_t size = growCapacity(
+				batch.indexStream ? batch.indexStream->getRegionSize() : s_minIndicesCount * sizeof(uint32_t), indicesSize
+			);
+			batch.indexStream = std::make_unique<StreamBuffer>(size);
+		}
+
+		batch.vertexArray = std::make_unique<VertexArray>();
+		batch.vertexBinding = batch.vertexArray->addVertexBuffer(*batch.vertexStream, batch.layout);
+		batch.vertexArray->setIndexBuffer(*batch.indexStream);
+		LOG_INFO("Batch stream regions resized to {0} bytes of vertices / {1} bytes of indices",
+			batch.vertexStream->getRegionSize(), batch.indexStream->getRegionSize());
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "vertexBuffer.h"
+#include "renderStats.h"
+
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace GameEngine {
+	class Shader;
+	class VertexArray;
+	class StreamBuffer;
+
+	// Collects meshes sharing a shader and a buffer layout into one streaming vertex/index buffer
+	// and draws each such group with a single call on flush().
+	// The GPU buffers are persistently mapped rings, so uploading a frame never waits on the draws
+	// of the previous ones unless the GPU falls StreamBuffer::RegionsCount frames behind.
+	// The first layout element is treated as the Float3 position and is transformed on the CPU,
+	// so the shader receives an identity model_matrix.
+	class BatchRenderer {
+	public:
+		BatchRenderer();
+		~BatchRenderer();
+
+		BatchRenderer(const BatchRenderer&) = delete;
+		BatchRenderer(BatchRenderer&&) = delete;
+		BatchRenderer& operator=(const BatchRenderer&) = delete;
+		BatchRenderer& operator=(BatchRenderer&&) = delete;
+
+		void begin();
+		void submit(
+			Shader& shader,
+			const BufferLayout& layout,
+			const void* vertices,
+			const size_t verticesCount,
+			const uint32_t* indices,
+			const size_t indicesCount,
+			const glm::mat4& transform
+		);
+		// A batch whose stream buffers couldn't be mapped is skipped
+		void flush();
+
+		inline const RenderStats& getStats() const { return m_stats; }
+	private:
+		struct Batch {
+			Shader* shader;
+			int modelMatrixLocation;
+			BufferLayout layout;
+
+			std::vector<uint8_t> vertices;
+			std::vector<uint32_t> indices;
+			size_t verticesCount = 0;
+
+			std::unique_ptr<VertexArray> vertexArray;
+			std::unique_ptr<StreamBuffer> vertexStream;
+			std::unique_ptr<StreamBuffer> indexStream;
+			uint32_t vertexBinding = 0;
+
+			Batch(Shader* shader, const BufferLayout& layout);
+			~Batch();
+		};
+
+		Batch& getBatch(Shader& shader, const BufferLayout& layout);
+		static void reserveGPUBuffers(Batch& batch);
+
+		std::vector<std::unique_ptr<Batch>> m_batches;
+		RenderStats m_stats;
+	};
+}
@@ -0,0 +1,142 @@
+#define LOG_MODULE Renderer
+
+#include "frameCapture.h"
+
+#include "framebuffer.h"
+#include "glState.h"
+
+#include <glad/glad.h>
+#include <log.h>
+#include <profiler.h>
+
+#include <fstream>
+
+namespace GameEngine {
+	FrameCapture::FrameCapture(const uint32_t width, const uint32_t height, FrameCallback callback)
+		: m_callback(std::move(callback)), m_width(width), m_height(height)
+	{
+		const GLsizeiptr size = static_cast<GLsizeiptr>(width) * height * 4;
+
+		glGenBuffers(BuffersCount, m_ids);
+		for (const unsigned int id : m_ids) {
+			GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, id);
+			glBufferStorage(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_MAP_READ_BIT | GL_CLIENT_STORAGE_BIT);
+		}
+		GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+
+	FrameCapture::~FrameCapture()
+	{
+		for (void* fence : m_fences) {
+			if (fence) {
+				glDeleteSync(static_cast<GLsync>(fence));
+			}
+		}
+		GLState::deleteBuffers(BuffersCount, m_ids);
+	}
+
+	void FrameCapture::capture(const Framebuffer& framebuffer)
+	{
+		PROFILE_FUNCTION();
+		if (framebuffer.getWidth() != m_width || framebuffer.getHeight() != m_height) {
+			LOG_ERR("Can't capture a {0}x{1} framebuffer into {2}x{3} buffers",
+				framebuffer.getWidth(), framebuffer.getHeight(), m_width, m_height);
+			return;
+		}
+
+		// Hand out whatever already finished, oldest first so frames stay in order
+		while (m_deliveredCount < m_capturedCount) {
+			const size_t oldest = m_deliveredCount % BuffersCount;
+			if (glClientWaitSync(static_cast<GLsync>(m_fences[oldest]), 0, 0) == GL_TIMEOUT_EXPIRED) {
+				break;
+			}
+			deliver(oldest);
+		}
+		if (m_capturedCount - m_deliveredCount == BuffersCount) {
+			++m_stallsCount;
+			deliver(m_deliveredCount % BuffersCount);
+		}
+
+		const size_t buffer = m_capturedCount % BuffersCount;
+		GLState::bindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer.getHandle());
+		glReadBuffer(GL_COLOR_ATTACHMENT0);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, m_ids[buffer]);
+		glReadPixels(0, 0, static_cast<GLsizei>(m_width), static_cast<GLsizei>(m_height), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		m_fences[buffer] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_frameIndices[buffer] = m_capturedCount++;
+	}
+
+	void FrameCapture::flush()
+	{
+		while (m_deliveredCount < m_capturedCount) {
+			deliver(m_deliveredCount % BuffersCount);
+		}
+	}
+
+	void FrameCapture::deliver(const size_t buffer)
+	{
+		GLsync fence = static_cast<GLsync>(m_fences[buffer]);
+		GLenum status;
+		do {
+			status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		} while (status == GL_TIMEOUT_EXPIRED);
+		if (status == GL_WAIT_FAILED) {
+			LOG_ERR("Frame capture fence wait failed");
+		}
+		glDeleteSync(fence);
+		m_fences[buffer] = nullptr;
+
+		const GLsizeiptr size = static_cast<GLsizeiptr>(m_width) * m_height * 4;
+		GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, m_ids[buffer]);
+		const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+		if (pixels) {
+			m_callback({ m_frameIndices[buffer], m_width, m_height, static_cast<const uint8_t*>(pixels) });
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		else {
+			LOG_ERR("Can't map the readback of frame {0}", m_frameIndices[buffer]);
+		}
+		GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		++m_deliveredCount;
+	}
+
+	uint64_t FrameCapture::hash(const CapturedFrame& frame)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		const size_t size = static_cast<size_t>(frame.width) * frame.height * 4;
+		for (size_t i = 0; i < size; ++i) {
+			hash = (hash ^ frame.pixels[i]) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	bool FrameCapture::writePpm(const std::string& path, const CapturedFrame& frame)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			LOG_ERR("Can't create image {0}", path);
+			return false;
+		}
+
+		file << "P6\n" << frame.width << ' ' << frame.height << "\n255\n";
+		std::string row(static_cast<size_t>(frame.width) * 3, '\0');
+		for (uint32_t y = frame.height; y-- > 0;) {
+			const uint8_t* source = frame.pixels + static_cast<size_t>(y) * frame.width * 4;
+			for (uint32_t x = 0; x < frame.width; ++x) {
+				row[x * 3 + 0] = static_cast<char>(source[x * 4 + 0]);
+				row[x * 3 + 1] = static_cast<char>(source[x * 4 + 1]);
+				row[x * 3 + 2] = static_cast<char>(source[x * 4 + 2]);
+			}
+			file.write(row.data(), static_cast<std::streamsize>(row.size()));
+		}
+
+		if (!file) {
+			LOG_ERR("Failed writing image {0}", path);
+			return false;
+		}
+		return true;
+	}
+}
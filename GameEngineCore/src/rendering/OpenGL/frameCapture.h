@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace GameEngine {
+	class Framebuffer;
+
+	struct CapturedFrame {
+		uint64_t index;
+		uint32_t width;
+		uint32_t height;
+		// Tightly packed RGBA8 rows, bottom row first as OpenGL reads them
+		const uint8_t* pixels;
+	};
+
+	// Reads frames back through a ring of pixel pack buffers. capture() only queues the copy,
+	// a frame reaches the callback once its copy is done, at the latest BuffersCount captures later,
+	// so the readback never stalls the frame that issued it.
+	class FrameCapture {
+	public:
+		using FrameCallback = std::function<void(const CapturedFrame& frame)>;
+
+		static constexpr size_t BuffersCount = 3;
+
+		FrameCapture(const uint32_t width, const uint32_t height, FrameCallback callback);
+		FrameCapture() = delete;
+		~FrameCapture();
+
+		FrameCapture(const FrameCapture&) = delete;
+		FrameCapture(FrameCapture&&) = delete;
+		FrameCapture& operator=(const FrameCapture&) = delete;
+		FrameCapture& operator=(FrameCapture&&) = delete;
+
+		// Queues a copy of the framebuffer color, delivering the oldest queued frame if the ring is full
+		void capture(const Framebuffer& framebuffer);
+		// Waits for and delivers every queued frame
+		void flush();
+
+		inline uint64_t getCapturedCount() const { return m_capturedCount; }
+		inline uint64_t getDeliveredCount() const { return m_deliveredCount; }
+		// How many deliveries found the copy still running and had to block
+		inline uint64_t getStallsCount() const { return m_stallsCount; }
+
+		// 64-bit FNV-1a of the pixels, stable across runs and platforms
+		static uint64_t hash(const CapturedFrame& frame);
+		// Binary PPM, flipped so the top row comes first
+		static bool writePpm(const std::string& path, const CapturedFrame& frame);
+	private:
+		void deliver(const size_t buffer);
+
+		FrameCallback m_callback;
+		uint32_t m_width;
+		uint32_t m_height;
+		unsigned int m_ids[BuffersCount] = {};
+		// GLsync handles, kept opaque so the header doesn't need glad
+		void* m_fences[BuffersCount] = {};
+		uint64_t m_frameIndices[BuffersCount] = {};
+
+		uint64_t m_capturedCount = 0;
+		uint64_t m_deliveredCount = 0;
+		uint64_t m_stallsCount = 0;
+	};
+}
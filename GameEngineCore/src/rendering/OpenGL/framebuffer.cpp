@@ -0,0 +1,51 @@
+#define LOG_MODULE Renderer
+
+#include "framebuffer.h"
+
+#include "glState.h"
+
+#include <glad/glad.h>
+#include <log.h>
+
+GameEngine::Framebuffer::Framebuffer(const uint32_t width, const uint32_t height)
+	: m_width(width), m_height(height)
+{
+	glGenRenderbuffers(1, &m_colorId);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_colorId);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+
+	glGenRenderbuffers(1, &m_depthId);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthId);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_id);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, m_id);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorId);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthId);
+
+	const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	m_isComplete = status == GL_FRAMEBUFFER_COMPLETE;
+	if (!m_isComplete) {
+		LOG_ERR("Framebuffer {0}x{1} is incomplete, status 0x{2:x}", width, height, status);
+	}
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+GameEngine::Framebuffer::~Framebuffer()
+{
+	GLState::deleteFramebuffer(m_id);
+	glDeleteRenderbuffers(1, &m_colorId);
+	glDeleteRenderbuffers(1, &m_depthId);
+}
+
+void GameEngine::Framebuffer::bind() const
+{
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, m_id);
+	GLState::viewport(0, 0, static_cast<GLsizei>(m_width), static_cast<GLsizei>(m_height));
+}
+
+void GameEngine::Framebuffer::unbind()
+{
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace GameEngine {
+	// Offscreen render target with an RGBA8 color and a 24-bit depth attachment,
+	// the same formats the default framebuffer of a window gets
+	class Framebuffer {
+	public:
+		Framebuffer(const uint32_t width, const uint32_t height);
+		Framebuffer() = delete;
+		~Framebuffer();
+
+		Framebuffer(const Framebuffer&) = delete;
+		Framebuffer(Framebuffer&&) = delete;
+		Framebuffer& operator=(const Framebuffer&) = delete;
+		Framebuffer& operator=(Framebuffer&&) = delete;
+
+		// Binds for drawing and reading and sets the viewport to the whole target
+		void bind() const;
+		static void unbind();
+
+		inline uint32_t getWidth() const { return m_width; }
+		inline uint32_t getHeight() const { return m_height; }
+		inline unsigned int getHandle() const { return m_id; }
+		inline bool isComplete() const { return m_isComplete; }
+	private:
+		unsigned int m_id = 0;
+		unsigned int m_colorId = 0;
+		unsigned int m_depthId = 0;
+		uint32_t m_width;
+		uint32_t m_height;
+		bool m_isComplete = false;
+	};
+}
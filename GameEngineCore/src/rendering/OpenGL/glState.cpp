@@ -0,0 +1,354 @@
+#include "glState.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace GameEngine {
+	namespace {
+		// No object has this name, a shadow holding it always differs from the requested value
+		constexpr GLuint Unknown = UINT32_MAX;
+
+		enum BufferTarget : size_t {
+			ArrayBuffer,
+			ElementArrayBuffer,
+			UniformBuffer,
+			ShaderStorageBuffer,
+			DrawIndirectBuffer,
+			CopyReadBuffer,
+			CopyWriteBuffer,
+			PixelPackBuffer,
+			PixelUnpackBuffer,
+
+			BufferTargetsCount
+		};
+
+		enum IndexedBufferTarget : size_t {
+			IndexedUniformBuffer,
+			IndexedShaderStorageBuffer,
+
+			IndexedBufferTargetsCount
+		};
+
+		// A whole buffer bound with glBindBufferBase has a zero size
+		struct IndexedBinding {
+			GLuint buffer = Unknown;
+			GLintptr offset = 0;
+			GLsizeiptr size = 0;
+
+			inline bool operator==(const IndexedBinding& other) const
+			{
+				return buffer == other.buffer && offset == other.offset && size == other.size;
+			}
+		};
+
+		enum class Toggle : uint8_t {
+			Unknown,
+			Disabled,
+			Enabled
+		};
+
+		struct State {
+			GLuint program = Unknown;
+			GLuint vertexArray = Unknown;
+			GLuint buffers[BufferTargetsCount];
+			IndexedBinding indexedBuffers[IndexedBufferTargetsCount][GLState::TrackedBufferIndices];
+			GLuint drawFramebuffer = Unknown;
+			GLuint readFramebuffer = Unknown;
+			GLuint activeTexture = Unknown;
+			// One name per unit whatever its target, a texture can only ever be bound to its own target
+			GLuint textures[GLState::TrackedTextureUnits];
+
+			GLint viewport[4] = { -1, -1, -1, -1 };
+			bool isClearColorKnown = false;
+			GLfloat clearColor[4] = {};
+			Toggle blend = Toggle::Unknown;
+			GLenum blendSource = Unknown;
+			GLenum blendDestination = Unknown;
+			Toggle depthTest = Toggle::Unknown;
+			GLenum depthFunc = Unknown;
+			Toggle depthMask = Toggle::Unknown;
+
+			State()
+			{
+				std::fill(std::begin(buffers), std::end(buffers), Unknown);
+				std::fill(std::begin(textures), std::end(textures), Unknown);
+			}
+		};
+
+		State s_state;
+		GLStateStats s_stats;
+
+		size_t getBufferTarget(const GLenum target)
+		{
+			switch (target) {
+			case GL_ARRAY_BUFFER: return ArrayBuffer;
+			case GL_ELEMENT_ARRAY_BUFFER: return ElementArrayBuffer;
+			case GL_UNIFORM_BUFFER: return UniformBuffer;
+			case GL_SHADER_STORAGE_BUFFER: return ShaderStorageBuffer;
+			case GL_DRAW_INDIRECT_BUFFER: return DrawIndirectBuffer;
+			case GL_COPY_READ_BUFFER: return CopyReadBuffer;
+			case GL_COPY_WRITE_BUFFER: return CopyWriteBuffer;
+			case GL_PIXEL_PACK_BUFFER: return PixelPackBuffer;
+			case GL_PIXEL_UNPACK_BUFFER: return PixelUnpackBuffer;
+			default: return BufferTargetsCount;
+			}
+		}
+
+		size_t getIndexedBufferTarget(const GLenum target)
+		{
+			switch (target) {
+			case GL_UNIFORM_BUFFER: return IndexedUniformBuffer;
+			case GL_SHADER_STORAGE_BUFFER: return IndexedShaderStorageBuffer;
+			default: return IndexedBufferTargetsCount;
+			}
+		}
+
+		// Returns true when the call has to be issued, updating the shadow and the counters
+		template<typename T>
+		bool change(T& shadow, const T value)
+		{
+			if (shadow == value) {
+				++s_stats.skippedCalls;
+				return false;
+			}
+			shadow = value;
+			++s_stats.issuedCalls;
+			return true;
+		}
+
+		// Shadows an indexed bind, returns true when it has to be issued. An issued one also
+		// replaces the generic binding of the target.
+		bool changeIndexed(const GLenum target, const GLuint index, const IndexedBinding& binding)
+		{
+			const size_t indexedTarget = getIndexedBufferTarget(target);
+			if (indexedTarget != IndexedBufferTargetsCount && index < GLState::TrackedBufferIndices) {
+				if (!change(s_state.indexedBuffers[indexedTarget][index], binding)) {
+					return false;
+				}
+			}
+			else {
+				++s_stats.issuedCalls;
+			}
+			const size_t genericTarget = getBufferTarget(target);
+			if (genericTarget != BufferTargetsCount) {
+				s_state.buffers[genericTarget] = binding.buffer;
+			}
+			return true;
+		}
+
+		void setToggle(Toggle& shadow, const bool enabled, const GLenum capability)
+		{
+			if (change(shadow, enabled ? Toggle::Enabled : Toggle::Disabled)) {
+				enabled ? glEnable(capability) : glDisable(capability);
+			}
+		}
+	}
+
+	void GLState::useProgram(const unsigned int program)
+	{
+		if (change(s_state.program, program)) {
+			glUseProgram(program);
+		}
+	}
+
+	void GLState::bindVertexArray(const unsigned int vertexArray)
+	{
+		if (change(s_state.vertexArray, vertexArray)) {
+			glBindVertexArray(vertexArray);
+			s_state.buffers[ElementArrayBuffer] = Unknown;
+		}
+	}
+
+	void GLState::bindBuffer(const unsigned int target, const unsigned int buffer)
+	{
+		const size_t index = getBufferTarget(target);
+		if (index == BufferTargetsCount) {
+			++s_stats.issuedCalls;
+			glBindBuffer(target, buffer);
+			return;
+		}
+		if (change(s_state.buffers[index], buffer)) {
+			glBindBuffer(target, buffer);
+		}
+	}
+
+	void GLState::bindBufferBase(const unsigned int target, const unsigned int index, const unsigned int buffer)
+	{
+		if (changeIndexed(target, index, { buffer, 0, 0 })) {
+			glBindBufferBase(target, index, buffer);
+		}
+	}
+
+	void GLState::bindBufferRange(const unsigned int target, const unsigned int index, const unsigned int buffer,
+		const ptrdiff_t offset, const ptrdiff_t size)
+	{
+		if (changeIndexed(target, index, { buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size) })) {
+			glBindBufferRange(target, index, buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+		}
+	}
+
+	void GLState::bindFramebuffer(const unsigned int target, const unsigned int framebuffer)
+	{
+		const bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+		const bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+		if ((draw && s_state.drawFramebuffer != framebuffer) || (read && s_state.readFramebuffer != framebuffer)) {
+			++s_stats.issuedCalls;
+			glBindFramebuffer(target, framebuffer);
+			s_state.drawFramebuffer = draw ? framebuffer : s_state.drawFramebuffer;
+			s_state.readFramebuffer = read ? framebuffer : s_state.readFramebuffer;
+			return;
+		}
+		++s_stats.skippedCalls;
+	}
+
+	void GLState::bindTexture(const unsigned int unit, const unsigned int target, const unsigned int texture)
+	{
+		if (change(s_state.activeTexture, unit)) {
+			glActiveTexture(GL_TEXTURE0 + unit);
+		}
+		if (unit >= TrackedTextureUnits) {
+			++s_stats.issuedCalls;
+			glBindTexture(target, texture);
+			return;
+		}
+		if (change(s_state.textures[unit], texture)) {
+			glBindTexture(target, texture);
+		}
+	}
+
+	void GLState::viewport(const int x, const int y, const int width, const int height)
+	{
+		const GLint viewport[4] = { x, y, width, height };
+		if (std::memcmp(viewport, s_state.viewport, sizeof(viewport)) == 0) {
+			++s_stats.skippedCalls;
+			return;
+		}
+		++s_stats.issuedCalls;
+		std::memcpy(s_state.viewport, viewport, sizeof(viewport));
+		glViewport(x, y, width, height);
+	}
+
+	void GLState::clearColor(const float r, const float g, const float b, const float a)
+	{
+		const GLfloat color[4] = { r, g, b, a };
+		if (s_state.isClearColorKnown && std::memcmp(color, s_state.clearColor, sizeof(color)) == 0) {
+			++s_stats.skippedCalls;
+			return;
+		}
+		++s_stats.issuedCalls;
+		s_state.isClearColorKnown = true;
+		std::memcpy(s_state.clearColor, color, sizeof(color));
+		glClearColor(r, g, b, a);
+	}
+
+	void GLState::setBlendEnabled(const bool enabled)
+	{
+		setToggle(s_state.blend, enabled, GL_BLEND);
+	}
+
+	void GLState::blendFunc(const unsigned int source, const unsigned int destination)
+	{
+		if (s_state.blendSource == source && s_state.blendDestination == destination) {
+			++s_stats.skippedCalls;
+			return;
+		}
+		++s_stats.issuedCalls;
+		s_state.blendSource = source;
+		s_state.blendDestination = destination;
+		glBlendFunc(source, destination);
+	}
+
+	void GLState::setDepthTestEnabled(const bool enabled)
+	{
+		setToggle(s_state.depthTest, enabled, GL_DEPTH_TEST);
+	}
+
+	void GLState::depthFunc(const unsigned int func)
+	{
+		if (change(s_state.depthFunc, func)) {
+			glDepthFunc(func);
+		}
+	}
+
+	void GLState::depthMask(const bool enabled)
+	{
+		if (change(s_state.depthMask, enabled ? Toggle::Enabled : Toggle::Disabled)) {
+			glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+		}
+	}
+
+	void GLState::deleteProgram(const unsigned int program)
+	{
+		glDeleteProgram(program);
+		if (s_state.program == program) {
+			s_state.program = Unknown;
+		}
+	}
+
+	void GLState::deleteVertexArray(const unsigned int vertexArray)
+	{
+		glDeleteVertexArrays(1, &vertexArray);
+		if (s_state.vertexArray == vertexArray) {
+			s_state.vertexArray = 0;
+			s_state.buffers[ElementArrayBuffer] = Unknown;
+		}
+	}
+
+	void GLState::deleteBuffers(const int count, const unsigned int* buffers)
+	{
+		glDeleteBuffers(count, buffers);
+		for (int i = 0; i < count; ++i) {
+			for (GLuint& bound : s_state.buffers) {
+				if (bound == buffers[i]) {
+					bound = 0;
+				}
+			}
+			for (auto& slots : s_state.indexedBuffers) {
+				for (IndexedBinding& bound : slots) {
+					if (bound.buffer == buffers[i]) {
+						bound = { 0, 0, 0 };
+					}
+				}
+			}
+		}
+	}
+
+	void GLState::deleteFramebuffer(const unsigned int framebuffer)
+	{
+		glDeleteFramebuffers(1, &framebuffer);
+		if (s_state.drawFramebuffer == framebuffer) {
+			s_state.drawFramebuffer = 0;
+		}
+		if (s_state.readFramebuffer == framebuffer) {
+			s_state.readFramebuffer = 0;
+		}
+	}
+
+	void GLState::deleteTexture(const unsigned int texture)
+	{
+		glDeleteTextures(1, &texture);
+		for (GLuint& bound : s_state.textures) {
+			if (bound == texture) {
+				bound = 0;
+			}
+		}
+	}
+
+	void GLState::invalidate()
+	{
+		s_state = State();
+	}
+
+	void GLState::resetStats()
+	{
+		s_stats = GLStateStats();
+	}
+
+	const GLStateStats& GLState::getStats()
+	{
+		return s_stats;
+	}
+}
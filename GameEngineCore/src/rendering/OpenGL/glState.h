@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GameEngine {
+	struct GLStateStats {
+		// State changing calls that reached the driver
+		size_t issuedCalls = 0;
+		// Calls dropped because the shadowed value was already set
+		size_t skippedCalls = 0;
+	};
+
+	// Shadow of the binding and fixed-function state of the context. Every wrapper compares with
+	// the value it set last and only calls GL when it differs. Code that changes the state behind
+	// its back, like ImGui's renderer, has to call invalidate() afterwards.
+	// Objects must be deleted through the delete* wrappers: GL unbinds a deleted object and its
+	// name can be handed out again, a stale shadow would skip binding the new object.
+	class GLState {
+	public:
+		static void useProgram(const unsigned int program);
+		static void bindVertexArray(const unsigned int vertexArray);
+		// The element array binding belongs to the bound vertex array, it's forgotten when that changes
+		static void bindBuffer(const unsigned int target, const unsigned int buffer);
+		// Indexed binding points of GL_UNIFORM_BUFFER and GL_SHADER_STORAGE_BUFFER. Like in GL both also bind
+		// buffer to the generic target, the shadows of the slot and of the target are updated together.
+		static void bindBufferBase(const unsigned int target, const unsigned int index, const unsigned int buffer);
+		static void bindBufferRange(const unsigned int target, const unsigned int index, const unsigned int buffer,
+			const ptrdiff_t offset, const ptrdiff_t size);
+		// GL_FRAMEBUFFER binds both the draw and the read framebuffer
+		static void bindFramebuffer(const unsigned int target, const unsigned int framebuffer);
+		// Makes unit the active texture unit and binds texture to target on it
+		static void bindTexture(const unsigned int unit, const unsigned int target, const unsigned int texture);
+
+		static void viewport(const int x, const int y, const int width, const int height);
+		static void clearColor(const float r, const float g, const float b, const float a);
+		static void setBlendEnabled(const bool enabled);
+		static void blendFunc(const unsigned int source, const unsigned int destination);
+		static void setDepthTestEnabled(const bool enabled);
+		static void depthFunc(const unsigned int func);
+		static void depthMask(const bool enabled);
+
+		static void deleteProgram(const unsigned int program);
+		static void deleteVertexArray(const unsigned int vertexArray);
+		static void deleteBuffers(const int count, const unsigned int* buffers);
+		static void deleteFramebuffer(const unsigned int framebuffer);
+		static void deleteTexture(const unsigned int texture);
+
+		// Forgets everything, the next call of every wrapper reaches GL
+		static void invalidate();
+
+		// Texture units with a shadowed binding, higher ones always reach GL
+		static constexpr unsigned int TrackedTextureUnits = 32;
+		// Indexed buffer binding points with a shadow per target, higher ones always reach GL
+		static constexpr unsigned int TrackedBufferIndices = 16;
+
+		static void resetStats();
+		static const GLStateStats& getStats();
+	};
+}
@@ -0,0 +1,82 @@
+#include "gpuTimer.h"
+
+#include <glad/glad.h>
+
+namespace GameEngine {
+	namespace {
+		struct FrameQueries {
+			GLuint ids[GpuTimer::MaxQueriesPerFrame] = {};
+			const char* names[GpuTimer::MaxQueriesPerFrame] = {};
+			uint64_t cpuStarts[GpuTimer::MaxQueriesPerFrame] = {};
+			unsigned int count = 0;
+		};
+
+		FrameQueries s_frames[GpuTimer::FramesInFlight];
+		unsigned int s_frameIndex = 0;
+		bool s_isQueryActive = false;
+		bool s_isInitialized = false;
+	}
+
+	void GpuTimer::init()
+	{
+		for (FrameQueries& frame : s_frames) {
+			glGenQueries(MaxQueriesPerFrame, frame.ids);
+			frame.count = 0;
+		}
+		s_isInitialized = true;
+	}
+
+	void GpuTimer::shutdown()
+	{
+		if (!s_isInitialized) {
+			return;
+		}
+		for (FrameQueries& frame : s_frames) {
+			glDeleteQueries(MaxQueriesPerFrame, frame.ids);
+			frame.count = 0;
+		}
+		s_isInitialized = false;
+	}
+
+	void GpuTimer::beginFrame()
+	{
+		if (!s_isInitialized) {
+			return;
+		}
+		s_frameIndex = (s_frameIndex + 1) % FramesInFlight;
+
+		// The slot being reused was filled FramesInFlight frames ago, its results are normally ready
+		FrameQueries& frame = s_frames[s_frameIndex];
+		for (unsigned int i = 0; i < frame.count; ++i) {
+			GLint isAvailable = GL_FALSE;
+			glGetQueryObjectiv(frame.ids[i], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+			if (!isAvailable) {
+				continue;
+			}
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(frame.ids[i], GL_QUERY_RESULT, &elapsed);
+			Profiler::recordGpu(frame.names[i], frame.cpuStarts[i], elapsed);
+		}
+		frame.count = 0;
+	}
+
+	bool GpuTimer::begin(const char* name)
+	{
+		FrameQueries& frame = s_frames[s_frameIndex];
+		if (!s_isInitialized || !Profiler::isEnabled() || s_isQueryActive || frame.count == MaxQueriesPerFrame) {
+			return false;
+		}
+		frame.names[frame.count] = name;
+		frame.cpuStarts[frame.count] = Profiler::now();
+		glBeginQuery(GL_TIME_ELAPSED, frame.ids[frame.count]);
+		s_isQueryActive = true;
+		return true;
+	}
+
+	void GpuTimer::end()
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+		++s_frames[s_frameIndex].count;
+		s_isQueryActive = false;
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "profiler.h"
+
+#ifdef GAMEENGINE_PROFILER_ENABLED
+
+#define PROFILE_GPU_SCOPE(name) ::GameEngine::GpuProfileScope PROFILE_CONCAT(gpuProfileScope_, __LINE__)(name)
+
+#else
+
+#define PROFILE_GPU_SCOPE(name)
+
+#endif
+
+namespace GameEngine {
+	// GL_TIME_ELAPSED queries read back FramesInFlight frames later, so timing never stalls the pipeline.
+	// Elapsed queries can't nest, an inner scope is ignored while an outer one is active.
+	class GpuTimer {
+	public:
+		static constexpr unsigned int FramesInFlight = 4;
+		static constexpr unsigned int MaxQueriesPerFrame = 32;
+
+		static void init();
+		static void shutdown();
+
+		static void beginFrame();
+		static bool begin(const char* name);
+		static void end();
+	};
+
+	class GpuProfileScope {
+	public:
+		explicit GpuProfileScope(const char* name) : m_isActive(GpuTimer::begin(name)) {}
+		~GpuProfileScope()
+		{
+			if (m_isActive) {
+				GpuTimer::end();
+			}
+		}
+
+		GpuProfileScope(const GpuProfileScope&) = delete;
+		GpuProfileScope(GpuProfileScope&&) = delete;
+		GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+		GpuProfileScope& operator=(GpuProfileScope&&) = delete;
+	private:
+		bool m_isActive;
+	};
+}
@@ -1,5 +1,9 @@
+#define LOG_MODULE Renderer
+
 #include "indexBuffer.h"
 
+#include "glState.h"
+
 #include <glad/glad.h>
 #include <log.h>
 
@@ -9,19 +13,28 @@ namespace GameEngine {
 		: m_count(count)
 	{
 		glGenBuffers(1, &m_id);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
+		GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(GLuint), data, GLUsage(usage));
 	}
 	IndexBuffer::~IndexBuffer()
 	{
-		glDeleteBuffers(1, &m_id);
+		GLState::deleteBuffers(1, &m_id);
 	}
 	void IndexBuffer::bind() const
 	{
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
+		GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
 	}
 	void IndexBuffer::unbind()
 	{
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+	void IndexBuffer::setData(const void* data, const size_t count, const size_t offset)
+	{
+		if (offset + count > m_count) {
+			LOG_ERR("Index buffer overflow: {0} indices at offset {1}, buffer holds {2}", count, offset, m_count);
+			return;
+		}
+		bind();
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset * sizeof(GLuint), count * sizeof(GLuint), data);
 	}
 }
@@ -15,6 +15,9 @@ namespace GameEngine {
 		void bind() const;
 		static void unbind();
 
+		// Overwrites count indices starting at index offset, the range must fit into getCount()
+		void setData(const void* data, const size_t count, const size_t offset = 0);
+
 		inline size_t getCount() const { return m_count; }
 	private:
 		unsigned int m_id;
@@ -0,0 +1,257 @@
+#define LOG_MODULE Renderer
+
+#include "indirectRenderer.h"
+
+#include "shader.h"
+#include "vertexArray.h"
+#include "indexBuffer.h"
+#include "streamBuffer.h"
+#include "openGL_Renderer.h"
+#include "glState.h"
+
+#include <glad/glad.h>
+
+#include <cstring>
+#include <log.h>
+#include <profiler.h>
+
+namespace GameEngine {
+	namespace {
+		// Layout of a glMultiDrawElementsIndirect command, the culling shader writes them tightly packed
+		struct DrawElementsIndirectCommand {
+			uint32_t count;
+			uint32_t instanceCount;
+			uint32_t firstIndex;
+			int32_t baseVertex;
+			uint32_t baseInstance;
+		};
+		static_assert(sizeof(DrawElementsIndirectCommand) == 20, "Indirect commands are five 32-bit values");
+
+		constexpr size_t s_minObjectsCount = 1024;
+
+		size_t growCapacity(size_t capacity, const size_t required)
+		{
+			while (capacity < required) {
+				capacity *= 2;
+			}
+			return capacity;
+		}
+
+		// Every invocation tests one object and writes its command to the slot of the object,
+		// so gl_DrawID in the draw shader is the object index
+		const char* cullShaderSource = R"(
+			#version 460
+
+			layout (local_size_x = 64) in;
+
+			struct ObjectData {
+				mat4 model;
+				uint meshId;
+				uint padding[3];
+			};
+			struct MeshData {
+				uint indicesCount;
+				uint firstIndex;
+				int baseVertex;
+				uint padding;
+				vec4 bounds;
+			};
+			struct DrawCommand {
+				uint count;
+				uint instanceCount;
+				uint firstIndex;
+				int baseVertex;
+				uint baseInstance;
+			};
+
+			layout (std430, binding = 0) readonly buffer Objects { ObjectData objects[]; };
+			layout (std430, binding = 1) readonly buffer Meshes { MeshData meshes[]; };
+			layout (std430, binding = 2) writeonly buffer DrawCommands { DrawCommand commands[]; };
+			layout (std430, binding = 3) buffer VisibleCount { uint visibleCount; };
+
+			uniform vec4 frustum_planes[6];
+			uniform uint objects_count;
+
+			void main() {
+				const uint index = gl_GlobalInvocationID.x;
+				if (index >= objects_count) {
+					return;
+				}
+				const mat4 model = objects[index].model;
+				const MeshData mesh = meshes[objects[index].meshId];
+
+				const vec3 center = (model * vec4(mesh.bounds.xyz, 1)).xyz;
+				const float scale = max(length(model[0].xyz), max(length(model[1].xyz), length(model[2].xyz)));
+				const float radius = mesh.bounds.w * scale;
+
+				bool visible = true;
+				for (int plane = 0; plane < 6; ++plane) {
+					visible = visible && dot(frustum_planes[plane].xyz, center) + frustum_planes[plane].w >= -radius;
+				}
+
+				commands[index] = DrawCommand(mesh.indicesCount, visible ? 1u : 0u, mesh.firstIndex, mesh.baseVertex, index);
+				if (visible) {
+					atomicAdd(visibleCount, 1u);
+				}
+			}
+		)";
+	}
+
+	IndirectRenderer::IndirectRenderer(const BufferLayout& layout)
+		: m_layout(layout)
+	{
+		static_assert(sizeof(ObjectData) == 80, "ObjectData must match the std430 layout of the Objects block");
+		static_assert(sizeof(MeshData) == 32, "MeshData must match the std430 layout of the Meshes block");
+
+		m_cullShader = std::make_unique<Shader>(cullShaderSource);
+		m_isCompiled = m_cullShader->isCompiled();
+		m_frustumPlanesLocation = m_cullShader->getUniformLocation("frustum_planes");
+		m_objectsCountLocation = m_cullShader->getUniformLocation("objects_count");
+
+		glGenBuffers(1, &m_visibleCountBuffer);
+		GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_visibleCountBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(uint32_t), nullptr, GL_DYNAMIC_READ);
+	}
+
+	IndirectRenderer::~IndirectRenderer()
+	{
+		GLState::deleteBuffers(1, &m_meshesBuffer);
+		GLState::deleteBuffers(1, &m_commandsBuffer);
+		GLState::deleteBuffers(1, &m_visibleCountBuffer);
+	}
+
+	uint32_t IndirectRenderer::addMesh(
+		const void* vertices,
+		const size_t verticesCount,
+		const uint32_t* indices,
+		const size_t indicesCount,
+		const glm::vec3& boundsCenter,
+		const float boundsRadius
+	)
+	{
+		const size_t stride = m_layout.getStride();
+		const size_t firstByte = m_vertices.size();
+		m_vertices.resize(firstByte + verticesCount * stride);
+		std::memcpy(m_vertices.data() + firstByte, vertices, verticesCount * stride);
+
+		const size_t firstIndex = m_indices.size();
+		m_indices.insert(m_indices.end(), indices, indices + indicesCount);
+
+		m_meshes.push_back({
+			static_cast<uint32_t>(indicesCount),
+			static_cast<uint32_t>(firstIndex),
+			static_cast<int32_t>(m_verticesCount),
+			0,
+			glm::vec4(boundsCenter, boundsRadius)
+		});
+		m_verticesCount += verticesCount;
+		m_areMeshesDirty = true;
+		return static_cast<uint32_t>(m_meshes.size() - 1);
+	}
+
+	void IndirectRenderer::begin()
+	{
+		m_objects.clear();
+		m_stats = {};
+	}
+
+	void IndirectRenderer::submit(const uint32_t meshId, const glm::mat4& transform)
+	{
+		m_objects.push_back({ transform, meshId, {} });
+		++m_stats.submissions;
+		m_stats.indices += m_meshes[meshId].indicesCount;
+	}
+
+	void IndirectRenderer::flush(Shader& shader, const Frustum& frustum)
+	{
+		PROFILE_FUNCTION();
+		if (m_objects.empty() || !m_isCompiled) {
+			return;
+		}
+		if (m_areMeshesDirty) {
+			uploadMeshes();
+		}
+		reserveObjects(m_objects.size());
+		if (!m_objectsStream->isValid()) {
+			return;
+		}
+
+		const uint64_t fenceWaits = m_objectsStream->getFenceWaitsCount();
+		m_objectsStream->beginRegion();
+		m_stats.fenceWaits += m_objectsStream->getFenceWaitsCount() - fenceWaits;
+		const size_t objectsSize = m_objects.size() * sizeof(ObjectData);
+		std::memcpy(m_objectsStream->getRegionData(), m_objects.data(), objectsSize);
+
+		GLState::bindBufferRange(
+			GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(StorageBlockBinding::Objects), m_objectsStream->getHandle(),
+			static_cast<ptrdiff_t>(m_objectsStream->getRegionOffset()), static_cast<ptrdiff_t>(objectsSize)
+		);
+		GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(StorageBlockBinding::Meshes), m_meshesBuffer);
+		GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(StorageBlockBinding::DrawCommands), m_commandsBuffer);
+		GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(StorageBlockBinding::VisibleCount), m_visibleCountBuffer);
+
+		const uint32_t zero = 0;
+		GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_visibleCountBuffer);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zero), &zero);
+
+		const uint32_t objectsCount = static_cast<uint32_t>(m_objects.size());
+		m_cullShader->bind();
+		m_cullShader->setVec4Array(m_frustumPlanesLocation, frustum.planes, Frustum::PlanesCount);
+		m_cullShader->setUInt(m_objectsCountLocation, objectsCount);
+		glDispatchCompute((objectsCount + CullGroupSize - 1) / CullGroupSize, 1, 1);
+		// The commands are consumed as indirect parameters, not through another storage block read
+		glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+
+		shader.bind();
+		m_vertexArray->bind();
+		GLState::bindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandsBuffer);
+		OpenGL_Renderer::multiDrawIndirect(objectsCount);
+
+		m_objectsStream->endRegion();
+		++m_stats.drawCalls;
+	}
+
+	uint32_t IndirectRenderer::readVisibleCount() const
+	{
+		uint32_t visibleCount = 0;
+		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+		GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_visibleCountBuffer);
+		glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(visibleCount), &visibleCount);
+		return visibleCount;
+	}
+
+	void IndirectRenderer::uploadMeshes()
+	{
+		// Meshes are added at load time, rebuilding the shared buffers is simpler than suballocating them
+		m_vertexBuffer = std::make_unique<VertexBuffer>(m_vertices.data(), m_vertices.size(), m_layout);
+		m_indexBuffer = std::make_unique<IndexBuffer>(m_indices.data(), m_indices.size());
+		m_vertexArray = std::make_unique<VertexArray>();
+		m_vertexArray->addVertexBuffer(*m_vertexBuffer);
+		m_vertexArray->setIndexBuffer(*m_indexBuffer);
+
+		GLState::deleteBuffers(1, &m_meshesBuffer);
+		glGenBuffers(1, &m_meshesBuffer);
+		GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_meshesBuffer);
+		glBufferStorage(GL_SHADER_STORAGE_BUFFER, m_meshes.size() * sizeof(MeshData), m_meshes.data(), 0);
+
+		m_areMeshesDirty = false;
+		LOG_INFO("Indirect renderer buffers rebuilt: {0} meshes, {1} vertices, {2} indices",
+			m_meshes.size(), m_verticesCount, m_indices.size());
+	}
+
+	void IndirectRenderer::reserveObjects(const size_t count)
+	{
+		if (count <= m_objectsCapacity) {
+			return;
+		}
+		m_objectsCapacity = growCapacity(m_objectsCapacity ? m_objectsCapacity : s_minObjectsCount, count);
+
+		// The old buffers are released by the driver once the draws still reading them are done
+		m_objectsStream = std::make_unique<StreamBuffer>(m_objectsCapacity * sizeof(ObjectData));
+		GLState::deleteBuffers(1, &m_commandsBuffer);
+		glGenBuffers(1, &m_commandsBuffer);
+		GLState::bindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandsBuffer);
+		glBufferStorage(GL_DRAW_INDIRECT_BUFFER, m_objectsCapacity * sizeof(DrawElementsIndirectCommand), nullptr, 0);
+		LOG_INFO("Indirect renderer resized to {0} objects", m_objectsCapacity);
+	}
+}
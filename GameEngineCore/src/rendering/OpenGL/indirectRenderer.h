@@ -0,0 +1,120 @@
+#pragma once
+
+#include "vertexBuffer.h"
+#include "renderStats.h"
+#include "camera.h"
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace GameEngine {
+	class Shader;
+	class VertexArray;
+	class IndexBuffer;
+	class StreamBuffer;
+
+	// Binding points of the shader storage blocks read by the culling shader and the indirect draw shaders
+	enum class StorageBlockBinding : unsigned int {
+		Objects = 0,
+		Meshes = 1,
+		DrawCommands = 2,
+		VisibleCount = 3,
+	};
+
+	// GPU-driven path: every mesh lives in one shared vertex and index buffer, the objects of a frame
+	// are uploaded into a storage buffer and a compute shader culls them against the frustum, writing one
+	// DrawElementsIndirectCommand per object (culled ones get no instances). The scene then goes out
+	// with a single glMultiDrawElementsIndirect.
+	//
+	// The draw shader reads its model matrix from the Objects block with gl_DrawID:
+	//   struct ObjectData { mat4 model; uint meshId; uint padding[3]; };
+	//   layout (std430, binding = 0) readonly buffer Objects { ObjectData objects[]; };
+	//   ... objects[gl_DrawID].model ...
+	class IndirectRenderer {
+	public:
+		static constexpr uint32_t InvalidMeshId = UINT32_MAX;
+		// Local size of the culling shader
+		static constexpr uint32_t CullGroupSize = 64;
+
+		struct ObjectData {
+			glm::mat4 model;
+			uint32_t meshId;
+			uint32_t padding[3];
+		};
+
+		// Every mesh added later has to match layout, the first element is the Float3 position
+		explicit IndirectRenderer(const BufferLayout& layout);
+		IndirectRenderer() = delete;
+		~IndirectRenderer();
+
+		IndirectRenderer(const IndirectRenderer&) = delete;
+		IndirectRenderer(IndirectRenderer&&) = delete;
+		IndirectRenderer& operator=(const IndirectRenderer&) = delete;
+		IndirectRenderer& operator=(IndirectRenderer&&) = delete;
+
+		// Copies the mesh into the shared buffers, they are uploaded again on the next flush()
+		uint32_t addMesh(
+			const void* vertices,
+			const size_t verticesCount,
+			const uint32_t* indices,
+			const size_t indicesCount,
+			const glm::vec3& boundsCenter,
+			const float boundsRadius
+		);
+
+		void begin();
+		void submit(const uint32_t meshId, const glm::mat4& transform);
+		// Uploads the objects, culls them on the GPU and draws them with shader in one call
+		void flush(Shader& shader, const Frustum& frustum);
+
+		inline bool isCompiled() const { return m_isCompiled; }
+		inline const BufferLayout& getLayout() const { return m_layout; }
+		inline size_t getMeshesCount() const { return m_meshes.size(); }
+		// Draw calls and submissions, vertices and indices are counted before culling
+		inline const RenderStats& getStats() const { return m_stats; }
+		// Objects that passed the culling of the last flush(), waits for the GPU to finish it
+		uint32_t readVisibleCount() const;
+	private:
+		struct MeshData {
+			uint32_t indicesCount;
+			uint32_t firstIndex;
+			int32_t baseVertex;
+			uint32_t padding;
+			// Bounding sphere in mesh space, radius in w
+			glm::vec4 bounds;
+		};
+
+		void uploadMeshes();
+		void reserveObjects(const size_t count);
+
+		BufferLayout m_layout;
+		std::unique_ptr<Shader> m_cullShader;
+		int m_frustumPlanesLocation;
+		int m_objectsCountLocation;
+		bool m_isCompiled = false;
+
+		std::vector<uint8_t> m_vertices;
+		std::vector<uint32_t> m_indices;
+		size_t m_verticesCount = 0;
+		std::vector<MeshData> m_meshes;
+		bool m_areMeshesDirty = false;
+
+		std::unique_ptr<VertexBuffer> m_vertexBuffer;
+		std::unique_ptr<IndexBuffer> m_indexBuffer;
+		std::unique_ptr<VertexArray> m_vertexArray;
+		unsigned int m_meshesBuffer = 0;
+
+		std::vector<ObjectData> m_objects;
+		size_t m_objectsCapacity = 0;
+		std::unique_ptr<StreamBuffer> m_objectsStream;
+		unsigned int m_commandsBuffer = 0;
+		unsigned int m_visibleCountBuffer = 0;
+
+		RenderStats m_stats;
+	};
+}
@@ -1,12 +1,22 @@
+#define LOG_MODULE Renderer
+
 #include "openGL_Renderer.h"
 
 #include "vertexArray.h"
+#include "shader.h"
+#include "rendering/renderQueue.h"
+#include "glState.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
 #include <log.h>
 
+#include <cstring>
+
+bool GameEngine::OpenGL_Renderer::s_hasParallelShaderCompile = false;
+bool GameEngine::OpenGL_Renderer::s_isReverseZ = false;
+
 bool GameEngine::OpenGL_Renderer::init(GLFWwindow* pWindow)
 {
 	glfwMakeContextCurrent(pWindow);
@@ -17,6 +27,22 @@ bool GameEngine::OpenGL_Renderer::init(GLFWwindow* pWindow)
 	}
 	LOG_INFO("GLAD initialized");
 
+	// Both extensions share the enums, only the thread count entry point is named differently
+	using MaxShaderCompilerThreadsFn = void (*)(GLuint count);
+	MaxShaderCompilerThreadsFn maxShaderCompilerThreads = nullptr;
+	if (hasExtension("GL_KHR_parallel_shader_compile")) {
+		maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsFn>(glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+	}
+	else if (hasExtension("GL_ARB_parallel_shader_compile")) {
+		maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsFn>(glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+	}
+	s_hasParallelShaderCompile = maxShaderCompilerThreads != nullptr;
+	if (s_hasParallelShaderCompile) {
+		// 0xFFFFFFFF lets the driver pick the number of threads
+		maxShaderCompilerThreads(0xFFFFFFFF);
+		LOG_INFO("Parallel shader compilation enabled");
+	}
+
 	return true;
 }
 
@@ -25,19 +51,80 @@ void GameEngine::OpenGL_Renderer::draw(const VertexArray& vertexArray)
 	glDrawElements(GL_TRIANGLES, vertexArray.getIndicesCount(), GL_UNSIGNED_INT, nullptr);
 }
 
+void GameEngine::OpenGL_Renderer::draw(const size_t indicesCount, const size_t firstIndex)
+{
+	glDrawElements(
+		GL_TRIANGLES,
+		static_cast<GLsizei>(indicesCount),
+		GL_UNSIGNED_INT,
+		reinterpret_cast<const void*>(firstIndex * sizeof(GLuint))
+	);
+}
+
+void GameEngine::OpenGL_Renderer::drawInstanced(const VertexArray& vertexArray, const size_t instancesCount)
+{
+	glDrawElementsInstanced(
+		GL_TRIANGLES,
+		static_cast<GLsizei>(vertexArray.getIndicesCount()),
+		GL_UNSIGNED_INT,
+		nullptr,
+		static_cast<GLsizei>(instancesCount)
+	);
+}
+
+void GameEngine::OpenGL_Renderer::multiDrawIndirect(const size_t commandsCount)
+{
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commandsCount), 0);
+}
+
+void GameEngine::OpenGL_Renderer::execute(const DrawCommand* commands, const size_t count)
+{
+	const Shader* boundShader = nullptr;
+	const VertexArray* boundVertexArray = nullptr;
+	for (size_t i = 0; i < count; ++i) {
+		const DrawCommand& command = commands[i];
+		if (command.shader != boundShader) {
+			command.shader->bind();
+			boundShader = command.shader;
+		}
+		if (command.vertexArray != boundVertexArray) {
+			command.vertexArray->bind();
+			boundVertexArray = command.vertexArray;
+		}
+		command.shader->setMat4(command.modelMatrixLocation, *command.transform);
+		draw(command.indicesCount, command.firstIndex);
+	}
+}
+
 void GameEngine::OpenGL_Renderer::setClearColor(const float r, const float g, const float b, const float a)
 {
-	glClearColor(r, g, b, a);
+	GLState::clearColor(r, g, b, a);
 }
 
 void GameEngine::OpenGL_Renderer::clear()
 {
-	glClear(GL_COLOR_BUFFER_BIT);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void GameEngine::OpenGL_Renderer::setDepthTest(const bool enabled)
+{
+	GLState::setDepthTestEnabled(enabled);
+}
+
+void GameEngine::OpenGL_Renderer::setReverseZ(const bool reverseZ)
+{
+	if (s_isReverseZ == reverseZ) {
+		return;
+	}
+	s_isReverseZ = reverseZ;
+	glClipControl(GL_LOWER_LEFT, reverseZ ? GL_ZERO_TO_ONE : GL_NEGATIVE_ONE_TO_ONE);
+	glClearDepth(reverseZ ? 0.0 : 1.0);
+	GLState::depthFunc(reverseZ ? GL_GREATER : GL_LESS);
 }
 
 void GameEngine::OpenGL_Renderer::setViewPort(const int width, const int height, const int bottomOffset, const int leftOffset)
 {
-	glViewport(bottomOffset, leftOffset, width, height);
+	GLState::viewport(bottomOffset, leftOffset, width, height);
 }
 
 const char* GameEngine::OpenGL_Renderer::getVersion()
@@ -54,3 +141,17 @@ const char* GameEngine::OpenGL_Renderer::getVendor()
 {
 	return reinterpret_cast<const char*>(glGetString(GL_VENDOR));
 }
+
+
+bool GameEngine::OpenGL_Renderer::hasExtension(const char* name)
+{
+	GLint extensionsCount = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &extensionsCount);
+	for (GLint i = 0; i < extensionsCount; ++i) {
+		const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+		if (extension && std::strcmp(extension, name) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
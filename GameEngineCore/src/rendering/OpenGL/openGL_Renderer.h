@@ -1,21 +1,45 @@
 #pragma once
 
+#include <cstddef>
+
 struct GLFWwindow;
 
 namespace GameEngine {
 	class VertexArray;
+	struct DrawCommand;
 
 	class OpenGL_Renderer {
 	public:
+		// GL_COMPLETION_STATUS_KHR, the generated loader stops at core 4.6
+		static constexpr unsigned int CompletionStatus = 0x91B1;
+
 		static bool init(GLFWwindow* pWindow);
 
 		static void draw(const VertexArray& vertexArray);
+		// Draws a range of the bound vertex array's indices, binding is left to the caller so it can skip redundant ones
+		static void draw(const size_t indicesCount, const size_t firstIndex = 0);
+		static void drawInstanced(const VertexArray& vertexArray, const size_t instancesCount);
+		// Issues commandsCount tightly packed commands from the bound GL_DRAW_INDIRECT_BUFFER in one call,
+		// with the bound vertex array
+		static void multiDrawIndirect(const size_t commandsCount);
+		// Issues the commands in order, binding a program or vertex array only when it differs from the previous command
+		static void execute(const DrawCommand* commands, const size_t count);
 		static void setClearColor(const float r, const float g, const float b, const float a);
+		// Clears color and depth
 		static void clear();
+		static void setDepthTest(const bool enabled);
+		// Switches to a [0, 1] clip space depth range cleared to 0 with GL_GREATER, for reverse-Z projections
+		static void setReverseZ(const bool reverseZ);
 		static void setViewPort(const int width, const int height, const int bottomOffset = 0, const int leftOffset = 0);
 
 		static const char* getVersion();
 		static const char* getRenderer();
 		static const char* getVendor();
+		static bool hasExtension(const char* name);
+		// KHR/ARB_parallel_shader_compile, compiles and links run on driver threads and can be polled
+		inline static bool hasParallelShaderCompile() { return s_hasParallelShaderCompile; }
+	private:
+		static bool s_hasParallelShaderCompile;
+		static bool s_isReverseZ;
 	};
 }
\ No newline at end of file
@@ -1,88 +1,267 @@
+#define LOG_MODULE Renderer
+
 #include "shader.h"
 
+#include "openGL_Renderer.h"
+#include "glState.h"
+#include "rendering/renderQueue.h"
+
 #include <glad/glad.h>
 #include <log.h>
 
-bool GameEngine::Shader::createShader(const char* source, unsigned int type, unsigned int* id)
+#include <cstring>
+
+namespace {
+	struct UniformBlockName {
+		const char* name;
+		GameEngine::UniformBlockBinding binding;
+	};
+	constexpr UniformBlockName s_sharedBlocks[] = {
+		{ "CameraData", GameEngine::UniformBlockBinding::Camera },
+	};
+
+	GameEngine::DrawKeyIds s_sortIds;
+}
+
+GameEngine::Shader::Shader(const char* vertexShaderSource, const char* fragmentShaderSource)
+	: Shader(DeferredTag{})
 {
-	*id = glCreateShader(type);
-	glShaderSource(*id, 1, &source, 0);
-	glCompileShader(*id);
+	beginCompile(vertexShaderSource, fragmentShaderSource, false);
+	endCompile();
+}
+
+GameEngine::Shader::Shader(const char* computeShaderSource)
+	: Shader(DeferredTag{})
+{
+	const GLuint computeShaderId = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(computeShaderId, 1, &computeShaderSource, 0);
+	glCompileShader(computeShaderId);
+	glAttachShader(m_id, computeShaderId);
+	glLinkProgram(m_id);
 
 	GLint success;
-	glGetShaderiv(*id, GL_COMPILE_STATUS, &success);
+	glGetProgramiv(m_id, GL_LINK_STATUS, &success);
 	if (!success) {
+		logShaderError(computeShaderId, "Compute");
+
 		char info_log[512];
-		glGetShaderInfoLog(*id, 512, 0, info_log);
-		LOG_ERR("Shader compilation error:\n{}", info_log);
-		return false;
+		glGetProgramInfoLog(m_id, 512, 0, info_log);
+		LOG_ERR("Compute program link error:\n{}", info_log);
+	}
+	glDetachShader(m_id, computeShaderId);
+	glDeleteShader(computeShaderId);
+
+	if (success) {
+		m_isCompiled = true;
+		reflect();
 	}
-	return true;
 }
 
-GameEngine::Shader::Shader(const char* vertexShaderSource, const char* fragmentShaderSource)
+GameEngine::Shader::Shader(DeferredTag)
 {
 	m_id = glCreateProgram();
-	GLuint vs = 0;
-	GLuint fs = 0;
-
-	if (!createShader(vertexShaderSource, GL_VERTEX_SHADER, &vs)) {
-		LOG_ERR("Vertex shader compile error");
-		glDeleteShader(vs);
-		glDeleteShader(fs);
-		return;
-	}
-	if (!createShader(fragmentShaderSource, GL_FRAGMENT_SHADER, &fs)) {
-		LOG_ERR("Fragment shader compile error");
-		glDeleteShader(vs);
-		glDeleteShader(fs);
-		return;
-	}
+	m_sortId = s_sortIds.acquire();
+}
 
-	glAttachShader(m_id, vs);
-	glAttachShader(m_id, fs);
+void GameEngine::Shader::beginCompile(const char* vertexShaderSource, const char* fragmentShaderSource, const bool retrievable)
+{
+	m_vertexShaderId = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(m_vertexShaderId, 1, &vertexShaderSource, 0);
+	glCompileShader(m_vertexShaderId);
+
+	m_fragmentShaderId = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(m_fragmentShaderId, 1, &fragmentShaderSource, 0);
+	glCompileShader(m_fragmentShaderId);
+
+	// Linking right away without checking the stages keeps the driver from blocking here,
+	// a failed stage fails the link and is reported by endCompile()
+	glAttachShader(m_id, m_vertexShaderId);
+	glAttachShader(m_id, m_fragmentShaderId);
+	if (retrievable) {
+		glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
 	glLinkProgram(m_id);
+}
 
+bool GameEngine::Shader::isCompileFinished() const
+{
+	if (!OpenGL_Renderer::hasParallelShaderCompile()) {
+		return true;
+	}
+	GLint finished = GL_FALSE;
+	glGetProgramiv(m_id, OpenGL_Renderer::CompletionStatus, &finished);
+	return finished == GL_TRUE;
+}
+
+bool GameEngine::Shader::endCompile()
+{
 	GLint success;
 	glGetProgramiv(m_id, GL_LINK_STATUS, &success);
 	if (!success) {
+		logShaderError(m_vertexShaderId, "Vertex");
+		logShaderError(m_fragmentShaderId, "Fragment");
+
 		char info_log[512];
 		glGetProgramInfoLog(m_id, 512, 0, info_log);
 		LOG_ERR("Shader program compile error:\n{}", info_log);
-		
-		glDeleteShader(vs);
-		glDeleteShader(fs);
-		return;
 	}
 
+	glDetachShader(m_id, m_vertexShaderId);
+	glDetachShader(m_id, m_fragmentShaderId);
+	glDeleteShader(m_vertexShaderId);
+	glDeleteShader(m_fragmentShaderId);
+	m_vertexShaderId = 0;
+	m_fragmentShaderId = 0;
+
+	if (!success) {
+		return false;
+	}
+	m_isCompiled = true;
+	reflect();
+	return true;
+}
+
+bool GameEngine::Shader::loadBinary(const void* binary, const size_t size, const uint32_t format)
+{
+	glProgramBinary(m_id, static_cast<GLenum>(format), binary, static_cast<GLsizei>(size));
+
+	// A driver update invalidates old binaries, that's reported as a failed link
+	GLint success;
+	glGetProgramiv(m_id, GL_LINK_STATUS, &success);
+	if (!success) {
+		return false;
+	}
 	m_isCompiled = true;
-	glDetachShader(m_id, vs);
-	glDetachShader(m_id, fs);
-	glDeleteShader(vs);
-	glDeleteShader(fs);
+	reflect();
+	return true;
+}
+
+bool GameEngine::Shader::getBinary(std::vector<uint8_t>& binary, uint32_t& format) const
+{
+	GLint length = 0;
+	glGetProgramiv(m_id, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		binary.clear();
+		return false;
+	}
+
+	binary.resize(static_cast<size_t>(length));
+	GLenum binaryFormat = 0;
+	glGetProgramBinary(m_id, length, &length, &binaryFormat, binary.data());
+	binary.resize(static_cast<size_t>(length));
+	format = static_cast<uint32_t>(binaryFormat);
+	return !binary.empty();
+}
+
+void GameEngine::Shader::logShaderError(const unsigned int id, const char* stage)
+{
+	GLint success;
+	glGetShaderiv(id, GL_COMPILE_STATUS, &success);
+	if (!success) {
+		char info_log[512];
+		glGetShaderInfoLog(id, 512, 0, info_log);
+		LOG_ERR("{0} shader compilation error:\n{1}", stage, info_log);
+	}
+}
+
+void GameEngine::Shader::reflect()
+{
+	GLint uniformsCount = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &uniformsCount);
+	glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	std::string name(static_cast<size_t>(maxNameLength), '\0');
+	for (GLint i = 0; i < uniformsCount; ++i) {
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(m_id, static_cast<GLuint>(i), maxNameLength, &length, &size, &type, name.data());
+
+		const GLint location = glGetUniformLocation(m_id, name.c_str());
+		if (location == InvalidLocation) {
+			// Block members have no location, they are set through the block's buffer
+			continue;
+		}
+
+		// Arrays are reported as "name[0]", make them reachable by the plain name as well
+		std::string uniformName(name.c_str(), static_cast<size_t>(length));
+		if (size > 1 && uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0) {
+			m_uniformLocations[uniformName.substr(0, uniformName.size() - 3)] = location;
+		}
+		m_uniformLocations[std::move(uniformName)] = location;
+	}
+
+	GLint blocksCount = 0;
+	GLint maxBlockNameLength = 0;
+	glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_BLOCKS, &blocksCount);
+	glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxBlockNameLength);
+
+	std::string blockName(static_cast<size_t>(maxBlockNameLength), '\0');
+	for (GLint i = 0; i < blocksCount; ++i) {
+		glGetActiveUniformBlockName(m_id, static_cast<GLuint>(i), maxBlockNameLength, nullptr, blockName.data());
+		for (const UniformBlockName& sharedBlock : s_sharedBlocks) {
+			if (std::strcmp(sharedBlock.name, blockName.c_str()) == 0) {
+				glUniformBlockBinding(m_id, static_cast<GLuint>(i), static_cast<GLuint>(sharedBlock.binding));
+			}
+		}
+	}
 }
 
 GameEngine::Shader::~Shader()
 {
-	glDeleteProgram(m_id);
+	// Zero ids of stages that were already cleaned up are ignored
+	glDeleteShader(m_vertexShaderId);
+	glDeleteShader(m_fragmentShaderId);
+	GLState::deleteProgram(m_id);
+	s_sortIds.release(m_sortId);
 }
 
 void GameEngine::Shader::bind() const
 {
-	glUseProgram(m_id);
+	GLState::useProgram(m_id);
 }
 
 void GameEngine::Shader::unbind()
 {
-	glUseProgram(0);
+	GLState::useProgram(0);
+}
+
+int GameEngine::Shader::getUniformLocation(const char* uniform) const
+{
+	const auto it = m_uniformLocations.find(uniform);
+	if (it == m_uniformLocations.end()) {
+		return InvalidLocation;
+	}
+	return it->second;
+}
+
+void GameEngine::Shader::setFloat(const int location, float value)
+{
+	glUniform1f(location, value);
+}
+
+void GameEngine::Shader::setUInt(const int location, uint32_t value)
+{
+	glUniform1ui(location, value);
+}
+
+void GameEngine::Shader::setMat4(const int location, const glm::mat4& matrix)
+{
+	glUniformMatrix4fv(location, 1, false, glm::value_ptr(matrix));
+}
+
+void GameEngine::Shader::setVec4Array(const int location, const glm::vec4* values, const size_t count)
+{
+	glUniform4fv(location, static_cast<GLsizei>(count), glm::value_ptr(values[0]));
 }
 
 void GameEngine::Shader::setFloat(const char* uniform, float value)
 {
-	glUniform1f(glGetUniformLocation(m_id, uniform), value);
+	setFloat(getUniformLocation(uniform), value);
 }
 
 void GameEngine::Shader::setMat4(const char* uniform, const glm::mat4& matrix)
 {
-	glUniformMatrix4fv(glGetUniformLocation(m_id, uniform), 1, false, glm::value_ptr(matrix));
+	setMat4(getUniformLocation(uniform), matrix);
 }
@@ -3,10 +3,25 @@
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace GameEngine {
+	// Binding points of the uniform blocks shared by every program
+	enum class UniformBlockBinding : unsigned int {
+		Camera = 0,
+	};
+
 	class Shader {
 	public:
+		static constexpr int InvalidLocation = -1;
+
+		// Compiles and links right away, blocking until the program is ready
 		Shader(const char* vertexShaderSource, const char* fragmentShaderSource);
+		// Compute program, also compiled and linked right away
+		explicit Shader(const char* computeShaderSource);
 		Shader() = delete;
 		Shader(Shader&&) = delete;
 		Shader& operator=(Shader&&) = delete;
@@ -17,14 +32,46 @@ namespace GameEngine {
 		void bind() const;
 		static void unbind();
 		
+		// Locations are reflected once at link time, resolve them outside of the frame loop
+		int getUniformLocation(const char* uniform) const;
+
+		void setFloat(const int location, float value);
+		void setUInt(const int location, uint32_t value);
+		void setMat4(const int location, const glm::mat4& matrix);
+		void setVec4Array(const int location, const glm::vec4* values, const size_t count);
 		void setFloat(const char* uniform, float value);
 		void setMat4(const char* uniform, const glm::mat4& matrix);
 
 		inline bool isCompiled() const { return m_isCompiled; }
+		inline unsigned int getHandle() const { return m_id; }
+		// Dense id for the shader field of a DrawKey
+		inline uint32_t getSortId() const { return m_sortId; }
+
+		// Driver specific image of the linked program, empty if the driver doesn't provide one
+		bool getBinary(std::vector<uint8_t>& binary, uint32_t& format) const;
 	private:
-		static bool createShader(const char* source, unsigned int type, unsigned int* id);
+		friend class ShaderCache;
+
+		struct DeferredTag {};
+		// Creates the program only, the ShaderCache fills it with one of the calls below
+		explicit Shader(DeferredTag);
+
+		// Starts compiling and linking without waiting for the result
+		void beginCompile(const char* vertexShaderSource, const char* fragmentShaderSource, const bool retrievable);
+		// Polls with KHR_parallel_shader_compile, without it the driver is assumed to be done
+		bool isCompileFinished() const;
+		// Waits for the link if it's still running, reports errors and reflects the program
+		bool endCompile();
+		bool loadBinary(const void* binary, const size_t size, const uint32_t format);
+
+		static void logShaderError(const unsigned int id, const char* stage);
+		void reflect();
 
 		unsigned int m_id = 0;
-		bool m_isCompiled;
+		uint32_t m_sortId = 0;
+		unsigned int m_vertexShaderId = 0;
+		unsigned int m_fragmentShaderId = 0;
+		bool m_isCompiled = false;
+		std::unordered_map<std::string, int> m_uniformLocations;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,175 @@
+#define LOG_MODULE Renderer
+
+#include "shaderCache.h"
+
+#include "openGL_Renderer.h"
+
+#include <log.h>
+#include <profiler.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace GameEngine {
+	namespace {
+		uint64_t fnv1a(uint64_t hash, const char* data, const size_t size)
+		{
+			for (size_t i = 0; i < size; ++i) {
+				hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ull;
+			}
+			return hash;
+		}
+
+		uint64_t fnv1a(const uint64_t hash, const std::string& string)
+		{
+			// The terminator separates the parts, "ab" + "c" and "a" + "bc" hash differently
+			return fnv1a(hash, string.c_str(), string.size() + 1);
+		}
+	}
+
+	ShaderCache::ShaderCache(std::string directory)
+		: m_directory(std::move(directory))
+	{
+		const auto toString = [](const char* string) { return std::string(string ? string : ""); };
+		m_driver = toString(OpenGL_Renderer::getRenderer()) + '\n'
+			+ toString(OpenGL_Renderer::getVersion()) + '\n'
+			+ toString(OpenGL_Renderer::getVendor());
+
+		if (!m_directory.empty()) {
+			std::error_code error;
+			std::filesystem::create_directories(m_directory, error);
+			if (error) {
+				LOG_WARN("Can't create shader cache directory {0}: {1}", m_directory, error.message());
+			}
+		}
+	}
+
+	std::unique_ptr<Shader> ShaderCache::load(const char* vertexShaderSource, const char* fragmentShaderSource)
+	{
+		PROFILE_FUNCTION();
+		const auto begin = std::chrono::steady_clock::now();
+
+		std::unique_ptr<Shader> shader(new Shader(Shader::DeferredTag{}));
+		const uint64_t key = computeKey(vertexShaderSource, fragmentShaderSource);
+		if (readBinary(key, *shader)) {
+			++m_hitsCount;
+		}
+		else {
+			++m_missesCount;
+			shader->beginCompile(vertexShaderSource, fragmentShaderSource, !m_directory.empty());
+			m_pending.push_back({ shader.get(), key });
+		}
+
+		m_loadMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+		return shader;
+	}
+
+	void ShaderCache::finish()
+	{
+		PROFILE_FUNCTION();
+		const auto begin = std::chrono::steady_clock::now();
+
+		// Finished programs are handled as they come, the rest keep compiling in the meantime
+		while (!m_pending.empty()) {
+			bool isAnyFinished = false;
+			for (size_t i = 0; i < m_pending.size();) {
+				if (!m_pending[i].shader->isCompileFinished()) {
+					++i;
+					continue;
+				}
+				if (m_pending[i].shader->endCompile() && !m_directory.empty()) {
+					writeBinary(m_pending[i].key, *m_pending[i].shader);
+				}
+				m_pending[i] = m_pending.back();
+				m_pending.pop_back();
+				isAnyFinished = true;
+			}
+			if (!isAnyFinished) {
+				std::this_thread::yield();
+			}
+		}
+
+		m_loadMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+	}
+
+	uint64_t ShaderCache::computeKey(const char* vertexShaderSource, const char* fragmentShaderSource) const
+	{
+		uint64_t key = 14695981039346656037ull;
+		key = fnv1a(key, vertexShaderSource);
+		key = fnv1a(key, fragmentShaderSource);
+		return fnv1a(key, m_driver);
+	}
+
+	std::string ShaderCache::getPath(const uint64_t key) const
+	{
+		char name[32];
+		std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+		return (std::filesystem::path(m_directory) / name).string();
+	}
+
+	bool ShaderCache::readBinary(const uint64_t key, Shader& shader) const
+	{
+		if (m_directory.empty()) {
+			return false;
+		}
+
+		std::ifstream file(getPath(key), std::ios::binary);
+		if (!file) {
+			return false;
+		}
+
+		ShaderBinaryHeader header;
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+			|| header.magic != ShaderBinaryHeader::Magic
+			|| header.version != ShaderBinaryHeader::Version
+			|| header.key != key) {
+			LOG_WARN("Ignoring invalid shader cache entry {0}", getPath(key));
+			return false;
+		}
+
+		std::vector<char> binary(header.size);
+		if (!file.read(binary.data(), static_cast<std::streamsize>(binary.size()))) {
+			LOG_WARN("Ignoring truncated shader cache entry {0}", getPath(key));
+			return false;
+		}
+		if (!shader.loadBinary(binary.data(), binary.size(), header.format)) {
+			LOG_WARN("Driver rejected shader cache entry {0}, recompiling", getPath(key));
+			return false;
+		}
+		return true;
+	}
+
+	void ShaderCache::writeBinary(const uint64_t key, const Shader& shader) const
+	{
+		std::vector<uint8_t> binary;
+		uint32_t format = 0;
+		if (!shader.getBinary(binary, format)) {
+			LOG_WARN("Driver provides no program binaries, shaders won't be cached");
+			return;
+		}
+
+		const ShaderBinaryHeader header = {
+			ShaderBinaryHeader::Magic, ShaderBinaryHeader::Version, format, static_cast<uint32_t>(binary.size()), key
+		};
+		// Written aside and renamed, a crash mid-write must not leave a truncated entry behind
+		const std::string path = getPath(key);
+		const std::string temporaryPath = path + ".tmp";
+		{
+			std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+			if (!file) {
+				LOG_WARN("Failed writing shader cache entry {0}", path);
+				return;
+			}
+		}
+		std::error_code error;
+		std::filesystem::rename(temporaryPath, path, error);
+		if (error) {
+			LOG_WARN("Failed writing shader cache entry {0}: {1}", path, error.message());
+		}
+	}
+}
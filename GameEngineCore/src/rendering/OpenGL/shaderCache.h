@@ -0,0 +1,73 @@
+#pragma once
+
+#include "shader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace GameEngine {
+	// Cached program, little endian:
+	//   ShaderBinaryHeader
+	//   size bytes of glGetProgramBinary output
+	struct ShaderBinaryHeader {
+		static constexpr uint32_t Magic = 0x42534547; // "GESB"
+		static constexpr uint32_t Version = 1;
+
+		uint32_t magic;
+		uint32_t version;
+		uint32_t format;
+		uint32_t size;
+		uint64_t key;
+	};
+
+	// Programs keyed by a hash of their sources and the driver, stored as program binaries.
+	// Misses are compiled together, all requests are issued first and finish() polls them,
+	// so with KHR_parallel_shader_compile the driver builds them on its own threads.
+	//
+	//   ShaderCache cache("shader_cache");
+	//   auto shader = cache.load(vertexSource, fragmentSource);  // not usable yet
+	//   cache.finish();                                           // every loaded shader is ready
+	class ShaderCache {
+	public:
+		// Empty directory disables reading and writing binaries, everything is compiled
+		explicit ShaderCache(std::string directory);
+		ShaderCache() = delete;
+		~ShaderCache() = default;
+
+		ShaderCache(const ShaderCache&) = delete;
+		ShaderCache(ShaderCache&&) = delete;
+		ShaderCache& operator=(const ShaderCache&) = delete;
+		ShaderCache& operator=(ShaderCache&&) = delete;
+
+		std::unique_ptr<Shader> load(const char* vertexShaderSource, const char* fragmentShaderSource);
+		// Waits for every compile started by load() and stores the new binaries
+		void finish();
+
+		inline size_t getHitsCount() const { return m_hitsCount; }
+		inline size_t getMissesCount() const { return m_missesCount; }
+		// Time spent in load() and finish() since the cache was created
+		inline double getLoadMs() const { return m_loadMs; }
+	private:
+		struct PendingShader {
+			Shader* shader;
+			uint64_t key;
+		};
+
+		uint64_t computeKey(const char* vertexShaderSource, const char* fragmentShaderSource) const;
+		std::string getPath(const uint64_t key) const;
+		bool readBinary(const uint64_t key, Shader& shader) const;
+		void writeBinary(const uint64_t key, const Shader& shader) const;
+
+		std::string m_directory;
+		// Renderer, version and vendor strings, a binary only loads on the driver that produced it
+		std::string m_driver;
+		std::vector<PendingShader> m_pending;
+
+		size_t m_hitsCount = 0;
+		size_t m_missesCount = 0;
+		double m_loadMs = 0;
+	};
+}
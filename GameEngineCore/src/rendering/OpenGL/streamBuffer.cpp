@@ -0,0 +1,80 @@
+#define LOG_MODULE Renderer
+
+#include "streamBuffer.h"
+
+#include "glState.h"
+
+#include <glad/glad.h>
+#include <log.h>
+#include <profiler.h>
+
+#include <chrono>
+
+namespace GameEngine {
+	// Keeps region offsets valid for any attribute type and for uint32 indices
+	static constexpr size_t s_regionAlignment = 256;
+
+	StreamBuffer::StreamBuffer(const size_t regionSize)
+		: m_regionSize((regionSize + s_regionAlignment - 1) / s_regionAlignment * s_regionAlignment)
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		const GLsizeiptr size = static_cast<GLsizeiptr>(m_regionSize * RegionsCount);
+
+		glGenBuffers(1, &m_id);
+		GLState::bindBuffer(GL_COPY_WRITE_BUFFER, m_id);
+		glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, flags);
+		m_mappedData = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags));
+		GLState::bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		if (!m_mappedData) {
+			LOG_CRIT("Can't map a stream buffer of {0} bytes", size);
+		}
+	}
+
+	StreamBuffer::~StreamBuffer()
+	{
+		for (void* fence : m_fences) {
+			if (fence) {
+				glDeleteSync(static_cast<GLsync>(fence));
+			}
+		}
+		// Deleting a mapped buffer unmaps it
+		GLState::deleteBuffers(1, &m_id);
+	}
+
+	void StreamBuffer::beginRegion()
+	{
+		m_region = (m_region + 1) % RegionsCount;
+		GLsync fence = static_cast<GLsync>(m_fences[m_region]);
+		if (!fence) {
+			return;
+		}
+
+		// Poll first, a region RegionsCount - 1 frames old is normally already free
+		GLenum status = glClientWaitSync(fence, 0, 0);
+		if (status == GL_TIMEOUT_EXPIRED) {
+			PROFILE_SCOPE("Stream buffer fence wait");
+			const auto begin = std::chrono::steady_clock::now();
+			do {
+				status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			} while (status == GL_TIMEOUT_EXPIRED);
+
+			++m_fenceWaitsCount;
+			m_fenceWaitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+		}
+		if (status == GL_WAIT_FAILED) {
+			LOG_ERR("Stream buffer fence wait failed");
+		}
+
+		glDeleteSync(fence);
+		m_fences[m_region] = nullptr;
+	}
+
+	void StreamBuffer::endRegion()
+	{
+		if (m_fences[m_region]) {
+			glDeleteSync(static_cast<GLsync>(m_fences[m_region]));
+		}
+		m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+}
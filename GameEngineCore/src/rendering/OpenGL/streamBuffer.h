@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GameEngine {
+	// Immutable buffer mapped once with persistent coherent access and split into RegionsCount regions.
+	// Every frame writes into its own region while the GPU may still read the previous ones,
+	// a fence per region keeps the CPU from overwriting data that is still in flight.
+	//
+	//   stream.beginRegion();                   // waits only if the GPU is RegionsCount - 1 frames behind
+	//   std::memcpy(stream.getRegionData(), ...);
+	//   ...draw from getRegionOffset()...
+	//   stream.endRegion();                     // fences the commands that read the region
+	class StreamBuffer {
+	public:
+		static constexpr size_t RegionsCount = 3;
+
+		// Check isValid(), the driver can refuse the persistent mapping
+		explicit StreamBuffer(const size_t regionSize);
+		StreamBuffer() = delete;
+		~StreamBuffer();
+
+		StreamBuffer(const StreamBuffer&) = delete;
+		StreamBuffer(StreamBuffer&&) = delete;
+		StreamBuffer& operator=(const StreamBuffer&) = delete;
+		StreamBuffer& operator=(StreamBuffer&&) = delete;
+
+		// Moves to the next region and blocks until the GPU is done with it
+		void beginRegion();
+		void endRegion();
+
+		// False when the buffer couldn't be mapped, nothing may be written into it then
+		inline bool isValid() const { return m_mappedData != nullptr; }
+		inline void* getRegionData() const { return m_mappedData + getRegionOffset(); }
+		// Byte offset of the current region from the start of the buffer
+		inline size_t getRegionOffset() const { return m_region * m_regionSize; }
+		inline size_t getRegionSize() const { return m_regionSize; }
+		inline unsigned int getHandle() const { return m_id; }
+
+		// How many beginRegion() calls found the GPU still reading and had to block
+		inline uint64_t getFenceWaitsCount() const { return m_fenceWaitsCount; }
+		inline double getFenceWaitMs() const { return m_fenceWaitMs; }
+	private:
+		unsigned int m_id = 0;
+		uint8_t* m_mappedData = nullptr;
+		size_t m_regionSize;
+		size_t m_region = RegionsCount - 1;
+		// GLsync handles, kept opaque so the header doesn't need glad
+		void* m_fences[RegionsCount] = {};
+
+		uint64_t m_fenceWaitsCount = 0;
+		double m_fenceWaitMs = 0;
+	};
+}
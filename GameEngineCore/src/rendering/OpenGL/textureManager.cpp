@@ -0,0 +1,111 @@
+#define LOG_MODULE Renderer
+
+#include "textureManager.h"
+
+#include <algorithm>
+#include <log.h>
+
+namespace GameEngine {
+	TextureManager::TextureManager() = default;
+
+	TextureManager::~TextureManager()
+	{
+		for (const TextureId id : m_streaming) {
+			m_files.destroy(m_textures[id].file);
+		}
+	}
+
+	TextureId TextureManager::load(const std::string& path)
+	{
+		TextureFile* file = m_files.create();
+		if (!file->open(path)) {
+			m_files.destroy(file);
+			return InvalidTextureId;
+		}
+
+		const uint32_t coarsest = file->getMipsCount() - 1;
+		const uint32_t poolIndex = findPool(file->getWidth(), file->getHeight(), file->getMipsCount());
+		TexturePool& pool = *m_pools[poolIndex];
+		const uint32_t layer = pool.allocateLayer();
+		pool.upload(layer, coarsest, file->getMipData(coarsest));
+
+		const TextureId id = static_cast<TextureId>(m_textures.size());
+		if (coarsest != 0) {
+			m_streaming.push_back(id);
+		}
+		else {
+			m_files.destroy(file);
+			file = nullptr;
+		}
+		m_textures.push_back({ poolIndex, layer, coarsest, file });
+		return id;
+	}
+
+	void TextureManager::update(const size_t budgetBytes)
+	{
+		m_uploadedBytes = 0;
+		bool isBudgetSpent = false;
+		while (!m_streaming.empty() && !isBudgetSpent) {
+			// One pass gives every streaming texture its next level, so all of them sharpen together
+			size_t kept = 0;
+			size_t resumeIndex = 0;
+			for (size_t i = 0; i < m_streaming.size(); ++i) {
+				Texture& texture = m_textures[m_streaming[i]];
+				if (!isBudgetSpent) {
+					const uint32_t mip = texture.residentMip - 1;
+					const size_t size = texture.file->getMip(mip).size;
+					if (m_uploadedBytes != 0 && m_uploadedBytes + size > budgetBytes) {
+						isBudgetSpent = true;
+						resumeIndex = kept;
+					}
+					else {
+						m_pools[texture.poolIndex]->upload(texture.layer, mip, texture.file->getMipData(mip));
+						texture.residentMip = mip;
+						m_uploadedBytes += size;
+					}
+				}
+				if (texture.residentMip == 0) {
+					m_files.destroy(texture.file);
+					texture.file = nullptr;
+				}
+				else {
+					m_streaming[kept++] = m_streaming[i];
+				}
+			}
+			m_streaming.resize(kept);
+			// The next update continues the pass where the budget ran out instead of favouring the first textures
+			std::rotate(m_streaming.begin(), m_streaming.begin() + resumeIndex, m_streaming.end());
+		}
+	}
+
+	TextureStats TextureManager::getStats() const
+	{
+		TextureStats stats;
+		stats.pools.reserve(m_pools.size());
+		for (const std::unique_ptr<TexturePool>& pool : m_pools) {
+			stats.pools.push_back({
+				pool->getWidth(),
+				pool->getHeight(),
+				pool->getMipsCount(),
+				pool->getLayersCount(),
+				pool->getCapacity(),
+				pool->getMemoryBytes()
+			});
+		}
+		stats.streamingTextures = m_streaming.size();
+		stats.uploadedBytes = m_uploadedBytes;
+		return stats;
+	}
+
+	uint32_t TextureManager::findPool(const uint32_t width, const uint32_t height, const uint32_t mipsCount)
+	{
+		for (size_t i = 0; i < m_pools.size(); ++i) {
+			if (m_pools[i]->matches(width, height, mipsCount)) {
+				return static_cast<uint32_t>(i);
+			}
+		}
+		m_pools.push_back(std::make_unique<TexturePool>(width, height, mipsCount));
+		LOG_INFO("Created texture pool {0}x{1} with {2} mips", width, height, mipsCount);
+		return static_cast<uint32_t>(m_pools.size() - 1);
+	}
+}
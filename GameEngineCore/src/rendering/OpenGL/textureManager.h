@@ -0,0 +1,70 @@
+#pragma once
+
+#include "texturePool.h"
+#include "renderStats.h"
+#include "resources/textureFile.h"
+#include "memory/poolAllocator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace GameEngine {
+	using TextureId = uint32_t;
+	constexpr TextureId InvalidTextureId = UINT32_MAX;
+
+	// Loads cooked textures into the layer of a TexturePool matching their size and mip count.
+	// Only the coarsest mip is uploaded by load(), the finer ones follow in update() under a byte
+	// budget, so a blurry but complete image is available from the first frame.
+	//
+	// Levels finer than the resident mip hold undefined texels, the shader clamps the level it samples:
+	//   uniform sampler2DArray pool;
+	//   in flat uint layer; in flat float residentMip; // per instance
+	//   float lod = max(textureQueryLod(pool, uv).y, residentMip);
+	//   vec4 color = textureLod(pool, vec3(uv, layer), lod);
+	// Objects using different textures of a pool keep one binding and stay in the same batch.
+	class TextureManager {
+	public:
+		TextureManager();
+		~TextureManager();
+
+		TextureManager(const TextureManager&) = delete;
+		TextureManager(TextureManager&&) = delete;
+		TextureManager& operator=(const TextureManager&) = delete;
+		TextureManager& operator=(TextureManager&&) = delete;
+
+		// The file stays mapped until all of its levels are resident
+		TextureId load(const std::string& path);
+		// Uploads pending levels coarse-first, one level per texture in turn, until budgetBytes is spent.
+		// At least one level goes up per call so a small budget still makes progress.
+		void update(const size_t budgetBytes);
+
+		inline uint32_t getPoolIndex(const TextureId id) const { return m_textures[id].poolIndex; }
+		inline uint32_t getLayer(const TextureId id) const { return m_textures[id].layer; }
+		// Finest level that can be sampled, 0 once the texture is fully streamed
+		inline uint32_t getResidentMip(const TextureId id) const { return m_textures[id].residentMip; }
+		inline TexturePool& getPool(const size_t index) { return *m_pools[index]; }
+		inline size_t getPoolsCount() const { return m_pools.size(); }
+		inline size_t getTexturesCount() const { return m_textures.size(); }
+		inline size_t getStreamingCount() const { return m_streaming.size(); }
+		TextureStats getStats() const;
+	private:
+		struct Texture {
+			uint32_t poolIndex;
+			uint32_t layer;
+			uint32_t residentMip;
+			// Open while levels are left to stream
+			TextureFile* file;
+		};
+
+		uint32_t findPool(const uint32_t width, const uint32_t height, const uint32_t mipsCount);
+
+		std::vector<std::unique_ptr<TexturePool>> m_pools;
+		std::vector<Texture> m_textures;
+		ObjectPool<TextureFile> m_files;
+		std::vector<TextureId> m_streaming;
+		size_t m_uploadedBytes = 0;
+	};
+}
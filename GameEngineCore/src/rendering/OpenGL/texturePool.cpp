@@ -0,0 +1,101 @@
+#define LOG_MODULE Renderer
+
+#include "texturePool.h"
+
+#include "glState.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <log.h>
+
+namespace GameEngine {
+	// Uploads and copies bind the pool here, drawing code owns the other units
+	static constexpr unsigned int s_uploadUnit = 0;
+
+	TexturePool::TexturePool(const uint32_t width, const uint32_t height, const uint32_t mipsCount, const uint32_t capacity)
+		: m_width(width), m_height(height), m_mipsCount(mipsCount)
+	{
+		grow(std::max(1u, capacity));
+	}
+
+	TexturePool::~TexturePool()
+	{
+		GLState::deleteTexture(m_id);
+	}
+
+	uint32_t TexturePool::allocateLayer()
+	{
+		if (!m_freeLayers.empty()) {
+			const uint32_t layer = m_freeLayers.back();
+			m_freeLayers.pop_back();
+			return layer;
+		}
+		if (m_layersCount == m_capacity) {
+			grow(m_capacity * 2);
+		}
+		return m_layersCount++;
+	}
+
+	void TexturePool::freeLayer(const uint32_t layer)
+	{
+		m_freeLayers.push_back(layer);
+	}
+
+	void TexturePool::upload(const uint32_t layer, const uint32_t mip, const void* pixels)
+	{
+		GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		GLState::bindTexture(s_uploadUnit, GL_TEXTURE_2D_ARRAY, m_id);
+		glTexSubImage3D(
+			GL_TEXTURE_2D_ARRAY, static_cast<GLint>(mip), 0, 0, static_cast<GLint>(layer),
+			static_cast<GLsizei>(std::max(1u, m_width >> mip)), static_cast<GLsizei>(std::max(1u, m_height >> mip)), 1,
+			GL_RGBA, GL_UNSIGNED_BYTE, pixels
+		);
+	}
+
+	void TexturePool::bind(const unsigned int unit) const
+	{
+		GLState::bindTexture(unit, GL_TEXTURE_2D_ARRAY, m_id);
+	}
+
+	size_t TexturePool::getMemoryBytes() const
+	{
+		size_t bytes = 0;
+		for (uint32_t mip = 0; mip < m_mipsCount; ++mip) {
+			bytes += static_cast<size_t>(std::max(1u, m_width >> mip)) * std::max(1u, m_height >> mip) * 4;
+		}
+		return bytes * m_capacity;
+	}
+
+	void TexturePool::grow(const uint32_t capacity)
+	{
+		GLuint id;
+		glGenTextures(1, &id);
+		GLState::bindTexture(s_uploadUnit, GL_TEXTURE_2D_ARRAY, id);
+		glTexStorage3D(
+			GL_TEXTURE_2D_ARRAY, static_cast<GLsizei>(m_mipsCount), GL_RGBA8,
+			static_cast<GLsizei>(m_width), static_cast<GLsizei>(m_height), static_cast<GLsizei>(capacity)
+		);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+		// Copied on the GPU, levels that were never uploaded come along as undefined texels
+		if (m_id != 0) {
+			for (uint32_t mip = 0; mip < m_mipsCount; ++mip) {
+				glCopyImageSubData(
+					m_id, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(mip), 0, 0, 0,
+					id, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(mip), 0, 0, 0,
+					static_cast<GLsizei>(std::max(1u, m_width >> mip)), static_cast<GLsizei>(std::max(1u, m_height >> mip)),
+					static_cast<GLsizei>(m_layersCount)
+				);
+			}
+			GLState::deleteTexture(m_id);
+			LOG_INFO("Texture pool {0}x{1} with {2} mips grown to {3} layers", m_width, m_height, m_mipsCount, capacity);
+		}
+
+		m_id = id;
+		m_capacity = capacity;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GameEngine {
+	// RGBA8 textures of one size and mip count stored as the layers of a single GL_TEXTURE_2D_ARRAY.
+	// Objects sampling different layers of a pool keep the same binding and can share a batch, the
+	// layer is picked per instance in the shader. The array grows by doubling, copying the old layers.
+	class TexturePool {
+	public:
+		TexturePool(const uint32_t width, const uint32_t height, const uint32_t mipsCount, const uint32_t capacity = 16);
+		TexturePool() = delete;
+		~TexturePool();
+
+		TexturePool(const TexturePool&) = delete;
+		TexturePool(TexturePool&&) = delete;
+		TexturePool& operator=(const TexturePool&) = delete;
+		TexturePool& operator=(TexturePool&&) = delete;
+
+		uint32_t allocateLayer();
+		// The layer's content stays until it is allocated and uploaded again
+		void freeLayer(const uint32_t layer);
+		// Tightly packed RGBA8 rows of the mip level
+		void upload(const uint32_t layer, const uint32_t mip, const void* pixels);
+		void bind(const unsigned int unit) const;
+
+		inline bool matches(const uint32_t width, const uint32_t height, const uint32_t mipsCount) const
+		{
+			return m_width == width && m_height == height && m_mipsCount == mipsCount;
+		}
+		inline uint32_t getWidth() const { return m_width; }
+		inline uint32_t getHeight() const { return m_height; }
+		inline uint32_t getMipsCount() const { return m_mipsCount; }
+		inline uint32_t getLayersCount() const { return m_layersCount - static_cast<uint32_t>(m_freeLayers.size()); }
+		inline uint32_t getCapacity() const { return m_capacity; }
+		inline unsigned int getHandle() const { return m_id; }
+		// Video memory of the whole array including the unused layers
+		size_t getMemoryBytes() const;
+	private:
+		void grow(const uint32_t capacity);
+
+		unsigned int m_id = 0;
+		uint32_t m_width;
+		uint32_t m_height;
+		uint32_t m_mipsCount;
+		uint32_t m_capacity = 0;
+		uint32_t m_layersCount = 0;
+		std::vector<uint32_t> m_freeLayers;
+	};
+}
@@ -0,0 +1,32 @@
+#define LOG_MODULE Renderer
+
+#include "uniformBuffer.h"
+
+#include "glState.h"
+
+#include <glad/glad.h>
+#include <log.h>
+
+namespace GameEngine {
+	UniformBuffer::UniformBuffer(const size_t size, const unsigned int bindingPoint)
+		: m_bindingPoint(bindingPoint), m_size(size)
+	{
+		glGenBuffers(1, &m_id);
+		GLState::bindBuffer(GL_UNIFORM_BUFFER, m_id);
+		glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+		GLState::bindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, m_id);
+	}
+	UniformBuffer::~UniformBuffer()
+	{
+		GLState::deleteBuffers(1, &m_id);
+	}
+	void UniformBuffer::setData(const void* data, const size_t size, const size_t offset)
+	{
+		if (offset + size > m_size) {
+			LOG_ERR("Uniform buffer overflow: {0} bytes at offset {1}, buffer size is {2}", size, offset, m_size);
+			return;
+		}
+		GLState::bindBuffer(GL_UNIFORM_BUFFER, m_id);
+		glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+namespace GameEngine {
+	class UniformBuffer {
+	public:
+		UniformBuffer(const size_t size, const unsigned int bindingPoint);
+		UniformBuffer() = delete;
+		~UniformBuffer();
+
+		UniformBuffer(const UniformBuffer&) = delete;
+		UniformBuffer(UniformBuffer&&) = delete;
+		UniformBuffer& operator=(const UniformBuffer&) = delete;
+		UniformBuffer& operator=(UniformBuffer&&) = delete;
+
+		void setData(const void* data, const size_t size, const size_t offset = 0);
+
+		inline unsigned int getHandle() const { return m_id; }
+		inline unsigned int getBindingPoint() const { return m_bindingPoint; }
+	private:
+		unsigned int m_id = 0;
+		unsigned int m_bindingPoint;
+		size_t m_size;
+	};
+}
@@ -1,32 +1,61 @@
+#define LOG_MODULE Renderer
+
 #include "vertexArray.h"
 
+#include "streamBuffer.h"
+#include "glState.h"
+#include "rendering/renderQueue.h"
+
 #include <glad/glad.h>
 #include <log.h>
 
+namespace {
+	GameEngine::DrawKeyIds s_sortIds;
+}
+
 GameEngine::VertexArray::VertexArray()
 {
 	glGenVertexArrays(1, &m_id);
+	m_sortId = s_sortIds.acquire();
 }
 
 GameEngine::VertexArray::~VertexArray()
 {
-	glDeleteVertexArrays(1, &m_id);
+	GLState::deleteVertexArray(m_id);
+	s_sortIds.release(m_sortId);
 }
 
 void GameEngine::VertexArray::addVertexBuffer(const VertexBuffer& vertexBuffer)
 {
 	bind();
+	vertexBuffer.bind();
 	for (const BufferElement& currentElement : vertexBuffer.getLayout().getElements()) {
-		glEnableVertexAttribArray(m_elementsCount);
-		glVertexAttribPointer(
-			m_elementsCount,
-			static_cast<GLint>(currentElement.componentCount),
-			currentElement.componentType,
-			false,
-			static_cast<GLsizei>(vertexBuffer.getLayout().getStride()),
-			reinterpret_cast<const void*>(currentElement.offset)
-		);
-		++m_elementsCount;
+		const size_t slotSize = currentElement.size / currentElement.slotsCount;
+		for (size_t slot = 0; slot < currentElement.slotsCount; ++slot) {
+			const void* offset = reinterpret_cast<const void*>(currentElement.offset + slot * slotSize);
+			glEnableVertexAttribArray(m_elementsCount);
+			if (currentElement.componentType == GL_INT) {
+				glVertexAttribIPointer(
+					m_elementsCount,
+					static_cast<GLint>(currentElement.componentCount),
+					currentElement.componentType,
+					static_cast<GLsizei>(vertexBuffer.getLayout().getStride()),
+					offset
+				);
+			}
+			else {
+				glVertexAttribPointer(
+					m_elementsCount,
+					static_cast<GLint>(currentElement.componentCount),
+					currentElement.componentType,
+					false,
+					static_cast<GLsizei>(vertexBuffer.getLayout().getStride()),
+					offset
+				);
+			}
+			glVertexAttribDivisor(m_elementsCount, currentElement.divisor);
+			++m_elementsCount;
+		}
 	}
 }
 
@@ -37,12 +66,62 @@ void GameEngine::VertexArray::setIndexBuffer(const IndexBuffer& indexBuffer)
 	m_indicesCount = indexBuffer.getCount();
 }
 
+uint32_t GameEngine::VertexArray::addVertexBuffer(const StreamBuffer& streamBuffer, const BufferLayout& layout)
+{
+	const uint32_t binding = static_cast<uint32_t>(m_bindingStrides.size());
+	const auto& elements = layout.getElements();
+
+	bind();
+	for (const BufferElement& currentElement : elements) {
+		const size_t slotSize = currentElement.size / currentElement.slotsCount;
+		for (size_t slot = 0; slot < currentElement.slotsCount; ++slot) {
+			const GLuint relativeOffset = static_cast<GLuint>(currentElement.offset + slot * slotSize);
+			glEnableVertexAttribArray(m_elementsCount);
+			if (currentElement.componentType == GL_INT) {
+				glVertexAttribIFormat(
+					m_elementsCount, static_cast<GLint>(currentElement.componentCount), currentElement.componentType, relativeOffset
+				);
+			}
+			else {
+				glVertexAttribFormat(
+					m_elementsCount, static_cast<GLint>(currentElement.componentCount), currentElement.componentType, false, relativeOffset
+				);
+			}
+			glVertexAttribBinding(m_elementsCount, binding);
+			++m_elementsCount;
+		}
+		if (currentElement.divisor != elements.front().divisor) {
+			LOG_WARN("Elements of one stream buffer binding share the divisor of the first one");
+		}
+	}
+	glVertexBindingDivisor(binding, elements.empty() ? 0 : elements.front().divisor);
+
+	m_bindingStrides.push_back(layout.getStride());
+	setVertexBufferOffset(binding, streamBuffer, 0);
+	return binding;
+}
+
+void GameEngine::VertexArray::setVertexBufferOffset(const uint32_t binding, const StreamBuffer& streamBuffer, const size_t offset)
+{
+	bind();
+	glBindVertexBuffer(
+		binding, streamBuffer.getHandle(), static_cast<GLintptr>(offset), static_cast<GLsizei>(m_bindingStrides[binding])
+	);
+}
+
+void GameEngine::VertexArray::setIndexBuffer(const StreamBuffer& streamBuffer)
+{
+	bind();
+	GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, streamBuffer.getHandle());
+	m_indicesCount = streamBuffer.getRegionSize() / sizeof(GLuint);
+}
+
 void GameEngine::VertexArray::bind() const
 {
-	glBindVertexArray(m_id);
+	GLState::bindVertexArray(m_id);
 }
 
 void GameEngine::VertexArray::unbind()
 {
-	glBindVertexArray(0);
+	GLState::bindVertexArray(0);
 }
@@ -3,7 +3,12 @@
 #include "VertexBuffer.h"
 #include "indexBuffer.h"
 
+#include <cstdint>
+#include <vector>
+
 namespace GameEngine {
+	class StreamBuffer;
+
 	class VertexArray {
 	public:
 		VertexArray();
@@ -17,13 +22,26 @@ namespace GameEngine {
 		void addVertexBuffer(const VertexBuffer& vertexBuffer);
 		void setIndexBuffer(const IndexBuffer& indexBuffer);
 
+		// Records the attribute format of layout on a new buffer binding and returns its index.
+		// The buffer is attached with setVertexBufferOffset, so a stream buffer can move to its
+		// current region every frame without redefining the attributes.
+		uint32_t addVertexBuffer(const StreamBuffer& streamBuffer, const BufferLayout& layout);
+		void setVertexBufferOffset(const uint32_t binding, const StreamBuffer& streamBuffer, const size_t offset);
+		// Indices then come from the stream buffer, the draw call selects the region with its first index
+		void setIndexBuffer(const StreamBuffer& streamBuffer);
+
 		void bind() const;
 		static void unbind();
 
 		size_t getIndicesCount() const { return m_indicesCount; }
+		inline unsigned int getHandle() const { return m_id; }
+		// Dense id for the vertex array field of a DrawKey
+		inline uint32_t getSortId() const { return m_sortId; }
 	private:
 		unsigned int m_id = 0;
+		uint32_t m_sortId = 0;
 		unsigned int m_elementsCount = 0;
 		size_t m_indicesCount = 0;
+		std::vector<size_t> m_bindingStrides;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,9 @@
+#define LOG_MODULE Renderer
+
 #include "vertexBuffer.h"
 
+#include "glState.h"
+
 #include <glad/glad.h>
 #include <log.h>
 namespace GameEngine {
@@ -13,10 +17,22 @@ namespace GameEngine {
 			return 2;
 		case ShaderDataType::Float3:
 		case ShaderDataType::Int3:
+		case ShaderDataType::Mat3:
 			return 3;
 		case ShaderDataType::Float4:
 		case ShaderDataType::Int4:
+		case ShaderDataType::Mat4:
+			return 4;
+		}
+	}
+	inline constexpr unsigned int shaderDataTypeSlotsCount(const ShaderDataType type) {
+		switch (type) {
+		case ShaderDataType::Mat3:
+			return 3;
+		case ShaderDataType::Mat4:
 			return 4;
+		default:
+			return 1;
 		}
 	}
 	inline constexpr size_t shaderDataTypeSize(const ShaderDataType type) {
@@ -26,7 +42,9 @@ namespace GameEngine {
 			case ShaderDataType::Float2:
 			case ShaderDataType::Float3:
 			case ShaderDataType::Float4:
-				return sizeof(GLfloat) * shaderDataToComponentsCount(type);
+			case ShaderDataType::Mat3:
+			case ShaderDataType::Mat4:
+				return sizeof(GLfloat) * shaderDataToComponentsCount(type) * shaderDataTypeSlotsCount(type);
 
 			case ShaderDataType::Int:
 			case ShaderDataType::Int2:
@@ -42,6 +60,8 @@ namespace GameEngine {
 			case ShaderDataType::Float2:
 			case ShaderDataType::Float3:
 			case ShaderDataType::Float4:
+			case ShaderDataType::Mat3:
+			case ShaderDataType::Mat4:
 				return GL_FLOAT;
 
 			case ShaderDataType::Int:
@@ -73,21 +93,57 @@ namespace GameEngine {
 		}
 	}
 	VertexBuffer::VertexBuffer(const void* data, const size_t size, BufferLayout bufferLayout, const Usage usage)
-		: m_bufferLayout(std::move(bufferLayout))
+		: m_size(size), m_bufferLayout(std::move(bufferLayout))
 	{
 		glGenBuffers(1, &m_id);
-		glBindBuffer(GL_ARRAY_BUFFER, m_id);
+		GLState::bindBuffer(GL_ARRAY_BUFFER, m_id);
 		glBufferData(GL_ARRAY_BUFFER, size, data, GLUsage(usage));
 	}
 	VertexBuffer::~VertexBuffer()
 	{
-		glDeleteBuffers(1, &m_id);
+		GLState::deleteBuffers(1, &m_id);
+	}
+	void VertexBuffer::bind() const
+	{
+		GLState::bindBuffer(GL_ARRAY_BUFFER, m_id);
+	}
+	void VertexBuffer::unbind()
+	{
+		GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
 	}
-	BufferElement::BufferElement(const ShaderDataType type) :
+	void VertexBuffer::setData(const void* data, const size_t size, const size_t offset)
+	{
+		if (offset + size > m_size) {
+			LOG_ERR("Vertex buffer overflow: {0} bytes at offset {1}, buffer size is {2}", size, offset, m_size);
+			return;
+		}
+		bind();
+		glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+	}
+	BufferElement::BufferElement(const ShaderDataType type, const uint32_t divisor) :
 		type(type),
 		componentType(shaderDataTypeToComponentType(type)),
 		componentCount(shaderDataToComponentsCount(type)),
+		slotsCount(shaderDataTypeSlotsCount(type)),
 		size(shaderDataTypeSize(type)),
-		offset(0)
+		offset(0),
+		divisor(divisor)
 	{}
+	void BufferLayout::reportFull(const BufferElement& element)
+	{
+		LOG_ERR("Buffer layout can hold {0} elements, element of type {1} is dropped", MaxElements, static_cast<int>(element.type));
+	}
+
+	bool BufferLayout::operator==(const BufferLayout& other) const
+	{
+		if (m_stride != other.m_stride || m_elements.size() != other.m_elements.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < m_elements.size(); ++i) {
+			if (m_elements[i].type != other.m_elements[i].type || m_elements[i].divisor != other.m_elements[i].divisor) {
+				return false;
+			}
+		}
+		return true;
+	}
 }
@@ -1,6 +1,10 @@
 #pragma once
 
-#include <vector>
+#include "memory/inlineVector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
 
 namespace GameEngine {
 	enum class ShaderDataType {
@@ -13,36 +17,60 @@ namespace GameEngine {
 		Int2,
 		Int3,
 		Int4,
+
+		Mat3,
+		Mat4,
 	};
 
 	struct BufferElement {
 		ShaderDataType type;
 		uint32_t componentType;
-		size_t componentCount;
+		size_t componentCount; // per attribute slot, matrices take one slot per column
+		size_t slotsCount;
 		size_t size;
 		size_t offset;
+		uint32_t divisor; // 0 - per vertex, N - advances once per N instances
 
-		BufferElement(const ShaderDataType type);
+		BufferElement(const ShaderDataType type, const uint32_t divisor = 0);
 	};
 
+	// Elements are stored inline, building or copying a layout doesn't allocate
 	class BufferLayout {
 	public:
+		static constexpr size_t MaxElements = 16;
+		using Elements = InlineVector<BufferElement, MaxElements>;
+
+		BufferLayout() = default;
+		// Elements past MaxElements are logged and left out
 		BufferLayout(std::initializer_list<BufferElement> elements)
-			: m_elements(std::move(elements))
 		{
-			size_t offset = 0;
-			m_stride = 0;
-			for (auto& element : m_elements) {
-				element.offset = offset;
-				offset += element.size;
-				m_stride += element.size;
+			for (const BufferElement& element : elements) {
+				addElement(element);
 			}
 		}
 
-		inline const std::vector<BufferElement>& getElements() const { return m_elements; }
+		// Appends an element after the existing ones, fails once the layout holds MaxElements
+		inline bool addElement(const BufferElement& element)
+		{
+			if (m_elements.full()) {
+				reportFull(element);
+				return false;
+			}
+			m_elements.push_back(element);
+			m_elements.back().offset = m_stride;
+			m_stride += element.size;
+			return true;
+		}
+		inline const Elements& getElements() const { return m_elements; }
 		inline size_t getStride() const { return m_stride; }
+
+		bool operator==(const BufferLayout& other) const;
+		inline bool operator!=(const BufferLayout& other) const { return !(*this == other); }
 	private:
-		std::vector<BufferElement> m_elements;
+		// Out of line, the logging stays off the inlined path
+		static void reportFull(const BufferElement& element);
+
+		Elements m_elements;
 		size_t m_stride = 0;
 	};
 
@@ -61,10 +89,18 @@ namespace GameEngine {
 		VertexBuffer& operator=(const VertexBuffer&) = delete;
 		VertexBuffer& operator=(VertexBuffer&&) = delete;
 
+		void bind() const;
+		static void unbind();
+
+		// Overwrites [offset, offset + size) of the buffer, the range must fit into getSize()
+		void setData(const void* data, const size_t size, const size_t offset = 0);
+
 		inline unsigned int getHandle() const { return m_id; }
+		inline size_t getSize() const { return m_size; }
 		inline const BufferLayout& getLayout() const { return m_bufferLayout; }
 	private:
 		unsigned int m_id = 0;
+		size_t m_size = 0;
 		BufferLayout m_bufferLayout;
 	};
 }
\ No newline at end of file
@@ -1,120 +1,245 @@
 #include "camera.h"
 
+#include <algorithm>
+#include <cmath>
+
 GameEngine::Camera::Camera(const glm::vec3& position, const glm::vec3& rotation, const ProjectionMode projectionMode)
+	: m_projectionMode(projectionMode), m_position(position), m_rotation(rotation)
 {
-	updateViewMatrix();
-	updateProjectionMatrix();
+	updateOrientation();
 }
 
 void GameEngine::Camera::setPosition(const glm::vec3& position)
 {
 	m_position = position;
-	m_updateViewMatrix = true;
+	m_isViewDirty = true;
 }
 
 void GameEngine::Camera::setRotation(const glm::vec3& rotation)
 {
 	m_rotation = rotation;
-	m_updateViewMatrix = true;
+	m_isOrientationDirty = true;
+	m_isViewDirty = true;
 }
 
 void GameEngine::Camera::setPositionRotation(const glm::vec3& position, const glm::vec3& rotation)
 {
 	m_position = position;
 	m_rotation = rotation;
-	m_updateViewMatrix = true;
+	m_isOrientationDirty = true;
+	m_isViewDirty = true;
+}
+
+void GameEngine::Camera::setProjectionMode(const ProjectionMode projectionMode)
+{
+	if (m_projectionMode != projectionMode) {
+		m_projectionMode = projectionMode;
+		m_isProjectionDirty = true;
+	}
+}
+
+void GameEngine::Camera::setAspect(const float aspect)
+{
+	if (aspect > 0.f && m_aspect != aspect) {
+		m_aspect = aspect;
+		m_isProjectionDirty = true;
+	}
+}
+
+void GameEngine::Camera::setFieldOfView(const float degrees)
+{
+	if (m_fieldOfView != degrees) {
+		m_fieldOfView = degrees;
+		m_isProjectionDirty = true;
+	}
+}
+
+void GameEngine::Camera::setClipPlanes(const float nearPlane, const float farPlane)
+{
+	if (m_near != nearPlane || m_far != farPlane) {
+		m_near = nearPlane;
+		m_far = farPlane;
+		m_isProjectionDirty = true;
+	}
+}
+
+void GameEngine::Camera::setReverseZ(const bool reverseZ)
+{
+	if (m_isReverseZ != reverseZ) {
+		m_isReverseZ = reverseZ;
+		m_isProjectionDirty = true;
+	}
 }
 
 void GameEngine::Camera::moveForward(const float delta) 
 {
+	updateOrientation();
 	m_position += m_direction * delta;
-	m_updateViewMatrix = true;
+	m_isViewDirty = true;
 }
 void GameEngine::Camera::moveRight(const float delta) 
 {
+	updateOrientation();
 	m_position += m_right * delta;
-	m_updateViewMatrix = true;
+	m_isViewDirty = true;
 }
 void GameEngine::Camera::moveUp(const float delta) 
 {
+	updateOrientation();
 	m_position += m_up * delta;
-	m_updateViewMatrix = true;
+	m_isViewDirty = true;
 }
 
 void GameEngine::Camera::moveAndRotate(const glm::vec3& move_delta, const glm::vec3& rotate_delta)
 {
-	m_position += m_direction * move_delta.x;
-	m_position += m_right * move_delta.y;
-	m_position += m_up * move_delta.z;
-	m_rotation += rotate_delta;
-
-	m_updateViewMatrix = true;
+	// Called every tick with whatever the input produced, a camera standing still keeps its matrices
+	if (move_delta != glm::vec3(0.f)) {
+		updateOrientation();
+		m_position += m_direction * move_delta.x;
+		m_position += m_right * move_delta.y;
+		m_position += m_up * move_delta.z;
+		m_isViewDirty = true;
+	}
+	if (rotate_delta != glm::vec3(0.f)) {
+		m_rotation += rotate_delta;
+		m_isOrientationDirty = true;
+		m_isViewDirty = true;
+	}
 }
 
 void GameEngine::Camera::rotate(const glm::vec3& rotate_delta)
 {
 	m_rotation += rotate_delta;
 
-	m_updateViewMatrix = true;
+	m_isOrientationDirty = true;
+	m_isViewDirty = true;
 }
 
 const glm::mat4& GameEngine::Camera::getViewMatrix()
 {
-	if (m_updateViewMatrix) {
+	if (m_isViewDirty) {
 		updateViewMatrix();
 	}
 	return m_viewMatrix;
 }
 
-const glm::mat4& GameEngine::Camera::getProjectionMatrix() const
+const glm::mat4& GameEngine::Camera::getProjectionMatrix()
 {
+	if (m_isProjectionDirty) {
+		updateProjectionMatrix();
+	}
 	return m_projectionMatrix;
 }
 
-void GameEngine::Camera::setProjectionMode(const ProjectionMode projectionMode)
+const glm::mat4& GameEngine::Camera::getViewProjectionMatrix()
+{
+	const glm::mat4& projection = getProjectionMatrix();
+	const glm::mat4& view = getViewMatrix();
+	if (m_isViewProjectionDirty) {
+		m_viewProjectionMatrix = projection * view;
+		m_isViewProjectionDirty = false;
+	}
+	return m_viewProjectionMatrix;
+}
+
+GameEngine::Frustum GameEngine::Frustum::fromMatrix(const glm::mat4& viewProjection)
+{
+	const glm::vec4 row0 = { viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0] };
+	const glm::vec4 row1 = { viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1] };
+	const glm::vec4 row2 = { viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2] };
+	const glm::vec4 row3 = { viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3] };
+
+	Frustum frustum;
+	frustum.planes[Frustum::Left] = row3 + row0;
+	frustum.planes[Frustum::Right] = row3 - row0;
+	frustum.planes[Frustum::Bottom] = row3 + row1;
+	frustum.planes[Frustum::Top] = row3 - row1;
+	frustum.planes[Frustum::Near] = row3 + row2;
+	frustum.planes[Frustum::Far] = row3 - row2;
+
+	for (glm::vec4& plane : frustum.planes) {
+		const float length = glm::length(glm::vec3(plane.x, plane.y, plane.z));
+		if (length > 0.f) {
+			plane /= length;
+		}
+	}
+	return frustum;
+}
+
+GameEngine::Frustum GameEngine::Camera::getFrustum()
+{
+	return Frustum::fromMatrix(getViewProjectionMatrix());
+}
+
+float GameEngine::Camera::getPixelsPerUnit(const float distance, const float viewportHeight) const
+{
+	if (m_projectionMode == ProjectionMode::Orthographic) {
+		return viewportHeight / (2.f * m_orthographicSize);
+	}
+	return viewportHeight / (2.f * std::tan(glm::radians(m_fieldOfView) * 0.5f) * std::max(distance, m_near));
+}
+
+void GameEngine::Camera::updateOrientation()
 {
-	m_projectionMode = projectionMode;
-	updateProjectionMatrix();
+	if (!m_isOrientationDirty) {
+		return;
+	}
+	// Yaw around world Z, then pitch around Y, then roll around X. Roll and yaw turn clockwise,
+	// like the Euler matrices this replaces
+	m_orientation = glm::angleAxis(-m_rotation.z, glm::vec3(0.f, 0.f, 1.f))
+		* glm::angleAxis(m_rotation.y, glm::vec3(0.f, 1.f, 0.f))
+		* glm::angleAxis(-m_rotation.x, glm::vec3(1.f, 0.f, 0.f));
+
+	// The camera looks along the rotated X, right is the rotated -Y and up the rotated Z
+	const glm::mat3 basis = glm::mat3_cast(m_orientation);
+	m_direction = basis[0];
+	m_right = -basis[1];
+	m_up = basis[2];
+
+	m_isOrientationDirty = false;
 }
 
 void GameEngine::Camera::updateViewMatrix()
 {
-	const glm::mat3 rotationMatrix_x = {
-		1, 0, 0,
-		0, cos(m_rotation.x), -sin(m_rotation.x),
-		0, sin(m_rotation.x), cos(m_rotation.x),
-	};
-	const glm::mat3 rotationMatrix_y = {
-		cos(m_rotation.y), 0, -sin(m_rotation.y),
-		0, 1, 0,
-		sin(m_rotation.y), 0, cos(m_rotation.y),
-	};
-	const glm::mat3 rotationMatrix_z = {
-		cos(m_rotation.z), -sin(m_rotation.z), 0,
-		sin(m_rotation.z), cos(m_rotation.z), 0,
-		0, 0, 1,
-	};
-	const glm::mat3 euler_rotateMatrix = rotationMatrix_z * rotationMatrix_y * rotationMatrix_x;
-	m_direction = glm::normalize(euler_rotateMatrix * s_world_forward);
-	m_right = glm::normalize(euler_rotateMatrix * s_world_right);
-	m_up = glm::cross(m_right, m_direction);
-
-	m_viewMatrix = glm::lookAt(m_position, m_position + m_direction, m_up);
+	updateOrientation();
+
+	// Same as lookAt(m_position, m_position + m_direction, m_up) with the basis already orthonormal
+	m_viewMatrix = glm::mat4(
+		m_right.x, m_up.x, -m_direction.x, 0.f,
+		m_right.y, m_up.y, -m_direction.y, 0.f,
+		m_right.z, m_up.z, -m_direction.z, 0.f,
+		-glm::dot(m_right, m_position), -glm::dot(m_up, m_position), glm::dot(m_direction, m_position), 1.f
+	);
+	m_isViewDirty = false;
+	m_isViewProjectionDirty = true;
 }
 
 void GameEngine::Camera::updateProjectionMatrix()
 {
 	if (m_projectionMode == ProjectionMode::Perspective) {
-		m_projectionMatrix = glm::perspective(glm::radians(45.0f), 1.f, 0.f, 100.0f);
+		if (m_isReverseZ) {
+			// Infinite far plane: clip z is the near distance and w the view depth, so depth is near / depth
+			const float focalLength = 1.f / std::tan(glm::radians(m_fieldOfView) * 0.5f);
+			m_projectionMatrix = glm::mat4(0.f);
+			m_projectionMatrix[0][0] = focalLength / m_aspect;
+			m_projectionMatrix[1][1] = focalLength;
+			m_projectionMatrix[2][3] = -1.f;
+			m_projectionMatrix[3][2] = m_near;
+		}
+		else {
+			m_projectionMatrix = glm::perspective(glm::radians(m_fieldOfView), m_aspect, m_near, m_far);
+		}
 	}
 	else {
-		float r = 2;
-		float t = 2;
-		float f = 100;
-		float n = 0.1f;
-		m_projectionMatrix = glm::mat4(1 / r, 0, 0, 0,
-			0, 1 / t, 0, 0,
-			0, 0, -2 / (f - n), 0,
-			0, 0, (-f - n) / (f - n), 1);
+		const float top = m_orthographicSize;
+		const float right = m_orthographicSize * m_aspect;
+		m_projectionMatrix = glm::ortho(-right, right, -top, top, m_near, m_far);
+		if (m_isReverseZ) {
+			// Depth goes from 1 at near to 0 at far
+			m_projectionMatrix[2][2] = 1.f / (m_far - m_near);
+			m_projectionMatrix[3][2] = m_far / (m_far - m_near);
+		}
 	}
+	m_isProjectionDirty = false;
+	m_isViewProjectionDirty = true;
 }
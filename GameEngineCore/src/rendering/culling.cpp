@@ -0,0 +1,283 @@
+#include "culling.h"
+
+#include "profiler.h"
+#include "jobSystem.h"
+#include "memory/frameMemory.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define GAMEENGINE_CULLING_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define GAMEENGINE_CULLING_SSE
+#endif
+
+namespace GameEngine {
+	namespace {
+#if defined(GAMEENGINE_CULLING_AVX)
+		struct Simd {
+			using Float = __m256;
+			static constexpr size_t Width = 8;
+			static constexpr const char* Name = "AVX";
+
+			static inline Float load(const float* data) { return _mm256_loadu_ps(data); }
+			static inline Float set(const float value) { return _mm256_set1_ps(value); }
+			static inline Float add(const Float a, const Float b) { return _mm256_add_ps(a, b); }
+			static inline Float mul(const Float a, const Float b) { return _mm256_mul_ps(a, b); }
+			static inline Float greaterEqual(const Float a, const Float b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+			static inline Float bitAnd(const Float a, const Float b) { return _mm256_and_ps(a, b); }
+			static inline Float allTrue() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+			static inline int mask(const Float a) { return _mm256_movemask_ps(a); }
+		};
+#elif defined(GAMEENGINE_CULLING_SSE)
+		struct Simd {
+			using Float = __m128;
+			static constexpr size_t Width = 4;
+			static constexpr const char* Name = "SSE2";
+
+			static inline Float load(const float* data) { return _mm_loadu_ps(data); }
+			static inline Float set(const float value) { return _mm_set1_ps(value); }
+			static inline Float add(const Float a, const Float b) { return _mm_add_ps(a, b); }
+			static inline Float mul(const Float a, const Float b) { return _mm_mul_ps(a, b); }
+			static inline Float greaterEqual(const Float a, const Float b) { return _mm_cmpge_ps(a, b); }
+			static inline Float bitAnd(const Float a, const Float b) { return _mm_and_ps(a, b); }
+			static inline Float allTrue() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+			static inline int mask(const Float a) { return _mm_movemask_ps(a); }
+		};
+#endif
+
+		// Appends the set lanes of mask without branching, the store is unconditional and the count
+		// only advances for visible objects
+		template<size_t Width>
+		inline size_t writeVisible(int mask, const uint32_t first, uint32_t* visibleIndices, size_t count)
+		{
+			for (size_t lane = 0; lane < Width; ++lane) {
+				visibleIndices[count] = first + static_cast<uint32_t>(lane);
+				count += (mask >> lane) & 1;
+			}
+			return count;
+		}
+
+#if defined(GAMEENGINE_CULLING_AVX) || defined(GAMEENGINE_CULLING_SSE)
+		struct SimdPlanes {
+			Simd::Float x[Frustum::PlanesCount];
+			Simd::Float y[Frustum::PlanesCount];
+			Simd::Float z[Frustum::PlanesCount];
+			Simd::Float w[Frustum::PlanesCount];
+		};
+
+		SimdPlanes splatPlanes(const Frustum& frustum, const bool absoluteNormals)
+		{
+			SimdPlanes planes;
+			for (size_t p = 0; p < Frustum::PlanesCount; ++p) {
+				const glm::vec4& plane = frustum.planes[p];
+				planes.x[p] = Simd::set(absoluteNormals ? std::fabs(plane.x) : plane.x);
+				planes.y[p] = Simd::set(absoluteNormals ? std::fabs(plane.y) : plane.y);
+				planes.z[p] = Simd::set(absoluteNormals ? std::fabs(plane.z) : plane.z);
+				planes.w[p] = Simd::set(plane.w);
+			}
+			return planes;
+		}
+
+		inline Simd::Float planeDistance(const SimdPlanes& planes, const size_t p, const Simd::Float x, const Simd::Float y, const Simd::Float z)
+		{
+			return Simd::add(
+				Simd::add(Simd::mul(planes.x[p], x), Simd::mul(planes.y[p], y)),
+				Simd::add(Simd::mul(planes.z[p], z), planes.w[p])
+			);
+		}
+#endif
+	}
+
+	void BoundingSpheres::push(const glm::vec3& center, const float sphereRadius)
+	{
+		centerX.push_back(center.x);
+		centerY.push_back(center.y);
+		centerZ.push_back(center.z);
+		radius.push_back(sphereRadius);
+	}
+	void BoundingSpheres::reserve(const size_t count)
+	{
+		centerX.reserve(count);
+		centerY.reserve(count);
+		centerZ.reserve(count);
+		radius.reserve(count);
+	}
+	void BoundingSpheres::clear()
+	{
+		centerX.clear();
+		centerY.clear();
+		centerZ.clear();
+		radius.clear();
+	}
+
+	void BoundingBoxes::push(const glm::vec3& center, const glm::vec3& extent)
+	{
+		centerX.push_back(center.x);
+		centerY.push_back(center.y);
+		centerZ.push_back(center.z);
+		extentX.push_back(extent.x);
+		extentY.push_back(extent.y);
+		extentZ.push_back(extent.z);
+	}
+	void BoundingBoxes::reserve(const size_t count)
+	{
+		centerX.reserve(count);
+		centerY.reserve(count);
+		centerZ.reserve(count);
+		extentX.reserve(count);
+		extentY.reserve(count);
+		extentZ.reserve(count);
+	}
+	void BoundingBoxes::clear()
+	{
+		centerX.clear();
+		centerY.clear();
+		centerZ.clear();
+		extentX.clear();
+		extentY.clear();
+		extentZ.clear();
+	}
+
+	size_t Culling::cullSpheresScalar(const Frustum& frustum, const BoundingSpheres& spheres, size_t begin, size_t end, uint32_t* visibleIndices)
+	{
+		size_t count = 0;
+		for (size_t i = begin; i < end; ++i) {
+			bool isInside = true;
+			for (const glm::vec4& plane : frustum.planes) {
+				const float distance = plane.x * spheres.centerX[i] + plane.y * spheres.centerY[i] + plane.z * spheres.centerZ[i] + plane.w;
+				isInside &= distance >= -spheres.radius[i];
+			}
+			visibleIndices[count] = static_cast<uint32_t>(i);
+			count += isInside ? 1 : 0;
+		}
+		return count;
+	}
+
+	size_t Culling::cullBoxesScalar(const Frustum& frustum, const BoundingBoxes& boxes, size_t begin, size_t end, uint32_t* visibleIndices)
+	{
+		size_t count = 0;
+		for (size_t i = begin; i < end; ++i) {
+			bool isInside = true;
+			for (const glm::vec4& plane : frustum.planes) {
+				const float distance = plane.x * boxes.centerX[i] + plane.y * boxes.centerY[i] + plane.z * boxes.centerZ[i] + plane.w;
+				const float projectedExtent =
+					std::fabs(plane.x) * boxes.extentX[i] + std::fabs(plane.y) * boxes.extentY[i] + std::fabs(plane.z) * boxes.extentZ[i];
+				isInside &= distance + projectedExtent >= 0.f;
+			}
+			visibleIndices[count] = static_cast<uint32_t>(i);
+			count += isInside ? 1 : 0;
+		}
+		return count;
+	}
+
+	size_t Culling::cullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, size_t begin, size_t end, uint32_t* visibleIndices)
+	{
+#if defined(GAMEENGINE_CULLING_AVX) || defined(GAMEENGINE_CULLING_SSE)
+		const SimdPlanes planes = splatPlanes(frustum, false);
+
+		size_t count = 0;
+		size_t i = begin;
+		for (; i + Simd::Width <= end; i += Simd::Width) {
+			const Simd::Float x = Simd::load(&spheres.centerX[i]);
+			const Simd::Float y = Simd::load(&spheres.centerY[i]);
+			const Simd::Float z = Simd::load(&spheres.centerZ[i]);
+			const Simd::Float negativeRadius = Simd::mul(Simd::load(&spheres.radius[i]), Simd::set(-1.f));
+
+			Simd::Float inside = Simd::allTrue();
+			for (size_t p = 0; p < Frustum::PlanesCount; ++p) {
+				inside = Simd::bitAnd(inside, Simd::greaterEqual(planeDistance(planes, p, x, y, z), negativeRadius));
+			}
+			count = writeVisible<Simd::Width>(Simd::mask(inside), static_cast<uint32_t>(i), visibleIndices, count);
+		}
+		return count + cullSpheresScalar(frustum, spheres, i, end, visibleIndices + count);
+#else
+		return cullSpheresScalar(frustum, spheres, begin, end, visibleIndices);
+#endif
+	}
+
+	size_t Culling::cullBoxes(const Frustum& frustum, const BoundingBoxes& boxes, size_t begin, size_t end, uint32_t* visibleIndices)
+	{
+#if defined(GAMEENGINE_CULLING_AVX) || defined(GAMEENGINE_CULLING_SSE)
+		const SimdPlanes planes = splatPlanes(frustum, false);
+		const SimdPlanes absolutePlanes = splatPlanes(frustum, true);
+		const Simd::Float zero = Simd::set(0.f);
+
+		size_t count = 0;
+		size_t i = begin;
+		for (; i + Simd::Width <= end; i += Simd::Width) {
+			const Simd::Float x = Simd::load(&boxes.centerX[i]);
+			const Simd::Float y = Simd::load(&boxes.centerY[i]);
+			const Simd::Float z = Simd::load(&boxes.centerZ[i]);
+			const Simd::Float extentX = Simd::load(&boxes.extentX[i]);
+			const Simd::Float extentY = Simd::load(&boxes.extentY[i]);
+			const Simd::Float extentZ = Simd::load(&boxes.extentZ[i]);
+
+			Simd::Float inside = Simd::allTrue();
+			for (size_t p = 0; p < Frustum::PlanesCount; ++p) {
+				const Simd::Float projectedExtent = Simd::add(
+					Simd::add(Simd::mul(absolutePlanes.x[p], extentX), Simd::mul(absolutePlanes.y[p], extentY)),
+					Simd::mul(absolutePlanes.z[p], extentZ)
+				);
+				const Simd::Float distance = Simd::add(planeDistance(planes, p, x, y, z), projectedExtent);
+				inside = Simd::bitAnd(inside, Simd::greaterEqual(distance, zero));
+			}
+			count = writeVisible<Simd::Width>(Simd::mask(inside), static_cast<uint32_t>(i), visibleIndices, count);
+		}
+		return count + cullBoxesScalar(frustum, boxes, i, end, visibleIndices + count);
+#else
+		return cullBoxesScalar(frustum, boxes, begin, end, visibleIndices);
+#endif
+	}
+
+	namespace {
+		// Every range writes its visible indices at its own offset, the gaps are squeezed out afterwards.
+		// Ranges are culled in ascending order so the result matches the single threaded one.
+		template<typename Bounds, typename CullFn>
+		size_t cullParallel(const Frustum& frustum, const Bounds& bounds, uint32_t* visibleIndices, CullFn cull)
+		{
+			const size_t objectsCount = bounds.size();
+			if (objectsCount <= Culling::ParallelGrain || JobSystem::getWorkersCount() <= 1) {
+				return cull(frustum, bounds, 0, objectsCount, visibleIndices);
+			}
+
+			const size_t rangesCount = (objectsCount + Culling::ParallelGrain - 1) / Culling::ParallelGrain;
+			ScratchScope scratch;
+			size_t* rangeCounts = scratch.getArena().allocateArray<size_t>(rangesCount);
+			JobSystem::parallel_for(0, objectsCount, Culling::ParallelGrain, [&](const size_t rangeBegin, const size_t rangeEnd) {
+				rangeCounts[rangeBegin / Culling::ParallelGrain] = cull(frustum, bounds, rangeBegin, rangeEnd, visibleIndices + rangeBegin);
+			});
+
+			size_t count = rangeCounts[0];
+			for (size_t range = 1; range < rangesCount; ++range) {
+				std::memmove(visibleIndices + count, visibleIndices + range * Culling::ParallelGrain, rangeCounts[range] * sizeof(uint32_t));
+				count += rangeCounts[range];
+			}
+			return count;
+		}
+	}
+
+	size_t Culling::cullSpheresParallel(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t* visibleIndices)
+	{
+		PROFILE_FUNCTION();
+		return cullParallel(frustum, spheres, visibleIndices, &Culling::cullSpheres);
+	}
+
+	size_t Culling::cullBoxesParallel(const Frustum& frustum, const BoundingBoxes& boxes, uint32_t* visibleIndices)
+	{
+		PROFILE_FUNCTION();
+		return cullParallel(frustum, boxes, visibleIndices, &Culling::cullBoxes);
+	}
+
+	const char* Culling::getSimdName()
+	{
+#if defined(GAMEENGINE_CULLING_AVX) || defined(GAMEENGINE_CULLING_SSE)
+		return Simd::Name;
+#else
+		return "Scalar";
+#endif
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "camera.h"
+
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GameEngine {
+	// World-space bounding spheres stored as structure of arrays so the culling loop
+	// can test several objects against a plane with a single instruction
+	struct BoundingSpheres {
+		std::vector<float> centerX;
+		std::vector<float> centerY;
+		std::vector<float> centerZ;
+		std::vector<float> radius;
+
+		void push(const glm::vec3& center, const float sphereRadius);
+		void reserve(const size_t count);
+		void clear();
+		size_t size() const { return radius.size(); }
+	};
+
+	// Axis aligned boxes stored as center and half extents
+	struct BoundingBoxes {
+		std::vector<float> centerX;
+		std::vector<float> centerY;
+		std::vector<float> centerZ;
+		std::vector<float> extentX;
+		std::vector<float> extentY;
+		std::vector<float> extentZ;
+
+		void push(const glm::vec3& center, const glm::vec3& extent);
+		void reserve(const size_t count);
+		void clear();
+		size_t size() const { return extentX.size(); }
+	};
+
+	// Every cull function writes the indices of the visible objects of [begin, end) into visibleIndices
+	// in ascending order and returns how many were written. visibleIndices must hold end - begin entries.
+	class Culling {
+	public:
+		static size_t cullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, size_t begin, size_t end, uint32_t* visibleIndices);
+		static size_t cullBoxes(const Frustum& frustum, const BoundingBoxes& boxes, size_t begin, size_t end, uint32_t* visibleIndices);
+
+		// Reference paths without SIMD, the vectorized ones fall back to them for the tail
+		static size_t cullSpheresScalar(const Frustum& frustum, const BoundingSpheres& spheres, size_t begin, size_t end, uint32_t* visibleIndices);
+		static size_t cullBoxesScalar(const Frustum& frustum, const BoundingBoxes& boxes, size_t begin, size_t end, uint32_t* visibleIndices);
+
+		// Splits the whole set across the job system, visibleIndices must hold spheres.size() entries
+		static size_t cullSpheresParallel(const Frustum& frustum, const BoundingSpheres& spheres, uint32_t* visibleIndices);
+		static size_t cullBoxesParallel(const Frustum& frustum, const BoundingBoxes& boxes, uint32_t* visibleIndices);
+
+		// Name of the instruction set the vectorized paths were compiled for
+		static const char* getSimdName();
+
+		// Below that many objects the parallel variants stay on the calling thread
+		static constexpr size_t ParallelGrain = 16384;
+	};
+}
@@ -0,0 +1,22 @@
+#include "lodSelector.h"
+
+namespace GameEngine {
+	uint32_t LodSelector::select(
+		const LodLevel* levels,
+		const size_t levelsCount,
+		const uint32_t currentLevel,
+		const float projectedScale,
+		const float maxPixelError,
+		const float hysteresis
+	)
+	{
+		// Errors grow with the level, the first coarse enough level from the end wins
+		for (size_t level = levelsCount; level-- > 1;) {
+			const float budget = level > currentLevel ? maxPixelError * (1.f - hysteresis) : maxPixelError;
+			if (levels[level].error * projectedScale <= budget) {
+				return static_cast<uint32_t>(level);
+			}
+		}
+		return 0;
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GameEngine {
+	// Index range of one level of detail inside its mesh's index buffer
+	struct LodLevel {
+		uint32_t firstIndex;
+		uint32_t indicesCount;
+		// Largest distance of the level from the full detail surface, in mesh units
+		float error;
+	};
+
+	// Picks the coarsest level whose error, projected on screen, stays under a pixel budget. A level is
+	// only given up for a coarser one once that one fits the budget shrunk by the hysteresis, so an object
+	// resting near a threshold doesn't switch back and forth every frame.
+	class LodSelector {
+	public:
+		// projectedScale - screen pixels covered by one mesh unit of the object, the camera's pixels per
+		// world unit at the object's distance times its scale
+		static uint32_t select(
+			const LodLevel* levels,
+			const size_t levelsCount,
+			const uint32_t currentLevel,
+			const float projectedScale,
+			const float maxPixelError,
+			const float hysteresis = DefaultHysteresis
+		);
+
+		static constexpr float DefaultHysteresis = 0.25f;
+	};
+}
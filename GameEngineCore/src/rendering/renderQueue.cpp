@@ -0,0 +1,170 @@
+#include "renderQueue.h"
+
+#include "jobSystem.h"
+
+#include <profiler.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace GameEngine {
+	uint64_t DrawKey::make(const uint32_t layer, const uint32_t shader, const uint32_t material, const uint32_t vertexArray, const float depth)
+	{
+		const auto field = [](const uint32_t value, const uint32_t bits) {
+			return static_cast<uint64_t>(value) & ((uint64_t(1) << bits) - 1);
+		};
+		assert(layer < (1u << LayerBits) && "Draw key layer out of range");
+		assert(shader < (1u << ShaderBits) && "Draw key shader id out of range");
+		assert(material < (1u << MaterialBits) && "Draw key material id out of range");
+		assert(vertexArray < (1u << VertexArrayBits) && "Draw key vertex array id out of range");
+		const float clampedDepth = std::min(std::max(depth, 0.f), 1.f);
+		const uint32_t quantizedDepth = static_cast<uint32_t>(clampedDepth * static_cast<float>((1u << DepthBits) - 1));
+
+		uint64_t key = field(layer, LayerBits);
+		key = (key << ShaderBits) | field(shader, ShaderBits);
+		key = (key << MaterialBits) | field(material, MaterialBits);
+		key = (key << VertexArrayBits) | field(vertexArray, VertexArrayBits);
+		key = (key << DepthBits) | field(quantizedDepth, DepthBits);
+		return key;
+	}
+
+	uint32_t DrawKeyIds::acquire()
+	{
+		if (m_free.empty()) {
+			return m_next++;
+		}
+		const uint32_t id = m_free.back();
+		m_free.pop_back();
+		return id;
+	}
+
+	void DrawKeyIds::release(const uint32_t id)
+	{
+		m_free.push_back(id);
+	}
+
+	void RenderQueue::begin(const size_t commandsCount)
+	{
+		const size_t listsCount = std::max<size_t>(JobSystem::getWorkersCount(), 1);
+		if (m_lists.size() != listsCount) {
+			m_lists = std::vector<CommandList>(listsCount);
+		}
+		for (CommandList& list : m_lists) {
+			list = CommandList();
+		}
+
+		// Every list may leave its last block partly empty
+		const size_t blocksCount = (commandsCount + BlockSize - 1) / BlockSize + listsCount;
+		if (m_blocksCount < blocksCount) {
+			m_storage = std::make_unique<DrawCommand[]>(blocksCount * BlockSize);
+			m_blockSizes = std::make_unique<size_t[]>(blocksCount);
+			m_blocksCount = blocksCount;
+			m_merged.reserve(blocksCount * BlockSize);
+			m_sorted.reserve(blocksCount * BlockSize);
+		}
+		std::fill(m_blockSizes.get(), m_blockSizes.get() + m_blocksCount, size_t(0));
+		m_nextBlock.store(0, std::memory_order_relaxed);
+		m_droppedForeign.store(0, std::memory_order_relaxed);
+		m_merged.clear();
+		m_sorted.clear();
+	}
+
+	void RenderQueue::push(const DrawCommand& command)
+	{
+		const int worker = JobSystem::getWorkerIndex();
+		if (worker < 0) {
+			// Threads outside the job system have no list of their own
+			m_droppedForeign.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		CommandList& list = m_lists[static_cast<size_t>(worker)];
+		if (list.block == NoBlock || list.size == BlockSize) {
+			const size_t block = m_nextBlock.fetch_add(1, std::memory_order_relaxed);
+			if (block >= m_blocksCount) {
+				++list.dropped;
+				list.block = NoBlock;
+				return;
+			}
+			list.block = block;
+			list.size = 0;
+		}
+		m_storage[list.block * BlockSize + list.size++] = command;
+		m_blockSizes[list.block] = list.size;
+	}
+
+	size_t RenderQueue::getDroppedCount() const
+	{
+		size_t dropped = m_droppedForeign.load(std::memory_order_relaxed);
+		for (const CommandList& list : m_lists) {
+			dropped += list.dropped;
+		}
+		return dropped;
+	}
+
+	void RenderQueue::sort()
+	{
+		PROFILE_FUNCTION();
+		// Recording is over, the job system's join made every block visible to this thread
+		m_merged.clear();
+		const size_t usedBlocks = std::min(m_nextBlock.load(std::memory_order_relaxed), m_blocksCount);
+		for (size_t block = 0; block < usedBlocks; ++block) {
+			const DrawCommand* commands = m_storage.get() + block * BlockSize;
+			m_merged.insert(m_merged.end(), commands, commands + m_blockSizes[block]);
+		}
+		m_stateChangesUnsorted = countStateChanges(m_merged.data(), m_merged.size());
+
+		// LSD radix sort on the key, 8 bits per pass. Passes where every key has the same byte
+		// are skipped, with few shaders and vertex arrays most of the high bytes are constant.
+		const size_t count = m_merged.size();
+		m_sorted.resize(count);
+		std::vector<DrawCommand>* source = &m_merged;
+		std::vector<DrawCommand>* destination = &m_sorted;
+
+		size_t histograms[sizeof(uint64_t)][256] = {};
+		for (const DrawCommand& command : m_merged) {
+			for (size_t pass = 0; pass < sizeof(uint64_t); ++pass) {
+				++histograms[pass][(command.key >> (pass * 8)) & 0xFF];
+			}
+		}
+
+		for (size_t pass = 0; pass < sizeof(uint64_t) && count > 0; ++pass) {
+			size_t* histogram = histograms[pass];
+			const size_t shift = pass * 8;
+			if (histogram[(source->front().key >> shift) & 0xFF] == count) {
+				continue;
+			}
+
+			size_t offset = 0;
+			for (size_t bucket = 0; bucket < 256; ++bucket) {
+				const size_t bucketSize = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += bucketSize;
+			}
+			for (const DrawCommand& command : *source) {
+				(*destination)[histogram[(command.key >> shift) & 0xFF]++] = command;
+			}
+			std::swap(source, destination);
+		}
+		if (source != &m_sorted) {
+			m_sorted.swap(m_merged);
+		}
+
+		m_stateChangesSorted = countStateChanges(m_sorted.data(), m_sorted.size());
+	}
+
+	size_t RenderQueue::countStateChanges(const DrawCommand* commands, const size_t count)
+	{
+		size_t changes = 0;
+		const Shader* shader = nullptr;
+		const VertexArray* vertexArray = nullptr;
+		for (size_t i = 0; i < count; ++i) {
+			changes += commands[i].shader != shader;
+			changes += commands[i].vertexArray != vertexArray;
+			shader = commands[i].shader;
+			vertexArray = commands[i].vertexArray;
+		}
+		return changes;
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace GameEngine {
+	class Shader;
+	class VertexArray;
+
+	// Everything needed to issue one indexed draw, the transform is referenced, not copied
+	struct DrawCommand {
+		uint64_t key;
+		Shader* shader;
+		const VertexArray* vertexArray;
+		const glm::mat4* transform;
+		int modelMatrixLocation;
+		uint32_t indicesCount;
+		uint32_t firstIndex;
+	};
+
+	// Draw keys, most significant bits first:
+	//   layer    4 bits  - passes that must stay in order (opaque, transparent, UI...)
+	//   shader  12 bits  - program switches are the most expensive
+	//   material 12 bits - textures and uniforms inside a program
+	//   vao     16 bits  - vertex format and buffers
+	//   depth   20 bits  - front to back inside a state bucket, for early depth rejection
+	struct DrawKey {
+		static constexpr uint32_t LayerBits = 4;
+		static constexpr uint32_t ShaderBits = 12;
+		static constexpr uint32_t MaterialBits = 12;
+		static constexpr uint32_t VertexArrayBits = 16;
+		static constexpr uint32_t DepthBits = 20;
+
+		// Ids must fit their field, pass DrawKeyIds ids rather than GL names. Depth in [0, 1] is quantized.
+		static uint64_t make(const uint32_t layer, const uint32_t shader, const uint32_t material, const uint32_t vertexArray, const float depth);
+	};
+
+	// Small ids for the key fields: GL names are only unique, the driver may hand out values far past
+	// the 12 and 16 bit fields. Released ids are reused first so they stay below the number of live objects.
+	// Not thread safe, GL objects are created and deleted on the render thread.
+	class DrawKeyIds {
+	public:
+		uint32_t acquire();
+		void release(const uint32_t id);
+	private:
+		std::vector<uint32_t> m_free;
+		uint32_t m_next = 0;
+	};
+
+	// Draw commands recorded during the frame, sorted by key and then executed in one pass.
+	// Every job worker records into its own list, a chain of BlockSize command blocks claimed from
+	// storage shared by all lists with one atomic increment per block. The storage is sized in begin(),
+	// so a push never allocates or locks. Commands past the expected count are dropped and counted.
+	//
+	//   queue.begin(expectedCommands);
+	//   ...queue.push(command) from any job system worker...
+	//   queue.sort();
+	//   OpenGL_Renderer::execute(queue.getSortedCommands(), queue.size());
+	class RenderQueue {
+	public:
+		RenderQueue() = default;
+		~RenderQueue() = default;
+
+		RenderQueue(const RenderQueue&) = delete;
+		RenderQueue(RenderQueue&&) = delete;
+		RenderQueue& operator=(const RenderQueue&) = delete;
+		RenderQueue& operator=(RenderQueue&&) = delete;
+
+		static constexpr size_t BlockSize = 256;
+
+		// Empties the queue and makes room for commandsCount commands recorded by any mix of workers
+		void begin(const size_t commandsCount);
+		// Thread safe across job system workers, each one writes to its own list
+		void push(const DrawCommand& command);
+		// Merges the lists and radix sorts them by key, equal keys keep their merged order
+		void sort();
+
+		inline const DrawCommand* getSortedCommands() const { return m_sorted.data(); }
+		inline size_t size() const { return m_sorted.size(); }
+		// Commands dropped since the last begin() because the storage ran out
+		size_t getDroppedCount() const;
+		// Program and vertex array switches needed to execute the commands in recording and in sorted order
+		inline size_t getStateChangesUnsorted() const { return m_stateChangesUnsorted; }
+		inline size_t getStateChangesSorted() const { return m_stateChangesSorted; }
+
+		static size_t countStateChanges(const DrawCommand* commands, const size_t count);
+	private:
+		static constexpr size_t NoBlock = SIZE_MAX;
+
+		// Padded so workers writing their counters don't share a cache line
+		struct alignas(64) CommandList {
+			size_t block = NoBlock;
+			size_t size = 0;
+			size_t dropped = 0;
+		};
+
+		std::unique_ptr<DrawCommand[]> m_storage;
+		// Commands written to every block, each block has a single writer
+		std::unique_ptr<size_t[]> m_blockSizes;
+		size_t m_blocksCount = 0;
+		std::atomic<size_t> m_nextBlock = 0;
+		std::atomic<size_t> m_droppedForeign = 0;
+		std::vector<CommandList> m_lists;
+		std::vector<DrawCommand> m_merged;
+		std::vector<DrawCommand> m_sorted;
+		size_t m_stateChangesUnsorted = 0;
+		size_t m_stateChangesSorted = 0;
+	};
+}
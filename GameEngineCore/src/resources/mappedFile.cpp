@@ -0,0 +1,118 @@
+#define LOG_MODULE Resources
+
+#include "mappedFile.h"
+
+#include <log.h>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace GameEngine {
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+#ifdef _WIN32
+	bool MappedFile::open(const std::string& path)
+	{
+		close();
+
+		HANDLE file = CreateFileA(
+			path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+		);
+		if (file == INVALID_HANDLE_VALUE) {
+			LOG_ERR("Can't open file {0}", path);
+			return false;
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+			LOG_ERR("Can't map empty file {0}", path);
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (!data) {
+			LOG_ERR("Can't map file {0}", path);
+			if (mapping) {
+				CloseHandle(mapping);
+			}
+			CloseHandle(file);
+			return false;
+		}
+
+		m_fileHandle = file;
+		m_mappingHandle = mapping;
+		m_data = data;
+		m_size = static_cast<size_t>(size.QuadPart);
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data) {
+			UnmapViewOfFile(m_data);
+			CloseHandle(m_mappingHandle);
+			CloseHandle(m_fileHandle);
+		}
+		m_data = nullptr;
+		m_size = 0;
+		m_fileHandle = nullptr;
+		m_mappingHandle = nullptr;
+	}
+#else
+	bool MappedFile::open(const std::string& path)
+	{
+		close();
+
+		const int file = ::open(path.c_str(), O_RDONLY);
+		if (file < 0) {
+			LOG_ERR("Can't open file {0}", path);
+			return false;
+		}
+
+		struct stat status;
+		if (fstat(file, &status) != 0 || status.st_size == 0) {
+			LOG_ERR("Can't map empty file {0}", path);
+			::close(file);
+			return false;
+		}
+
+		const size_t size = static_cast<size_t>(status.st_size);
+		void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		// The mapping keeps its own reference to the file
+		::close(file);
+		if (data == MAP_FAILED) {
+			LOG_ERR("Can't map file {0}", path);
+			return false;
+		}
+		// The whole file is about to be streamed into a buffer, let the kernel read ahead
+		madvise(data, size, MADV_SEQUENTIAL);
+		madvise(data, size, MADV_WILLNEED);
+
+		m_data = data;
+		m_size = size;
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data) {
+			munmap(const_cast<void*>(m_data), m_size);
+		}
+		m_data = nullptr;
+		m_size = 0;
+	}
+#endif
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace GameEngine {
+	// Read-only view of a whole file mapped into the address space,
+	// pages are loaded by the OS on first access instead of being copied up front
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&&) = delete;
+
+		bool open(const std::string& path);
+		void close();
+
+		inline bool isOpen() const { return m_data != nullptr; }
+		inline const void* getData() const { return m_data; }
+		inline size_t getSize() const { return m_size; }
+	private:
+		const void* m_data = nullptr;
+		size_t m_size = 0;
+#ifdef _WIN32
+		void* m_fileHandle = nullptr;
+		void* m_mappingHandle = nullptr;
+#endif
+	};
+}
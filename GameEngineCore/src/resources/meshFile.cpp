@@ -0,0 +1,188 @@
+#define LOG_MODULE Resources
+
+#include "meshFile.h"
+
+#include <log.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace GameEngine {
+	// The header is written and mapped as is, it must have the same layout on every compiler
+	static_assert(sizeof(MeshFileHeader) == 224, "Mesh file header layout changed");
+	static_assert(MeshFileHeader::MaxLayoutElements <= BufferLayout::MaxElements, "Every stored layout must fit into a BufferLayout");
+
+	static uint64_t alignBlob(const uint64_t offset)
+	{
+		return (offset + MeshFileHeader::BlobAlignment - 1) / MeshFileHeader::BlobAlignment * MeshFileHeader::BlobAlignment;
+	}
+
+	static bool blobFits(const uint64_t offset, const uint64_t count, const uint64_t elementSize, const uint64_t fileSize)
+	{
+		if (offset % MeshFileHeader::BlobAlignment != 0 || offset > fileSize) {
+			return false;
+		}
+		return elementSize == 0 || count <= (fileSize - offset) / elementSize;
+	}
+
+	static bool lodsFit(const MeshFileLod* lods, const uint64_t lodsCount, const uint64_t indicesCount)
+	{
+		if (lodsCount == 0 || lodsCount > MeshFileHeader::MaxLods) {
+			return false;
+		}
+		for (uint64_t i = 0; i < lodsCount; ++i) {
+			if (lods[i].indicesCount % 3 != 0 || lods[i].firstIndex > indicesCount || lods[i].indicesCount > indicesCount - lods[i].firstIndex) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool MeshFile::open(const std::string& path)
+	{
+		close();
+		if (!m_file.open(path)) {
+			return false;
+		}
+
+		if (m_file.getSize() < sizeof(MeshFileHeader)) {
+			LOG_ERR("Mesh file {0} is truncated", path);
+			m_file.close();
+			return false;
+		}
+		const MeshFileHeader* header = static_cast<const MeshFileHeader*>(m_file.getData());
+		if (header->magic != MeshFileHeader::Magic || header->version != MeshFileHeader::Version) {
+			LOG_ERR("{0} is not a mesh file of version {1}", path, MeshFileHeader::Version);
+			m_file.close();
+			return false;
+		}
+		if (header->layoutElementsCount == 0 || header->layoutElementsCount > MeshFileHeader::MaxLayoutElements) {
+			LOG_ERR("Mesh file {0} has an invalid layout", path);
+			m_file.close();
+			return false;
+		}
+
+		BufferLayout layout;
+		for (uint32_t i = 0; i < header->layoutElementsCount; ++i) {
+			if (header->layout[i] > static_cast<uint8_t>(ShaderDataType::Mat4)) {
+				LOG_ERR("Mesh file {0} has an unknown attribute type {1}", path, header->layout[i]);
+				m_file.close();
+				return false;
+			}
+			layout.addElement(static_cast<ShaderDataType>(header->layout[i]));
+		}
+
+		const uint64_t fileSize = m_file.getSize();
+		if (layout.getStride() != header->stride
+			|| !blobFits(header->verticesOffset, header->verticesCount, header->stride, fileSize)
+			|| !blobFits(header->indicesOffset, header->indicesCount, sizeof(uint32_t), fileSize)
+			|| !lodsFit(header->lods, header->lodsCount, header->indicesCount)) {
+			LOG_ERR("Mesh file {0} is corrupted", path);
+			m_file.close();
+			return false;
+		}
+
+		m_header = header;
+		m_layout = std::move(layout);
+		return true;
+	}
+
+	void MeshFile::close()
+	{
+		m_file.close();
+		m_header = nullptr;
+		m_layout = BufferLayout();
+	}
+
+	const void* MeshFile::getVertices() const
+	{
+		return m_header ? static_cast<const uint8_t*>(m_file.getData()) + m_header->verticesOffset : nullptr;
+	}
+
+	const uint32_t* MeshFile::getIndices() const
+	{
+		return m_header
+			? reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(m_file.getData()) + m_header->indicesOffset)
+			: nullptr;
+	}
+
+	bool MeshFile::write(
+		const std::string& path,
+		const BufferLayout& layout,
+		const void* vertices,
+		const size_t verticesCount,
+		const uint32_t* indices,
+		const size_t indicesCount,
+		const MeshFileLod* lods,
+		const size_t lodsCount
+	)
+	{
+		const auto& elements = layout.getElements();
+		if (elements.empty() || elements.size() > MeshFileHeader::MaxLayoutElements) {
+			LOG_ERR("Can't write mesh {0}: a layout needs 1..{1} elements", path, MeshFileHeader::MaxLayoutElements);
+			return false;
+		}
+		const MeshFileLod wholeMesh = { 0, static_cast<uint32_t>(indicesCount), 0.f, 0 };
+		const MeshFileLod* writtenLods = lods ? lods : &wholeMesh;
+		const size_t writtenLodsCount = lods ? lodsCount : 1;
+		if (!lodsFit(writtenLods, writtenLodsCount, indicesCount)) {
+			LOG_ERR("Can't write mesh {0}: 1..{1} levels of detail of whole triangles within the indices are needed", path, MeshFileHeader::MaxLods);
+			return false;
+		}
+
+		MeshFileHeader header = {};
+		header.magic = MeshFileHeader::Magic;
+		header.version = MeshFileHeader::Version;
+		header.layoutElementsCount = static_cast<uint32_t>(elements.size());
+		header.stride = static_cast<uint32_t>(layout.getStride());
+		for (size_t i = 0; i < elements.size(); ++i) {
+			header.layout[i] = static_cast<uint8_t>(elements[i].type);
+		}
+		header.verticesCount = verticesCount;
+		header.verticesOffset = alignBlob(sizeof(MeshFileHeader));
+		header.indicesCount = indicesCount;
+		header.indicesOffset = alignBlob(header.verticesOffset + verticesCount * layout.getStride());
+		header.lodsCount = static_cast<uint32_t>(writtenLodsCount);
+		std::copy(writtenLods, writtenLods + writtenLodsCount, header.lods);
+
+		if (verticesCount > 0 && elements[0].type == ShaderDataType::Float3) {
+			std::fill(std::begin(header.boundsMin), std::end(header.boundsMin), std::numeric_limits<float>::max());
+			std::fill(std::begin(header.boundsMax), std::end(header.boundsMax), std::numeric_limits<float>::lowest());
+			const uint8_t* vertex = static_cast<const uint8_t*>(vertices) + elements[0].offset;
+			for (size_t i = 0; i < verticesCount; ++i, vertex += layout.getStride()) {
+				float position[3];
+				std::memcpy(position, vertex, sizeof(position));
+				for (int axis = 0; axis < 3; ++axis) {
+					header.boundsMin[axis] = std::min(header.boundsMin[axis], position[axis]);
+					header.boundsMax[axis] = std::max(header.boundsMax[axis], position[axis]);
+				}
+			}
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			LOG_ERR("Can't create mesh file {0}", path);
+			return false;
+		}
+
+		static constexpr char padding[MeshFileHeader::BlobAlignment] = {};
+		const auto pad = [&](const uint64_t offset) {
+			file.write(padding, static_cast<std::streamsize>(offset - static_cast<uint64_t>(file.tellp())));
+		};
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		pad(header.verticesOffset);
+		file.write(static_cast<const char*>(vertices), static_cast<std::streamsize>(verticesCount * layout.getStride()));
+		pad(header.indicesOffset);
+		file.write(reinterpret_cast<const char*>(indices), static_cast<std::streamsize>(indicesCount * sizeof(uint32_t)));
+
+		if (!file) {
+			LOG_ERR("Failed writing mesh file {0}", path);
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "mappedFile.h"
+#include "rendering/OpenGL/vertexBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace GameEngine {
+	// Index range of one level of detail, all levels share the vertices
+	struct MeshFileLod {
+		uint32_t firstIndex;
+		uint32_t indicesCount;
+		// Largest distance the simplified surface strays from the full detail one, in mesh units
+		float error;
+		uint32_t padding;
+	};
+
+	// Cooked mesh, little endian:
+	//   MeshFileHeader
+	//   vertices - verticesCount * stride bytes, interleaved exactly as the stored BufferLayout
+	//   indices  - indicesCount uint32_t, the index lists of every level of detail back to back
+	// Both blobs start at a MeshFileHeader::BlobAlignment boundary so they can be handed to the GPU
+	// straight from the mapping.
+	struct MeshFileHeader {
+		static constexpr uint32_t Magic = 0x534D4547; // "GEMS"
+		// 2 - levels of detail
+		static constexpr uint32_t Version = 2;
+		static constexpr size_t MaxLayoutElements = 16;
+		static constexpr size_t BlobAlignment = 16;
+		static constexpr size_t MaxLods = 8;
+
+		uint32_t magic;
+		uint32_t version;
+		uint32_t layoutElementsCount;
+		uint32_t stride;
+		uint8_t layout[MaxLayoutElements]; // ShaderDataType of every element
+		uint64_t verticesCount;
+		uint64_t verticesOffset;
+		uint64_t indicesCount;
+		uint64_t indicesOffset;
+		float boundsMin[3];
+		float boundsMax[3];
+		uint32_t lodsCount;
+		uint32_t reserved;
+		// Finest first, the first level is the full detail mesh
+		MeshFileLod lods[MaxLods];
+	};
+
+	class MeshFile {
+	public:
+		MeshFile() = default;
+		~MeshFile() = default;
+
+		MeshFile(const MeshFile&) = delete;
+		MeshFile(MeshFile&&) = delete;
+		MeshFile& operator=(const MeshFile&) = delete;
+		MeshFile& operator=(MeshFile&&) = delete;
+
+		// Maps the file and validates the header, nothing is copied
+		bool open(const std::string& path);
+		void close();
+
+		inline bool isOpen() const { return m_header != nullptr; }
+		inline const BufferLayout& getLayout() const { return m_layout; }
+		const void* getVertices() const;
+		const uint32_t* getIndices() const;
+		inline size_t getVerticesCount() const { return m_header ? static_cast<size_t>(m_header->verticesCount) : 0; }
+		// Indices of all the levels of detail
+		inline size_t getIndicesCount() const { return m_header ? static_cast<size_t>(m_header->indicesCount) : 0; }
+		inline size_t getLodsCount() const { return m_header ? m_header->lodsCount : 0; }
+		inline const MeshFileLod& getLod(const size_t lod) const { return m_header->lods[lod]; }
+		inline const MeshFileHeader* getHeader() const { return m_header; }
+
+		// Bounds are taken from the first layout element when it is a Float3 position. Without lods the
+		// whole index list is the only level of detail.
+		static bool write(
+			const std::string& path,
+			const BufferLayout& layout,
+			const void* vertices,
+			const size_t verticesCount,
+			const uint32_t* indices,
+			const size_t indicesCount,
+			const MeshFileLod* lods = nullptr,
+			const size_t lodsCount = 0
+		);
+	private:
+		MappedFile m_file;
+		const MeshFileHeader* m_header = nullptr;
+		BufferLayout m_layout;
+	};
+}
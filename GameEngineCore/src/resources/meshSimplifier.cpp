@@ -0,0 +1,374 @@
+#include "meshSimplifier.h"
+
+#include <profiler.h>
+
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace GameEngine {
+	namespace {
+		// Sum of squared distances to a set of planes weighted by the area of their triangles:
+		// error(p) = (p^T A p + 2 b^T p + c) / weight
+		struct Quadric {
+			double a00 = 0, a11 = 0, a22 = 0, a01 = 0, a02 = 0, a12 = 0;
+			double b0 = 0, b1 = 0, b2 = 0;
+			double c = 0;
+			double weight = 0;
+
+			void addPlane(const glm::dvec3& normal, const double distance, const double area)
+			{
+				a00 += area * normal.x * normal.x;
+				a11 += area * normal.y * normal.y;
+				a22 += area * normal.z * normal.z;
+				a01 += area * normal.x * normal.y;
+				a02 += area * normal.x * normal.z;
+				a12 += area * normal.y * normal.z;
+				b0 += area * normal.x * distance;
+				b1 += area * normal.y * distance;
+				b2 += area * normal.z * distance;
+				c += area * distance * distance;
+				weight += area;
+			}
+
+			void add(const Quadric& other)
+			{
+				a00 += other.a00; a11 += other.a11; a22 += other.a22;
+				a01 += other.a01; a02 += other.a02; a12 += other.a12;
+				b0 += other.b0; b1 += other.b1; b2 += other.b2;
+				c += other.c;
+				weight += other.weight;
+			}
+
+			// Squared distance, averaged over the planes
+			double evaluate(const glm::vec3& point) const
+			{
+				if (weight <= 0) {
+					return 0;
+				}
+				const double x = point.x, y = point.y, z = point.z;
+				const double error = a00 * x * x + a11 * y * y + a22 * z * z
+					+ 2 * (a01 * x * y + a02 * x * z + a12 * y * z)
+					+ 2 * (b0 * x + b1 * y + b2 * z)
+					+ c;
+				return std::max(0.0, error / weight);
+			}
+		};
+
+		struct PositionKey {
+			uint32_t bits[3];
+
+			bool operator==(const PositionKey& other) const
+			{
+				return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+			}
+		};
+
+		struct PositionKeyHash {
+			size_t operator()(const PositionKey& key) const
+			{
+				uint64_t hash = 14695981039346656037ull;
+				for (const uint32_t bits : key.bits) {
+					hash = (hash ^ bits) * 1099511628211ull;
+				}
+				return static_cast<size_t>(hash);
+			}
+		};
+
+		// Collapses turning a remaining triangle by more than ~75 degrees are rejected, a plain sign test
+		// lets a coarse mesh fold over itself in a few steps
+		constexpr float MinNormalCosine = 0.25f;
+		// Largest error of a generated level of detail relative to the bounding radius
+		constexpr float MaxLodError = 0.1f;
+
+		struct Collapse {
+			uint32_t from;
+			uint32_t to;
+			float cost;
+		};
+
+		inline uint64_t edgeKey(const uint32_t from, const uint32_t to)
+		{
+			return static_cast<uint64_t>(from) << 32 | to;
+		}
+
+		// Half diagonal of the bounding box of the first layout element
+		float computeRadius(const BufferLayout& layout, const void* vertices, const size_t verticesCount)
+		{
+			glm::vec3 boundsMin(std::numeric_limits<float>::max());
+			glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+			const uint8_t* vertex = static_cast<const uint8_t*>(vertices) + layout.getElements()[0].offset;
+			for (size_t i = 0; i < verticesCount; ++i, vertex += layout.getStride()) {
+				float position[3];
+				std::memcpy(position, vertex, sizeof(position));
+				boundsMin = glm::vec3(std::min(boundsMin.x, position[0]), std::min(boundsMin.y, position[1]), std::min(boundsMin.z, position[2]));
+				boundsMax = glm::vec3(std::max(boundsMax.x, position[0]), std::max(boundsMax.y, position[1]), std::max(boundsMax.z, position[2]));
+			}
+			return verticesCount ? glm::length(boundsMax - boundsMin) * 0.5f : 0.f;
+		}
+
+		glm::vec3 triangleNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+		{
+			return glm::cross(b - a, c - a);
+		}
+	}
+
+	std::vector<uint32_t> MeshSimplifier::simplify(
+		const BufferLayout& layout,
+		const void* vertices,
+		const size_t verticesCount,
+		const uint32_t* indices,
+		const size_t indicesCount,
+		const size_t targetIndicesCount,
+		const float maxError,
+		float* resultError
+	)
+	{
+		PROFILE_FUNCTION();
+		std::vector<uint32_t> result(indices, indices + indicesCount);
+		if (resultError) {
+			*resultError = 0;
+		}
+		if (layout.getElements().empty() || layout.getElements()[0].type != ShaderDataType::Float3) {
+			return result;
+		}
+
+		std::vector<glm::vec3> positions(verticesCount);
+		const uint8_t* vertex = static_cast<const uint8_t*>(vertices) + layout.getElements()[0].offset;
+		for (size_t i = 0; i < verticesCount; ++i, vertex += layout.getStride()) {
+			std::memcpy(&positions[i], vertex, sizeof(glm::vec3));
+		}
+
+		// Vertices split by another attribute share one position, the error and the topology are
+		// tracked per position
+		std::vector<uint32_t> positionIds(verticesCount);
+		std::vector<uint32_t> wedgesCount;
+		{
+			std::unordered_map<PositionKey, uint32_t, PositionKeyHash> uniquePositions;
+			uniquePositions.reserve(verticesCount);
+			for (size_t i = 0; i < verticesCount; ++i) {
+				PositionKey key;
+				std::memcpy(key.bits, &positions[i], sizeof(key.bits));
+				const auto inserted = uniquePositions.emplace(key, static_cast<uint32_t>(wedgesCount.size()));
+				if (inserted.second) {
+					wedgesCount.push_back(0);
+				}
+				positionIds[i] = inserted.first->second;
+				++wedgesCount[positionIds[i]];
+			}
+		}
+		const size_t positionsCount = wedgesCount.size();
+
+		// An edge without its twin is an open border, one with several is non-manifold
+		std::vector<uint8_t> isPositionLocked(positionsCount, 0);
+		{
+			std::unordered_map<uint64_t, uint32_t> edges;
+			edges.reserve(indicesCount);
+			for (size_t i = 0; i + 2 < indicesCount; i += 3) {
+				for (size_t corner = 0; corner < 3; ++corner) {
+					const uint32_t from = positionIds[indices[i + corner]];
+					const uint32_t to = positionIds[indices[i + (corner + 1) % 3]];
+					if (from != to) {
+						++edges[edgeKey(from, to)];
+					}
+				}
+			}
+			for (const auto& edge : edges) {
+				const uint32_t from = static_cast<uint32_t>(edge.first >> 32);
+				const uint32_t to = static_cast<uint32_t>(edge.first);
+				const auto twin = edges.find(edgeKey(to, from));
+				if (edge.second != 1 || twin == edges.end() || twin->second != 1) {
+					isPositionLocked[from] = 1;
+					isPositionLocked[to] = 1;
+				}
+			}
+		}
+		std::vector<uint8_t> isCollapsible(verticesCount);
+		for (size_t i = 0; i < verticesCount; ++i) {
+			isCollapsible[i] = wedgesCount[positionIds[i]] == 1 && !isPositionLocked[positionIds[i]];
+		}
+
+		std::vector<Quadric> quadrics(positionsCount);
+		for (size_t i = 0; i + 2 < indicesCount; i += 3) {
+			const glm::dvec3 a = positions[indices[i]];
+			const glm::dvec3 b = positions[indices[i + 1]];
+			const glm::dvec3 c = positions[indices[i + 2]];
+			const glm::dvec3 normal = glm::cross(b - a, c - a);
+			const double doubleArea = glm::length(normal);
+			if (doubleArea <= 0) {
+				continue;
+			}
+			const glm::dvec3 unitNormal = normal / doubleArea;
+			Quadric plane;
+			plane.addPlane(unitNormal, -glm::dot(unitNormal, a), doubleArea * 0.5);
+			for (size_t corner = 0; corner < 3; ++corner) {
+				quadrics[positionIds[indices[i + corner]]].add(plane);
+			}
+		}
+
+		const double maxCost = static_cast<double>(maxError) * static_cast<double>(maxError);
+		double appliedCost = 0;
+		std::vector<uint32_t> remap(verticesCount);
+		std::vector<uint8_t> isTouched(verticesCount);
+		std::vector<uint32_t> trianglesOffsets(verticesCount + 1);
+		std::vector<uint32_t> vertexTriangles;
+		std::vector<Collapse> collapses;
+
+		// Every pass collapses the cheapest edges whose vertices weren't touched earlier in the same pass,
+		// then compacts the index list and starts over with the updated costs
+		while (result.size() > targetIndicesCount) {
+			const size_t trianglesCount = result.size() / 3;
+
+			std::fill(trianglesOffsets.begin(), trianglesOffsets.end(), 0);
+			for (const uint32_t index : result) {
+				++trianglesOffsets[index + 1];
+			}
+			for (size_t i = 0; i < verticesCount; ++i) {
+				trianglesOffsets[i + 1] += trianglesOffsets[i];
+			}
+			vertexTriangles.resize(result.size());
+			std::vector<uint32_t> filled(trianglesOffsets.begin(), trianglesOffsets.end() - 1);
+			for (size_t i = 0; i < result.size(); ++i) {
+				vertexTriangles[filled[result[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+
+			collapses.clear();
+			for (size_t i = 0; i < result.size(); i += 3) {
+				for (size_t corner = 0; corner < 3; ++corner) {
+					const uint32_t a = result[i + corner];
+					const uint32_t b = result[i + (corner + 1) % 3];
+					if (isCollapsible[a]) {
+						collapses.push_back({ a, b, static_cast<float>(quadrics[positionIds[a]].evaluate(positions[b])) });
+					}
+					if (isCollapsible[b]) {
+						collapses.push_back({ b, a, static_cast<float>(quadrics[positionIds[b]].evaluate(positions[a])) });
+					}
+				}
+			}
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& left, const Collapse& right) {
+				return left.cost < right.cost;
+			});
+
+			for (size_t i = 0; i < verticesCount; ++i) {
+				remap[i] = static_cast<uint32_t>(i);
+			}
+			std::fill(isTouched.begin(), isTouched.end(), 0);
+			const size_t trianglesToRemove = (result.size() - targetIndicesCount + 2) / 3;
+			size_t removedTriangles = 0;
+			size_t appliedCollapses = 0;
+			for (const Collapse& collapse : collapses) {
+				if (removedTriangles >= trianglesToRemove || collapse.cost > maxCost) {
+					break;
+				}
+				if (isTouched[collapse.from] || isTouched[collapse.to]) {
+					continue;
+				}
+
+				// Triangles around from that keep their area must not turn over, the ones holding the
+				// collapsed edge disappear
+				bool isFlipping = false;
+				size_t collapsedTriangles = 0;
+				for (uint32_t t = trianglesOffsets[collapse.from]; t < trianglesOffsets[collapse.from + 1]; ++t) {
+					const size_t triangle = vertexTriangles[t] * size_t(3);
+					uint32_t corners[3] = { remap[result[triangle]], remap[result[triangle + 1]], remap[result[triangle + 2]] };
+					if (corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2]) {
+						continue;
+					}
+					if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to) {
+						++collapsedTriangles;
+						continue;
+					}
+					const glm::vec3 before = triangleNormal(positions[corners[0]], positions[corners[1]], positions[corners[2]]);
+					for (uint32_t& corner : corners) {
+						if (corner == collapse.from) {
+							corner = collapse.to;
+						}
+					}
+					const glm::vec3 after = triangleNormal(positions[corners[0]], positions[corners[1]], positions[corners[2]]);
+					if (glm::dot(before, after) < MinNormalCosine * glm::length(before) * glm::length(after)) {
+						isFlipping = true;
+						break;
+					}
+				}
+				if (isFlipping) {
+					continue;
+				}
+
+				remap[collapse.from] = collapse.to;
+				isTouched[collapse.from] = 1;
+				isTouched[collapse.to] = 1;
+				quadrics[positionIds[collapse.to]].add(quadrics[positionIds[collapse.from]]);
+				appliedCost = std::max(appliedCost, static_cast<double>(collapse.cost));
+				removedTriangles += collapsedTriangles;
+				++appliedCollapses;
+			}
+			if (appliedCollapses == 0) {
+				break;
+			}
+
+			size_t written = 0;
+			for (size_t i = 0; i < trianglesCount; ++i) {
+				const uint32_t a = remap[result[i * 3]];
+				const uint32_t b = remap[result[i * 3 + 1]];
+				const uint32_t c = remap[result[i * 3 + 2]];
+				if (a == b || b == c || a == c) {
+					continue;
+				}
+				result[written++] = a;
+				result[written++] = b;
+				result[written++] = c;
+			}
+			result.resize(written);
+		}
+
+		if (resultError) {
+			*resultError = static_cast<float>(std::sqrt(appliedCost));
+		}
+		return result;
+	}
+
+	MeshLodChain MeshSimplifier::buildLods(
+		const BufferLayout& layout,
+		const void* vertices,
+		const size_t verticesCount,
+		const uint32_t* indices,
+		const size_t indicesCount,
+		const size_t maxLods,
+		const size_t minIndicesCount
+	)
+	{
+		MeshLodChain chain;
+		chain.indices.assign(indices, indices + indicesCount);
+		chain.lods.push_back({ 0, static_cast<uint32_t>(indicesCount), 0.f, 0 });
+		if (layout.getElements().empty() || layout.getElements()[0].type != ShaderDataType::Float3) {
+			return chain;
+		}
+		// Past that the shape is gone, no screen size makes such a level worth drawing
+		const float maxLodError = computeRadius(layout, vertices, verticesCount) * MaxLodError;
+
+		std::vector<uint32_t> previous(indices, indices + indicesCount);
+		float error = 0;
+		while (chain.lods.size() < maxLods && previous.size() / 2 >= minIndicesCount) {
+			float lodError = 0;
+			std::vector<uint32_t> lod = simplify(
+				layout, vertices, verticesCount, previous.data(), previous.size(), previous.size() / 6 * 3,
+				maxLodError - error, &lodError
+			);
+			// Less than a tenth went away, what's left is mostly locked borders and seams or the error ran out
+			if (lod.size() > previous.size() / 10 * 9) {
+				break;
+			}
+			// Every level starts from the previous one, their errors add up
+			error += lodError;
+			chain.lods.push_back({ static_cast<uint32_t>(chain.indices.size()), static_cast<uint32_t>(lod.size()), error, 0 });
+			chain.indices.insert(chain.indices.end(), lod.begin(), lod.end());
+			previous.swap(lod);
+		}
+		return chain;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "resources/meshFile.h"
+#include "rendering/OpenGL/vertexBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GameEngine {
+	// Level of detail chain of one mesh. Every level indexes the same vertices, the index lists are
+	// stored back to back, finest level first.
+	struct MeshLodChain {
+		std::vector<uint32_t> indices;
+		std::vector<MeshFileLod> lods;
+	};
+
+	// Quadric error edge collapse (Garland & Heckbert) that only rewrites the index buffer: a vertex is
+	// collapsed onto one of its neighbours, so no vertex is moved or created and all the levels can share
+	// one vertex buffer. Vertices on open borders and on attribute seams (several vertices at the same
+	// position) are never collapsed, which keeps the silhouette of open meshes and the uv/normal splits.
+	class MeshSimplifier {
+	public:
+		// Collapses edges cheapest first until at most targetIndicesCount indices remain or the next
+		// collapse would move the surface further than maxError (mesh units). The first layout element
+		// must be the Float3 position. resultError receives the largest error of the applied collapses.
+		static std::vector<uint32_t> simplify(
+			const BufferLayout& layout,
+			const void* vertices,
+			const size_t verticesCount,
+			const uint32_t* indices,
+			const size_t indicesCount,
+			const size_t targetIndicesCount,
+			const float maxError,
+			float* resultError = nullptr
+		);
+
+		// Halves the triangles from level to level, each simplified from the previous one. Stops at
+		// maxLods, when a level gets below minIndicesCount or when the simplifier can't reduce any further
+		// within an error of a tenth of the bounding radius.
+		static MeshLodChain buildLods(
+			const BufferLayout& layout,
+			const void* vertices,
+			const size_t verticesCount,
+			const uint32_t* indices,
+			const size_t indicesCount,
+			const size_t maxLods = MeshFileHeader::MaxLods,
+			const size_t minIndicesCount = 192
+		);
+	};
+}
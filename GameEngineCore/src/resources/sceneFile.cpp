@@ -0,0 +1,349 @@
+#define LOG_MODULE Resources
+
+#include "sceneFile.h"
+
+#include <log.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <system_error>
+
+namespace GameEngine {
+	// The header and the tables are written and mapped as is, they must have the same layout on every compiler
+	static_assert(sizeof(SceneFileHeader) == 240, "Scene file header layout changed");
+	static_assert(sizeof(SceneNode) == 48 && sizeof(SceneEntity) == 16 && sizeof(SceneMatrix) == 64 && sizeof(SceneSpin) == 8
+		&& sizeof(SceneString) == 8, "Scene table layout changed");
+
+	namespace {
+		constexpr size_t TablesCount = static_cast<size_t>(SceneTable::Count);
+		constexpr uint64_t ChunkSize = SceneFileHeader::ChunkSize;
+		constexpr uint32_t ElementSizes[TablesCount] = {
+			sizeof(SceneNode), sizeof(SceneEntity), sizeof(SceneMatrix), sizeof(SceneSpin), sizeof(SceneString), sizeof(char)
+		};
+		static_assert(ChunkSize % sizeof(uint64_t) == 0, "Chunks are hashed a word at a time");
+
+		struct TableData {
+			const void* data;
+			uint64_t count;
+		};
+
+		// Files mapped by an open SceneFile, once per SceneFile mapping them
+		std::mutex s_mappedPathsMutex;
+		std::vector<std::string> s_mappedPaths;
+
+		// Same file, same string, as far as it can be told without opening it
+		std::string normalizePath(const std::string& path)
+		{
+			std::error_code error;
+			const std::filesystem::path normalized = std::filesystem::weakly_canonical(path, error);
+			return error ? std::filesystem::absolute(path, error).lexically_normal().string() : normalized.string();
+		}
+
+		bool isMapped(const std::string& normalizedPath)
+		{
+			std::lock_guard<std::mutex> lock(s_mappedPathsMutex);
+			return std::find(s_mappedPaths.begin(), s_mappedPaths.end(), normalizedPath) != s_mappedPaths.end();
+		}
+
+		uint64_t alignChunk(const uint64_t offset)
+		{
+			return (offset + ChunkSize - 1) / ChunkSize * ChunkSize;
+		}
+
+		uint64_t getRegionSize(const SceneTableInfo& table)
+		{
+			return alignChunk(table.capacity * table.elementSize);
+		}
+
+		// FNV-1a over 64-bit words, a change within any one word always changes the hash
+		uint64_t hashChunk(const uint8_t* chunk)
+		{
+			uint64_t hash = 14695981039346656037ull;
+			for (uint64_t i = 0; i < ChunkSize; i += sizeof(uint64_t)) {
+				uint64_t word;
+				std::memcpy(&word, chunk + i, sizeof(word));
+				hash = (hash ^ word) * 1099511628211ull;
+			}
+			return hash;
+		}
+
+		// Regions must follow each other in table order without gaps, so the layout alone
+		// tells which chunk belongs to which table
+		bool isLayoutValid(const SceneFileHeader& header, const uint64_t fileSize)
+		{
+			if (header.chunkSize != ChunkSize || header.tablesCount != TablesCount || header.hashesOffset != sizeof(SceneFileHeader)
+				|| header.chunksCount > fileSize / ChunkSize
+				|| header.chunksOffset != alignChunk(header.hashesOffset + header.chunksCount * sizeof(uint64_t))
+				|| header.chunksOffset + header.chunksCount * ChunkSize > fileSize) {
+				return false;
+			}
+
+			uint64_t offset = header.chunksOffset;
+			for (size_t i = 0; i < TablesCount; ++i) {
+				const SceneTableInfo& table = header.tables[i];
+				if (table.elementSize != ElementSizes[i] || table.offset != offset
+					|| table.capacity > fileSize / table.elementSize || table.count > table.capacity) {
+					return false;
+				}
+				offset += getRegionSize(table);
+			}
+			return offset == header.chunksOffset + header.chunksCount * ChunkSize;
+		}
+
+		// Every region gets a quarter more room than it needs, rounded up to whole chunks
+		SceneFileHeader makeLayout(const TableData* tables)
+		{
+			SceneFileHeader header = {};
+			header.magic = SceneFileHeader::Magic;
+			header.version = SceneFileHeader::Version;
+			header.chunkSize = static_cast<uint32_t>(ChunkSize);
+			header.tablesCount = static_cast<uint32_t>(TablesCount);
+			header.hashesOffset = sizeof(SceneFileHeader);
+
+			uint64_t regionsSize = 0;
+			for (size_t i = 0; i < TablesCount; ++i) {
+				SceneTableInfo& table = header.tables[i];
+				const uint64_t size = tables[i].count * ElementSizes[i];
+				table.elementSize = ElementSizes[i];
+				table.capacity = alignChunk(size + size / 4) / ElementSizes[i];
+				table.offset = regionsSize;
+				regionsSize += getRegionSize(table);
+			}
+			header.chunksCount = regionsSize / ChunkSize;
+			header.chunksOffset = alignChunk(header.hashesOffset + header.chunksCount * sizeof(uint64_t));
+			for (SceneTableInfo& table : header.tables) {
+				table.offset += header.chunksOffset;
+			}
+			return header;
+		}
+
+		// Layout and chunk hashes of the file at path, when every table still fits into its region
+		bool readLayout(const std::string& path, const TableData* tables, SceneFileHeader& header, std::vector<uint64_t>& hashes)
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file) {
+				return false;
+			}
+			const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+			file.seekg(0);
+			if (fileSize < sizeof(SceneFileHeader) || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+				return false;
+			}
+			if (header.magic != SceneFileHeader::Magic || header.version != SceneFileHeader::Version || !isLayoutValid(header, fileSize)) {
+				return false;
+			}
+			for (size_t i = 0; i < TablesCount; ++i) {
+				if (tables[i].count > header.tables[i].capacity) {
+					return false;
+				}
+			}
+
+			hashes.resize(static_cast<size_t>(header.chunksCount));
+			file.seekg(static_cast<std::streamoff>(header.hashesOffset));
+			return static_cast<bool>(file.read(reinterpret_cast<char*>(hashes.data()), static_cast<std::streamsize>(hashes.size() * sizeof(uint64_t))));
+		}
+	}
+
+	SceneFile::~SceneFile()
+	{
+		close();
+	}
+
+	bool SceneFile::open(const std::string& path)
+	{
+		close();
+		if (!m_file.open(path)) {
+			return false;
+		}
+
+		if (m_file.getSize() < sizeof(SceneFileHeader)) {
+			LOG_ERR("Scene file {0} is truncated", path);
+			m_file.close();
+			return false;
+		}
+		const SceneFileHeader* header = static_cast<const SceneFileHeader*>(m_file.getData());
+		if (header->magic != SceneFileHeader::Magic || header->version != SceneFileHeader::Version) {
+			LOG_ERR("{0} is not a scene file of version {1}", path, SceneFileHeader::Version);
+			m_file.close();
+			return false;
+		}
+		if (!isLayoutValid(*header, m_file.getSize())) {
+			LOG_ERR("Scene file {0} is corrupted", path);
+			m_file.close();
+			return false;
+		}
+
+		// The only fix-up there is, tables are used in place from here on
+		const uint8_t* data = static_cast<const uint8_t*>(m_file.getData());
+		for (size_t i = 0; i < TablesCount; ++i) {
+			m_tables[i] = data + header->tables[i].offset;
+		}
+		m_header = header;
+
+		const SceneString* meshes = static_cast<const SceneString*>(getTable(SceneTable::Meshes));
+		const uint64_t charactersCount = header->tables[static_cast<size_t>(SceneTable::Characters)].count;
+		for (size_t i = 0; i < getMeshesCount(); ++i) {
+			if (meshes[i].offset > charactersCount || meshes[i].size > charactersCount - meshes[i].offset) {
+				LOG_ERR("Scene file {0} is corrupted", path);
+				close();
+				return false;
+			}
+		}
+
+		m_mappedPath = normalizePath(path);
+		std::lock_guard<std::mutex> lock(s_mappedPathsMutex);
+		s_mappedPaths.push_back(m_mappedPath);
+		return true;
+	}
+
+	void SceneFile::close()
+	{
+		if (!m_mappedPath.empty()) {
+			std::lock_guard<std::mutex> lock(s_mappedPathsMutex);
+			s_mappedPaths.erase(std::find(s_mappedPaths.begin(), s_mappedPaths.end(), m_mappedPath));
+			m_mappedPath.clear();
+		}
+		m_file.close();
+		m_header = nullptr;
+		std::fill(std::begin(m_tables), std::end(m_tables), nullptr);
+	}
+
+	std::string_view SceneFile::getMeshPath(const size_t mesh) const
+	{
+		const SceneString& path = static_cast<const SceneString*>(getTable(SceneTable::Meshes))[mesh];
+		return std::string_view(static_cast<const char*>(getTable(SceneTable::Characters)) + path.offset, path.size);
+	}
+
+	bool SceneFile::write(const std::string& path, const SceneSnapshot& snapshot, SceneSaveStats* stats)
+	{
+		std::vector<SceneString> meshes;
+		std::string characters;
+		meshes.reserve(snapshot.meshPaths.size());
+		for (const std::string& meshPath : snapshot.meshPaths) {
+			meshes.push_back({ static_cast<uint32_t>(characters.size()), static_cast<uint32_t>(meshPath.size()) });
+			characters += meshPath;
+		}
+		const TableData tables[TablesCount] = {
+			{ snapshot.nodes.data(), snapshot.nodes.size() },
+			{ snapshot.entities.data(), snapshot.entities.size() },
+			{ snapshot.matrices.data(), snapshot.matrices.size() },
+			{ snapshot.spins.data(), snapshot.spins.size() },
+			{ meshes.data(), meshes.size() },
+			{ characters.data(), characters.size() }
+		};
+		for (const TableData& table : tables) {
+			if (table.count >= SceneFileHeader::InvalidIndex) {
+				LOG_ERR("Can't write scene {0}: tables are limited to {1} elements", path, SceneFileHeader::InvalidIndex - 1);
+				return false;
+			}
+		}
+		// An incremental save would change the pages under the mapping, and on Windows the mapping
+		// keeps the file from being opened for writing or replaced
+		if (isMapped(normalizePath(path))) {
+			LOG_ERR("Can't write scene {0} while it's open, close the SceneFile mapping it first", path);
+			return false;
+		}
+
+		SceneFileHeader header;
+		std::vector<uint64_t> hashes;
+		const bool isIncremental = readLayout(path, tables, header, hashes);
+		if (!isIncremental) {
+			header = makeLayout(tables);
+			hashes.assign(static_cast<size_t>(header.chunksCount), 0);
+		}
+		for (size_t i = 0; i < TablesCount; ++i) {
+			header.tables[i].count = tables[i].count;
+		}
+		++header.savesCount;
+
+		// A full save is written aside and renamed, a crash mid-write must not destroy the previous snapshot
+		const std::string writtenPath = isIncremental ? path : path + ".tmp";
+		const auto removeTemporary = [&]() {
+			if (!isIncremental) {
+				std::error_code error;
+				std::filesystem::remove(writtenPath, error);
+			}
+		};
+		std::fstream file(writtenPath, std::ios::binary | std::ios::out | (isIncremental ? std::ios::in : std::ios::trunc));
+		if (!file) {
+			LOG_ERR("Can't {0} scene file {1}", isIncremental ? "open" : "create", writtenPath);
+			removeTemporary();
+			return false;
+		}
+		if (!isIncremental) {
+			// Header and hashes are only known at the end, their space is reserved up front
+			const std::vector<char> padding(static_cast<size_t>(header.chunksOffset), 0);
+			file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+		}
+
+		// Chunks cut through elements, a chunk past the end of its table's data is padded with zeroes
+		std::vector<uint8_t> buffer(ChunkSize);
+		size_t chunksWritten = 0;
+		for (size_t i = 0; i < TablesCount; ++i) {
+			const SceneTableInfo& table = header.tables[i];
+			const uint8_t* data = static_cast<const uint8_t*>(tables[i].data);
+			const uint64_t size = table.count * table.elementSize;
+			const uint64_t firstChunk = (table.offset - header.chunksOffset) / ChunkSize;
+			for (uint64_t begin = 0; begin < getRegionSize(table); begin += ChunkSize) {
+				const uint8_t* chunk = buffer.data();
+				if (begin + ChunkSize <= size) {
+					chunk = data + begin;
+				}
+				else {
+					const uint64_t used = begin < size ? size - begin : 0;
+					if (used > 0) {
+						std::copy(data + begin, data + begin + used, buffer.data());
+					}
+					std::fill(buffer.data() + used, buffer.data() + ChunkSize, static_cast<uint8_t>(0));
+				}
+
+				uint64_t& hash = hashes[static_cast<size_t>(firstChunk + begin / ChunkSize)];
+				const uint64_t chunkHash = hashChunk(chunk);
+				if (isIncremental && chunkHash == hash) {
+					continue;
+				}
+				hash = chunkHash;
+				const std::streamoff offset = static_cast<std::streamoff>(table.offset + begin);
+				if (file.tellp() != offset) {
+					file.seekp(offset);
+				}
+				file.write(reinterpret_cast<const char*>(chunk), static_cast<std::streamsize>(ChunkSize));
+				++chunksWritten;
+			}
+		}
+
+		// The header goes last, it's what tells a reader the save is complete
+		file.seekp(static_cast<std::streamoff>(header.hashesOffset));
+		file.write(reinterpret_cast<const char*>(hashes.data()), static_cast<std::streamsize>(hashes.size() * sizeof(uint64_t)));
+		file.seekp(0);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.close();
+		if (!file) {
+			LOG_ERR("Failed writing scene file {0}", writtenPath);
+			removeTemporary();
+			return false;
+		}
+
+		if (!isIncremental) {
+			std::error_code error;
+			std::filesystem::rename(writtenPath, path, error);
+			if (error) {
+				LOG_ERR("Failed writing scene file {0}: {1}", path, error.message());
+				removeTemporary();
+				return false;
+			}
+		}
+
+		if (stats) {
+			stats->isIncremental = isIncremental;
+			stats->chunksCount = static_cast<size_t>(header.chunksCount);
+			stats->chunksWritten = chunksWritten;
+			stats->bytesWritten = (isIncremental ? 0 : header.chunksOffset) + chunksWritten * ChunkSize
+				+ hashes.size() * sizeof(uint64_t) + sizeof(header);
+		}
+		return true;
+	}
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "mappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace GameEngine {
+	// Local transform of a hierarchy node
+	struct SceneNode {
+		// Index into the nodes table, parents precede their children. SceneFileHeader::InvalidIndex for roots.
+		uint32_t parent;
+		float position[3];
+		float rotation[4]; // x, y, z, w
+		float scale[3];
+		uint32_t reserved;
+	};
+
+	struct SceneEntity {
+		// Index into the nodes table, InvalidIndex - no TransformNode
+		uint32_t node;
+		// Index into the meshes table, InvalidIndex - no MeshRef
+		uint32_t mesh;
+		// Index into the matrices table, entities without a node keep their Transform as is. InvalidIndex otherwise.
+		uint32_t matrix;
+		// Index into the spins table, InvalidIndex - no Spin
+		uint32_t spin;
+	};
+
+	// Column-major, the layout of glm::mat4
+	struct SceneMatrix {
+		float values[16];
+	};
+
+	// Spin around Z, the interpolation state isn't stored
+	struct SceneSpin {
+		float angle;
+		float speed;
+	};
+
+	// Range of the characters table
+	struct SceneString {
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	enum class SceneTable : uint32_t {
+		Nodes,       // SceneNode
+		Entities,    // SceneEntity
+		Matrices,    // SceneMatrix
+		Spins,       // SceneSpin
+		Meshes,      // SceneString, the path of a cooked mesh, empty for the built-in cube
+		Characters,  // char
+		Count
+	};
+
+	struct SceneTableInfo {
+		uint32_t elementSize;
+		uint32_t reserved;
+		uint64_t count;
+		// Elements the region has room for, the rest of it is zeroed
+		uint64_t capacity;
+		uint64_t offset;
+	};
+
+	// Scene snapshot, little endian:
+	//   SceneFileHeader
+	//   chunk hashes - chunksCount uint64_t, one per ChunkSize bytes from chunksOffset on
+	//   tables       - one region per SceneTable in order, each starts at a chunk boundary and spans whole chunks
+	// The tables are flat arrays used in place from the mapping: opening only validates the header and
+	// turns the table offsets into pointers. Regions are written with room to grow, so as long as every
+	// table still fits, a save rewrites only the chunks whose hash changed.
+	struct SceneFileHeader {
+		static constexpr uint32_t Magic = 0x43534547; // "GESC"
+		static constexpr uint32_t Version = 2;
+		static constexpr uint64_t ChunkSize = 16 * 1024;
+		static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+		uint32_t magic;
+		uint32_t version;
+		uint32_t chunkSize;
+		uint32_t tablesCount;
+		uint64_t hashesOffset;
+		uint64_t chunksOffset;
+		uint64_t chunksCount;
+		// Incremented by every save
+		uint64_t savesCount;
+		SceneTableInfo tables[static_cast<size_t>(SceneTable::Count)];
+	};
+
+	// What SceneFile::write stores, filled by the application from its registry and transform hierarchy
+	struct SceneSnapshot {
+		std::vector<SceneNode> nodes;
+		std::vector<SceneEntity> entities;
+		std::vector<SceneMatrix> matrices;
+		std::vector<SceneSpin> spins;
+		std::vector<std::string> meshPaths;
+	};
+
+	struct SceneSaveStats {
+		// False when the file was rewritten whole: it didn't exist, a table outgrew its region or the format changed
+		bool isIncremental = false;
+		size_t chunksCount = 0;
+		size_t chunksWritten = 0;
+		uint64_t bytesWritten = 0;
+	};
+
+	class SceneFile {
+	public:
+		SceneFile() = default;
+		~SceneFile();
+
+		SceneFile(const SceneFile&) = delete;
+		SceneFile(SceneFile&&) = delete;
+		SceneFile& operator=(const SceneFile&) = delete;
+		SceneFile& operator=(SceneFile&&) = delete;
+
+		// Maps the file and validates the table layout, nothing is copied or visited per entity.
+		// Node and entity indices are not checked here, whoever instantiates the scene checks them.
+		bool open(const std::string& path);
+		void close();
+
+		inline bool isOpen() const { return m_header != nullptr; }
+		inline const SceneFileHeader* getHeader() const { return m_header; }
+		inline size_t getNodesCount() const { return getCount(SceneTable::Nodes); }
+		inline const SceneNode* getNodes() const { return static_cast<const SceneNode*>(getTable(SceneTable::Nodes)); }
+		inline size_t getEntitiesCount() const { return getCount(SceneTable::Entities); }
+		inline const SceneEntity* getEntities() const { return static_cast<const SceneEntity*>(getTable(SceneTable::Entities)); }
+		inline size_t getMatricesCount() const { return getCount(SceneTable::Matrices); }
+		inline const SceneMatrix* getMatrices() const { return static_cast<const SceneMatrix*>(getTable(SceneTable::Matrices)); }
+		inline size_t getSpinsCount() const { return getCount(SceneTable::Spins); }
+		inline const SceneSpin* getSpins() const { return static_cast<const SceneSpin*>(getTable(SceneTable::Spins)); }
+		inline size_t getMeshesCount() const { return getCount(SceneTable::Meshes); }
+		std::string_view getMeshPath(const size_t mesh) const;
+
+		// Updates the chunks of an existing snapshot in place when its layout still fits, otherwise the
+		// whole file is written aside and renamed over it. An interrupted incremental save may leave a
+		// mix of both states behind.
+		// Refuses a path an open SceneFile of this process maps. A mapping held by another process isn't
+		// detected: on Windows the save then fails to open or replace the file, elsewhere that process
+		// sees an incremental save change its tables.
+		static bool write(const std::string& path, const SceneSnapshot& snapshot, SceneSaveStats* stats = nullptr);
+	private:
+		inline size_t getCount(const SceneTable table) const
+		{
+			return m_header ? static_cast<size_t>(m_header->tables[static_cast<size_t>(table)].count) : 0;
+		}
+		inline const void* getTable(const SceneTable table) const { return m_tables[static_cast<size_t>(table)]; }
+
+		MappedFile m_file;
+		// Normalized, while open
+		std::string m_mappedPath;
+		const SceneFileHeader* m_header = nullptr;
+		const void* m_tables[static_cast<size_t>(SceneTable::Count)] = {};
+	};
+}
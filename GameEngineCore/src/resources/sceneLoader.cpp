@@ -0,0 +1,121 @@
+#include "sceneLoader.h"
+
+#include "components.h"
+
+#include <cstring>
+
+namespace GameEngine {
+	namespace {
+		// Optional parts of a stored entity, entities with the same flags share an archetype
+		constexpr uint32_t HasNode = 1;
+		constexpr uint32_t HasMesh = 2;
+		constexpr uint32_t HasSpin = 4;
+
+		inline uint32_t getFlags(const SceneEntity& entity)
+		{
+			return (entity.node != SceneFileHeader::InvalidIndex ? HasNode : 0)
+				| (entity.mesh != SceneFileHeader::InvalidIndex ? HasMesh : 0)
+				| (entity.spin != SceneFileHeader::InvalidIndex ? HasSpin : 0);
+		}
+
+		struct SceneTables {
+			const SceneEntity* entities;
+			const SceneMatrix* matrices;
+			const SceneSpin* spins;
+			const uint32_t* meshIds;
+		};
+
+		// The components are unconstructed memory, every field is written
+		inline void convert(Transform& transform, const SceneEntity& entity, const SceneTables& tables)
+		{
+			static const glm::mat4 s_identity(1.f);
+			// Entities with a node get their Transform from the hierarchy on the next update
+			const void* matrix = entity.node == SceneFileHeader::InvalidIndex ? tables.matrices[entity.matrix].values : static_cast<const void*>(&s_identity);
+			std::memcpy(&transform.model_matrix, matrix, sizeof(SceneMatrix));
+		}
+		inline void convert(TransformNode& node, const SceneEntity& entity, const SceneTables&)
+		{
+			// Node i of the file is transform i
+			node.id = entity.node;
+		}
+		inline void convert(MeshRef& mesh, const SceneEntity& entity, const SceneTables& tables)
+		{
+			mesh.meshId = tables.meshIds[entity.mesh];
+			mesh.lod = 0;
+		}
+		inline void convert(Spin& spin, const SceneEntity& entity, const SceneTables& tables)
+		{
+			const SceneSpin& stored = tables.spins[entity.spin];
+			spin.angle = stored.angle;
+			spin.previousAngle = stored.angle;
+			spin.speed = stored.speed;
+		}
+
+		// Creates the entities [begin, end) of the file, all of them have Transform and Ts
+		template<typename... Ts>
+		void createRun(Registry& scene, const SceneTables& tables, const size_t begin, const size_t end)
+		{
+			scene.createMany<Transform, Ts...>(end - begin,
+				[&tables, begin](const size_t first, const size_t count, const Entity*, Transform* transforms, Ts*... components) {
+					const SceneEntity* entities = tables.entities + begin + first;
+					for (size_t i = 0; i < count; ++i) {
+						convert(transforms[i], entities[i], tables);
+						(convert(components[i], entities[i], tables), ...);
+					}
+				});
+		}
+	}
+
+	bool SceneLoader::instantiate(const SceneFile& file, const std::vector<uint32_t>& meshIds, Registry& scene, TransformHierarchy& transforms)
+	{
+		// The file only vouches for its layout, references are checked before anything is replaced
+		const SceneNode* nodes = file.getNodes();
+		const size_t nodesCount = file.getNodesCount();
+		for (size_t i = 0; i < nodesCount; ++i) {
+			if (nodes[i].parent != SceneFileHeader::InvalidIndex && nodes[i].parent >= i) {
+				return false;
+			}
+		}
+		const SceneTables tables = { file.getEntities(), file.getMatrices(), file.getSpins(), meshIds.data() };
+		const size_t entitiesCount = file.getEntitiesCount();
+		for (size_t i = 0; i < entitiesCount; ++i) {
+			const SceneEntity& entity = tables.entities[i];
+			const bool isNodeValid = entity.node == SceneFileHeader::InvalidIndex
+				? entity.matrix < file.getMatricesCount() : entity.node < nodesCount;
+			if (!isNodeValid || (entity.mesh != SceneFileHeader::InvalidIndex && entity.mesh >= meshIds.size())
+				|| (entity.spin != SceneFileHeader::InvalidIndex && entity.spin >= file.getSpinsCount())) {
+				return false;
+			}
+		}
+
+		scene.clear();
+		transforms.assign(nodesCount, [nodes](const size_t i, TransformId& parent, glm::vec3& position, glm::quat& rotation, glm::vec3& scale) {
+			const SceneNode& node = nodes[i];
+			parent = node.parent == SceneFileHeader::InvalidIndex ? InvalidTransformId : node.parent;
+			position = { node.position[0], node.position[1], node.position[2] };
+			rotation = glm::quat(node.rotation[3], node.rotation[0], node.rotation[1], node.rotation[2]);
+			scale = { node.scale[0], node.scale[1], node.scale[2] };
+		});
+
+		// A save walks the registry archetype by archetype, so entities of one archetype come in long runs
+		for (size_t begin = 0; begin < entitiesCount;) {
+			const uint32_t flags = getFlags(tables.entities[begin]);
+			size_t end = begin + 1;
+			while (end < entitiesCount && getFlags(tables.entities[end]) == flags) {
+				++end;
+			}
+			switch (flags) {
+			case 0: createRun<>(scene, tables, begin, end); break;
+			case HasNode: createRun<TransformNode>(scene, tables, begin, end); break;
+			case HasMesh: createRun<MeshRef>(scene, tables, begin, end); break;
+			case HasNode | HasMesh: createRun<MeshRef, TransformNode>(scene, tables, begin, end); break;
+			case HasSpin: createRun<Spin>(scene, tables, begin, end); break;
+			case HasNode | HasSpin: createRun<Spin, TransformNode>(scene, tables, begin, end); break;
+			case HasMesh | HasSpin: createRun<MeshRef, Spin>(scene, tables, begin, end); break;
+			case HasNode | HasMesh | HasSpin: createRun<MeshRef, Spin, TransformNode>(scene, tables, begin, end); break;
+			}
+			begin = end;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "resources/sceneFile.h"
+#include "transformHierarchy.h"
+#include "ecs/registry.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace GameEngine {
+	// Transforms are copied to and from the matrices table as they are
+	static_assert(sizeof(glm::mat4) == sizeof(SceneMatrix), "A scene matrix must match glm::mat4");
+
+	// Turns an open scene file into entities and transform nodes. The hierarchy is filled from the nodes
+	// table in one pass and the entities are created a run of one archetype at a time, their components
+	// converted straight from the mapped tables into the archetype's chunks.
+	class SceneLoader {
+	public:
+		// Checks every reference of the file first and replaces the contents of scene and transforms
+		// only when they are all valid. meshIds maps the meshes table to the caller's mesh ids.
+		static bool instantiate(const SceneFile& file, const std::vector<uint32_t>& meshIds, Registry& scene, TransformHierarchy& transforms);
+	};
+}
@@ -0,0 +1,162 @@
+#define LOG_MODULE Resources
+
+#include "textureFile.h"
+
+#include <log.h>
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace GameEngine {
+	// The header is written and mapped as is, it must have the same layout on every compiler
+	static_assert(sizeof(TextureFileHeader) == 408, "Texture file header layout changed");
+
+	static constexpr uint32_t s_bytesPerPixel = 4;
+
+	static uint64_t alignBlob(const uint64_t offset)
+	{
+		return (offset + TextureFileHeader::BlobAlignment - 1) / TextureFileHeader::BlobAlignment * TextureFileHeader::BlobAlignment;
+	}
+
+	bool TextureFile::open(const std::string& path)
+	{
+		close();
+		if (!m_file.open(path)) {
+			return false;
+		}
+
+		if (m_file.getSize() < sizeof(TextureFileHeader)) {
+			LOG_ERR("Texture file {0} is truncated", path);
+			m_file.close();
+			return false;
+		}
+		const TextureFileHeader* header = static_cast<const TextureFileHeader*>(m_file.getData());
+		if (header->magic != TextureFileHeader::Magic || header->version != TextureFileHeader::Version) {
+			LOG_ERR("{0} is not a texture file of version {1}", path, TextureFileHeader::Version);
+			m_file.close();
+			return false;
+		}
+		if (header->format != TextureFormat::RGBA8 || header->width == 0 || header->height == 0
+			|| header->mipsCount == 0 || header->mipsCount > computeMipsCount(header->width, header->height)) {
+			LOG_ERR("Texture file {0} has an unsupported format or size", path);
+			m_file.close();
+			return false;
+		}
+
+		const uint64_t fileSize = m_file.getSize();
+		for (uint32_t level = 0; level < header->mipsCount; ++level) {
+			const TextureFileMip& mip = header->mips[level];
+			const uint32_t width = std::max(1u, header->width >> level);
+			const uint32_t height = std::max(1u, header->height >> level);
+			if (mip.width != width || mip.height != height
+				|| mip.size != static_cast<uint64_t>(width) * height * s_bytesPerPixel
+				|| mip.offset % TextureFileHeader::BlobAlignment != 0 || mip.offset > fileSize || mip.size > fileSize - mip.offset) {
+				LOG_ERR("Texture file {0} is corrupted", path);
+				m_file.close();
+				return false;
+			}
+		}
+
+		m_header = header;
+		return true;
+	}
+
+	void TextureFile::close()
+	{
+		m_file.close();
+		m_header = nullptr;
+	}
+
+	const void* TextureFile::getMipData(const uint32_t level) const
+	{
+		return m_header ? static_cast<const uint8_t*>(m_file.getData()) + m_header->mips[level].offset : nullptr;
+	}
+
+	uint32_t TextureFile::computeMipsCount(const uint32_t width, const uint32_t height)
+	{
+		uint32_t count = 1;
+		for (uint32_t size = std::max(width, height); size > 1; size >>= 1) {
+			++count;
+		}
+		return std::min<uint32_t>(count, TextureFileHeader::MaxMips);
+	}
+
+	bool TextureFile::write(const std::string& path, const uint32_t width, const uint32_t height, const void* pixels)
+	{
+		if (width == 0 || height == 0) {
+			LOG_ERR("Can't write texture {0}: it has no pixels", path);
+			return false;
+		}
+
+		TextureFileHeader header = {};
+		header.magic = TextureFileHeader::Magic;
+		header.version = TextureFileHeader::Version;
+		header.width = width;
+		header.height = height;
+		header.mipsCount = computeMipsCount(width, height);
+		header.format = TextureFormat::RGBA8;
+
+		// Odd sizes round down and drop the last row or column, a side 1 texel wide is reused for both taps
+		std::vector<std::vector<uint8_t>> mips(header.mipsCount);
+		const uint8_t* source = static_cast<const uint8_t*>(pixels);
+		mips[0].assign(source, source + static_cast<size_t>(width) * height * s_bytesPerPixel);
+		for (uint32_t level = 1; level < header.mipsCount; ++level) {
+			const uint32_t sourceWidth = std::max(1u, width >> (level - 1));
+			const uint32_t sourceHeight = std::max(1u, height >> (level - 1));
+			const uint32_t mipWidth = std::max(1u, width >> level);
+			const uint32_t mipHeight = std::max(1u, height >> level);
+			const std::vector<uint8_t>& finer = mips[level - 1];
+			std::vector<uint8_t>& mip = mips[level];
+			mip.resize(static_cast<size_t>(mipWidth) * mipHeight * s_bytesPerPixel);
+			for (uint32_t y = 0; y < mipHeight; ++y) {
+				const uint32_t y0 = std::min(y * 2, sourceHeight - 1);
+				const uint32_t y1 = std::min(y * 2 + 1, sourceHeight - 1);
+				for (uint32_t x = 0; x < mipWidth; ++x) {
+					const uint32_t x0 = std::min(x * 2, sourceWidth - 1);
+					const uint32_t x1 = std::min(x * 2 + 1, sourceWidth - 1);
+					for (uint32_t channel = 0; channel < s_bytesPerPixel; ++channel) {
+						const auto texel = [&](const uint32_t tx, const uint32_t ty) -> uint32_t {
+							return finer[(static_cast<size_t>(ty) * sourceWidth + tx) * s_bytesPerPixel + channel];
+						};
+						const uint32_t sum = texel(x0, y0) + texel(x1, y0) + texel(x0, y1) + texel(x1, y1);
+						mip[(static_cast<size_t>(y) * mipWidth + x) * s_bytesPerPixel + channel] = static_cast<uint8_t>((sum + 2) / 4);
+					}
+				}
+			}
+		}
+
+		uint64_t blobOffset = alignBlob(sizeof(TextureFileHeader));
+		for (uint32_t level = header.mipsCount; level-- > 0;) {
+			TextureFileMip& mip = header.mips[level];
+			mip.width = std::max(1u, width >> level);
+			mip.height = std::max(1u, height >> level);
+			mip.size = mips[level].size();
+			mip.offset = blobOffset;
+			blobOffset = alignBlob(blobOffset + mip.size);
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			LOG_ERR("Can't create texture file {0}", path);
+			return false;
+		}
+
+		static constexpr char padding[TextureFileHeader::BlobAlignment] = {};
+		const auto pad = [&](const uint64_t offset) {
+			file.write(padding, static_cast<std::streamsize>(offset - static_cast<uint64_t>(file.tellp())));
+		};
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		for (uint32_t level = header.mipsCount; level-- > 0;) {
+			pad(header.mips[level].offset);
+			file.write(reinterpret_cast<const char*>(mips[level].data()), static_cast<std::streamsize>(mips[level].size()));
+		}
+
+		if (!file) {
+			LOG_ERR("Failed writing texture file {0}", path);
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "mappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace GameEngine {
+	enum class TextureFormat : uint32_t {
+		RGBA8 = 0,
+	};
+
+	struct TextureFileMip {
+		uint64_t offset;
+		uint64_t size;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	// Cooked texture with its whole mip chain, little endian:
+	//   TextureFileHeader, the mip table indexed by level, 0 being the full resolution
+	//   mip blobs, coarsest first so streaming reads the file front to back
+	// Every blob starts at a TextureFileHeader::BlobAlignment boundary and holds tightly packed rows,
+	// top row first, as glTexSubImage expects them.
+	struct TextureFileHeader {
+		static constexpr uint32_t Magic = 0x58544547; // "GETX"
+		static constexpr uint32_t Version = 1;
+		static constexpr size_t MaxMips = 16;
+		static constexpr size_t BlobAlignment = 16;
+
+		uint32_t magic;
+		uint32_t version;
+		uint32_t width;
+		uint32_t height;
+		uint32_t mipsCount;
+		TextureFormat format;
+		TextureFileMip mips[MaxMips];
+	};
+
+	class TextureFile {
+	public:
+		TextureFile() = default;
+		~TextureFile() = default;
+
+		TextureFile(const TextureFile&) = delete;
+		TextureFile(TextureFile&&) = delete;
+		TextureFile& operator=(const TextureFile&) = delete;
+		TextureFile& operator=(TextureFile&&) = delete;
+
+		// Maps the file and validates the header, nothing is copied
+		bool open(const std::string& path);
+		void close();
+
+		inline bool isOpen() const { return m_header != nullptr; }
+		inline uint32_t getWidth() const { return m_header ? m_header->width : 0; }
+		inline uint32_t getHeight() const { return m_header ? m_header->height : 0; }
+		inline uint32_t getMipsCount() const { return m_header ? m_header->mipsCount : 0; }
+		inline TextureFormat getFormat() const { return m_header->format; }
+		inline const TextureFileMip& getMip(const uint32_t level) const { return m_header->mips[level]; }
+		const void* getMipData(const uint32_t level) const;
+
+		// Builds the mip chain of the RGBA8 image down to 1x1 with a 2x2 box filter and writes it
+		static bool write(const std::string& path, const uint32_t width, const uint32_t height, const void* pixels);
+		// Levels of a full chain down to 1x1
+		static uint32_t computeMipsCount(const uint32_t width, const uint32_t height);
+	private:
+		MappedFile m_file;
+		const TextureFileHeader* m_header = nullptr;
+	};
+}
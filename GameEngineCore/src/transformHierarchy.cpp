@@ -0,0 +1,342 @@
+#include "transformHierarchy.h"
+
+#include "jobSystem.h"
+#include "memory/frameMemory.h"
+#include "memory/stlAllocators.h"
+
+#include <log.h>
+
+#include <numeric>
+#include <utility>
+
+namespace GameEngine {
+	namespace {
+		template<typename T>
+		void permute(std::vector<T>& values, const ArenaVector<uint32_t>& order)
+		{
+			std::vector<T> permuted;
+			permuted.reserve(order.size());
+			for (const uint32_t index : order) {
+				permuted.push_back(values[index]);
+			}
+			values.swap(permuted);
+		}
+	}
+
+	TransformId TransformHierarchy::create(const TransformId parent, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+	{
+		if (parent != InvalidTransformId && !isAlive(parent)) {
+			LOG_ERR("Transform parent {0} doesn't exist", parent);
+			return InvalidTransformId;
+		}
+
+		TransformId id;
+		if (m_freeIds.empty()) {
+			id = static_cast<TransformId>(m_indices.size());
+			m_indices.push_back(InvalidIndex);
+		}
+		else {
+			id = m_freeIds.back();
+			m_freeIds.pop_back();
+		}
+
+		// Appended nodes still follow their parents, only the level ranges need a rebuild
+		const uint32_t index = static_cast<uint32_t>(m_parents.size());
+		m_indices[id] = index;
+		m_parents.push_back(parent == InvalidTransformId ? InvalidIndex : m_indices[parent]);
+		m_positions.push_back(position);
+		m_rotations.push_back(rotation);
+		m_scales.push_back(scale);
+		m_worldMatrices.push_back(glm::mat4(1.f));
+		m_localDirty.push_back(0);
+		m_worldVersions.push_back(0);
+		m_removed.push_back(0);
+		m_ids.push_back(id);
+
+		markDirty(index);
+		m_isOrderDirty = true;
+		return id;
+	}
+
+	void TransformHierarchy::destroy(const TransformId id)
+	{
+		if (!isAlive(id)) {
+			return;
+		}
+		// The descendants are dropped with their ancestor when the order is rebuilt
+		m_removed[m_indices[id]] = 1;
+		++m_removedCount;
+		m_isOrderDirty = true;
+	}
+
+	bool TransformHierarchy::setParent(const TransformId id, const TransformId parent)
+	{
+		if (!isAlive(id) || (parent != InvalidTransformId && !isAlive(parent))) {
+			LOG_ERR("Can't parent transform {0} to {1}, one of them doesn't exist", id, parent);
+			return false;
+		}
+
+		const uint32_t index = m_indices[id];
+		const uint32_t parentIndex = parent == InvalidTransformId ? InvalidIndex : m_indices[parent];
+		for (uint32_t ancestor = parentIndex; ancestor != InvalidIndex; ancestor = m_parents[ancestor]) {
+			if (ancestor == index) {
+				LOG_ERR("Can't parent transform {0} to its descendant {1}", id, parent);
+				return false;
+			}
+		}
+
+		m_parents[index] = parentIndex;
+		markDirty(index);
+		m_isOrderDirty = true;
+		return true;
+	}
+
+	void TransformHierarchy::clear()
+	{
+		m_parents.clear();
+		m_positions.clear();
+		m_rotations.clear();
+		m_scales.clear();
+		m_worldMatrices.clear();
+		m_localDirty.clear();
+		m_worldVersions.clear();
+		m_removed.clear();
+		m_ids.clear();
+		m_levels.clear();
+		m_indices.clear();
+		m_freeIds.clear();
+		m_removedCount = 0;
+		m_updatedCount = 0;
+		m_isOrderDirty = false;
+		m_isAnyDirty.store(false, std::memory_order_relaxed);
+	}
+
+	void TransformHierarchy::resetNodes(const size_t count)
+	{
+		clear();
+		m_parents.resize(count);
+		m_positions.resize(count);
+		m_rotations.resize(count);
+		m_scales.resize(count);
+		m_worldMatrices.assign(count, glm::mat4(1.f));
+		m_localDirty.assign(count, 1);
+		m_worldVersions.assign(count, 0);
+		m_removed.assign(count, 0);
+		m_ids.resize(count);
+		std::iota(m_ids.begin(), m_ids.end(), 0);
+		m_indices = m_ids;
+		// Parents precede their children, the levels are found by the next update
+		m_isOrderDirty = true;
+		m_isAnyDirty.store(count > 0, std::memory_order_relaxed);
+	}
+
+	void TransformHierarchy::setPosition(const TransformId id, const glm::vec3& position)
+	{
+		const uint32_t index = m_indices[id];
+		m_positions[index] = position;
+		markDirty(index);
+	}
+
+	void TransformHierarchy::setRotation(const TransformId id, const glm::quat& rotation)
+	{
+		const uint32_t index = m_indices[id];
+		m_rotations[index] = rotation;
+		markDirty(index);
+	}
+
+	void TransformHierarchy::setScale(const TransformId id, const glm::vec3& scale)
+	{
+		const uint32_t index = m_indices[id];
+		m_scales[index] = scale;
+		markDirty(index);
+	}
+
+	void TransformHierarchy::setLocal(const TransformId id, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+	{
+		const uint32_t index = m_indices[id];
+		m_positions[index] = position;
+		m_rotations[index] = rotation;
+		m_scales[index] = scale;
+		markDirty(index);
+	}
+
+	TransformId TransformHierarchy::getParent(const TransformId id) const
+	{
+		const uint32_t parentIndex = m_parents[m_indices[id]];
+		return parentIndex == InvalidIndex ? InvalidTransformId : m_ids[parentIndex];
+	}
+
+	bool TransformHierarchy::isAlive(const TransformId id) const
+	{
+		if (id >= m_indices.size() || m_indices[id] == InvalidIndex) {
+			return false;
+		}
+		if (m_removedCount == 0) {
+			return true;
+		}
+		// Descendants of a destroyed node are only flagged through it until the order is rebuilt
+		for (uint32_t index = m_indices[id]; index != InvalidIndex; index = m_parents[index]) {
+			if (m_removed[index]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void TransformHierarchy::update()
+	{
+		if (m_isOrderDirty) {
+			rebuildOrder();
+		}
+		++m_version;
+		m_updatedCount = 0;
+		if (!m_isAnyDirty.exchange(false, std::memory_order_relaxed)) {
+			return;
+		}
+
+		for (size_t level = 0; level + 1 < m_levels.size(); ++level) {
+			const size_t begin = m_levels[level];
+			const size_t end = m_levels[level + 1];
+			if (end - begin < ParallelLevelSize || JobSystem::getWorkersCount() == 1) {
+				m_updatedCount += updateRange(begin, end);
+				continue;
+			}
+			std::atomic<size_t> updatedCount = 0;
+			JobSystem::parallel_for(begin, end, ParallelGrain, [this, &updatedCount](const size_t rangeBegin, const size_t rangeEnd) {
+				updatedCount.fetch_add(updateRange(rangeBegin, rangeEnd), std::memory_order_relaxed);
+			});
+			m_updatedCount += updatedCount.load(std::memory_order_relaxed);
+		}
+	}
+
+	void TransformHierarchy::markDirty(const uint32_t index)
+	{
+		m_localDirty[index] = 1;
+		// Checked first so that workers animating many nodes don't keep bouncing the cache line
+		if (!m_isAnyDirty.load(std::memory_order_relaxed)) {
+			m_isAnyDirty.store(true, std::memory_order_relaxed);
+		}
+	}
+
+	void TransformHierarchy::rebuildOrder()
+	{
+		const size_t count = m_parents.size();
+		// The temporaries live in the scratch arena, the permuted members stay on the heap
+		ScratchScope scratch;
+		const ArenaAllocator<uint32_t> allocator(scratch.getArena());
+
+		// Children of every node as ranges of one array
+		ArenaVector<uint32_t> childrenOffsets(count + 1, 0, allocator);
+		for (size_t i = 0; i < count; ++i) {
+			if (m_parents[i] != InvalidIndex) {
+				++childrenOffsets[m_parents[i] + 1];
+			}
+		}
+		for (size_t i = 0; i < count; ++i) {
+			childrenOffsets[i + 1] += childrenOffsets[i];
+		}
+		ArenaVector<uint32_t> children(childrenOffsets[count], allocator);
+		ArenaVector<uint32_t> childrenFilled(childrenOffsets.begin(), childrenOffsets.end() - 1, allocator);
+		for (size_t i = 0; i < count; ++i) {
+			if (m_parents[i] != InvalidIndex) {
+				children[childrenFilled[m_parents[i]]++] = static_cast<uint32_t>(i);
+			}
+		}
+
+		// Breadth-first from the roots, removed nodes are never entered so their subtrees fall out
+		ArenaVector<uint32_t> order(allocator);
+		order.reserve(count);
+		for (size_t i = 0; i < count; ++i) {
+			if (m_parents[i] == InvalidIndex && !m_removed[i]) {
+				order.push_back(static_cast<uint32_t>(i));
+			}
+		}
+		m_levels.clear();
+		size_t levelBegin = 0;
+		while (levelBegin < order.size()) {
+			m_levels.push_back(static_cast<uint32_t>(levelBegin));
+			const size_t levelEnd = order.size();
+			for (size_t i = levelBegin; i < levelEnd; ++i) {
+				for (uint32_t child = childrenOffsets[order[i]]; child < childrenOffsets[order[i] + 1]; ++child) {
+					if (!m_removed[children[child]]) {
+						order.push_back(children[child]);
+					}
+				}
+			}
+			levelBegin = levelEnd;
+		}
+		m_levels.push_back(static_cast<uint32_t>(order.size()));
+
+		ArenaVector<uint32_t> newIndices(count, InvalidIndex, allocator);
+		for (size_t i = 0; i < order.size(); ++i) {
+			newIndices[order[i]] = static_cast<uint32_t>(i);
+		}
+		for (size_t i = 0; i < count; ++i) {
+			if (newIndices[i] == InvalidIndex) {
+				m_indices[m_ids[i]] = InvalidIndex;
+				m_freeIds.push_back(m_ids[i]);
+			}
+		}
+
+		std::vector<uint32_t> parents;
+		parents.reserve(order.size());
+		for (const uint32_t index : order) {
+			parents.push_back(m_parents[index] == InvalidIndex ? InvalidIndex : newIndices[m_parents[index]]);
+		}
+		m_parents.swap(parents);
+		permute(m_positions, order);
+		permute(m_rotations, order);
+		permute(m_scales, order);
+		permute(m_worldMatrices, order);
+		permute(m_localDirty, order);
+		permute(m_worldVersions, order);
+		permute(m_ids, order);
+		m_removed.assign(order.size(), 0);
+		for (size_t i = 0; i < order.size(); ++i) {
+			m_indices[m_ids[i]] = static_cast<uint32_t>(i);
+		}
+
+		m_removedCount = 0;
+		m_isOrderDirty = false;
+	}
+
+	size_t TransformHierarchy::updateRange(const size_t begin, const size_t end)
+	{
+		size_t updatedCount = 0;
+		for (size_t i = begin; i < end; ++i) {
+			const uint32_t parent = m_parents[i];
+			const bool isParentChanged = parent != InvalidIndex && m_worldVersions[parent] == m_version;
+			if (!m_localDirty[i] && !isParentChanged) {
+				continue;
+			}
+			m_localDirty[i] = 0;
+
+			// Columns of translate * rotate * scale, built without the full matrix products
+			const glm::mat3 rotation = glm::mat3_cast(m_rotations[i]);
+			const glm::vec3& scale = m_scales[i];
+			const glm::vec3 axisX = rotation[0] * scale.x;
+			const glm::vec3 axisY = rotation[1] * scale.y;
+			const glm::vec3 axisZ = rotation[2] * scale.z;
+			const glm::vec3& position = m_positions[i];
+
+			glm::mat4& world = m_worldMatrices[i];
+			if (parent == InvalidIndex) {
+				world[0] = glm::vec4(axisX, 0.f);
+				world[1] = glm::vec4(axisY, 0.f);
+				world[2] = glm::vec4(axisZ, 0.f);
+				world[3] = glm::vec4(position, 1.f);
+			}
+			else {
+				// Both matrices are affine, the bottom row of the local one is never multiplied
+				const glm::mat4& parentWorld = m_worldMatrices[parent];
+				world[0] = parentWorld[0] * axisX.x + parentWorld[1] * axisX.y + parentWorld[2] * axisX.z;
+				world[1] = parentWorld[0] * axisY.x + parentWorld[1] * axisY.y + parentWorld[2] * axisY.z;
+				world[2] = parentWorld[0] * axisZ.x + parentWorld[1] * axisZ.y + parentWorld[2] * axisZ.z;
+				world[3] = parentWorld[0] * position.x + parentWorld[1] * position.y + parentWorld[2] * position.z + parentWorld[3];
+			}
+			m_worldVersions[i] = m_version;
+			++updatedCount;
+		}
+		return updatedCount;
+	}
+}
@@ -5,10 +5,13 @@
 
 #include <GLFW/glfw3.h>
 #include <log.h>
+#include <profiler.h>
+
+#include <cstdlib>
 
 namespace GameEngine {
-	Window::Window(uint width, uint height, std::string title)
-		: winProps({ width, height, (float)width / (float)height, std::move(title) })
+	Window::Window(uint width, uint height, std::string title, const bool headless)
+		: winProps({ width, height, (float)width / (float)height, std::move(title) }), m_isHeadless(headless)
 	{
 		LOG_INFO("Window created {0}x{1}", width, height);
 		int res = init();
@@ -51,6 +54,13 @@ namespace GameEngine {
 			LOG_ERR("GLFW error: {}", description);
 		});
 
+#if defined(GLFW_PLATFORM_NULL) && defined(__linux__)
+		// Build machines have no display server, GLFW's null platform with OSMesa renders on llvmpipe
+		const bool useOSMesa = m_isHeadless && !std::getenv("DISPLAY") && !std::getenv("WAYLAND_DISPLAY");
+		if (useOSMesa) {
+			glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+		}
+#endif
 		if (!glfwInit()) {
 			LOG_CRIT("GLFW initialization failure");
 			return -1;
@@ -59,6 +69,14 @@ namespace GameEngine {
 		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
 		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
 		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		if (m_isHeadless) {
+			glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		}
+#if defined(GLFW_PLATFORM_NULL) && defined(__linux__)
+		if (useOSMesa) {
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+		}
+#endif
 
 		m_window = glfwCreateWindow(winProps.width, winProps.height, winProps.title.c_str(), NULL, NULL);
 		if (!m_window)
@@ -82,14 +100,12 @@ namespace GameEngine {
 			winProps->height = height;
 			winProps->aspect_ratio = (float)width / (float)height;
 
-			WindowResizeEvent event(width, height);
-			winProps->eventCallback(event);
+			winProps->eventQueue.push(WindowResizeEvent(width, height));
 			});
 		glfwSetWindowCloseCallback(m_window, [](GLFWwindow* window) {
 			WinProps* winProps = reinterpret_cast<WinProps*>(glfwGetWindowUserPointer(window));
 
-			WindowCloseEvent event;
-			winProps->eventCallback(event);
+			winProps->eventQueue.push(WindowCloseEvent());
 			});
 		glfwSetFramebufferSizeCallback(m_window, [](GLFWwindow* window, int width, int height) {
 			OpenGL_Renderer::setViewPort(width, height);
@@ -100,18 +116,15 @@ namespace GameEngine {
 			switch (action)
 			{
 			case GLFW_PRESS: {
-				KeyPressedEvent event(static_cast<KeyCode>(key), false);
-				winProps->eventCallback(event);
+				winProps->eventQueue.push(KeyPressedEvent(static_cast<KeyCode>(key), false));
 				break;
 			}
 			case GLFW_RELEASE: {
-				KeyReleasedEvent event(static_cast<KeyCode>(key));
-				winProps->eventCallback(event);
+				winProps->eventQueue.push(KeyReleasedEvent(static_cast<KeyCode>(key)));
 				break;
 			}
 			case GLFW_REPEAT: {
-				KeyPressedEvent event(static_cast<KeyCode>(key), true);
-				winProps->eventCallback(event);
+				winProps->eventQueue.push(KeyPressedEvent(static_cast<KeyCode>(key), true));
 				break;
 			}
 			}
@@ -119,14 +132,12 @@ namespace GameEngine {
 		glfwSetCursorPosCallback(m_window, [](GLFWwindow* window, double xpos, double ypos) {
 			WinProps* winProps = reinterpret_cast<WinProps*>(glfwGetWindowUserPointer(window));
 
-			MouseMovedEvent event(xpos, ypos);
-			winProps->eventCallback(event);
+			winProps->eventQueue.push(MouseMovedEvent(xpos, ypos));
 			});
 		glfwSetScrollCallback(m_window, [](GLFWwindow* window, double xoffset, double yoffset) {
 			WinProps* winProps = reinterpret_cast<WinProps*>(glfwGetWindowUserPointer(window));
 
-			MouseScrolledEvent event(xoffset);
-			winProps->eventCallback(event);
+			winProps->eventQueue.push(MouseScrolledEvent(xoffset));
 			});
 		glfwSetMouseButtonCallback(m_window, [](GLFWwindow* window, int button, int action, int mods) 
 		{
@@ -138,13 +149,11 @@ namespace GameEngine {
 			switch (action)
 			{
 				case GLFW_PRESS: {
-					MouseButtonPressedEvent event(static_cast<MouseButton>(button), xpos, ypos);
-					winProps->eventCallback(event);
+					winProps->eventQueue.push(MouseButtonPressedEvent(static_cast<MouseButton>(button), xpos, ypos));
 					break;
 				}
 				case GLFW_RELEASE: {
-					MouseButtonReleasedEvent event(static_cast<MouseButton>(button), xpos, ypos);
-					winProps->eventCallback(event);
+					winProps->eventQueue.push(MouseButtonReleasedEvent(static_cast<MouseButton>(button), xpos, ypos));
 					break;
 				}
 			}
@@ -158,7 +167,12 @@ namespace GameEngine {
 
 	void Window::onUpdate()
 	{
-		glfwSwapBuffers(m_window);
+		// Headless frames go to an offscreen framebuffer, there is nothing to present
+		if (!m_isHeadless) {
+			PROFILE_SCOPE("Swap buffers");
+			glfwSwapBuffers(m_window);
+		}
+		PROFILE_SCOPE("Poll events");
 		glfwPollEvents();
 	}
 
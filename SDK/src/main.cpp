@@ -1,14 +1,36 @@
 #include "application.h"
 
 #include "input.h"
+#include "profiler.h"
+#include "components.h"
+#include "memory/frameMemory.h"
 
 #include <imgui/imgui.h>
 #include <log.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 
 
 class SDK : public GameEngine::Application {
+	float rotation_speed = 0.6f;
+
+	int spawn_count = 1000;
+	std::vector<GameEngine::Entity> spawned_entities;
+
+	char mesh_path[256] = "mesh.gem";
+	char texture_path[256] = "texture.getx";
+	char scene_path[256] = "scene.gesc";
+
+	bool profiler_paused = false;
+	// Copy of the latest frame taken when pausing, the history recycles its frames
+	GameEngine::ProfileFrame profiler_frame;
+	std::vector<float> profiler_frame_times;
+
 	void setupDockspaceMenu()
 	{
 		static ImGuiDockNodeFlags dockspace_flags = ImGuiDockNodeFlags_PassthruCentralNode;
@@ -34,57 +56,156 @@ class SDK : public GameEngine::Application {
 		ImGui::End();
 	}
 
-	virtual void onUpdate() override {
+	void spawnCubes(const size_t count)
+	{
+		const size_t side = static_cast<size_t>(std::ceil(std::cbrt(static_cast<double>(spawned_entities.size() + count))));
+		for (size_t i = 0; i < count; ++i) {
+			const size_t index = spawned_entities.size();
+			const glm::vec3 position = {
+				2.f + static_cast<float>(index % side) * 1.5f,
+				static_cast<float>((index / side) % side) * 1.5f,
+				static_cast<float>(index / (side * side)) * 1.5f
+			};
+			GameEngine::Transform transform;
+			transform.model_matrix = glm::scale(glm::translate(glm::mat4(1.f), position), glm::vec3(0.5f));
+			spawned_entities.push_back(scene.create(transform, GameEngine::MeshRef{ CubeMeshId }));
+		}
+	}
+
+	void drawProfilerWindow()
+	{
+		ImGui::Begin("Profiler");
+
+		bool isProfilerEnabled = GameEngine::Profiler::isEnabled();
+		if (ImGui::Checkbox("Enabled", &isProfilerEnabled)) {
+			GameEngine::Profiler::setEnabled(isProfilerEnabled);
+		}
+		ImGui::SameLine();
+		const GameEngine::ProfileFrame* latestFrame = GameEngine::Profiler::getLatestFrame();
+		if (ImGui::Checkbox("Pause", &profiler_paused) && profiler_paused && latestFrame) {
+			profiler_frame = *latestFrame;
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Export trace")) {
+			GameEngine::Profiler::exportChromeTrace("trace.json");
+		}
+
+		if (!profiler_paused) {
+			profiler_frame_times.clear();
+			for (size_t i = 0; i < GameEngine::Profiler::getHistorySize(); ++i) {
+				const GameEngine::ProfileFrame& frame = GameEngine::Profiler::getHistoryFrame(i);
+				profiler_frame_times.push_back((frame.end - frame.start) / 1e6f);
+			}
+		}
+		if (!profiler_frame_times.empty()) {
+			ImGui::PlotLines("Frame ms", profiler_frame_times.data(), static_cast<int>(profiler_frame_times.size()), 0, nullptr, 0.f, 33.f, ImVec2(0, 60));
+		}
+		ImGui::Text("Dropped events: %zu", GameEngine::Profiler::getDroppedEventsCount());
+
+		const GameEngine::ProfileFrame& frame = profiler_paused || !latestFrame ? profiler_frame : *latestFrame;
+		if (frame.end <= frame.start) {
+			ImGui::End();
+			return;
+		}
+
+		// One lane per thread, stacked by scope depth, plus a lane for GPU timings
+		const float rowHeight = 18.f;
+		uint32_t maxThreadId = 0;
+		uint16_t maxDepth = 0;
+		for (const GameEngine::ProfileEvent& event : frame.events) {
+			if (!event.isGpu) {
+				maxThreadId = std::max(maxThreadId, event.threadId);
+			}
+			maxDepth = std::max(maxDepth, event.depth);
+		}
+		const uint32_t rowsPerThread = maxDepth + 1u;
+		const float gpuLaneY = (maxThreadId + 1) * rowsPerThread * rowHeight;
+
+		const ImVec2 origin = ImGui::GetCursorScreenPos();
+		const float width = std::max(ImGui::GetContentRegionAvail().x, 100.f);
+		const float height = gpuLaneY + rowHeight;
+		const double frameDuration = static_cast<double>(frame.end - frame.start);
+		ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+		for (const GameEngine::ProfileEvent& event : frame.events) {
+			const double start = event.start > frame.start ? static_cast<double>(event.start - frame.start) : 0.0;
+			const double end = event.end > frame.start ? static_cast<double>(event.end - frame.start) : 0.0;
+			const float x0 = origin.x + static_cast<float>(std::min(start / frameDuration, 1.0)) * width;
+			const float x1 = std::max(origin.x + static_cast<float>(std::min(end / frameDuration, 1.0)) * width, x0 + 1.f);
+			const float y0 = origin.y + (event.isGpu ? gpuLaneY : (event.threadId * rowsPerThread + event.depth) * rowHeight);
+			const ImVec2 min(x0, y0);
+			const ImVec2 max(x1, y0 + rowHeight - 1.f);
+
+			drawList->AddRectFilled(min, max, event.isGpu ? IM_COL32(200, 120, 60, 255) : IM_COL32(70, 130, 200, 255));
+			drawList->PushClipRect(min, max, true);
+			drawList->AddText(ImVec2(x0 + 2.f, y0 + 2.f), IM_COL32(255, 255, 255, 255), event.name);
+			drawList->PopClipRect();
+
+			if (ImGui::IsMouseHoveringRect(min, max)) {
+				ImGui::SetTooltip("%s%s: %.3f ms", event.isGpu ? "GPU " : "", event.name, (event.end - event.start) / 1e6);
+			}
+		}
+		ImGui::Dummy(ImVec2(width, height));
+		ImGui::Text("Frame: %.3f ms", frameDuration / 1e6);
+
+		ImGui::End();
+	}
+
+	virtual void onFixedUpdate(const double fixedDeltaTime) override {
+		const float move_step = camera_speed * static_cast<float>(fixedDeltaTime);
+		const float rotate_step = rotation_speed * static_cast<float>(fixedDeltaTime);
 
 		glm::vec3 move_delta = { 0, 0, 0 };
 		glm::vec3 rotate_delta = { 0, 0, 0 };
 
 		if (GameEngine::Input::isKeyPressed(GameEngine::KeyCode::KEY_W)) {
-			move_delta.x += camera_speed;
+			move_delta.x += move_step;
 		}
 		else if (GameEngine::Input::isKeyPressed(GameEngine::KeyCode::KEY_S)) {
-			move_delta.x -= camera_speed;
+			move_delta.x -= move_step;
 		}
 		if (GameEngine::Input::isKeyPressed(GameEngine::KeyCode::KEY_D)) {
-			move_delta.y += camera_speed;
+			move_delta.y += move_step;
 		}
 		else if (GameEngine::Input::isKeyPressed(GameEngine::KeyCode::KEY_A)) {
-			move_delta.y -= camera_speed;
+			move_delta.y -= move_step;
 		}
 		if (GameEngine::Input::isKeyPressed(GameEngine::KeyCode::KEY_SPACE)) {
-			move_delta.z += camera_speed;
+			move_delta.z += move_step;
 		}
 		else if (GameEngine::Input::isKeyPressed(GameEngine::KeyCode::KEY_LEFT_SHIFT)) {
-			move_delta.z -= camera_speed;
+			move_delta.z -= move_step;
 		}
 
 		if (GameEngine::Input::isKeyPressed(GameEngine::KeyCode::KEY_UP)) {
-			rotate_delta.y -= 0.01;
+			rotate_delta.y -= rotate_step;
 		}
 		else if (GameEngine::Input::isKeyPressed(GameEngine::KeyCode::KEY_DOWN)) {
-			rotate_delta.y += 0.01;
+			rotate_delta.y += rotate_step;
 		}
 		if (GameEngine::Input::isKeyPressed(GameEngine::KeyCode::KEY_RIGHT)) {
-			rotate_delta.z += 0.01;
+			rotate_delta.z += rotate_step;
 		}
 		else if (GameEngine::Input::isKeyPressed(GameEngine::KeyCode::KEY_LEFT)) {
-			rotate_delta.z -= 0.01;
+			rotate_delta.z -= rotate_step;
 		}
 		if (GameEngine::Input::isKeyPressed(GameEngine::KeyCode::KEY_P)) {
-			rotate_delta.x += 0.01;
+			rotate_delta.x += rotate_step;
 		}
 		else if (GameEngine::Input::isKeyPressed(GameEngine::KeyCode::KEY_Q)) {
-			rotate_delta.x -= 0.01;
+			rotate_delta.x -= rotate_step;
+		}
+		// Mouse look is read from the tick snapshot too, so recorded sessions replay the same flythrough
+		if (!isCursorEnabled()) {
+			const glm::vec2 cursor_delta = GameEngine::Input::getCursorDelta();
+			rotate_delta.y += cursor_delta.y * 0.001f * sensivity;
+			rotate_delta.z += cursor_delta.x * 0.001f * sensivity;
 		}
 		camera.moveAndRotate(move_delta, rotate_delta);
 
-	}
-
-	virtual void onKeyPressed(const GameEngine::KeyCode key) override {
-		if (key == GameEngine::KeyCode::KEY_ESCAPE) {
+		if (GameEngine::Input::isKeyJustPressed(GameEngine::KeyCode::KEY_ESCAPE)) {
 			if (isCursorEnabled())
 			{
-				lastCursorPos = getCursorPos();
 				disableCursor();
 			}
 			else
@@ -93,15 +214,20 @@ class SDK : public GameEngine::Application {
 			}
 		}
 	}
-	virtual void onMouseMoved(double x, double y) override {
-		if (!isCursorEnabled()) {
-			double xOffset = x - lastCursorPos.x;
-			double yOffset = y - lastCursorPos.y;
-			lastCursorPos.x = x;
-			lastCursorPos.y = y;
 
-			camera.rotate({ 0, yOffset * 0.001 * sensivity, xOffset * 0.001 * sensivity });
+	virtual void onInputReplayFinished(const std::vector<double>& frameTimes) override {
+		if (!frameTimes.empty()) {
+			std::vector<double> sorted = frameTimes;
+			std::sort(sorted.begin(), sorted.end());
+			double total = 0;
+			for (const double frameTime : sorted) {
+				total += frameTime;
+			}
+			LOG_INFO("Replay frame times: avg {0:.3f} ms, p50 {1:.3f} ms, p99 {2:.3f} ms, max {3:.3f} ms over {4} frames",
+				total * 1000.0 / sorted.size(), sorted[sorted.size() / 2] * 1000.0,
+				sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)] * 1000.0, sorted.back() * 1000.0, sorted.size());
 		}
+		close();
 	}
 
 	virtual void on_UI_draw() override {
@@ -109,19 +235,131 @@ class SDK : public GameEngine::Application {
 
 		ImGui::Begin("Settings");
 
-		ImGui::SliderFloat("Camera speed", &camera_speed, 0, 0.5);
+		ImGui::SliderFloat("Camera speed", &camera_speed, 0, 30);
 		ImGui::SliderFloat("Sensivity", &sensivity, 0, 3);
 		ImGui::Checkbox("Perspective mode", &isPerspectiveMode);
+		ImGui::Checkbox("Reverse-Z", &isReverseZ);
+		ImGui::Checkbox("GPU-driven (compute culling + MDI)", &isGpuDriven);
+		ImGui::Checkbox("Levels of detail", &isLodEnabled);
+		ImGui::SliderFloat("LOD pixel error", &lodPixelError, 0.1f, 10.f);
 		if (ImGui::Button("Default positions")) {
 			camera.setPositionRotation({ 0, 0, 0 }, { 0, 0, 0 });
 		}
+
+		ImGui::Separator();
+		ImGui::SliderInt("Cubes to spawn", &spawn_count, 1, 100000);
+		if (ImGui::Button("Spawn cubes")) {
+			spawnCubes(static_cast<size_t>(spawn_count));
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Clear cubes")) {
+			for (const GameEngine::Entity entity : spawned_entities) {
+				scene.destroy(entity);
+			}
+			spawned_entities.clear();
+		}
+		ImGui::Text("Entities: %zu", scene.size());
+
+		ImGui::Separator();
+		ImGui::InputText("Mesh file", mesh_path, sizeof(mesh_path));
+		if (ImGui::Button("Load mesh")) {
+			const uint32_t meshId = loadMesh(mesh_path);
+			if (meshId != InvalidMeshId) {
+				scene.create(GameEngine::Transform{}, GameEngine::MeshRef{ meshId });
+			}
+		}
+		ImGui::InputText("Texture file", texture_path, sizeof(texture_path));
+		if (ImGui::Button("Load texture")) {
+			loadTexture(texture_path);
+		}
+		ImGui::InputText("Scene file", scene_path, sizeof(scene_path));
+		if (ImGui::Button("Save scene")) {
+			saveScene(scene_path);
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Load scene") && loadScene(scene_path)) {
+			// The loaded entities are part of the scene now, not spawned cubes
+			spawned_entities.clear();
+		}
 		ImGui::End();
+
+		const GameEngine::RenderStats& stats = getRenderStats();
+		ImGui::Begin("Render stats");
+		ImGui::Text("Objects: %zu", stats.submissions);
+		ImGui::Text("Culled: %zu", stats.culledObjects);
+		ImGui::Text("Draw calls: %zu", stats.drawCalls);
+		ImGui::Text("Vertices: %zu", stats.vertices);
+		ImGui::Text("Indices: %zu", stats.indices);
+		ImGui::Text("Triangles: %zu (%zu at full detail)", stats.indices / 3, stats.fullDetailIndices / 3);
+		ImGui::Text("Stream fence waits: %zu", stats.fenceWaits);
+		ImGui::Text("State changes: %zu unsorted, %zu sorted", stats.stateChangesUnsorted, stats.stateChangesSorted);
+		ImGui::Text("GL state calls: %zu issued, %zu skipped", stats.glCallsIssued, stats.glCallsSkipped);
+		ImGui::Text("Frame time: %.3f ms", getFrameDeltaTime() * 1000.0);
+		const GameEngine::TextureStats textureStats = getTextureStats();
+		ImGui::Text("Streaming textures: %zu, %.2f KB uploaded", textureStats.streamingTextures, textureStats.uploadedBytes / 1024.0);
+		for (const GameEngine::TexturePoolStats& pool : textureStats.pools) {
+			ImGui::Text("Texture pool %ux%u, %u mips: %u/%u layers, %.2f MB",
+				pool.width, pool.height, pool.mipsCount, pool.layersCount, pool.capacity, pool.memoryBytes / (1024.0 * 1024.0));
+		}
+		// Zero in release builds, the allocators only count in debug
+		const GameEngine::FrameMemoryStats& memoryStats = GameEngine::FrameMemory::getStats();
+		ImGui::Text("Frame arena: %zu allocations, %.1f KB (peak %.1f KB of %.1f KB)", memoryStats.frameAllocations,
+			memoryStats.frameBytes / 1024.0, memoryStats.frameHighWaterMark / 1024.0, memoryStats.frameCapacity / 1024.0);
+		ImGui::Text("Scratch arena peak: %.1f KB", memoryStats.scratchHighWaterMark / 1024.0);
+		const GameEngine::LogStats logStats = GameEngine::Log::getStats();
+		ImGui::Text("Log: %zu written, %zu dropped, queue peak %zu/%zu", logStats.written, logStats.dropped,
+			logStats.highWaterMark, GameEngine::Log::QueueCapacity);
+		ImGui::End();
+
+		drawProfilerWindow();
 	}
 };
 
-int main() {
+// Usage: SDK [--record input.rec] [--replay input.rec] [--headless] [--frames N] [--hash hashes.txt] [--images dir] [--scene scene.gesc]
+// A replay runs the recorded ticks, logs the frame time statistics and exits.
+// Headless runs render offscreen, optionally hashing or saving every frame, and exit after --frames.
+int main(int argc, char** argv) {
 	auto sdk = std::make_unique<SDK>();
-	sdk->start(1280, 720, "Editor");
+	GameEngine::ApplicationOptions options;
+	for (int i = 1; i < argc; ++i) {
+		const std::string option = argv[i];
+		if (option == "--headless") {
+			options.headless = true;
+			continue;
+		}
+		if (i + 1 >= argc) {
+			LOG_ERR("Option {0} needs a value", option);
+			return 1;
+		}
+		const char* value = argv[++i];
+		if (option == "--record") {
+			sdk->recordInput(value);
+		}
+		else if (option == "--replay") {
+			if (!sdk->replayInput(value)) {
+				return 1;
+			}
+		}
+		else if (option == "--frames") {
+			options.framesCount = std::strtoull(value, nullptr, 10);
+		}
+		else if (option == "--hash") {
+			options.frameOutput = GameEngine::ApplicationOptions::FrameOutput::Hash;
+			options.outputPath = value;
+		}
+		else if (option == "--images") {
+			options.frameOutput = GameEngine::ApplicationOptions::FrameOutput::Images;
+			options.outputPath = value;
+		}
+		else if (option == "--scene") {
+			options.scenePath = value;
+		}
+		else {
+			LOG_ERR("Unknown option {0}", option);
+			return 1;
+		}
+	}
+	sdk->start(1280, 720, "Editor", options);
 
 	return 0;
 }
\ No newline at end of file
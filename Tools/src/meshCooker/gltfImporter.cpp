@@ -0,0 +1,547 @@
+#include "gltfImporter.h"
+
+#include "json.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace MeshCooker {
+	namespace {
+		constexpr uint32_t GlbMagic = 0x46546C67; // "glTF"
+		constexpr uint32_t GlbJsonChunk = 0x4E4F534A;
+		constexpr uint32_t GlbBinaryChunk = 0x004E4942;
+
+		constexpr int ComponentByte = 5120;
+		constexpr int ComponentUnsignedByte = 5121;
+		constexpr int ComponentShort = 5122;
+		constexpr int ComponentUnsignedShort = 5123;
+		constexpr int ComponentUnsignedInt = 5125;
+		constexpr int ComponentFloat = 5126;
+
+		constexpr int ModeTriangles = 4;
+
+		// Column-major like the file
+		struct Matrix {
+			float values[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+
+			Matrix operator*(const Matrix& other) const
+			{
+				Matrix result;
+				for (int column = 0; column < 4; ++column) {
+					for (int row = 0; row < 4; ++row) {
+						float sum = 0;
+						for (int k = 0; k < 4; ++k) {
+							sum += values[k * 4 + row] * other.values[column * 4 + k];
+						}
+						result.values[column * 4 + row] = sum;
+					}
+				}
+				return result;
+			}
+		};
+
+		struct Document {
+			JsonValue json;
+			std::vector<std::vector<uint8_t>> buffers;
+			std::string directory;
+		};
+
+		bool readFile(const std::string& path, std::vector<uint8_t>& data)
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file) {
+				std::fprintf(stderr, "Can't open %s\n", path.c_str());
+				return false;
+			}
+			data.resize(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+			return static_cast<bool>(file);
+		}
+
+		bool decodeBase64(const char* text, const size_t length, std::vector<uint8_t>& data)
+		{
+			static const auto decodeChar = [](const char c) -> int {
+				if (c >= 'A' && c <= 'Z') return c - 'A';
+				if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+				if (c >= '0' && c <= '9') return c - '0' + 52;
+				if (c == '+') return 62;
+				if (c == '/') return 63;
+				return -1;
+			};
+
+			data.clear();
+			data.reserve(length / 4 * 3);
+			uint32_t accumulator = 0;
+			int bits = 0;
+			for (size_t i = 0; i < length && text[i] != '='; ++i) {
+				const int value = decodeChar(text[i]);
+				if (value < 0) {
+					return false;
+				}
+				accumulator = (accumulator << 6) | static_cast<uint32_t>(value);
+				bits += 6;
+				if (bits >= 8) {
+					bits -= 8;
+					data.push_back(static_cast<uint8_t>(accumulator >> bits));
+				}
+			}
+			return true;
+		}
+
+		bool loadBuffers(Document& document, const std::vector<uint8_t>* glbBinary)
+		{
+			const JsonValue* buffers = document.json.find("buffers");
+			if (!buffers) {
+				return true;
+			}
+			for (size_t i = 0; i < buffers->size(); ++i) {
+				const JsonValue& buffer = (*buffers)[i];
+				document.buffers.emplace_back();
+				std::vector<uint8_t>& data = document.buffers.back();
+
+				const std::string* uri = buffer.getString("uri");
+				if (!uri) {
+					if (!glbBinary) {
+						std::fprintf(stderr, "Buffer %zu has no uri and there is no GLB binary chunk\n", i);
+						return false;
+					}
+					data = *glbBinary;
+				}
+				else if (uri->compare(0, 5, "data:") == 0) {
+					const size_t comma = uri->find(";base64,");
+					if (comma == std::string::npos || !decodeBase64(uri->c_str() + comma + 8, uri->size() - comma - 8, data)) {
+						std::fprintf(stderr, "Buffer %zu has an unsupported data uri\n", i);
+						return false;
+					}
+				}
+				else if (!readFile(document.directory + *uri, data)) {
+					return false;
+				}
+
+				if (data.size() < static_cast<size_t>(buffer.getNumber("byteLength", 0))) {
+					std::fprintf(stderr, "Buffer %zu is shorter than its byteLength\n", i);
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool loadDocument(const std::string& path, Document& document)
+		{
+			const size_t slash = path.find_last_of("/\\");
+			document.directory = slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+
+			std::vector<uint8_t> file;
+			if (!readFile(path, file)) {
+				return false;
+			}
+
+			std::string error;
+			uint32_t header[3] = {};
+			if (file.size() >= sizeof(header)) {
+				std::memcpy(header, file.data(), sizeof(header));
+			}
+			if (header[0] != GlbMagic) {
+				const char* text = reinterpret_cast<const char*>(file.data());
+				if (!JsonValue::parse(text, text + file.size(), document.json, error)) {
+					std::fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str());
+					return false;
+				}
+				return loadBuffers(document, nullptr);
+			}
+
+			// GLB: 12 byte header, then chunks of { length, type, data } padded to 4 bytes
+			std::vector<uint8_t> binary;
+			bool hasJson = false;
+			bool hasBinary = false;
+			size_t offset = sizeof(header);
+			while (offset + 8 <= file.size()) {
+				uint32_t chunk[2];
+				std::memcpy(chunk, file.data() + offset, sizeof(chunk));
+				offset += sizeof(chunk);
+				if (chunk[0] > file.size() - offset) {
+					std::fprintf(stderr, "%s: truncated GLB chunk\n", path.c_str());
+					return false;
+				}
+				const uint8_t* data = file.data() + offset;
+				if (chunk[1] == GlbJsonChunk && !hasJson) {
+					const char* text = reinterpret_cast<const char*>(data);
+					if (!JsonValue::parse(text, text + chunk[0], document.json, error)) {
+						std::fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str());
+						return false;
+					}
+					hasJson = true;
+				}
+				else if (chunk[1] == GlbBinaryChunk && !hasBinary) {
+					binary.assign(data, data + chunk[0]);
+					hasBinary = true;
+				}
+				offset += (chunk[0] + 3) & ~3u;
+			}
+			if (!hasJson) {
+				std::fprintf(stderr, "%s: GLB without a JSON chunk\n", path.c_str());
+				return false;
+			}
+			return loadBuffers(document, hasBinary ? &binary : nullptr);
+		}
+
+		size_t componentSize(const int componentType)
+		{
+			switch (componentType) {
+			case ComponentByte:
+			case ComponentUnsignedByte:
+				return 1;
+			case ComponentShort:
+			case ComponentUnsignedShort:
+				return 2;
+			case ComponentUnsignedInt:
+			case ComponentFloat:
+				return 4;
+			default:
+				return 0;
+			}
+		}
+
+		size_t typeComponentsCount(const std::string& type)
+		{
+			if (type == "SCALAR") return 1;
+			if (type == "VEC2") return 2;
+			if (type == "VEC3") return 3;
+			if (type == "VEC4") return 4;
+			return 0;
+		}
+
+		// Resolved view of an accessor, element i starts at data + i * stride
+		struct AccessorView {
+			const uint8_t* data = nullptr;
+			size_t count = 0;
+			size_t stride = 0;
+			size_t componentsCount = 0;
+			int componentType = 0;
+			bool isNormalized = false;
+		};
+
+		bool getAccessor(const Document& document, const size_t index, AccessorView& view)
+		{
+			const JsonValue* accessors = document.json.find("accessors");
+			const JsonValue* bufferViews = document.json.find("bufferViews");
+			if (!accessors || index >= accessors->size()) {
+				std::fprintf(stderr, "Accessor %zu doesn't exist\n", index);
+				return false;
+			}
+			const JsonValue& accessor = (*accessors)[index];
+			if (accessor.find("sparse")) {
+				std::fprintf(stderr, "Accessor %zu is sparse, that is not supported\n", index);
+				return false;
+			}
+
+			const std::string* type = accessor.getString("type");
+			view.componentType = static_cast<int>(accessor.getNumber("componentType", 0));
+			view.componentsCount = type ? typeComponentsCount(*type) : 0;
+			view.count = static_cast<size_t>(accessor.getNumber("count", 0));
+			const JsonValue* normalized = accessor.find("normalized");
+			view.isNormalized = normalized && normalized->getBool();
+
+			const size_t elementSize = componentSize(view.componentType) * view.componentsCount;
+			const double bufferViewIndex = accessor.getNumber("bufferView", -1);
+			if (elementSize == 0 || bufferViewIndex < 0 || !bufferViews || bufferViewIndex >= bufferViews->size()) {
+				std::fprintf(stderr, "Accessor %zu has no usable data\n", index);
+				return false;
+			}
+
+			const JsonValue& bufferView = (*bufferViews)[static_cast<size_t>(bufferViewIndex)];
+			const size_t bufferIndex = static_cast<size_t>(bufferView.getNumber("buffer", 0));
+			if (bufferIndex >= document.buffers.size()) {
+				std::fprintf(stderr, "Buffer view of accessor %zu points at a missing buffer\n", index);
+				return false;
+			}
+			const std::vector<uint8_t>& buffer = document.buffers[bufferIndex];
+			const size_t viewOffset = static_cast<size_t>(bufferView.getNumber("byteOffset", 0));
+			const size_t viewLength = static_cast<size_t>(bufferView.getNumber("byteLength", 0));
+			const size_t accessorOffset = static_cast<size_t>(accessor.getNumber("byteOffset", 0));
+			view.stride = static_cast<size_t>(bufferView.getNumber("byteStride", 0));
+			if (view.stride == 0) {
+				view.stride = elementSize;
+			}
+
+			const size_t required = view.count == 0 ? 0 : accessorOffset + (view.count - 1) * view.stride + elementSize;
+			if (viewOffset + viewLength > buffer.size() || required > viewLength) {
+				std::fprintf(stderr, "Accessor %zu reads past its buffer\n", index);
+				return false;
+			}
+			view.data = buffer.data() + viewOffset + accessorOffset;
+			return true;
+		}
+
+		float readComponent(const uint8_t* data, const int componentType, const bool isNormalized)
+		{
+			switch (componentType) {
+			case ComponentFloat: {
+				float value;
+				std::memcpy(&value, data, sizeof(value));
+				return value;
+			}
+			case ComponentUnsignedByte:
+				return isNormalized ? data[0] / 255.f : data[0];
+			case ComponentByte: {
+				const float value = static_cast<float>(static_cast<int8_t>(data[0]));
+				return isNormalized ? std::fmax(value / 127.f, -1.f) : value;
+			}
+			case ComponentUnsignedShort: {
+				uint16_t value;
+				std::memcpy(&value, data, sizeof(value));
+				return isNormalized ? value / 65535.f : value;
+			}
+			case ComponentShort: {
+				int16_t value;
+				std::memcpy(&value, data, sizeof(value));
+				return isNormalized ? std::fmax(value / 32767.f, -1.f) : value;
+			}
+			default:
+				return 0;
+			}
+		}
+
+		bool readFloats(const AccessorView& view, const size_t componentsCount, std::vector<float>& values)
+		{
+			if (view.componentsCount != componentsCount) {
+				std::fprintf(stderr, "Attribute has %zu components, expected %zu\n", view.componentsCount, componentsCount);
+				return false;
+			}
+			const size_t size = componentSize(view.componentType);
+			values.resize(view.count * componentsCount);
+			for (size_t i = 0; i < view.count; ++i) {
+				const uint8_t* element = view.data + i * view.stride;
+				for (size_t component = 0; component < componentsCount; ++component) {
+					values[i * componentsCount + component] = readComponent(element + component * size, view.componentType, view.isNormalized);
+				}
+			}
+			return true;
+		}
+
+		bool readIndices(const AccessorView& view, const size_t verticesCount, std::vector<uint32_t>& indices)
+		{
+			if (view.componentsCount != 1) {
+				std::fprintf(stderr, "Indices must be scalars\n");
+				return false;
+			}
+			indices.resize(view.count);
+			for (size_t i = 0; i < view.count; ++i) {
+				const uint8_t* element = view.data + i * view.stride;
+				uint32_t index = 0;
+				switch (view.componentType) {
+				case ComponentUnsignedByte:
+					index = element[0];
+					break;
+				case ComponentUnsignedShort: {
+					uint16_t value;
+					std::memcpy(&value, element, sizeof(value));
+					index = value;
+					break;
+				}
+				case ComponentUnsignedInt:
+					std::memcpy(&index, element, sizeof(index));
+					break;
+				default:
+					std::fprintf(stderr, "Unsupported index component type %d\n", view.componentType);
+					return false;
+				}
+				if (index >= verticesCount) {
+					std::fprintf(stderr, "Index %u is out of range\n", index);
+					return false;
+				}
+				indices[i] = index;
+			}
+			return true;
+		}
+
+		Matrix getLocalTransform(const JsonValue& node)
+		{
+			Matrix local;
+			if (const JsonValue* matrix = node.find("matrix"); matrix && matrix->size() == 16) {
+				for (size_t i = 0; i < 16; ++i) {
+					local.values[i] = static_cast<float>((*matrix)[i].getNumber(0));
+				}
+				return local;
+			}
+
+			const auto readVector = [&node](const char* key, float* values, const size_t count) {
+				if (const JsonValue* vector = node.find(key); vector && vector->size() == count) {
+					for (size_t i = 0; i < count; ++i) {
+						values[i] = static_cast<float>((*vector)[i].getNumber(0));
+					}
+				}
+			};
+			float translation[3] = { 0, 0, 0 };
+			float rotation[4] = { 0, 0, 0, 1 }; // x, y, z, w
+			float scale[3] = { 1, 1, 1 };
+			readVector("translation", translation, 3);
+			readVector("rotation", rotation, 4);
+			readVector("scale", scale, 3);
+
+			const float x = rotation[0], y = rotation[1], z = rotation[2], w = rotation[3];
+			const float rotationMatrix[9] = {
+				1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w),
+				2 * (x * y - z * w), 1 - 2 * (x * x + z * z), 2 * (y * z + x * w),
+				2 * (x * z + y * w), 2 * (y * z - x * w), 1 - 2 * (x * x + y * y)
+			};
+			for (int column = 0; column < 3; ++column) {
+				for (int row = 0; row < 3; ++row) {
+					local.values[column * 4 + row] = rotationMatrix[column * 3 + row] * scale[column];
+				}
+			}
+			local.values[12] = translation[0];
+			local.values[13] = translation[1];
+			local.values[14] = translation[2];
+			return local;
+		}
+
+		bool importPrimitive(const Document& document, const JsonValue& primitive, const Matrix& transform, ImportedMesh& mesh)
+		{
+			if (primitive.getNumber("mode", ModeTriangles) != ModeTriangles) {
+				std::fprintf(stderr, "Skipping a primitive that is not a triangle list\n");
+				return true;
+			}
+			const JsonValue* attributes = primitive.find("attributes");
+			const JsonValue* position = attributes ? attributes->find("POSITION") : nullptr;
+			if (!position) {
+				std::fprintf(stderr, "Skipping a primitive without positions\n");
+				return true;
+			}
+
+			ImportedMesh part;
+			AccessorView view;
+			if (!getAccessor(document, static_cast<size_t>(position->getNumber(0)), view) || !readFloats(view, 3, part.positions)) {
+				return false;
+			}
+			if (const JsonValue* normal = attributes->find("NORMAL")) {
+				if (!getAccessor(document, static_cast<size_t>(normal->getNumber(0)), view) || !readFloats(view, 3, part.normals)) {
+					return false;
+				}
+			}
+			if (const JsonValue* uv = attributes->find("TEXCOORD_0")) {
+				if (!getAccessor(document, static_cast<size_t>(uv->getNumber(0)), view) || !readFloats(view, 2, part.uvs)) {
+					return false;
+				}
+			}
+
+			if (const JsonValue* indices = primitive.find("indices")) {
+				if (!getAccessor(document, static_cast<size_t>(indices->getNumber(0)), view)
+					|| !readIndices(view, part.getVerticesCount(), part.indices)) {
+					return false;
+				}
+			}
+			else {
+				part.indices.resize(part.getVerticesCount());
+				for (size_t i = 0; i < part.indices.size(); ++i) {
+					part.indices[i] = static_cast<uint32_t>(i);
+				}
+			}
+			part.indices.resize(part.indices.size() / 3 * 3);
+
+			// Normals go through the upper 3x3, exact for rotations and uniform scale
+			const float* m = transform.values;
+			for (size_t i = 0; i < part.positions.size(); i += 3) {
+				const float x = part.positions[i], y = part.positions[i + 1], z = part.positions[i + 2];
+				part.positions[i] = m[0] * x + m[4] * y + m[8] * z + m[12];
+				part.positions[i + 1] = m[1] * x + m[5] * y + m[9] * z + m[13];
+				part.positions[i + 2] = m[2] * x + m[6] * y + m[10] * z + m[14];
+			}
+			for (size_t i = 0; i < part.normals.size(); i += 3) {
+				const float x = part.normals[i], y = part.normals[i + 1], z = part.normals[i + 2];
+				float normal[3] = {
+					m[0] * x + m[4] * y + m[8] * z,
+					m[1] * x + m[5] * y + m[9] * z,
+					m[2] * x + m[6] * y + m[10] * z
+				};
+				const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+				for (size_t axis = 0; axis < 3; ++axis) {
+					part.normals[i + axis] = length > 0.f ? normal[axis] / length : 0.f;
+				}
+			}
+
+			mesh.append(part);
+			return true;
+		}
+
+		bool importMesh(const Document& document, const size_t meshIndex, const Matrix& transform, ImportedMesh& mesh)
+		{
+			const JsonValue* meshes = document.json.find("meshes");
+			if (!meshes || meshIndex >= meshes->size()) {
+				std::fprintf(stderr, "Mesh %zu doesn't exist\n", meshIndex);
+				return false;
+			}
+			const JsonValue* primitives = (*meshes)[meshIndex].find("primitives");
+			for (size_t i = 0; primitives && i < primitives->size(); ++i) {
+				if (!importPrimitive(document, (*primitives)[i], transform, mesh)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool importNode(const Document& document, const size_t nodeIndex, const Matrix& parent, ImportedMesh& mesh, const size_t depth)
+		{
+			const JsonValue* nodes = document.json.find("nodes");
+			// glTF forbids cycles, the depth limit only guards against broken files
+			if (!nodes || nodeIndex >= nodes->size() || depth > 256) {
+				std::fprintf(stderr, "Node %zu is invalid\n", nodeIndex);
+				return false;
+			}
+			const JsonValue& node = (*nodes)[nodeIndex];
+			const Matrix world = parent * getLocalTransform(node);
+
+			if (const JsonValue* meshIndex = node.find("mesh")) {
+				if (!importMesh(document, static_cast<size_t>(meshIndex->getNumber(0)), world, mesh)) {
+					return false;
+				}
+			}
+			if (const JsonValue* children = node.find("children")) {
+				for (size_t i = 0; i < children->size(); ++i) {
+					if (!importNode(document, static_cast<size_t>((*children)[i].getNumber(0)), world, mesh, depth + 1)) {
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+	}
+
+	bool importGltf(const std::string& path, ImportedMesh& mesh)
+	{
+		Document document;
+		if (!loadDocument(path, document)) {
+			return false;
+		}
+
+		mesh = {};
+		const JsonValue* scenes = document.json.find("scenes");
+		if (!scenes || scenes->size() == 0) {
+			// No scene graph, every mesh is taken as is
+			const JsonValue* meshes = document.json.find("meshes");
+			for (size_t i = 0; meshes && i < meshes->size(); ++i) {
+				if (!importMesh(document, i, Matrix(), mesh)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		const size_t sceneIndex = static_cast<size_t>(document.json.getNumber("scene", 0));
+		if (sceneIndex >= scenes->size()) {
+			std::fprintf(stderr, "%s: default scene %zu doesn't exist\n", path.c_str(), sceneIndex);
+			return false;
+		}
+		const JsonValue* rootNodes = (*scenes)[sceneIndex].find("nodes");
+		for (size_t i = 0; rootNodes && i < rootNodes->size(); ++i) {
+			if (!importNode(document, static_cast<size_t>((*rootNodes)[i].getNumber(0)), Matrix(), mesh, 0)) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "importedMesh.h"
+
+#include <string>
+
+namespace MeshCooker {
+	// glTF 2.0 as .gltf (external or data URI buffers) or .glb. Triangle primitives of every mesh
+	// instanced by the default scene are baked with their node transforms and merged into one mesh.
+	// Reads POSITION, NORMAL and TEXCOORD_0; sparse accessors and Draco compression are not supported.
+	bool importGltf(const std::string& path, ImportedMesh& mesh);
+}
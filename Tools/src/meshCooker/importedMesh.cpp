@@ -0,0 +1,99 @@
+#include "importedMesh.h"
+
+#include <cmath>
+
+namespace MeshCooker {
+	void ImportedMesh::append(const ImportedMesh& other)
+	{
+		const size_t verticesCount = getVerticesCount();
+		const uint32_t baseVertex = static_cast<uint32_t>(verticesCount);
+
+		// A stream survives only if both sides have it, or this mesh is still empty
+		const bool keepNormals = (verticesCount == 0 || !normals.empty()) && !other.normals.empty();
+		const bool keepUvs = (verticesCount == 0 || !uvs.empty()) && !other.uvs.empty();
+		if (!keepNormals) {
+			normals.clear();
+		}
+		if (!keepUvs) {
+			uvs.clear();
+		}
+
+		positions.insert(positions.end(), other.positions.begin(), other.positions.end());
+		if (keepNormals) {
+			normals.insert(normals.end(), other.normals.begin(), other.normals.end());
+		}
+		if (keepUvs) {
+			uvs.insert(uvs.end(), other.uvs.begin(), other.uvs.end());
+		}
+
+		indices.reserve(indices.size() + other.indices.size());
+		for (const uint32_t index : other.indices) {
+			indices.push_back(index + baseVertex);
+		}
+	}
+
+	void ImportedMesh::computeNormals()
+	{
+		normals.assign(positions.size(), 0.f);
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			const float* a = &positions[indices[i] * 3];
+			const float* b = &positions[indices[i + 1] * 3];
+			const float* c = &positions[indices[i + 2] * 3];
+			const float ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+			const float ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+			// Not normalized, so larger triangles weigh more
+			const float normal[3] = {
+				ab[1] * ac[2] - ab[2] * ac[1],
+				ab[2] * ac[0] - ab[0] * ac[2],
+				ab[0] * ac[1] - ab[1] * ac[0]
+			};
+			for (size_t corner = 0; corner < 3; ++corner) {
+				float* target = &normals[indices[i + corner] * 3];
+				target[0] += normal[0];
+				target[1] += normal[1];
+				target[2] += normal[2];
+			}
+		}
+		for (size_t i = 0; i < normals.size(); i += 3) {
+			const float length = std::sqrt(normals[i] * normals[i] + normals[i + 1] * normals[i + 1] + normals[i + 2] * normals[i + 2]);
+			if (length > 0.f) {
+				normals[i] /= length;
+				normals[i + 1] /= length;
+				normals[i + 2] /= length;
+			}
+		}
+	}
+
+	GameEngine::BufferLayout ImportedMesh::getLayout(const bool withUvs) const
+	{
+		using GameEngine::ShaderDataType;
+		if (withUvs) {
+			return { ShaderDataType::Float3, ShaderDataType::Float3, ShaderDataType::Float2 };
+		}
+		return { ShaderDataType::Float3, ShaderDataType::Float3 };
+	}
+
+	std::vector<float> ImportedMesh::interleave(const bool withUvs) const
+	{
+		const size_t verticesCount = getVerticesCount();
+		const size_t floatsPerVertex = withUvs ? 8 : 6;
+
+		std::vector<float> vertices(verticesCount * floatsPerVertex, 0.f);
+		for (size_t i = 0; i < verticesCount; ++i) {
+			float* vertex = &vertices[i * floatsPerVertex];
+			vertex[0] = positions[i * 3];
+			vertex[1] = positions[i * 3 + 1];
+			vertex[2] = positions[i * 3 + 2];
+			if (!normals.empty()) {
+				vertex[3] = normals[i * 3];
+				vertex[4] = normals[i * 3 + 1];
+				vertex[5] = normals[i * 3 + 2];
+			}
+			if (withUvs && !uvs.empty()) {
+				vertex[6] = uvs[i * 2];
+				vertex[7] = uvs[i * 2 + 1];
+			}
+		}
+		return vertices;
+	}
+}
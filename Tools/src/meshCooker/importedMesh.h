@@ -0,0 +1,29 @@
+#pragma once
+
+#include "rendering/OpenGL/vertexBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MeshCooker {
+	// Triangle list shared by every importer, attributes are stored per vertex as separate streams
+	// and interleaved only when the output layout is known
+	struct ImportedMesh {
+		std::vector<float> positions; // xyz
+		std::vector<float> normals;   // xyz, empty when the source has none
+		std::vector<float> uvs;       // uv, empty when the source has none
+		std::vector<uint32_t> indices;
+
+		inline size_t getVerticesCount() const { return positions.size() / 3; }
+
+		// Appends other with its indices rebased, streams missing on either side are dropped or zero filled
+		void append(const ImportedMesh& other);
+		// Area weighted smooth normals
+		void computeNormals();
+
+		// position Float3, normal Float3 and, when withUvs, uv Float2
+		GameEngine::BufferLayout getLayout(const bool withUvs) const;
+		std::vector<float> interleave(const bool withUvs) const;
+	};
+}
@@ -0,0 +1,293 @@
+#include "json.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace MeshCooker {
+	class JsonParser {
+	public:
+		JsonParser(const char* begin, const char* end)
+			: m_begin(begin), m_cursor(begin), m_end(end)
+		{}
+
+		bool parseDocument(JsonValue& value, std::string& error)
+		{
+			const bool isParsed = parseValue(value, 0) && (skipSpaces(), m_cursor == m_end);
+			if (!isParsed) {
+				error = (m_error ? m_error : "trailing characters") + std::string(" at offset ")
+					+ std::to_string(m_cursor - m_begin);
+			}
+			return isParsed;
+		}
+	private:
+		static constexpr size_t MaxDepth = 128;
+
+		bool fail(const char* error)
+		{
+			m_error = error;
+			return false;
+		}
+
+		void skipSpaces()
+		{
+			while (m_cursor < m_end && (*m_cursor == ' ' || *m_cursor == '\t' || *m_cursor == '\n' || *m_cursor == '\r')) {
+				++m_cursor;
+			}
+		}
+
+		bool consume(const char* literal)
+		{
+			const size_t length = std::strlen(literal);
+			if (static_cast<size_t>(m_end - m_cursor) < length || std::memcmp(m_cursor, literal, length) != 0) {
+				return false;
+			}
+			m_cursor += length;
+			return true;
+		}
+
+		bool parseValue(JsonValue& value, const size_t depth)
+		{
+			if (depth > MaxDepth) {
+				return fail("nesting too deep");
+			}
+			skipSpaces();
+			if (m_cursor == m_end) {
+				return fail("unexpected end");
+			}
+
+			switch (*m_cursor) {
+			case '{':
+				return parseObject(value, depth);
+			case '[':
+				return parseArray(value, depth);
+			case '"':
+				value.m_type = JsonValue::Type::String;
+				return parseString(value.m_string);
+			case 't':
+			case 'f':
+				value.m_type = JsonValue::Type::Bool;
+				value.m_bool = *m_cursor == 't';
+				return consume(value.m_bool ? "true" : "false") || fail("invalid literal");
+			case 'n':
+				value.m_type = JsonValue::Type::Null;
+				return consume("null") || fail("invalid literal");
+			default:
+				return parseNumber(value);
+			}
+		}
+
+		bool parseNumber(JsonValue& value)
+		{
+			// strtod needs a terminated string, numbers are short so copy them out
+			char buffer[64];
+			size_t length = 0;
+			while (m_cursor + length < m_end && length + 1 < sizeof(buffer)
+				&& std::strchr("+-0123456789.eE", m_cursor[length]) != nullptr) {
+				buffer[length] = m_cursor[length];
+				++length;
+			}
+			buffer[length] = '\0';
+
+			char* numberEnd = nullptr;
+			value.m_type = JsonValue::Type::Number;
+			value.m_number = std::strtod(buffer, &numberEnd);
+			if (length == 0 || numberEnd != buffer + length) {
+				return fail("invalid number");
+			}
+			m_cursor += length;
+			return true;
+		}
+
+		static void appendUtf8(std::string& string, const uint32_t codePoint)
+		{
+			if (codePoint < 0x80) {
+				string += static_cast<char>(codePoint);
+			}
+			else if (codePoint < 0x800) {
+				string += static_cast<char>(0xC0 | (codePoint >> 6));
+				string += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+			else if (codePoint < 0x10000) {
+				string += static_cast<char>(0xE0 | (codePoint >> 12));
+				string += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				string += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+			else {
+				string += static_cast<char>(0xF0 | (codePoint >> 18));
+				string += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+				string += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				string += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+		}
+
+		bool parseHex4(uint32_t& value)
+		{
+			if (m_end - m_cursor < 4) {
+				return fail("invalid unicode escape");
+			}
+			char digits[5] = { m_cursor[0], m_cursor[1], m_cursor[2], m_cursor[3], '\0' };
+			char* digitsEnd = nullptr;
+			value = static_cast<uint32_t>(std::strtoul(digits, &digitsEnd, 16));
+			if (digitsEnd != digits + 4) {
+				return fail("invalid unicode escape");
+			}
+			m_cursor += 4;
+			return true;
+		}
+
+		bool parseString(std::string& string)
+		{
+			++m_cursor; // opening quote
+			while (m_cursor < m_end && *m_cursor != '"') {
+				if (*m_cursor != '\\') {
+					string += *m_cursor++;
+					continue;
+				}
+				if (++m_cursor == m_end) {
+					break;
+				}
+				const char escape = *m_cursor++;
+				switch (escape) {
+				case '"': string += '"'; break;
+				case '\\': string += '\\'; break;
+				case '/': string += '/'; break;
+				case 'b': string += '\b'; break;
+				case 'f': string += '\f'; break;
+				case 'n': string += '\n'; break;
+				case 'r': string += '\r'; break;
+				case 't': string += '\t'; break;
+				case 'u': {
+					uint32_t codePoint = 0;
+					if (!parseHex4(codePoint)) {
+						return false;
+					}
+					if (codePoint >= 0xD800 && codePoint < 0xDC00 && consume("\\u")) {
+						uint32_t low = 0;
+						if (!parseHex4(low)) {
+							return false;
+						}
+						codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+					}
+					appendUtf8(string, codePoint);
+					break;
+				}
+				default:
+					return fail("invalid escape");
+				}
+			}
+			if (m_cursor == m_end) {
+				return fail("unterminated string");
+			}
+			++m_cursor; // closing quote
+			return true;
+		}
+
+		bool parseArray(JsonValue& value, const size_t depth)
+		{
+			value.m_type = JsonValue::Type::Array;
+			++m_cursor;
+			skipSpaces();
+			if (m_cursor < m_end && *m_cursor == ']') {
+				++m_cursor;
+				return true;
+			}
+			while (true) {
+				value.m_array.emplace_back();
+				if (!parseValue(value.m_array.back(), depth + 1)) {
+					return false;
+				}
+				skipSpaces();
+				if (m_cursor < m_end && *m_cursor == ',') {
+					++m_cursor;
+					continue;
+				}
+				if (m_cursor < m_end && *m_cursor == ']') {
+					++m_cursor;
+					return true;
+				}
+				return fail("expected ',' or ']'");
+			}
+		}
+
+		bool parseObject(JsonValue& value, const size_t depth)
+		{
+			value.m_type = JsonValue::Type::Object;
+			++m_cursor;
+			skipSpaces();
+			if (m_cursor < m_end && *m_cursor == '}') {
+				++m_cursor;
+				return true;
+			}
+			while (true) {
+				skipSpaces();
+				if (m_cursor == m_end || *m_cursor != '"') {
+					return fail("expected a key");
+				}
+				value.m_object.emplace_back();
+				if (!parseString(value.m_object.back().first)) {
+					return false;
+				}
+				skipSpaces();
+				if (m_cursor == m_end || *m_cursor != ':') {
+					return fail("expected ':'");
+				}
+				++m_cursor;
+				if (!parseValue(value.m_object.back().second, depth + 1)) {
+					return false;
+				}
+				skipSpaces();
+				if (m_cursor < m_end && *m_cursor == ',') {
+					++m_cursor;
+					continue;
+				}
+				if (m_cursor < m_end && *m_cursor == '}') {
+					++m_cursor;
+					return true;
+				}
+				return fail("expected ',' or '}'");
+			}
+		}
+
+		const char* m_begin;
+		const char* m_cursor;
+		const char* m_end;
+		const char* m_error = nullptr;
+	};
+
+	const JsonValue* JsonValue::find(const char* key) const
+	{
+		if (m_type != Type::Object) {
+			return nullptr;
+		}
+		for (const auto& [name, value] : m_object) {
+			if (name == key) {
+				return &value;
+			}
+		}
+		return nullptr;
+	}
+
+	double JsonValue::getNumber(const double fallback) const
+	{
+		return m_type == Type::Number ? m_number : fallback;
+	}
+
+	double JsonValue::getNumber(const char* key, const double fallback) const
+	{
+		const JsonValue* value = find(key);
+		return value ? value->getNumber(fallback) : fallback;
+	}
+
+	const std::string* JsonValue::getString(const char* key) const
+	{
+		const JsonValue* value = find(key);
+		return value && value->m_type == Type::String ? &value->m_string : nullptr;
+	}
+
+	bool JsonValue::parse(const char* begin, const char* end, JsonValue& value, std::string& error)
+	{
+		value = JsonValue();
+		JsonParser parser(begin, end);
+		return parser.parseDocument(value, error);
+	}
+}
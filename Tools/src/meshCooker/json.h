@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace MeshCooker {
+	// Just enough JSON for glTF documents: a DOM with objects kept in file order
+	class JsonValue {
+	public:
+		enum class Type {
+			Null, Bool, Number, String, Array, Object
+		};
+
+		inline Type getType() const { return m_type; }
+		inline bool isObject() const { return m_type == Type::Object; }
+		inline bool isArray() const { return m_type == Type::Array; }
+
+		// nullptr when this is not an object or the key is absent
+		const JsonValue* find(const char* key) const;
+		// Elements of an array, 0 for anything else
+		inline size_t size() const { return m_array.size(); }
+		inline const JsonValue& operator[](const size_t index) const { return m_array[index]; }
+
+		double getNumber(const double fallback = 0) const;
+		inline bool getBool(const bool fallback = false) const { return m_type == Type::Bool ? m_bool : fallback; }
+		const std::string& getString() const { return m_string; }
+		// Shortcuts for optional members
+		double getNumber(const char* key, const double fallback) const;
+		const std::string* getString(const char* key) const;
+
+		// Parses a whole document, error gets the reason and the offset on failure
+		static bool parse(const char* begin, const char* end, JsonValue& value, std::string& error);
+	private:
+		friend class JsonParser;
+
+		Type m_type = Type::Null;
+		bool m_bool = false;
+		double m_number = 0;
+		std::string m_string;
+		std::vector<JsonValue> m_array;
+		std::vector<std::pair<std::string, JsonValue>> m_object;
+	};
+}
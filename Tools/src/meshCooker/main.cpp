@@ -0,0 +1,110 @@
+#include "importedMesh.h"
+#include "objImporter.h"
+#include "gltfImporter.h"
+#include "resources/meshFile.h"
+#include "resources/meshSimplifier.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// Converts OBJ/glTF into the engine's binary mesh format offline, see resources/meshFile.h.
+// The output layout is position Float3, normal Float3 and, with --uv, uv Float2. --lods adds up to
+// count levels of detail (all of them by default), each with half the triangles of the previous one.
+// Usage: meshcooker <input.obj|.gltf|.glb> <output.gem> [--uv] [--lods [count]]
+
+namespace {
+	std::string getExtension(const std::string& path)
+	{
+		const size_t dot = path.find_last_of('.');
+		std::string extension = dot == std::string::npos ? std::string() : path.substr(dot + 1);
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](const unsigned char c) {
+			return static_cast<char>(std::tolower(c));
+		});
+		return extension;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using Clock = std::chrono::steady_clock;
+
+	if (argc < 3) {
+		std::fprintf(stderr, "Usage: meshcooker <input.obj|.gltf|.glb> <output.gem> [--uv] [--lods [count]]\n");
+		return 1;
+	}
+	const std::string input = argv[1];
+	const std::string output = argv[2];
+	bool withUvs = false;
+	// Levels including the full detail one
+	size_t lodsCount = 1;
+	for (int i = 3; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--uv") == 0) {
+			withUvs = true;
+		}
+		else if (std::strcmp(argv[i], "--lods") == 0) {
+			lodsCount = GameEngine::MeshFileHeader::MaxLods;
+			if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+				lodsCount = std::clamp<size_t>(std::strtoul(argv[++i], nullptr, 10), 1, GameEngine::MeshFileHeader::MaxLods);
+			}
+		}
+		else {
+			std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	const Clock::time_point begin = Clock::now();
+	MeshCooker::ImportedMesh mesh;
+	const std::string extension = getExtension(input);
+	bool isImported = false;
+	if (extension == "obj") {
+		isImported = MeshCooker::importObj(input, mesh);
+	}
+	else if (extension == "gltf" || extension == "glb") {
+		isImported = MeshCooker::importGltf(input, mesh);
+	}
+	else {
+		std::fprintf(stderr, "Unsupported input format .%s\n", extension.c_str());
+		return 1;
+	}
+	if (!isImported) {
+		return 1;
+	}
+	if (mesh.indices.empty()) {
+		std::fprintf(stderr, "%s has no triangles\n", input.c_str());
+		return 1;
+	}
+
+	if (mesh.normals.empty()) {
+		mesh.computeNormals();
+	}
+	if (withUvs && mesh.uvs.empty()) {
+		std::fprintf(stderr, "%s has no texture coordinates, they are written as zeros\n", input.c_str());
+	}
+
+	const std::vector<float> vertices = mesh.interleave(withUvs);
+	const GameEngine::BufferLayout layout = mesh.getLayout(withUvs);
+	const GameEngine::MeshLodChain chain = GameEngine::MeshSimplifier::buildLods(
+		layout, vertices.data(), mesh.getVerticesCount(), mesh.indices.data(), mesh.indices.size(), lodsCount
+	);
+	if (!GameEngine::MeshFile::write(
+		output, layout, vertices.data(), mesh.getVerticesCount(),
+		chain.indices.data(), chain.indices.size(), chain.lods.data(), chain.lods.size()
+	)) {
+		std::fprintf(stderr, "Can't write %s\n", output.c_str());
+		return 1;
+	}
+
+	const double ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+	std::printf("%s -> %s: %zu vertices, %zu triangles in %.1f ms\n",
+		input.c_str(), output.c_str(), mesh.getVerticesCount(), mesh.indices.size() / 3, ms);
+	for (size_t i = 1; i < chain.lods.size(); ++i) {
+		std::printf("  lod %zu: %u triangles, error %g\n", i, chain.lods[i].indicesCount / 3, static_cast<double>(chain.lods[i].error));
+	}
+	return 0;
+}
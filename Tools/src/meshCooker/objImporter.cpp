@@ -0,0 +1,175 @@
+#include "objImporter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace MeshCooker {
+	namespace {
+		struct VertexKey {
+			int32_t position;
+			int32_t uv;
+			int32_t normal;
+
+			bool operator==(const VertexKey& other) const
+			{
+				return position == other.position && uv == other.uv && normal == other.normal;
+			}
+		};
+
+		struct VertexKeyHash {
+			size_t operator()(const VertexKey& key) const
+			{
+				uint64_t hash = static_cast<uint32_t>(key.position);
+				hash = hash * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(key.uv);
+				hash = hash * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(key.normal);
+				return static_cast<size_t>(hash ^ (hash >> 32));
+			}
+		};
+
+		inline const char* skipSpaces(const char* cursor)
+		{
+			while (*cursor == ' ' || *cursor == '\t') {
+				++cursor;
+			}
+			return cursor;
+		}
+
+		inline const char* skipLine(const char* cursor)
+		{
+			while (*cursor != '\0' && *cursor != '\n') {
+				++cursor;
+			}
+			return *cursor == '\n' ? cursor + 1 : cursor;
+		}
+
+		// Reads up to count floats of the current line, missing ones stay zero
+		inline const char* parseFloats(const char* cursor, float* values, const size_t count)
+		{
+			for (size_t i = 0; i < count; ++i) {
+				char* next = nullptr;
+				values[i] = std::strtof(cursor, &next);
+				if (next == cursor) {
+					values[i] = 0.f;
+					break;
+				}
+				cursor = next;
+			}
+			return cursor;
+		}
+
+		// OBJ indices are 1-based, negative ones count back from the last element read so far.
+		// Returns -1 for an absent or out of range reference.
+		inline int32_t resolveIndex(const long index, const size_t elementsCount)
+		{
+			const long resolved = index > 0 ? index - 1 : static_cast<long>(elementsCount) + index;
+			return resolved >= 0 && resolved < static_cast<long>(elementsCount) ? static_cast<int32_t>(resolved) : -1;
+		}
+	}
+
+	bool importObj(const std::string& path, ImportedMesh& mesh)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			std::fprintf(stderr, "Can't open %s\n", path.c_str());
+			return false;
+		}
+		std::ostringstream stream;
+		stream << file.rdbuf();
+		// The string keeps a terminating zero, so strtof/strtol never run past the data
+		const std::string text = stream.str();
+
+		std::vector<float> positions;
+		std::vector<float> uvs;
+		std::vector<float> normals;
+		positions.reserve(text.size() / 16);
+
+		std::unordered_map<VertexKey, uint32_t, VertexKeyHash> vertices;
+		vertices.reserve(text.size() / 32);
+		std::vector<uint32_t> polygon;
+
+		mesh = {};
+		size_t lineNumber = 0;
+		for (const char* cursor = text.c_str(); *cursor != '\0'; cursor = skipLine(cursor)) {
+			++lineNumber;
+			const char* line = skipSpaces(cursor);
+
+			if (line[0] == 'v' && (line[1] == ' ' || line[1] == '\t')) {
+				float value[3];
+				parseFloats(line + 2, value, 3);
+				positions.insert(positions.end(), value, value + 3);
+			}
+			else if (line[0] == 'v' && line[1] == 't') {
+				float value[2];
+				parseFloats(line + 2, value, 2);
+				uvs.insert(uvs.end(), value, value + 2);
+			}
+			else if (line[0] == 'v' && line[1] == 'n') {
+				float value[3];
+				parseFloats(line + 2, value, 3);
+				normals.insert(normals.end(), value, value + 3);
+			}
+			else if (line[0] == 'f' && (line[1] == ' ' || line[1] == '\t')) {
+				polygon.clear();
+				const char* reference = skipSpaces(line + 2);
+				while (*reference != '\0' && *reference != '\n' && *reference != '\r') {
+					char* next = nullptr;
+					VertexKey key = { -1, -1, -1 };
+					key.position = resolveIndex(std::strtol(reference, &next, 10), positions.size() / 3);
+					if (next == reference || key.position < 0) {
+						std::fprintf(stderr, "%s:%zu: invalid face vertex\n", path.c_str(), lineNumber);
+						return false;
+					}
+					reference = next;
+					if (*reference == '/') {
+						++reference;
+						if (*reference != '/') {
+							key.uv = resolveIndex(std::strtol(reference, &next, 10), uvs.size() / 2);
+							reference = next;
+						}
+						if (*reference == '/') {
+							++reference;
+							key.normal = resolveIndex(std::strtol(reference, &next, 10), normals.size() / 3);
+							reference = next;
+						}
+					}
+
+					const auto [it, isNew] = vertices.try_emplace(key, static_cast<uint32_t>(vertices.size()));
+					if (isNew) {
+						mesh.positions.insert(mesh.positions.end(), &positions[key.position * 3], &positions[key.position * 3] + 3);
+						if (key.uv >= 0) {
+							mesh.uvs.resize(it->second * 2 + 2, 0.f);
+							mesh.uvs[it->second * 2] = uvs[key.uv * 2];
+							mesh.uvs[it->second * 2 + 1] = uvs[key.uv * 2 + 1];
+						}
+						if (key.normal >= 0) {
+							mesh.normals.resize(it->second * 3 + 3, 0.f);
+							std::copy(&normals[key.normal * 3], &normals[key.normal * 3] + 3, &mesh.normals[it->second * 3]);
+						}
+					}
+					polygon.push_back(it->second);
+					reference = skipSpaces(reference);
+				}
+
+				for (size_t i = 2; i < polygon.size(); ++i) {
+					mesh.indices.push_back(polygon[0]);
+					mesh.indices.push_back(polygon[i - 1]);
+					mesh.indices.push_back(polygon[i]);
+				}
+			}
+		}
+
+		// Vertices without a uv/normal reference leave holes at the end of the streams
+		if (!mesh.uvs.empty()) {
+			mesh.uvs.resize(mesh.getVerticesCount() * 2, 0.f);
+		}
+		if (!mesh.normals.empty()) {
+			mesh.normals.resize(mesh.getVerticesCount() * 3, 0.f);
+		}
+		return true;
+	}
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "importedMesh.h"
+
+#include <string>
+
+namespace MeshCooker {
+	// Wavefront OBJ: v/vt/vn/f records, polygons are fan triangulated and every distinct
+	// position/uv/normal triple becomes one vertex. Groups, objects and materials are merged.
+	bool importObj(const std::string& path, ImportedMesh& mesh);
+}
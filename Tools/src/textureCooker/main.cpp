@@ -0,0 +1,103 @@
+#include "resources/textureFile.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Converts a binary PPM image into the engine's texture format with its mip chain, see resources/textureFile.h.
+// The texels are stored as RGBA8 with an opaque alpha.
+// Usage: texturecooker <input.ppm> <output.getx>
+
+namespace {
+	// Header fields are whitespace separated numbers, comments run from # to the end of the line
+	bool readHeaderValue(std::istream& stream, uint32_t& value)
+	{
+		int c = stream.get();
+		while (c == '#' || std::isspace(c)) {
+			if (c == '#') {
+				while (c != '\n' && c != EOF) {
+					c = stream.get();
+				}
+			}
+			c = stream.get();
+		}
+		if (!std::isdigit(c)) {
+			return false;
+		}
+		value = 0;
+		while (std::isdigit(c)) {
+			value = value * 10 + static_cast<uint32_t>(c - '0');
+			c = stream.get();
+		}
+		// The single whitespace after the last value separates the header from the pixels
+		return std::isspace(c) != 0;
+	}
+
+	bool readPpm(const std::string& path, uint32_t& width, uint32_t& height, std::vector<uint8_t>& pixels)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			std::fprintf(stderr, "Can't open %s\n", path.c_str());
+			return false;
+		}
+		char magic[2] = {};
+		file.read(magic, 2);
+		uint32_t maxValue = 0;
+		if (magic[0] != 'P' || magic[1] != '6'
+			|| !readHeaderValue(file, width) || !readHeaderValue(file, height) || !readHeaderValue(file, maxValue)) {
+			std::fprintf(stderr, "%s is not a binary PPM (P6) image\n", path.c_str());
+			return false;
+		}
+		if (maxValue != 255 || width == 0 || height == 0) {
+			std::fprintf(stderr, "%s: only 8-bit images with pixels are supported\n", path.c_str());
+			return false;
+		}
+
+		std::vector<uint8_t> rgb(static_cast<size_t>(width) * height * 3);
+		file.read(reinterpret_cast<char*>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+		if (!file) {
+			std::fprintf(stderr, "%s is truncated\n", path.c_str());
+			return false;
+		}
+		pixels.resize(static_cast<size_t>(width) * height * 4);
+		for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i) {
+			pixels[i * 4 + 0] = rgb[i * 3 + 0];
+			pixels[i * 4 + 1] = rgb[i * 3 + 1];
+			pixels[i * 4 + 2] = rgb[i * 3 + 2];
+			pixels[i * 4 + 3] = 255;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using Clock = std::chrono::steady_clock;
+
+	if (argc != 3) {
+		std::fprintf(stderr, "Usage: texturecooker <input.ppm> <output.getx>\n");
+		return 1;
+	}
+	const std::string input = argv[1];
+	const std::string output = argv[2];
+
+	const Clock::time_point begin = Clock::now();
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<uint8_t> pixels;
+	if (!readPpm(input, width, height, pixels)) {
+		return 1;
+	}
+	if (!GameEngine::TextureFile::write(output, width, height, pixels.data())) {
+		std::fprintf(stderr, "Can't write %s\n", output.c_str());
+		return 1;
+	}
+
+	const double ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+	std::printf("%s -> %s: %ux%u, %u mips in %.1f ms\n",
+		input.c_str(), output.c_str(), width, height, GameEngine::TextureFile::computeMipsCount(width, height), ms);
+	return 0;
+}